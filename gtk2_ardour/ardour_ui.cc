@@ -2225,6 +2225,39 @@ ARDOUR_UI::save_state (const string & name, bool switch_to_it)
 		rename_session (true);
 	}
 
+	add_ui_state_to_session ();
+
+	save_state_canfail (name, switch_to_it);
+}
+
+/** Save the current snapshot, writing the state file in a background
+ *  thread. Snapshots, and sessions which are yet to be named, are saved
+ *  by save_state().
+ */
+void
+ARDOUR_UI::save_state_in_background ()
+{
+	if (!_session || _session->deletion_in_progress()) {
+		return;
+	}
+
+	if (_session->unnamed()) {
+		save_state ("", false);
+		return;
+	}
+
+	add_ui_state_to_session ();
+
+	if (_session->save_state_in_background () == 0) {
+		watch_background_save ();
+	}
+
+	save_ardour_state ();
+}
+
+void
+ARDOUR_UI::add_ui_state_to_session ()
+{
 	XMLNode* node = new XMLNode (X_("UI"));
 
 	WM::Manager::instance().add_state (*node);
@@ -2236,8 +2269,27 @@ ARDOUR_UI::save_state (const string & name, bool switch_to_it)
 	if (export_video_dialog) {
 		_session->add_extra_xml (export_video_dialog->get_state());
 	}
+}
 
-	save_state_canfail (name, switch_to_it);
+void
+ARDOUR_UI::watch_background_save ()
+{
+	if (!_background_save_connection.connected()) {
+		_background_save_connection = Glib::signal_timeout().connect (sigc::mem_fun (*this, &ARDOUR_UI::poll_background_save), 100);
+	}
+}
+
+/* finish the save (emitting its signals and updating the dirty state) in the
+ * GUI thread, once the save thread is done
+ */
+gint
+ARDOUR_UI::poll_background_save ()
+{
+	if (!_session || _session->finish_background_save ()) {
+		return 0;
+	}
+
+	return 1;
 }
 
 int
@@ -249,6 +249,7 @@ public:
 
 	int  save_state_canfail (std::string state_name = "", bool switch_to_it = false);
 	void save_state (const std::string & state_name = "", bool switch_to_it = false);
+	void save_state_in_background ();
 
 	static ARDOUR_UI *instance () { return theArdourUI; }
 
@@ -483,6 +484,13 @@ private:
 	void update_autosave();
 	sigc::connection _autosave_connection;
 
+	/* finish a session save which is written in the background */
+	void watch_background_save ();
+	gint poll_background_save ();
+	sigc::connection _background_save_connection;
+
+	void add_ui_state_to_session ();
+
 	void session_dirty_changed ();
 	void update_title ();
 
@@ -1345,6 +1345,7 @@ ARDOUR_UI::autosave_session ()
 
 	if (_session) {
 		_session->maybe_write_autosave();
+		watch_background_save ();
 	}
 
 	return 1;
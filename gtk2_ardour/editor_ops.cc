@@ -5398,6 +5398,7 @@ Editor::reset_point_selection ()
 	for (PointSelection::iterator i = selection->points.begin(); i != selection->points.end(); ++i) {
 		ARDOUR::AutomationList::iterator j = (*i)->model ();
 		(*j)->value = (*i)->line().the_list()->descriptor ().normal;
+		(*i)->line().the_list()->mark_dirty ();
 	}
 }
 
@@ -4575,6 +4575,21 @@ These settings will only take effect after %1 is restarted.\n\
 		procs->set_note (string_compose (_("This setting will only take effect when %1 is restarted."), PROGRAM_NAME));
 
 		add_option (_("Performance"), procs);
+
+		ComboOption<GraphScheduling>* gs = new ComboOption<GraphScheduling> (
+				"graph-scheduling",
+				_("Process graph scheduling"),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::get_graph_scheduling),
+				sigc::mem_fun (*_rc_config, &RCConfiguration::set_graph_scheduling)
+				);
+
+		gs->add (SharedTriggerQueue, _("shared queue"));
+		gs->add (WorkStealing, _("work stealing"));
+
+		Gtkmm2ext::UI::instance()->set_tip (gs->tip_widget(),
+				_("With work stealing, each DSP thread keeps its own queue of ready routes and runs downstream routes itself. Idle threads spin until the cycle's deadline before sleeping. This can reduce scheduling overhead for large sessions on many-core systems."));
+
+		add_option (_("Performance"), gs);
 	}
 
 #if !(defined PLATFORM_WINDOWS || defined __APPLE__)
@@ -32,9 +32,14 @@
 #include "pbd/debug.h"
 #include "pbd/error.h"
 #include "pbd/failed_constructor.h"
+#include "pbd/g_atomic_compat.h"
+#include "pbd/timing.h"
 
 #include "ardour/ardour.h"
+#include "ardour/audio_backend.h"
 #include "ardour/audioengine.h"
+#include "ardour/butler.h"
+#include "ardour/disk_reader.h"
 #include "ardour/revision.h"
 #include "ardour/session.h"
 
@@ -50,6 +55,7 @@ static const char* localedir = LOCALEDIR;
 
 static string             backend_client_name;
 static string             backend_name = "JACK";
+static string             driver_name;
 static CrossThreadChannel xthread (true);
 static TestReceiver       test_receiver;
 
@@ -72,6 +78,11 @@ load_session (string dir, string state)
 		exit (EXIT_FAILURE);
 	}
 
+	if (!driver_name.empty () && engine->current_backend ()->set_driver (driver_name)) {
+		std::cerr << "Cannot set Audio/MIDI engine driver\n";
+		exit (EXIT_FAILURE);
+	}
+
 	if (engine->start () != 0) {
 		std::cerr << "Cannot start Audio/MIDI engine\n";
 		exit (EXIT_FAILURE);
@@ -103,6 +114,94 @@ engine_halted (const char* reason)
 	xthread.deliver ('x');
 }
 
+static TimingStats       benchmark_stats;
+static GATOMIC_QUAL gint benchmark_underruns = 0;
+
+/** Freewheel handler used by benchmark(). Processing is not paced by
+ * the backend, so wait for the butler to catch up with disk i/o before
+ * each cycle, like an export does. Only the session's process()
+ * is timed, not the wait.
+ */
+static void
+benchmark_cycle (Session* s, pframes_t nframes)
+{
+	s->butler ()->wait_until_finished ();
+
+	TimerRAII tr (benchmark_stats);
+	s->process (nframes);
+}
+
+static void
+benchmark_underrun ()
+{
+	g_atomic_int_inc (&benchmark_underruns);
+}
+
+/** Let the session roll for \p seconds of engine time, freewheeling,
+ * and report the time taken by Session::process () per cycle.
+ *
+ * @return false if no cycles were processed, or if the
+ * disk reader ran out of data.
+ */
+static bool
+benchmark (Session* s, double seconds)
+{
+	AudioEngine* engine = AudioEngine::instance ();
+
+	PBD::ScopedConnectionList con;
+	engine->Freewheel.connect_same_thread (con, boost::bind (&benchmark_cycle, s, _1));
+	DiskReader::Underrun.connect_same_thread (con, boost::bind (&benchmark_underrun));
+
+	if (engine->freewheel (true)) {
+		cerr << "Benchmark: cannot freewheel the Audio/MIDI engine\n";
+		return false;
+	}
+
+	while (engine->running () && !engine->freewheeling ()) {
+		Glib::usleep (1000);
+	}
+
+	samplepos_t const start    = engine->sample_time ();
+	samplecnt_t const duration = seconds * engine->sample_rate ();
+
+	benchmark_stats.queue_reset ();
+	g_atomic_int_set (&benchmark_underruns, 0);
+	int64_t const t0 = g_get_monotonic_time ();
+
+	while (engine->running () && engine->sample_time () - start < duration) {
+		Glib::usleep (10000);
+	}
+
+	int64_t const     t1       = g_get_monotonic_time ();
+	samplecnt_t const n_cycles = (engine->sample_time () - start) / engine->samples_per_cycle ();
+
+	engine->freewheel (false);
+	con.drop_connections ();
+
+	microseconds_t min, max;
+	double         avg, dev;
+
+	if (n_cycles == 0 || t1 <= t0 || !benchmark_stats.get_stats (min, max, avg, dev)) {
+		cerr << "Benchmark: no cycles were processed\n";
+		return false;
+	}
+
+	cout << "Benchmark: " << n_cycles << " cycles of " << engine->samples_per_cycle () << " samples"
+	     << " in " << (t1 - t0) / 1e6 << " sec, " << n_cycles * 1e6 / (t1 - t0) << " cycles/sec\n"
+	     << "Session process: avg " << avg << " us, min " << min << " us, max " << max << " us, dev " << dev << " us"
+	     << " (" << 100. * avg * engine->sample_rate () / (1e6 * engine->samples_per_cycle ()) << "% of nominal cycle time)"
+	     << endl;
+
+	int const underruns = g_atomic_int_get (&benchmark_underruns);
+
+	if (underruns > 0) {
+		cerr << "Benchmark: disk reader underrun (" << underruns << " times), results are not valid\n";
+		return false;
+	}
+
+	return true;
+}
+
 #ifndef PLATFORM_WINDOWS
 static void
 wearedone (int)
@@ -138,6 +237,10 @@ print_help ()
 	     << "  -c, --name <name>           Use a specific backend client name, default is ardour\n"
 	     << "  -d, --disable-plugins       Disable all plugins in an existing session\n"
 	     << "  -D, --debug <options>       Set debug flags. Use \"-D list\" to see available options\n"
+	     << "  -E, --backend <name>        Use the given Audio/MIDI backend, default is JACK\n"
+	     << "  -S, --driver <name>         Use the given backend driver\n"
+	     << "  -T, --benchmark <sec>       Freewheel for the given time, print process statistics and quit\n"
+	     << "  -R, --seed <n>              Use fixed seeds for the Dummy backend's signal generators\n"
 	     << "  -O, --no-hw-optimizations   Disable h/w specific optimizations\n"
 	     << "  -P, --no-connect-ports      Do not connect any ports at startup\n"
 #ifdef WINDOWS_VST_SUPPORT
@@ -149,7 +252,7 @@ print_help ()
 int
 main (int argc, char* argv[])
 {
-	const char* optstring = "vhBdD:c:OU:P";
+	const char* optstring = "vhBdD:c:E:OU:PR:S:T:";
 
 	/* clang-format off */
 	const struct option longopts[] = {
@@ -161,11 +264,16 @@ main (int argc, char* argv[])
 		{ "name",                required_argument, 0, 'c' },
 		{ "no-hw-optimizations", no_argument,       0, 'O' },
 		{ "no-connect-ports",    no_argument,       0, 'P' },
+		{ "backend",             required_argument, 0, 'E' },
+		{ "driver",              required_argument, 0, 'S' },
+		{ "benchmark",           required_argument, 0, 'T' },
+		{ "seed",                required_argument, 0, 'R' },
 		{ 0, 0, 0, 0 }
 	};
 	/* clang-format on */
 
-	bool try_hw_optimization = true;
+	bool   try_hw_optimization = true;
+	double benchmark_time      = 0;
 
 	backend_client_name = PBD::downcase (std::string (PROGRAM_NAME));
 
@@ -211,6 +319,23 @@ main (int argc, char* argv[])
 				ARDOUR::Port::set_connecting_blocked (true);
 				break;
 
+			case 'E':
+				backend_name = optarg;
+				break;
+
+			case 'S':
+				driver_name = optarg;
+				break;
+
+			case 'T':
+				benchmark_time = atof (optarg);
+				break;
+
+			case 'R':
+				/* read by the Dummy backend when it is instantiated */
+				g_setenv ("ARDOUR_DUMMY_SEED", optarg, true);
+				break;
+
 			default:
 				print_help ();
 				exit (EXIT_FAILURE);
@@ -267,14 +392,20 @@ main (int argc, char* argv[])
 
 	s->request_roll ();
 
-	char msg;
-	do {
-	} while (0 == xthread.receive (msg, true));
+	bool ok = true;
+
+	if (benchmark_time > 0) {
+		ok = benchmark (s, benchmark_time);
+	} else {
+		char msg;
+		do {
+		} while (0 == xthread.receive (msg, true));
+	}
 
 	AudioEngine::instance ()->remove_session ();
 	delete s;
 	AudioEngine::instance ()->stop ();
 
 	AudioEngine::destroy ();
-	return 0;
+	return ok ? EXIT_SUCCESS : EXIT_FAILURE;
 }
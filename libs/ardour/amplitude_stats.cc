@@ -0,0 +1,310 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef COMPILER_MSVC
+#include <io.h> // Microsoft's nearest equivalent to <unistd.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/compose.h"
+#include "pbd/scoped_file_descriptor.h"
+
+#include "ardour/amplitude_stats.h"
+#include "ardour/debug.h"
+#include "ardour/runtime_functions.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char stats_magic[4] = { 'A', 'A', 'M', 'S' };
+
+AmplitudeStats::AmplitudeStats ()
+	: _fd (-1)
+	, _stale (false)
+	, _modified (false)
+{
+	reset ();
+}
+
+AmplitudeStats::~AmplitudeStats ()
+{
+	close ();
+}
+
+void
+AmplitudeStats::set_path (std::string const& path)
+{
+	close ();
+	_path = path;
+}
+
+void
+AmplitudeStats::reset ()
+{
+	memset (&_header, 0, sizeof (Header));
+	memcpy (_header.magic, stats_magic, sizeof (stats_magic));
+	_header.version    = version;
+	_header.block_size = block_size;
+
+	_acc.peak           = 0;
+	_acc.reserved       = 0;
+	_acc.sum_of_squares = 0;
+	_acc_cnt            = 0;
+	_n_complete         = 0;
+	_next_sample        = 0;
+	_stale              = false;
+	_pending.clear ();
+}
+
+bool
+AmplitudeStats::header_ok (Header const& h) const
+{
+	return 0 == memcmp (h.magic, stats_magic, sizeof (stats_magic))
+		&& h.version == version
+		&& h.block_size == (uint32_t) block_size
+		&& h.n_samples >= 0;
+}
+
+int
+AmplitudeStats::read_header (int fd, Header& h) const
+{
+	if (lseek (fd, 0, SEEK_SET) != 0) {
+		return -1;
+	}
+	if (::read (fd, &h, sizeof (Header)) != sizeof (Header)) {
+		return -1;
+	}
+	return header_ok (h) ? 0 : -1;
+}
+
+int
+AmplitudeStats::write_header ()
+{
+	if (lseek (_fd, 0, SEEK_SET) != 0) {
+		return -1;
+	}
+	if (::write (_fd, &_header, sizeof (Header)) != sizeof (Header)) {
+		error << string_compose (_("%1: could not write amplitude statistics header (%2)"), _path, strerror (errno)) << endmsg;
+		return -1;
+	}
+	return 0;
+}
+
+int
+AmplitudeStats::write_blocks (Block const* blocks, samplecnt_t first_block, samplecnt_t n_blocks)
+{
+	off_t byte = sizeof (Header) + first_block * sizeof (Block);
+
+	if (lseek (_fd, byte, SEEK_SET) != byte) {
+		return -1;
+	}
+
+	ssize_t bytes_to_write = n_blocks * sizeof (Block);
+
+	if (::write (_fd, blocks, bytes_to_write) != bytes_to_write) {
+		error << string_compose (_("%1: could not write amplitude statistics (%2)"), _path, strerror (errno)) << endmsg;
+		return -1;
+	}
+	return 0;
+}
+
+int
+AmplitudeStats::open_for_write ()
+{
+	if (_fd >= 0) {
+		return 0;
+	}
+
+	if (_path.empty ()) {
+		return -1;
+	}
+
+	if ((_fd = g_open (_path.c_str (), O_CREAT | O_RDWR, 0664)) == -1) {
+		error << string_compose (_("AmplitudeStats: cannot open \"%1\" (%2)"), _path, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	/* the file is invalid (covers no samples) until the first flush */
+	reset ();
+
+	if (ftruncate (_fd, 0) || write_header ()) {
+		::close (_fd);
+		_fd = -1;
+		return -1;
+	}
+
+	_modified = false;
+	return 0;
+}
+
+void
+AmplitudeStats::close ()
+{
+	if (_fd < 0) {
+		return;
+	}
+	flush ();
+	::close (_fd);
+	_fd = -1;
+}
+
+int
+AmplitudeStats::add (Sample const* buf, samplecnt_t cnt, samplepos_t first_sample)
+{
+	if (_fd < 0) {
+		return -1;
+	}
+
+	if (first_sample == 0) {
+		reset ();
+	} else if (first_sample != _next_sample) {
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Amplitude statistics %1 are stale (%2 vs %3)\n", _path, first_sample, _next_sample));
+		_stale = true;
+	}
+
+	_modified    = true;
+	_next_sample = first_sample + cnt;
+
+	if (_stale) {
+		return 0;
+	}
+
+	while (cnt > 0) {
+		samplecnt_t const n = min (cnt, block_size - _acc_cnt);
+
+		_acc.peak = compute_peak (buf, n, _acc.peak);
+
+		double sum = 0;
+		for (samplecnt_t i = 0; i < n; ++i) {
+			sum += buf[i] * buf[i];
+		}
+		_acc.sum_of_squares += sum;
+
+		_acc_cnt += n;
+		buf      += n;
+		cnt      -= n;
+
+		if (_acc_cnt == block_size) {
+			_pending.push_back (_acc);
+			_acc.peak           = 0;
+			_acc.sum_of_squares = 0;
+			_acc_cnt            = 0;
+		}
+	}
+
+	if (!_pending.empty ()) {
+		if (write_blocks (&_pending[0], _n_complete, _pending.size ())) {
+			_stale = true;
+			return -1;
+		}
+		_n_complete += _pending.size ();
+		_pending.clear ();
+	}
+
+	return 0;
+}
+
+int
+AmplitudeStats::flush ()
+{
+	if (_fd < 0 || !_modified) {
+		return 0;
+	}
+
+	if (_stale) {
+		_header.n_samples = 0;
+	} else {
+		/* the partial last block, overwritten once it is complete */
+		if (_acc_cnt > 0 && write_blocks (&_acc, _n_complete, 1)) {
+			return -1;
+		}
+		_header.n_samples = _next_sample;
+	}
+
+	_modified = false;
+	return write_header ();
+}
+
+bool
+AmplitudeStats::valid (samplecnt_t n_samples) const
+{
+	if (_path.empty () || _fd >= 0) {
+		return false;
+	}
+
+	ScopedFileDescriptor sfd (g_open (_path.c_str (), O_RDONLY, 0444));
+
+	Header h;
+	if (sfd < 0 || read_header (sfd, h)) {
+		return false;
+	}
+
+	return h.n_samples == n_samples && n_samples > 0;
+}
+
+int
+AmplitudeStats::read (samplecnt_t first_block, samplecnt_t n_blocks, Sample& peak, double& sum_of_squares) const
+{
+	ScopedFileDescriptor sfd (g_open (_path.c_str (), O_RDONLY, 0444));
+
+	Header h;
+	if (sfd < 0 || read_header (sfd, h)) {
+		return -1;
+	}
+
+	if (first_block < 0 || (first_block + n_blocks - 1) * block_size >= h.n_samples) {
+		return -1;
+	}
+
+	off_t byte = sizeof (Header) + first_block * sizeof (Block);
+
+	if (lseek (sfd, byte, SEEK_SET) != byte) {
+		return -1;
+	}
+
+	const samplecnt_t  bufsize = 4096;
+	std::vector<Block> buf (min (bufsize, n_blocks));
+
+	while (n_blocks > 0) {
+		samplecnt_t const n             = min (bufsize, n_blocks);
+		ssize_t const     bytes_to_read = n * sizeof (Block);
+
+		if (::read (sfd, &buf[0], bytes_to_read) != bytes_to_read) {
+			return -1;
+		}
+
+		for (samplecnt_t i = 0; i < n; ++i) {
+			peak            = max (peak, buf[i].peak);
+			sum_of_squares += buf[i].sum_of_squares;
+		}
+
+		n_blocks -= n;
+	}
+
+	return 0;
+}
@@ -0,0 +1,111 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_amplitude_stats_h_
+#define _ardour_amplitude_stats_h_
+
+#include <stdint.h>
+#include <string>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR
+{
+
+/** Block-level amplitude statistics of an AudioSource.
+ *
+ * For every `block_size` samples, the file holds the absolute peak and the
+ * sum of squares of the samples. The peak and RMS of any range can then be
+ * computed from the blocks it covers, plus the samples at either end that
+ * are not part of a whole block (see AudioSource::amplitude_stats()).
+ *
+ * The file starts with a versioned Header, which records the number of
+ * samples that the blocks cover. The last block may be partial.
+ *
+ * Blocks are written as samples are added, which must happen in order and
+ * starting at the first sample of the source. Otherwise the statistics are
+ * marked as stale, and are not written. Stale or missing statistics have
+ * to be built from the audio data.
+ *
+ * There is no internal locking, AudioSource uses its own lock.
+ */
+class LIBARDOUR_API AmplitudeStats
+{
+public:
+	static const uint32_t    version    = 1;
+	static const samplecnt_t block_size = 4096;
+
+	AmplitudeStats ();
+	~AmplitudeStats ();
+
+	void               set_path (std::string const&);
+	std::string const& path () const { return _path; }
+
+	/* writing */
+	int  open_for_write ();
+	int  add (Sample const* buf, samplecnt_t cnt, samplepos_t first_sample);
+	int  flush ();
+	void close ();
+	bool writing () const { return _fd >= 0; }
+	bool stale () const { return _stale; }
+
+	/* reading */
+
+	/** @return true if the file is usable and covers exactly \p n_samples */
+	bool valid (samplecnt_t n_samples) const;
+
+	/** Combine \p n_blocks blocks, starting at \p first_block */
+	int read (samplecnt_t first_block, samplecnt_t n_blocks, Sample& peak, double& sum_of_squares) const;
+
+private:
+	struct Header {
+		char     magic[4];
+		uint32_t version;
+		uint32_t block_size;
+		uint32_t reserved;
+		int64_t  n_samples;
+	};
+
+	struct Block {
+		float  peak;
+		float  reserved;
+		double sum_of_squares;
+	};
+
+	int  read_header (int fd, Header&) const;
+	int  write_header ();
+	bool header_ok (Header const&) const;
+	void reset ();
+	int  write_blocks (Block const*, samplecnt_t first_block, samplecnt_t n_blocks);
+
+	std::string _path;
+	int         _fd;
+	bool        _stale;
+	bool        _modified;
+	Header      _header;
+
+	samplepos_t        _next_sample;
+	Block              _acc;
+	samplecnt_t        _acc_cnt;
+	samplecnt_t        _n_complete;
+	std::vector<Block> _pending;
+};
+
+} // namespace ARDOUR
+
+#endif /* _ardour_amplitude_stats_h_ */
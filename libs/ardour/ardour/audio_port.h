@@ -52,6 +52,11 @@ public:
 	AudioBuffer& get_audio_buffer (pframes_t nframes);
 	void set_buffer_size (pframes_t nframes);
 
+	/* true if ::cycle_start (input) or ::cycle_end (output) run the resampler */
+	bool resampling () const {
+		return externally_connected () && !_shared_input && 0 == (flags () & TransportSyncPort);
+	}
+
 protected:
 	friend class PortManager;
 	AudioPort (std::string const &, PortFlags);
@@ -65,6 +70,12 @@ private:
 	ArdourZita::VMResampler _src;
 	Sample*                 _data;
 	bool                    _buf_valid;
+
+	/* Set by PortManager for the duration of a cycle, when this input has
+	 * the same connections as another input port. The input is then
+	 * resampled only once, and read from that port's buffer.
+	 */
+	AudioPort const*        _shared_input;
 };
 
 } // namespace ARDOUR
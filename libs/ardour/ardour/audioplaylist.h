@@ -25,6 +25,10 @@
 #include <vector>
 #include <list>
 
+#include <glibmm/threads.h>
+
+#include "temporal/tempo.h"
+
 #include "ardour/ardour.h"
 #include "ardour/playlist.h"
 
@@ -34,6 +38,7 @@ class Session;
 class AudioRegion;
 class Source;
 class AudioPlaylist;
+class FileReadAhead;
 
 class LIBARDOUR_API AudioPlaylist : public ARDOUR::Playlist
 {
@@ -45,6 +50,9 @@ public:
 
 	timecnt_t read (Sample *dst, Sample *mixdown, float *gain_buffer, timepos_t const & start, timecnt_t const & cnt, uint32_t chan_n=0);
 
+	/** Queue prefetching the source data that read() will use for the given range */
+	void prefetch (FileReadAhead&, timepos_t const & start, timecnt_t const & cnt);
+
 	bool destroy_region (boost::shared_ptr<Region>);
 
 protected:
@@ -53,12 +61,48 @@ protected:
 	void post_combine (std::vector<boost::shared_ptr<Region> >&, boost::shared_ptr<Region>);
 	void pre_uncombine (std::vector<boost::shared_ptr<Region> >&, boost::shared_ptr<Region>);
 
+	void region_layout_invalidated ();
+
 private:
 	int set_state (const XMLNode&, int version);
 	void dump () const;
 	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 	void source_offset_changed (boost::shared_ptr<AudioRegion>);
         void load_legacy_crossfades (const XMLNode&, int version);
+
+	/** A part of the playlist, [start, end) in session samples, in which
+	 * the same regions have to be read. There are no boundaries of any
+	 * region (or of the body of an opaque region) within a segment.
+	 */
+	struct PlanSegment {
+		PlanSegment (samplepos_t s, samplepos_t e) : start (s), end (e) {}
+
+		samplepos_t start;
+		samplepos_t end;
+		/** the regions to read, in the order that the reads have to be
+		 * done: lower layers first, and only up to the first opaque region
+		 * whose body covers the segment.
+		 */
+		std::vector<boost::shared_ptr<AudioRegion> > regions;
+	};
+
+	/** The segments of the whole playlist that contain audible regions,
+	 * sorted by time and not overlapping, so that a read can look up its
+	 * start and stop at its end.
+	 *
+	 * The plan does not depend on the editor selection. While
+	 * solo-selection is active, read() does not use it (see read_unplanned()).
+	 */
+	typedef std::vector<PlanSegment> RenderPlan;
+
+	boost::shared_ptr<RenderPlan const> render_plan ();
+	void invalidate_render_plan ();
+
+	timecnt_t read_unplanned (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, timepos_t const & start, timecnt_t const & cnt, uint32_t chan_n);
+
+	Glib::Threads::Mutex                _render_plan_lock;
+	boost::shared_ptr<RenderPlan const> _render_plan;
+	Temporal::TempoMap::SharedPtr       _render_plan_tempo_map;
 };
 
 } /* namespace ARDOUR */
@@ -131,6 +131,21 @@ class LIBARDOUR_API AudioRegion : public Region, public AudioReadable
 	XMLNode& get_basic_state () const;
 	int set_state (const XMLNode&, int version);
 
+	class LIBARDOUR_API StateCopy : public Region::StateCopy {
+	public:
+		/** @param basic true to copy only what get_basic_state() saves */
+		StateCopy (AudioRegion const&, bool basic);
+		~StateCopy ();
+
+		XMLNode& get_state () const;
+
+	private:
+		uint32_t              _channels;
+		std::vector<XMLNode*> _curves; ///< envelope and fades
+	};
+
+	boost::shared_ptr<Region::StateCopy const> state_copy () const;
+
 	void fade_range (samplepos_t, samplepos_t);
 
 	bool fade_in_is_default () const;
@@ -23,6 +23,8 @@
 #ifndef __ardour_audio_source_h__
 #define __ardour_audio_source_h__
 
+#include <atomic>
+
 #include <boost/shared_ptr.hpp>
 #include <boost/shared_array.hpp>
 #include <boost/enable_shared_from_this.hpp>
@@ -35,12 +37,16 @@
 
 #include "ardour/source.h"
 #include "ardour/ardour.h"
+#include "ardour/amplitude_stats.h"
+#include "ardour/peak_pyramid.h"
 #include "ardour/readable.h"
 #include "pbd/stateful.h"
 #include "pbd/xml++.h"
 
 namespace ARDOUR {
 
+class FileReadAhead;
+
 class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioReadable
 {
   public:
@@ -58,6 +64,13 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 	virtual samplecnt_t read (Sample *dst, samplepos_t start, samplecnt_t cnt, int channel=0) const;
 	virtual samplecnt_t write (Sample *src, samplecnt_t cnt);
 
+	/** Queue a read-ahead hint for the file-data of the given range, so
+	 * that a following read() of that range is less likely to block on
+	 * disk I/O.
+	 * @return false if the source does not support this
+	 */
+	virtual bool queue_prefetch (FileReadAhead&, samplepos_t /*start*/, samplecnt_t /*cnt*/) const { return false; }
+
 	virtual float sample_rate () const = 0;
 
 	virtual void mark_streaming_write_completed (const WriterLock& lock);
@@ -68,6 +81,20 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 			samplepos_t start, samplecnt_t cnt, double samples_per_visual_peak) const;
 
 	int  build_peaks ();
+
+	/** Get the absolute peak and the sum of squares of the samples in
+	 * [start, start + cnt), using the amplitude statistics file that is
+	 * written along with the peakfile, and reading only the samples that
+	 * are not part of a whole block of the statistics.
+	 *
+	 * Statistics that are missing (e.g. from older sessions) are built
+	 * from the audio data by the peak-building threads, this call does
+	 * not wait for that.
+	 *
+	 * @return 0 on success, -1 if the statistics are not available, in
+	 * which case the caller has to read the data.
+	 */
+	int amplitude_stats (samplepos_t start, samplecnt_t cnt, Sample& peak, double& sum_of_squares) const;
 	bool peaks_ready (boost::function<void()> callWhenReady, PBD::ScopedConnection** connection_created_if_not_ready, PBD::EventLoop* event_loop) const;
 
 	mutable PBD::Signal0<void>  PeaksReady;
@@ -91,9 +118,25 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 		return _build_peakfiles;
 	}
 
+	struct PeakReadStats {
+		uint64_t mapped_reads;     ///< peak reads served from a peakfile or pyramid mapping
+		uint64_t maps;             ///< peakfiles and pyramids (re)mapped
+		uint64_t pyramid_reads;    ///< of mapped_reads, served from a peak pyramid
+		uint64_t syscalls_avoided; ///< compared to stat/open/mmap/munmap/close per read
+	};
+
+	static PeakReadStats peak_read_stats ();
+	static void reset_peak_read_stats ();
+
 	virtual int setup_peakfile () { return 0; }
 	int close_peakfile ();
 
+	/** Build data derived from the peakfile that was scheduled by
+	 * initialize_peakfile() or done_with_peakfile_writes().
+	 * Called by the peak-building threads.
+	 */
+	void build_peak_data ();
+
 	int prepare_for_peakfile_writes ();
 	void done_with_peakfile_writes (bool done = true);
 
@@ -124,6 +167,13 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
 
 	mutable off_t _peak_byte_max; // modified in compute_and_write_peak()
 
+	std::string peak_pyramid_path () const;
+	std::string amplitude_stats_path () const;
+	int         build_amplitude_stats ();
+	int         read_amplitude (samplepos_t start, samplecnt_t cnt, Sample& peak, double& sum_of_squares) const;
+
+	void unmap_peakfile () const;
+
 	virtual samplecnt_t read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const = 0;
 	virtual samplecnt_t write_unlocked (Sample *dst, samplecnt_t cnt) = 0;
 	virtual std::string construct_peak_filepath (const std::string& audio_path, const bool in_session = false, const bool old_peak_name = false) const = 0;
@@ -148,16 +198,31 @@ class LIBARDOUR_API AudioSource : virtual public Source, public ARDOUR::AudioRea
         Glib::Threads::Mutex _initialize_peaks_lock;
 
 	int        _peakfile_fd;
+	PeakPyramid _peak_pyramid;
+	std::atomic<bool> _pyramid_pending; ///< readers must not use the pyramid
+	mutable AmplitudeStats _amplitude_stats;
+	mutable Glib::Threads::Mutex _amplitude_stats_lock;
+	mutable std::atomic<bool> _amplitude_stats_pending; ///< build queued
+	mutable std::atomic<bool> _amplitude_stats_tried;   ///< do not queue again
 	samplecnt_t peak_leftover_cnt;
 	samplecnt_t peak_leftover_size;
 	Sample*    peak_leftovers;
 	samplepos_t peak_leftover_sample;
 
-	mutable bool _first_run;
-	mutable double _last_scale;
-	mutable off_t _last_map_off;
-	mutable size_t  _last_raw_map_length;
-	mutable boost::scoped_array<PeakData> peak_cache;
+	/* read-only mapping of the peakfile, shared by all readers. It is
+	 * created on demand and replaced when reading beyond its end.
+	 */
+	mutable Glib::Threads::RWLock _peak_map_lock;
+	mutable char*                 _peak_map_addr;
+	mutable size_t                _peak_map_length;
+
+	void queue_peak_data ();
+
+	int map_peakfile () const;
+	int read_peakfile (PeakData* dst, off_t offset, size_t n_bytes) const;
+
+	static std::atomic<uint64_t> _peak_mapped_reads;
+	static std::atomic<uint64_t> _peak_maps;
 };
 
 }
@@ -24,6 +24,7 @@
 #define __ardour_butler_h__
 
 #include <pthread.h>
+#include <vector>
 
 #include <glibmm/threads.h>
 
@@ -32,6 +33,7 @@
 #include "pbd/pool.h"
 #include "pbd/ringbuffer.h"
 #include "pbd/mpmc_queue.h"
+#include "pbd/semutils.h"
 
 #include "ardour/libardour_visibility.h"
 #include "ardour/session_handle.h"
@@ -39,6 +41,9 @@
 
 namespace ARDOUR
 {
+class FileReadAhead;
+class Track;
+
 /**
  *  One of the Butler's functions is to clean up (ie delete) unused CrossThreadPools.
  *  When a thread with a CrossThreadPool terminates, its CTP is added to pool_trash.
@@ -93,14 +98,27 @@ private:
 	};
 
 
+	enum IOTask {
+		Refill,
+		Flush
+	};
+
 	static void* _thread_work (void* arg);
+	static void* _io_thread_work (void* arg);
 
 	void* thread_work ();
+	void* io_thread_work ();
 
 	void empty_pool_trash ();
 	void process_delegated_work ();
 	void config_changed (std::string);
+	bool refill_tracks (RouteList const&);
+	void prefetch_tracks (RouteList const&);
 	bool flush_tracks_to_disk_normal (boost::shared_ptr<RouteList>, uint32_t& errors);
+	bool run_io_tasks (IOTask, RouteList const&);
+	void io_work ();
+	void start_io_threads ();
+	void terminate_io_threads ();
 	void queue_request (Request::Type r);
 
 	pthread_t thread;
@@ -117,6 +135,21 @@ private:
 	PBD::RingBuffer<PBD::CrossThreadPool*> pool_trash;
 	CrossThreadChannel                    _xthread;
 	PBD::MPMCQueue<sigc::slot<void> >     _delegated_work;
+
+	/* Disk I/O worker threads, used in addition to the butler thread */
+	std::vector<pthread_t> _io_threads;
+	PBD::Semaphore         _io_work_sem;
+	PBD::Semaphore         _io_done_sem;
+	GATOMIC_QUAL gint      _io_quit;
+
+	/* Current I/O task, shared by the butler and I/O threads */
+	IOTask                                 _io_task;
+	std::vector<boost::shared_ptr<Track> > _io_tracks;
+	std::vector<int>                       _io_results;
+	GATOMIC_QUAL gint                      _io_next;
+
+	/* Batched read-ahead of source data for all tracks */
+	FileReadAhead* _prefetch;
 };
 
 } // namespace ARDOUR
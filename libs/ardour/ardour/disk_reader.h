@@ -22,6 +22,8 @@
 
 #include <boost/optional.hpp>
 
+#include <glibmm/threads.h>
+
 #include "pbd/g_atomic_compat.h"
 
 #include "evoral/Curve.h"
@@ -32,6 +34,7 @@
 
 namespace ARDOUR
 {
+class FileReadAhead;
 class Playlist;
 class AudioPlaylist;
 class MidiPlaylist;
@@ -84,12 +87,22 @@ public:
 	/** For contexts outside the normal butler refill loop (allocates temporary working buffers) */
 	int do_refill_with_alloc (bool partial_fill, bool reverse);
 
+	/** Queue read-ahead hints for the data that the next do_refill() will need,
+	 * called by the butler before refilling all tracks.
+	 */
+	void queue_prefetch (FileReadAhead&);
+
 	bool pending_overwrite () const;
 
 	/* Working buffers for do_refill (butler thread) */
 	static void allocate_working_buffers ();
 	static void free_working_buffers ();
 
+	/* Working buffers for do_refill in additional butler I/O threads,
+	 * released when the calling thread terminates.
+	 */
+	static void allocate_thread_working_buffers ();
+
 	void adjust_buffering ();
 
 	bool can_internal_playback_seek (sampleoffset_t distance);
@@ -231,6 +244,17 @@ private:
 	static Sample* _mixdown_buffer;
 	static gain_t* _gain_buffer;
 
+	struct WorkingBuffers {
+		WorkingBuffers ();
+		~WorkingBuffers ();
+
+		Sample* sum_buffer;
+		Sample* mixdown_buffer;
+		gain_t* gain_buffer;
+	};
+
+	static Glib::Threads::Private<WorkingBuffers> _thread_working_buffers;
+
 	int refill (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level, bool reversed);
 	int refill_audio (Sample* sum_buffer, Sample* mixdown_buffer, float* gain_buffer, samplecnt_t fill_level, bool reversed);
 
@@ -0,0 +1,119 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_dsp_profiler_h_
+#define _ardour_dsp_profiler_h_
+
+#include <pthread.h>
+
+#include <string>
+#include <vector>
+
+#include "pbd/g_atomic_compat.h"
+#include "pbd/microseconds.h"
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR
+{
+class Session;
+
+/** Instrumentation of the process graph.
+ *
+ * Every GraphNode (Route, IOPlug) keeps a histogram of its run-time.
+ * While the profiler is enabled, the processors of each route are
+ * timed as well. Histograms are updated in place without locks, and
+ * can be read at any time, see Route::process_histogram() and
+ * Processor::process_histogram().
+ *
+ * In addition the profiler can record every node and processor run of
+ * a given number of process cycles, to be written as Chrome trace-event
+ * JSON for offline analysis (chrome://tracing, ui.perfetto.dev).
+ */
+class LIBARDOUR_API DSPProfiler
+{
+public:
+	DSPProfiler (Session&);
+
+	bool enabled () const { return g_atomic_int_get (&_enabled); }
+	void set_enabled (bool yn);
+
+	/** clear the histograms of all routes, I/O plugins and processors */
+	void reset_stats ();
+
+	/** Record a trace of the next \p n_cycles process cycles.
+	 * @param max_events trace size, further events are dropped
+	 * @return 0 on success, -1 if a trace is already in progress
+	 */
+	int  start_trace (uint32_t n_cycles, uint32_t max_events = 262144);
+	bool trace_complete () const { return g_atomic_int_get (&_trace_state) == TraceComplete; }
+	/** Write the completed trace, may be called more than once */
+	int  write_trace (std::string const& path) const;
+
+	/* realtime API, called by Session::process () */
+	void cycle_start ();
+	void cycle_end ();
+
+	/* realtime API, called from process threads */
+	bool tracing () const { return g_atomic_int_get (&_trace_state) == TraceRecording; }
+
+	void record_node (void const* node, PBD::microseconds_t start, PBD::microseconds_t end) {
+		record (node, Node, start, end);
+	}
+
+	void record_processor (void const* proc, PBD::microseconds_t start, PBD::microseconds_t end) {
+		record (proc, Proc, start, end);
+	}
+
+private:
+	enum TraceState {
+		TraceIdle,
+		TraceArmed,
+		TraceRecording,
+		TraceComplete
+	};
+
+	enum Category {
+		Cycle,
+		Node,
+		Proc
+	};
+
+	struct Event {
+		void const*         obj;
+		Category            cat;
+		pthread_t           thread;
+		PBD::microseconds_t start;
+		PBD::microseconds_t end;
+	};
+
+	void record (void const*, Category, PBD::microseconds_t, PBD::microseconds_t);
+
+	Session& _session;
+
+	GATOMIC_QUAL gint _enabled;
+	GATOMIC_QUAL gint _trace_state;
+	GATOMIC_QUAL gint _n_events;
+
+	std::vector<Event>  _events;
+	uint32_t            _trace_cycles;
+	uint32_t            _cycles_left;
+	PBD::microseconds_t _cycle_start;
+};
+
+} // namespace ARDOUR
+
+#endif
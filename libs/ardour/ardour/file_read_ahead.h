@@ -0,0 +1,102 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_file_read_ahead_h_
+#define _ardour_file_read_ahead_h_
+
+#include <map>
+#include <stdint.h>
+#include <sys/types.h>
+#include <vector>
+
+#include "ardour/libardour_visibility.h"
+
+namespace ARDOUR
+{
+
+/** Batched read-ahead hints for file data.
+ *
+ * Ranges are collected with queue() and then passed to the kernel together
+ * by run(), as POSIX_FADV_WILLNEED hints (F_RDADVISE on macOS). The kernel
+ * starts reading them into the page cache in the background, so that a
+ * following read of the same range (e.g. AudioSource::read) is less likely
+ * to block on I/O. Nothing is read or copied here, and nothing waits for
+ * the data: the kernel may also ignore the hints.
+ *
+ * Large ranges are split into blocks. When built with liburing, the hints
+ * are submitted via io_uring, with up to queue_depth of them in flight.
+ * Otherwise they are issued one after the other. There is no hint on
+ * Windows, where queue() does nothing.
+ */
+class LIBARDOUR_API FileReadAhead
+{
+public:
+	FileReadAhead (uint32_t queue_depth, size_t block_size = 256 * 1024);
+	~FileReadAhead ();
+
+	/** Add read-ahead of \p length bytes at \p offset of \p fd to the current batch.
+	 *
+	 * Hints are not issued for \p fd itself, but for a duplicate of it that
+	 * is owned by the batch and closed once run() completes. The caller may
+	 * therefore close \p fd as soon as this call returns. It must however
+	 * serialize this call against closing \p fd.
+	 *
+	 * All ranges that are queued with the same \p owner during a batch share
+	 * a single duplicate descriptor.
+	 */
+	void queue (void const* owner, int fd, int64_t offset, size_t length);
+
+	/** Issue hints for all queued ranges.
+	 * @return the number of bytes for which the kernel accepted a hint
+	 */
+	uint64_t run ();
+
+	size_t n_queued () const { return _requests.size (); }
+	bool   uses_io_uring () const;
+
+private:
+	struct Request {
+		Request (int f, int64_t o, size_t l)
+			: fd (f)
+			, offset (o)
+			, length (l)
+		{}
+
+		int     fd;
+		int64_t offset;
+		size_t  length;
+	};
+
+	void close_fds ();
+
+	uint64_t run_sequential ();
+	uint64_t run_io_uring ();
+
+	uint32_t _queue_depth;
+	size_t   _block_size;
+
+	std::vector<Request> _requests;
+
+	/* owner -> duplicate descriptor used by the current batch */
+	std::map<void const*, int> _fds;
+
+	struct URing;
+	URing* _uring;
+};
+
+} // namespace ARDOUR
+
+#endif /* _ardour_file_read_ahead_h_ */
@@ -30,7 +30,10 @@
 
 #include <boost/shared_ptr.hpp>
 
+#include <glibmm/threads.h>
+
 #include "pbd/g_atomic_compat.h"
+#include "pbd/microseconds.h"
 #include "pbd/mpmc_queue.h"
 #include "pbd/semutils.h"
 
@@ -45,6 +48,7 @@ class ProcessNode;
 class GraphNode;
 class Graph;
 
+class DSPProfiler;
 class IOPlug;
 class Route;
 class RTTaskList;
@@ -62,11 +66,32 @@ struct GraphChain {
 	void dump () const;
 	bool plot (std::string const&) const;
 
+	/** Update each node's longest remaining path from measured
+	 * process times, and re-order _init_trigger_rt accordingly.
+	 * Nodes that become ready later in the cycle are queued in the
+	 * same order by GraphNode::finish.
+	 * Called by Graph::prep, does not allocate memory.
+	 */
+	void update_critical_path ();
+
+	/** @return the longest path through the graph [usec] */
+	float critical_path_us () const;
+
 	node_list_t _nodes_rt;
 	/** Nodes that are not fed by any other nodes */
 	node_list_t _init_trigger_list;
+	/** Same as _init_trigger_list, longest remaining path first */
+	std::vector<GraphNode*> _init_trigger_rt;
 	/** The number of nodes that do not feed any other node */
 	int _n_terminal_nodes;
+
+private:
+	void critical_path (std::set<GraphNode const*>&) const;
+
+	/** Nodes in topological order */
+	std::vector<GraphNode*> _topo_order;
+	/** Indices into _topo_order of the nodes directly fed by each node */
+	std::vector<std::vector<size_t> > _topo_feeds;
 };
 
 class LIBARDOUR_API Graph : public SessionHandleRef
@@ -83,6 +108,11 @@ public:
 	bool     in_process_thread () const;
 	uint32_t n_threads () const;
 
+	/** nominal duration of the current cycle */
+	int64_t period_us () const { return _period_us; }
+
+	DSPProfiler& dsp_profiler () const;
+
 	/* called by GraphNode */
 	void trigger (ProcessNode* n);
 	void reached_terminal_node ();
@@ -98,9 +128,26 @@ protected:
 	virtual void session_going_away ();
 
 private:
+	/** Per thread state of the work-stealing scheduler */
+	struct Worker {
+		Worker (uint32_t i)
+			: id (i)
+			, next (0)
+		{}
+
+		uint32_t                     id;
+		PBD::MPMCQueue<ProcessNode*> queue; ///< nodes triggered by this thread, others may steal them
+		ProcessNode*                 next;  ///< continuation, run directly by this thread without queueing
+	};
+
 	void reset_thread_list ();
+	void reset_workers (uint32_t);
 	void drop_threads ();
+	void select_scheduler ();
 	void run_one ();
+	void run_one_shared ();
+	void run_one_stealing ();
+	bool steal (Worker const&, ProcessNode*&);
 	void main_thread ();
 	void prep ();
 
@@ -109,6 +156,17 @@ private:
 	PBD::MPMCQueue<ProcessNode*> _trigger_queue;      ///< nodes that can be processed
 	GATOMIC_QUAL guint           _trigger_queue_size; ///< number of entries in trigger-queue
 
+	/** work-stealing scheduler, one entry per process thread (0: main thread) */
+	std::vector<Worker*>                  _workers;
+	static Glib::Threads::Private<Worker> _thread_worker;
+
+	/** true if the current cycle uses the work-stealing scheduler */
+	bool _work_stealing;
+
+	/** idle work-stealing threads spin until this time, then park on _execution_sem */
+	PBD::microseconds_t _cycle_deadline;
+	PBD::microseconds_t _period_us;
+
 	/** Start worker threads */
 	PBD::Semaphore _execution_sem;
 
@@ -131,7 +189,7 @@ private:
 	GATOMIC_QUAL gint _terminate;
 
 	/* graph chain */
-	GraphChain const* _graph_chain;
+	GraphChain* _graph_chain;
 
 	/* parameter caches */
 	pframes_t   _process_nframes;
@@ -29,7 +29,9 @@
 
 #include "pbd/g_atomic_compat.h"
 #include "pbd/rcu.h"
+#include "pbd/timing.h"
 
+#include "ardour/dsp_load_calculator.h"
 #include "ardour/libardour_visibility.h"
 
 namespace ARDOUR
@@ -48,6 +50,9 @@ public:
 	virtual ~ProcessNode() {}
 	virtual void prep (GraphChain const*) = 0;
 	virtual void run (GraphChain const*) = 0;
+
+	/** Estimated time [usec] from starting this node until all nodes that depend on it completed */
+	virtual float critical_path_us () const { return 0; }
 };
 
 class LIBARDOUR_API GraphActivision
@@ -81,6 +86,17 @@ public:
 	void prep (GraphChain const*);
 	void run (GraphChain const*);
 
+	/** Time spent in process() [usec], peak-hold with slow decay */
+	float process_time_us () const {
+		return _dsp_load.get_dsp_load_unbound () * _dsp_load.get_max_time_us ();
+	}
+
+	float critical_path_us () const { return _critical_path_us; }
+
+	/** Histogram of the time spent in process() */
+	PBD::TimingHistogram process_histogram () const { return _process_histogram; }
+	void reset_process_histogram () { _process_histogram.queue_reset (); }
+
 	/* API used to sort Nodes and create GraphChain */
 	virtual std::string graph_node_name () const = 0;
 
@@ -93,9 +109,19 @@ protected:
 	boost::shared_ptr<Graph> _graph;
 
 private:
+	friend struct GraphChain;
+
 	void finish (GraphChain const*);
+	bool release ();
 
 	GATOMIC_QUAL gint _refcount;
+
+	DSPLoadCalculator _dsp_load;
+
+	PBD::TimingHistogram _process_histogram;
+
+	/** set by GraphChain::update_critical_path of the most recently processed chain */
+	float _critical_path_us;
 };
 
 } // namespace ARDOUR
@@ -357,6 +357,8 @@ private:
 
 	PBD::ScopedConnectionList _midi_source_connections;
 
+	void extend_to_whole_notes (TimeType& start, TimeType& end) const;
+
 	MidiSource& _midi_source;
 	InsertMergePolicy _insert_merge_policy;
 };
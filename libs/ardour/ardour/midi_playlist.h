@@ -25,11 +25,16 @@
 
 #include <vector>
 #include <list>
+#include <map>
+#include <set>
 
 #include <boost/utility.hpp>
 
+#include "evoral/EventSink.h"
 #include "evoral/Parameter.h"
 
+#include "temporal/tempo.h"
+
 #include "ardour/ardour.h"
 #include "ardour/midi_cursor.h"
 #include "ardour/midi_model.h"
@@ -90,6 +95,7 @@ public:
   protected:
 	void remove_dependents (boost::shared_ptr<Region> region);
 	void region_going_away (boost::weak_ptr<Region> region);
+	bool region_changed (const PBD::PropertyChange&, boost::shared_ptr<Region>);
 
   private:
 	void dump () const;
@@ -97,6 +103,58 @@ public:
 	NoteMode     _note_mode;
 
 	RTMidiBuffer _rendered;
+
+	/** The events of a single region, as written by MidiRegion::render(),
+	 * sorted in playlist order. render() keeps one for each region and only
+	 * renders regions again that changed since.
+	 */
+	class RenderedRegion : public Evoral::EventSink<samplepos_t> {
+	public:
+		RenderedRegion (boost::shared_ptr<MidiRegion> const&);
+
+		struct Item {
+			samplepos_t       time;
+			Evoral::EventType type;
+			uint32_t          size;
+			size_t            offset; /* into _data */
+		};
+
+		uint32_t write (samplepos_t time, Evoral::EventType type, uint32_t size, const uint8_t* buf);
+		void     sort ();
+		void     copy_to (Evoral::EventSink<samplepos_t>&) const;
+
+		/** @return true if the region has moved or was trimmed since it was rendered */
+		bool stale (boost::shared_ptr<MidiRegion> const&) const;
+
+		std::vector<Item> const& items () const { return _items; }
+		uint8_t const* buffer (Item const& i) const { return &_data[i.offset]; }
+		bool before (Item const& a, Item const& b) const;
+
+	private:
+		std::vector<Item>    _items;
+		std::vector<uint8_t> _data;
+		timepos_t            _position;
+		timepos_t            _start;
+		timecnt_t            _length;
+	};
+
+	typedef std::map<PBD::ID, boost::shared_ptr<RenderedRegion> > RenderCache;
+
+	boost::shared_ptr<RenderedRegion> rendered_region (boost::shared_ptr<MidiRegion> const&, MidiChannelFilter*, RenderCache&);
+	void merge_rendered (std::vector<boost::shared_ptr<RenderedRegion> > const&);
+
+	/* only used by render() */
+	Glib::Threads::Mutex          _render_lock;
+	RenderCache                   _render_cache;
+	Temporal::TempoMap::SharedPtr _render_tempo_map;
+	MidiChannelFilter*            _render_filter;
+	ChannelMode                   _render_filter_mode;
+	uint16_t                      _render_filter_mask;
+	NoteMode                      _render_note_mode;
+
+	/* regions that changed since the last render(), see region_changed() */
+	Glib::Threads::Mutex _render_invalid_lock;
+	std::set<PBD::ID>    _render_invalid;
 };
 
 } /* namespace ARDOUR */
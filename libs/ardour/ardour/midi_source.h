@@ -140,6 +140,17 @@ class LIBARDOUR_API MidiSource : virtual public Source
 	virtual void mark_streaming_write_started (const WriterLock& lock);
 	virtual void mark_streaming_write_completed (const WriterLock& lock);
 
+	/** Begin to rewrite the events in [start, end] only, keeping all other
+	 * events of the source. The new events are written with
+	 * append_event_beats(), followed by mark_range_write_completed().
+	 *
+	 * This is only possible if the source was not changed since the last
+	 * complete write, otherwise (or if the source does not support it)
+	 * false is returned, and the whole source has to be rewritten.
+	 */
+	virtual bool mark_range_write_started (const WriterLock& lock, Temporal::Beats const & start, Temporal::Beats const & end) { return false; }
+	virtual void mark_range_write_completed (const WriterLock& lock) {}
+
 	/** Mark write starting with the given time parameters.
 	 *
 	 * This is called by MidiDiskStream::process before writing to the capture
@@ -35,6 +35,10 @@ extern "C" {
 
 LIBARDOUR_API void x86_sse_find_peaks              (float const* buf, uint32_t nsamples, float* min, float* max);
 
+LIBARDOUR_API void x86_sse_apply_gain_vector            (float* dst, float const* gain, uint32_t nframes);
+LIBARDOUR_API void x86_sse_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+LIBARDOUR_API void x86_sse_crossfade_buffers            (float* dst, float const* src, float const* gain, uint32_t nframes);
+
 extern "C" {
 /* AVX functions */
 	LIBARDOUR_API float x86_sse_avx_compute_peak          (float const* buf, uint32_t nsamples, float current);
@@ -50,9 +54,23 @@ extern "C" {
 LIBARDOUR_API void x86_sse_avx_find_peaks               (float const* buf, uint32_t nsamples, float* min, float* max);
 #endif
 
+LIBARDOUR_API void  x86_sse_avx_apply_gain_vector            (float* dst, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_avx_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_sse_avx_crossfade_buffers            (float* dst, float const* src, float const* gain, uint32_t nframes);
+
 /* FMA functions */
 #ifdef FPU_AVX_FMA_SUPPORT
 LIBARDOUR_API void  x86_fma_mix_buffers_with_gain       (float* dst, float const* src, uint32_t nframes, float gain);
+LIBARDOUR_API void  x86_fma_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+LIBARDOUR_API void  x86_fma_crossfade_buffers           (float* dst, float const* src, float const* gain, uint32_t nframes);
+#endif
+
+/* SSE2 ramp functions */
+#ifdef __SSE2__
+LIBARDOUR_API void  x86_sse_linear_ramp                 (float* dst, uint32_t nframes, float y0, float dy);
+LIBARDOUR_API void  x86_sse_exp2_ramp                   (float* dst, uint32_t nframes, float y0, float de);
+LIBARDOUR_API void  x86_sse_gain_ramp                   (float* dst, uint32_t nframes, float p0, float dp, float scale);
+LIBARDOUR_API void  x86_sse_cubic_ramp                  (float* dst, uint32_t nframes, float a0, float a1, float a2, float a3, float dt);
 #endif
 
 /* debug wrappers for SSE functions */
@@ -84,6 +102,15 @@ extern "C" {
 	LIBARDOUR_API void  arm_neon_find_peaks            (float const* src, uint32_t nframes, float* minf, float* maxf);
 	LIBARDOUR_API void  arm_neon_mix_buffers_no_gain   (float* dst, float const* src, uint32_t nframes);
 	LIBARDOUR_API void  arm_neon_mix_buffers_with_gain (float* dst, float const* src, uint32_t nframes, float gain);
+	LIBARDOUR_API void  arm_neon_linear_ramp           (float* dst, uint32_t nframes, float y0, float dy);
+	LIBARDOUR_API void  arm_neon_exp2_ramp             (float* dst, uint32_t nframes, float y0, float de);
+#ifdef __aarch64__
+	LIBARDOUR_API void  arm_neon_gain_ramp             (float* dst, uint32_t nframes, float p0, float dp, float scale);
+#endif
+	LIBARDOUR_API void  arm_neon_cubic_ramp            (float* dst, uint32_t nframes, float a0, float a1, float a2, float a3, float dt);
+	LIBARDOUR_API void  arm_neon_apply_gain_vector            (float* dst, float const* gain, uint32_t nframes);
+	LIBARDOUR_API void  arm_neon_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes);
+	LIBARDOUR_API void  arm_neon_crossfade_buffers            (float* dst, float const* src, float const* gain, uint32_t nframes);
 }
 #endif
 
@@ -95,5 +122,13 @@ LIBARDOUR_API void  default_apply_gain_to_buffer      (ARDOUR::Sample* buf, ARDO
 LIBARDOUR_API void  default_mix_buffers_with_gain     (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes, float gain);
 LIBARDOUR_API void  default_mix_buffers_no_gain       (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
 LIBARDOUR_API void  default_copy_vector               (ARDOUR::Sample* dst, ARDOUR::Sample const* src, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_linear_ramp               (ARDOUR::Sample* dst, ARDOUR::pframes_t nframes, float y0, float dy);
+LIBARDOUR_API void  default_exp2_ramp                 (ARDOUR::Sample* dst, ARDOUR::pframes_t nframes, float y0, float de);
+LIBARDOUR_API void  default_gain_ramp                 (ARDOUR::Sample* dst, ARDOUR::pframes_t nframes, float p0, float dp, float scale);
+LIBARDOUR_API void  default_cubic_ramp                (ARDOUR::Sample* dst, ARDOUR::pframes_t nframes, float a0, float a1, float a2, float a3, float dt);
+
+LIBARDOUR_API void  default_apply_gain_vector            (ARDOUR::Sample* dst, float const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_mix_buffers_with_gain_vector (ARDOUR::Sample* dst, ARDOUR::Sample const* src, float const* gain, ARDOUR::pframes_t nframes);
+LIBARDOUR_API void  default_crossfade_buffers            (ARDOUR::Sample* dst, ARDOUR::Sample const* src, float const* gain, ARDOUR::pframes_t nframes);
 
 #endif /* __ardour_mix_h__ */
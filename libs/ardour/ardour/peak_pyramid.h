@@ -0,0 +1,158 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef _ardour_peak_pyramid_h_
+#define _ardour_peak_pyramid_h_
+
+#include <atomic>
+#include <stdint.h>
+#include <sys/types.h>
+#include <string>
+#include <vector>
+
+#include <glibmm/threads.h>
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR
+{
+
+/** Reduced resolution levels of an AudioSource's peakfile.
+ *
+ * The peakfile holds one PeakData per `base_fpp` samples (level 0).
+ * The pyramid file stores additional levels, each of which reduces the
+ * previous one by `factor`. When drawing a long source zoomed out, peaks
+ * are read from the level closest to the requested resolution, so only
+ * a few kilobytes need to be read and reduced.
+ *
+ * The file starts with a versioned Header, followed by the levels. Space
+ * for each level is reserved according to Header::capacity (in level 0
+ * peaks), which is doubled (and the data moved) when recording beyond it.
+ *
+ * Levels are written incrementally as level 0 peaks are added. If the
+ * level 0 data is not added contiguously, the pyramid is marked as stale
+ * and has to be rebuilt from the peakfile.
+ *
+ * Readers share a read-only mapping of the file, which is created on
+ * first use and replaced when reading beyond its end. The header is read
+ * from the mapping, so finding a level does not require any I/O. The
+ * writer invalidates the mapping whenever it truncates or replaces the
+ * file. There must only be one writer.
+ */
+class LIBARDOUR_API PeakPyramid
+{
+public:
+	static const uint32_t version    = 1;
+	static const uint32_t factor     = 16;
+	static const uint32_t max_levels = 3;
+
+	PeakPyramid (samplecnt_t base_fpp);
+	~PeakPyramid ();
+
+	void               set_path (std::string const&);
+	std::string const& path () const { return _path; }
+
+	/* writing */
+	int  open_for_write ();
+	int  add (PeakData const* peaks, samplecnt_t n_peaks, samplecnt_t first_peak);
+	int  flush ();
+	void close ();
+	bool stale () const { return _stale; }
+
+	/** (re)create the pyramid from the level 0 peaks in \p peakpath */
+	int build_from (std::string const& peakpath);
+
+	/* reading */
+
+	/** @return true if the file is usable and covers \p n_base_peaks */
+	bool valid (samplecnt_t n_base_peaks) const;
+
+	/** Find the coarsest level with at most \p samples_per_visual_peak
+	 * samples per peak that covers all data up to \p end.
+	 * @return the level, or 0 if the peakfile itself should be used.
+	 */
+	uint32_t level_for (double samples_per_visual_peak, samplepos_t end) const;
+
+	samplecnt_t samples_per_peak (uint32_t level) const;
+
+	/** Read \p n_peaks peaks of the given level, zero-fill beyond the end */
+	int read (uint32_t level, PeakData* dst, samplecnt_t first_peak, samplecnt_t n_peaks) const;
+
+	/** Drop the readers' mapping, e.g. before the file is removed */
+	void unmap () const;
+
+	static uint64_t mapped_reads () { return _mapped_reads; }
+	static uint64_t maps () { return _maps; }
+	static void     reset_stats ();
+
+private:
+	struct Header {
+		char     magic[4];
+		uint32_t version;
+		uint32_t base_fpp;
+		uint32_t factor;
+		uint32_t n_levels;
+		uint32_t reserved;
+		int64_t  capacity;
+		int64_t  n_peaks[max_levels];
+	};
+
+	int  read_header (int fd, Header&) const;
+	bool map_header (Header&) const;
+	int  map () const;
+	void unmap_unlocked () const;
+	samplecnt_t copy_mapped (uint32_t level, PeakData*, samplecnt_t first_peak, samplecnt_t n_peaks, bool& truncated) const;
+	int  write_header ();
+	bool header_ok (Header const&) const;
+	void reset ();
+	void init_header (int64_t capacity);
+
+	int   grow (samplecnt_t n_base_peaks);
+	int   write_peaks (uint32_t level, PeakData const*, samplecnt_t first_peak, samplecnt_t n_peaks);
+	void  push (uint32_t level, PeakData const&);
+	off_t level_offset (uint32_t level, int64_t capacity) const;
+
+	static int64_t level_size (uint32_t level, int64_t capacity);
+
+	std::string _path;
+	samplecnt_t _base_fpp;
+	int         _fd;
+	bool        _stale;
+	bool        _modified;
+	Header      _header;
+
+	samplecnt_t _next_base_peak;
+
+	/* per level (1 .. max_levels) */
+	PeakData              _acc[max_levels];
+	uint32_t              _acc_cnt[max_levels];
+	samplecnt_t           _n_complete[max_levels];
+	std::vector<PeakData> _pending[max_levels];
+
+	/* read-only mapping, shared by all readers */
+	mutable Glib::Threads::RWLock _map_lock;
+	mutable char*                 _map_addr;
+	mutable size_t                _map_length;
+	mutable bool                  _map_failed;
+
+	static std::atomic<uint64_t> _mapped_reads;
+	static std::atomic<uint64_t> _maps;
+};
+
+} // namespace ARDOUR
+
+#endif /* _ardour_peak_pyramid_h_ */
@@ -51,6 +51,7 @@
 #include "ardour/ardour.h"
 #include "ardour/data_type.h"
 #include "ardour/region.h"
+#include "ardour/region_interval_index.h"
 #include "ardour/session_object.h"
 #include "ardour/thawlist.h"
 
@@ -249,6 +250,24 @@ public:
 	XMLNode&    get_state () const;
 	virtual int set_state (const XMLNode&, int version);
 	XMLNode&    get_template ();
+	void        write_state (XMLWriter&) const;
+
+	/** A copy of the full state of a playlist, which holds copies of the
+	 * state of its regions. It is taken in the thread that edits the
+	 * playlist, and can be written later, in any thread.
+	 */
+	class LIBARDOUR_API StateCopy : public boost::noncopyable {
+	public:
+		StateCopy (Playlist const&);
+		~StateCopy ();
+
+		void write_state (XMLWriter&);
+
+	private:
+		XMLNode _node;
+		std::vector<boost::shared_ptr<Region::StateCopy const> > _regions;
+		XMLNode* _extra_xml;
+	};
 
 	PBD::Signal1<void, bool>                     InUse;
 	PBD::Signal0<void>                           ContentsChanged;
@@ -331,6 +350,10 @@ protected:
 
 		~RegionWriteLock ()
 		{
+			/* regions may have been moved, with notifications
+			 * delayed until the thawlist is released
+			 */
+			playlist->invalidate_region_index ();
 			Glib::Threads::RWLock::WriterLock::release ();
 			thawlist.release ();
 			if (block_notify) {
@@ -429,6 +452,9 @@ protected:
 	virtual void remove_dependents (boost::shared_ptr<Region> /*region*/) {}
 	virtual void region_going_away (boost::weak_ptr<Region> /*region*/) {}
 
+	/** Called whenever the set of regions, their extents or their layering change */
+	virtual void region_layout_invalidated () {}
+
 	virtual XMLNode& state (bool) const;
 
 	bool add_region_internal (boost::shared_ptr<Region>, timepos_t const & position, ThawList& thawlist);
@@ -470,12 +496,21 @@ private:
 	mutable Glib::Threads::RWLock region_lock;
 
 private:
+	void add_properties (XMLNode&, bool full_state) const;
+	void add_state (XMLNode&, bool full_state, XMLWriter*) const;
 	void freeze_locked ();
 	void setup_layering_indices (RegionList const &);
 	void coalesce_and_check_crossfades (std::list<Temporal::TimeRange>);
 	boost::shared_ptr<RegionList> find_regions_at (timepos_t const &);
 
+	void invalidate_region_index ();
+	void find_region_candidates (timepos_t const & start, timepos_t const & end, std::vector<boost::shared_ptr<Region> >&) const;
+
 	mutable boost::optional<std::pair<timepos_t, timepos_t> > _cached_extent;
+
+	/* range query index of `regions', rebuilt on demand */
+	mutable RegionIntervalIndex  _region_index;
+	mutable Glib::Threads::Mutex _region_index_lock;
 	timepos_t _end_space;  //this is used when we are pasting a range with extra space at the end
 	bool _playlist_shift_active;
 
@@ -52,6 +52,8 @@ class LIBARDOUR_API BackendPort : public ProtoPort
   public:
 	virtual ~BackendPort ();
 
+	typedef std::vector<BackendPortPtr> ConnectionList;
+
 	const std::string& name ()        const { return _name; }
 	const std::string& pretty_name () const { return _pretty_name; }
 	const std::string& hw_port_name () const { return _hw_port_name; }
@@ -89,6 +91,13 @@ class LIBARDOUR_API BackendPort : public ProtoPort
 		return _connections;
 	}
 
+	/** Flat copy of the connections, for use in the process callback.
+	 * All ports in the list are of the same type() as this port.
+	 */
+	boost::shared_ptr<const ConnectionList> rt_connections () const {
+		return _rt_connections.reader ();
+	}
+
 	int  connect (BackendPortHandle port, BackendPortHandle self);
 	int  disconnect (BackendPortHandle port, BackendPortHandle self);
 	void disconnect_all (BackendPortHandle self);
@@ -116,8 +125,11 @@ private:
 	LatencyRange           _playback_latency_range;
 	std::set<BackendPortPtr> _connections;
 
+	SerializedRCUManager<ConnectionList> _rt_connections;
+
 	void store_connection (BackendPortHandle);
 	void remove_connection (BackendPortHandle);
+	void update_rt_connections ();
 
 }; // class BackendPort
 
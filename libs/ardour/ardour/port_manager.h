@@ -43,6 +43,7 @@ namespace ARDOUR {
 
 class PortEngine;
 class AudioBackend;
+class AudioPort;
 class Session;
 
 class CircularSampleBuffer;
@@ -284,8 +285,40 @@ protected:
 	boost::shared_ptr<Port> register_port (DataType type, const std::string& portname, bool input, bool async = false, PortFlags extra_flags = PortFlags (0));
 	void                    port_registration_failure (const std::string& portname);
 
-	/** List of ports to be used between \ref cycle_start() and \ref cycle_end() */
-	boost::shared_ptr<Ports> _cycle_ports;
+	/** The ports of a Ports map as flat lists, grouped by type and
+	 *  direction, for iteration in the process callback. The map that
+	 *  the lists were built from keeps the ports alive.
+	 */
+	struct PortTable {
+		boost::shared_ptr<Ports> map;
+		std::vector<AudioPort*>  audio_inputs;
+		std::vector<AudioPort*>  audio_outputs;
+		std::vector<Port*>       midi_inputs;
+		std::vector<Port*>       midi_outputs;
+		std::vector<Port*>       all; ///< all of the above, in the same order
+	};
+
+	/** Published whenever _ports changes, name lookups still use _ports */
+	SerializedRCUManager<PortTable> _port_table;
+
+	void update_port_table ();
+
+	/** Ports to be used between \ref cycle_start() and \ref cycle_end() */
+	boost::shared_ptr<PortTable> _cycle_ports;
+
+	/** Audio input ports with identical connections. The first port of each
+	 *  group resamples the input, the others read from its buffer.
+	 */
+	typedef std::vector<std::vector<boost::shared_ptr<AudioPort> > > SharedInputs;
+
+	SerializedRCUManager<SharedInputs> _shared_inputs;
+	boost::shared_ptr<SharedInputs>    _cycle_shared_inputs;
+
+	void update_shared_inputs ();
+	void release_cycle_ports ();
+	void cycle_start_ports (pframes_t nframes, bool with_resampling);
+	void cycle_end_ports (pframes_t nframes, bool with_resampling);
+	void run_cycle_end (pframes_t nframes, Session*);
 
 	void silence (pframes_t nframes, Session* s = 0);
 	void silence_outputs (pframes_t nframes);
@@ -27,6 +27,7 @@
 #include <exception>
 
 #include "pbd/statefuldestructible.h"
+#include "pbd/timing.h"
 
 #include "ardour/ardour.h"
 #include "ardour/buffer_set.h"
@@ -157,6 +158,12 @@ class LIBARDOUR_API Processor : public SessionObject, public Automatable, public
 	virtual void set_owner (SessionObject*);
 	SessionObject* owner() const;
 
+	/** Histogram of the time spent in run(), while the session's DSPProfiler is enabled */
+	PBD::TimingHistogram process_histogram () const { return _process_histogram; }
+	void reset_process_histogram () { _process_histogram.queue_reset (); }
+	/** called by the owning Route after run() */
+	void add_process_time (PBD::microseconds_t t) { _process_histogram.add (t); }
+
 protected:
 	virtual XMLNode& state () const;
 	virtual int set_state_2X (const XMLNode&, int version);
@@ -183,6 +190,8 @@ protected:
 	samplecnt_t _capture_offset;
 	samplecnt_t _playback_offset;
 	Location*   _loop_location;
+
+	PBD::TimingHistogram _process_histogram;
 };
 
 } // namespace ARDOUR
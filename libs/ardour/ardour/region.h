@@ -33,6 +33,7 @@
 #include "temporal/range.h"
 
 #include "pbd/undo.h"
+#include "pbd/property_list.h"
 #include "pbd/signals.h"
 #include "ardour/ardour.h"
 #include "ardour/data_type.h"
@@ -355,6 +356,31 @@ public:
 	XMLNode&         get_state () const;
 	virtual int      set_state (const XMLNode&, int version);
 
+	/** A copy of the values that make up the state of a region. It is taken
+	 * in the thread that edits the region, and can be serialized later, in
+	 * any thread, while the region is changed or destroyed.
+	 */
+	class LIBARDOUR_API StateCopy : public boost::noncopyable {
+	public:
+		StateCopy (Region const&);
+		virtual ~StateCopy ();
+
+		/** @return the state that Region::get_state() returned when the copy was taken */
+		virtual XMLNode& get_state () const;
+
+	private:
+		PBD::PropertyList    _properties;
+		PBD::ID              _id;
+		DataType             _type;
+		RegionEditState      _first_edit;
+		std::vector<PBD::ID> _sources;
+		std::vector<PBD::ID> _master_sources;
+		XMLNode*             _nested_sources;
+		XMLNode*             _extra_xml;
+	};
+
+	virtual boost::shared_ptr<StateCopy const> state_copy () const;
+
 	virtual bool do_export (std::string const&) const = 0;
 
 	virtual boost::shared_ptr<Region> get_parent() const;
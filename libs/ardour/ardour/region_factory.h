@@ -27,6 +27,7 @@
 #include <glibmm/threads.h>
 #include <map>
 #include <set>
+#include <unordered_map>
 
 #include "pbd/id.h"
 #include "pbd/property_list.h"
@@ -148,6 +149,9 @@ public:
 
 	static void map_add (boost::shared_ptr<Region>);
 
+	/** Update the source index after the sources of \p r changed */
+	static void reindex_sources (Region const& r);
+
 private:
 	friend class ::RegionNamingTest;
 
@@ -157,9 +161,22 @@ private:
 	static void update_region_name_number_map (boost::shared_ptr<Region>);
 	static void remove_from_region_name_map (std::string);
 
+	static void index_sources_locked (Region const&);
+	static void unindex_sources_locked (PBD::ID const&);
+	static void region_candidates_for_source_locked (boost::shared_ptr<Source>, std::set<PBD::ID>&);
+
 	static Glib::Threads::Mutex region_map_lock;
 	static RegionMap            region_map;
 
+	/* source-ID -> IDs of regions using it, and the reverse, protected by
+	 * region_map_lock. Regions that use a PlaylistSource may use other
+	 * sources indirectly, those are checked on every lookup.
+	 */
+	typedef std::unordered_map<PBD::ID, std::set<PBD::ID>, PBD::ID::Hash> IDSetMap;
+	static IDSetMap          regions_by_source;
+	static IDSetMap          sources_by_region;
+	static std::set<PBD::ID> compound_regions;
+
 	static Glib::Threads::Mutex region_name_maps_mutex;
 	/** map of partial region names and suffix numbers */
 	static std::map<std::string, uint32_t> region_name_number_map;
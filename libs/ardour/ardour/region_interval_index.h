@@ -0,0 +1,100 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifndef __libardour_region_interval_index_h__
+#define __libardour_region_interval_index_h__
+
+#include <vector>
+
+#include <boost/shared_ptr.hpp>
+
+#include "temporal/superclock.h"
+
+#include "ardour/libardour_visibility.h"
+#include "ardour/types.h"
+
+namespace ARDOUR {
+
+class Region;
+
+/** An augmented interval tree of the extents of a list of regions.
+ *
+ * The regions are stored in an array sorted by their start, which forms an
+ * implicit balanced binary tree (the root of [lo, hi) is at the middle).
+ * Each node also holds the maximum end of all regions in its subtree, so a
+ * range query only visits subtrees that can contain an overlapping region:
+ * O(log n + k) rather than O(n).
+ *
+ * Extents are converted to superclock when the index is built, and are
+ * widened slightly to cover rounding between time domains. Results are
+ * therefore candidates; callers apply the exact test (Region::covers(),
+ * Region::coverage()) to them. Candidates are returned in the order of the
+ * RegionList that the index was built from.
+ *
+ * There is no internal locking, and the index does not track changes of the
+ * regions. Playlist invalidates and rebuilds it as required. Only a valid
+ * index holds references to regions.
+ */
+class LIBARDOUR_API RegionIntervalIndex
+{
+public:
+	RegionIntervalIndex ();
+
+	void build (RegionList::const_iterator begin, RegionList::const_iterator end);
+	void clear ();
+
+	bool   valid () const { return _valid; }
+	size_t size () const { return _entries.size (); }
+
+	/** Mark the index as outdated. This also drops the references to the
+	 * regions, so that removed regions are not kept alive by the index.
+	 */
+	void invalidate () { clear (); }
+
+	/** Append all regions whose extent overlaps [start, end] (inclusive) to @p result */
+	void find (superclock_t start, superclock_t end, std::vector<boost::shared_ptr<Region> >& result) const;
+
+private:
+	struct Entry {
+		Entry (superclock_t s, superclock_t e, size_t o)
+			: start (s)
+			, end (e)
+			, order (o)
+		{}
+
+		bool operator< (Entry const& other) const {
+			return start < other.start || (start == other.start && order < other.order);
+		}
+
+		superclock_t start;
+		superclock_t end;
+		size_t       order; /* position in the RegionList */
+	};
+
+	superclock_t build_max_end (size_t lo, size_t hi);
+	void         find (size_t lo, size_t hi, superclock_t start, superclock_t end, std::vector<size_t>& orders) const;
+
+	std::vector<Entry>                      _entries;
+	std::vector<superclock_t>               _max_end;
+	std::vector<boost::shared_ptr<Region> > _regions;
+	bool                                    _valid;
+
+	mutable std::vector<size_t> _orders; /* scratch space for ::find() */
+};
+
+} // namespace ARDOUR
+
+#endif /* __libardour_region_interval_index_h__ */
@@ -597,6 +597,8 @@ protected:
 	void catch_up_on_solo_mute_override ();
 	void set_listen (bool);
 
+	void id_changed (PBD::ID const&);
+
 	virtual void set_block_size (pframes_t nframes);
 
 	virtual int no_roll_unlocked (pframes_t nframes, samplepos_t start_sample, samplepos_t end_sample, bool session_state_changing);
@@ -31,6 +31,14 @@ namespace ARDOUR {
 	typedef void  (*mix_buffers_with_gain_t) (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t, float);
 	typedef void  (*mix_buffers_no_gain_t)   (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
 	typedef void  (*copy_vector_t)           (ARDOUR::Sample *, const ARDOUR::Sample *, pframes_t);
+	typedef void  (*linear_ramp_t)           (ARDOUR::Sample *, pframes_t, float, float);
+	typedef void  (*exp2_ramp_t)             (ARDOUR::Sample *, pframes_t, float, float);
+	typedef void  (*gain_ramp_t)             (ARDOUR::Sample *, pframes_t, float, float, float);
+	typedef void  (*cubic_ramp_t)            (ARDOUR::Sample *, pframes_t, float, float, float, float, float);
+
+	typedef void  (*apply_gain_vector_t)            (ARDOUR::Sample *, const float *, pframes_t);
+	typedef void  (*mix_buffers_with_gain_vector_t) (ARDOUR::Sample *, const ARDOUR::Sample *, const float *, pframes_t);
+	typedef void  (*crossfade_buffers_t)            (ARDOUR::Sample *, const ARDOUR::Sample *, const float *, pframes_t);
 
 	LIBARDOUR_API extern compute_peak_t          compute_peak;
 	LIBARDOUR_API extern find_peaks_t            find_peaks;
@@ -38,6 +46,14 @@ namespace ARDOUR {
 	LIBARDOUR_API extern mix_buffers_with_gain_t mix_buffers_with_gain;
 	LIBARDOUR_API extern mix_buffers_no_gain_t   mix_buffers_no_gain;
 	LIBARDOUR_API extern copy_vector_t           copy_vector;
+	LIBARDOUR_API extern linear_ramp_t           linear_ramp;
+	LIBARDOUR_API extern exp2_ramp_t             exp2_ramp;
+	LIBARDOUR_API extern gain_ramp_t             gain_ramp;
+	LIBARDOUR_API extern cubic_ramp_t            cubic_ramp;
+
+	LIBARDOUR_API extern apply_gain_vector_t            apply_gain_vector;
+	LIBARDOUR_API extern mix_buffers_with_gain_vector_t mix_buffers_with_gain_vector;
+	LIBARDOUR_API extern crossfade_buffers_t            crossfade_buffers;
 }
 
 #endif /* __ardour_runtime_functions_h__ */
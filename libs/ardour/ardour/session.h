@@ -41,6 +41,7 @@
 #include <map>
 #include <set>
 #include <string>
+#include <unordered_map>
 #include <vector>
 #include <queue>
 #include <stdint.h>
@@ -107,6 +108,7 @@ class Parser;
 
 namespace PBD {
 class Controllable;
+class Thread;
 }
 
 namespace luabridge {
@@ -138,6 +140,7 @@ class Bundle;
 class Butler;
 class Click;
 class CoreSelection;
+class DSPProfiler;
 class ExportHandler;
 class ExportStatus;
 class Graph;
@@ -327,10 +330,12 @@ public:
 	}
 
 	boost::shared_ptr<RTTaskList> rt_tasklist () { return _rt_tasklist; }
+	boost::shared_ptr<Graph> process_graph () const { return _process_graph; }
 
 	RouteList get_routelist (bool mixer_order = false, PresentationInfo::Flag fl = PresentationInfo::MixerRoutes) const;
 
 	CoreSelection& selection () const { return *_selection; }
+	DSPProfiler& dsp_profiler () const { return *_dsp_profiler; }
 
 	/* because the set of Stripables consists of objects managed
 	 * independently, in multiple containers within the Session (or objects
@@ -600,6 +605,39 @@ public:
 	                bool for_archive = false,
 	                bool only_used_assets = false);
 
+	/** save the state of the current snapshot, without waiting for it to be written.
+	 *
+	 * The calling thread only takes a snapshot: it copies the lists of
+	 * objects to save (the route list is the RCU list itself), copies the
+	 * state of the playlists and their regions as values, and serializes
+	 * the rest of the state, which is small. Routes are serialized there
+	 * too, since plugin state can only be retrieved in that thread. The
+	 * undo history is limited to the saved history depth. A separate
+	 * thread streams the snapshot to the file, and writes the backups and
+	 * the history. Later edits do not affect what is saved.
+	 *
+	 * The result is handed back by wait_for_background_save() or
+	 * finish_background_save(), in the thread that calls them: that is where
+	 * BackgroundSaveFinished and, for a successful full save, StateSaved are
+	 * emitted, and where the session is marked dirty again if the save failed.
+	 *
+	 * @param pending save a 'recovery', not full state (default: false)
+	 * @return zero if the save was started
+	 */
+	int save_state_in_background (bool pending = false);
+
+	/** wait until a save started by save_state_in_background() is complete,
+	 * and finish it in the calling thread.
+	 */
+	void wait_for_background_save ();
+
+	/** finish a save started by save_state_in_background() if it is complete,
+	 * without blocking. Intended to be polled from the GUI thread.
+	 *
+	 * @return true if no background save is in progress any more
+	 */
+	bool finish_background_save ();
+
 	enum ArchiveEncode {
 		NO_ENCODE,
 		FLAC_16BIT,
@@ -627,6 +665,12 @@ public:
 	PBD::Signal1<void,std::string> StateSaved;
 	PBD::Signal0<void> StateReady;
 
+	/* emitted when a background save is finished, by the thread that calls
+	 * wait_for_background_save() or finish_background_save().
+	 * Arguments are the snapshot name, and whether the state was written.
+	 */
+	PBD::Signal2<void,std::string,bool> BackgroundSaveFinished;
+
 	/* emitted when session needs to be saved due to some internal
 	 * event or condition (i.e. not in response to a user request).
 	 *
@@ -1604,9 +1648,14 @@ private:
 	GATOMIC_QUAL gint  _suspend_save;
 	volatile bool      _save_queued;
 	volatile bool      _save_queued_pending;
+	PBD::Thread*       _save_thread;
+	struct BackgroundSave;
+	BackgroundSave*    _background_save;
+	GATOMIC_QUAL gint  _background_save_done;
 
 	Glib::Threads::Mutex save_state_lock;
 	Glib::Threads::Mutex save_source_lock;
+	Glib::Threads::Mutex save_thread_lock;
 	Glib::Threads::Mutex peak_cleanup_lock;
 
 	int        load_options (const XMLNode&);
@@ -1932,6 +1981,15 @@ private:
 
 	SerializedRCUManager<RouteList>  routes;
 
+	/* ID-keyed index of `routes', for lock-free ::route_by_id(). It is
+	 * published after each change of `routes', and follows ID changes
+	 * of the routes in it.
+	 */
+	typedef std::unordered_map<PBD::ID, boost::weak_ptr<Route>, PBD::ID::Hash> RouteIDMap;
+	SerializedRCUManager<RouteIDMap> _route_id_map;
+	void update_route_id_map ();
+	void route_id_changed (Route&, PBD::ID const& previous);
+
 	void add_routes (RouteList&, bool input_auto_connect, bool output_auto_connect, PresentationInfo::order_t);
 	void add_routes_inner (RouteList&, bool input_auto_connect, bool output_auto_connect, PresentationInfo::order_t);
 	bool _adding_routes_in_progress;
@@ -2126,8 +2184,43 @@ private:
 	                bool for_archive = false,
 	                bool only_used_assets = false) const;
 
+	struct StateSnapshot;
+
+	void state (XMLNode&, XMLWriter*,
+	            bool save_template,
+	            snapshot_t snapshot_type,
+	            bool for_archive,
+	            bool only_used_assets,
+	            StateSnapshot* snapshot = 0) const;
+
 	XMLNode& get_state () const;
 	int      set_state (const XMLNode& node, int version); // not idempotent
+
+	static void write_state_snapshot (XMLWriter&, StateSnapshot&);
+
+	/** state captured by save_state_in_background(). Used by the save thread
+	 * until it is joined, then by background_save_done().
+	 */
+	struct BackgroundSave {
+		BackgroundSave () : state (0), history (0), pending (false), ok (false) {}
+		~BackgroundSave ();
+
+		std::string    snapshot_name;
+		std::string    tmp_path;
+		StateSnapshot* state;
+		XMLNode*       history;
+		bool           pending;
+		bool           ok;
+	};
+
+	void background_save (BackgroundSave*);
+	void background_save_done (BackgroundSave*);
+	BackgroundSave* join_save_thread ();
+	int  install_state_file (std::string const& tmp_path, std::string const& snapshot_name, bool written, bool pending) const;
+	void remove_pending_state_file (std::string const& snapshot_name) const;
+	XMLNode* history_state ();
+	int  write_history (std::string const& snapshot_name, XMLNode* history) const;
+
 	XMLNode& get_template ();
 
 	bool maybe_copy_midifile (snapshot_t, boost::shared_ptr<Source> src, XMLNode*);
@@ -2341,6 +2434,7 @@ private:
 	StripableList _soloSelection;  //the items that are soloe'd during a solo-selection operation; need to unsolo after the roll
 
 	CoreSelection* _selection;
+	DSPProfiler*   _dsp_profiler;
 
 	bool _global_locate_pending;
 	boost::optional<samplepos_t> _nominal_jack_transport_sample;
@@ -30,7 +30,10 @@
 
 #include "pbd/signals.h"
 
+#include "ardour/playlist.h"
+
 class XMLNode;
+class XMLWriter;
 
 namespace PBD {
 	class ID;
@@ -81,7 +84,9 @@ private:
 
 	void find_equivalent_playlist_regions (boost::shared_ptr<Region>, std::vector<boost::shared_ptr<Region> >& result);
 	void update_after_tempo_map_change ();
-	void add_state (XMLNode*, bool save_template, bool include_unused) const;
+	void add_state (XMLNode*, bool save_template, bool include_unused, XMLWriter* writer = 0) const;
+	void add_playlist_state (XMLNode*, Playlist&, bool save_template, XMLWriter*) const;
+	void state_copies (std::vector<boost::shared_ptr<Playlist::StateCopy> >& used, std::vector<boost::shared_ptr<Playlist::StateCopy> >& unused) const;
 	bool maybe_delete_unused (boost::function<int(boost::shared_ptr<Playlist>)>);
 	int load (Session &, const XMLNode&);
 	int load_unused (Session &, const XMLNode&);
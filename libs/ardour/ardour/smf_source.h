@@ -64,6 +64,9 @@ public:
 	                                          Evoral::Sequence<Temporal::Beats>::StuckNoteOption,
 	                                          Temporal::Beats when = Temporal::Beats());
 
+	bool mark_range_write_started (const WriterLock& lock, Temporal::Beats const & start, Temporal::Beats const & end);
+	void mark_range_write_completed (const WriterLock& lock);
+
 	XMLNode& get_state () const;
 	int set_state (const XMLNode&, int version);
 
@@ -85,6 +88,8 @@ public:
 
   private:
 	bool _open;
+	/** SMF::track_revision() after the last complete write */
+	uint64_t          _written_revision;
 	Temporal::Beats   _last_ev_time_beats;
 	samplepos_t       _last_ev_time_samples;
 	/** end time (start + duration) of last call to read_unlocked */
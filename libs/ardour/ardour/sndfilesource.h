@@ -70,6 +70,8 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 
 	bool clamped_at_unity () const;
 
+	bool queue_prefetch (FileReadAhead&, samplepos_t start, samplecnt_t cnt) const;
+
 	static const Source::Flag default_writable_flags;
 
 	static int get_soundfile_info (const std::string& path, SoundFileInfo& _info, std::string& error_msg);
@@ -89,6 +91,14 @@ class LIBARDOUR_API SndFileSource : public AudioFileSource {
 	SF_INFO _info;
 	BroadcastInfo *_broadcast_info;
 
+	/** file descriptor owned by _sndfile, used to queue read-ahead hints.
+	 * _fd_lock serializes its use in queue_prefetch() against close()
+	 */
+	int _sndfile_fd;
+	/** file offset of the first sample, -1 if unknown */
+	int64_t _data_offset;
+	mutable Glib::Threads::Mutex _fd_lock;
+
 	void init_sndfile ();
 	int open();
 	int setup_broadcast_info (samplepos_t when, struct tm&, time_t);
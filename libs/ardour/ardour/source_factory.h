@@ -57,9 +57,11 @@ public:
 	static std::vector<PBD::Thread*> peak_thread_pool;
 
 	static std::list<boost::weak_ptr<AudioSource>> files_with_peaks;
+	static std::list<boost::weak_ptr<AudioSource>> files_with_peak_data;
 
-	static int peak_work_queue_length ();
-	static int setup_peakfile (boost::shared_ptr<Source>, bool async);
+	static int  peak_work_queue_length ();
+	static int  setup_peakfile (boost::shared_ptr<Source>, bool async);
+	static void queue_peak_data (boost::shared_ptr<AudioSource>);
 };
 
 } // namespace ARDOUR
@@ -32,6 +32,7 @@
 
 namespace ARDOUR {
 
+class FileReadAhead;
 class Session;
 class Playlist;
 class RouteGroup;
@@ -145,6 +146,7 @@ public:
 	float capture_buffer_load () const;
 	int do_refill ();
 	int do_flush (RunContext, bool force = false);
+	void queue_prefetch (FileReadAhead&);
 	void set_pending_overwrite (OverwriteReason);
 	int seek (samplepos_t, bool complete_refill = false);
 	bool can_internal_playback_seek (samplecnt_t);
@@ -525,6 +525,11 @@ enum DenormalModel {
 	DenormalFTZDAZ
 };
 
+enum GraphScheduling {
+	SharedTriggerQueue,
+	WorkStealing
+};
+
 enum LayerModel {
 	LaterHigher,
 	Manual
@@ -515,4 +515,182 @@ arm_neon_copy_vector(
 	}
 }
 
+/* 2^x, polynomial approximation (Cephes exp2f), relative error < 2e-7 */
+static inline float32x4_t
+neon_exp2_ps (float32x4_t x)
+{
+	x = vminq_f32 (vmaxq_f32 (x, vdupq_n_f32 (-126.f)), vdupq_n_f32 (126.f));
+
+	/* n = round (x), vcvtq truncates towards zero: floor (x + .5) */
+	float32x4_t const y  = vaddq_f32 (x, vdupq_n_f32 (.5f));
+	int32x4_t         n  = vcvtq_s32_f32 (y);
+	uint32x4_t const  gt = vcgtq_f32 (vcvtq_f32_s32 (n), y);
+	n = vaddq_s32 (n, vreinterpretq_s32_u32 (gt)); // subtract 1 where n > y
+
+	float32x4_t const f = vsubq_f32 (x, vcvtq_f32_s32 (n));
+
+	float32x4_t p = vdupq_n_f32 (1.535336188319500e-4f);
+	p = vmlaq_f32 (vdupq_n_f32 (1.339887440266574e-3f), p, f);
+	p = vmlaq_f32 (vdupq_n_f32 (9.618437357674640e-3f), p, f);
+	p = vmlaq_f32 (vdupq_n_f32 (5.550332471162809e-2f), p, f);
+	p = vmlaq_f32 (vdupq_n_f32 (2.402264791363012e-1f), p, f);
+	p = vmlaq_f32 (vdupq_n_f32 (6.931472028550421e-1f), p, f);
+	p = vmlaq_f32 (vdupq_n_f32 (1.f), p, f);
+
+	/* 2^n */
+	int32x4_t const e = vshlq_n_s32 (vaddq_s32 (n, vdupq_n_s32 (127)), 23);
+	return vmulq_f32 (p, vreinterpretq_f32_s32 (e));
+}
+
+static inline float32x4_t
+neon_ramp_index ()
+{
+	static const float idx[4] = { 0.f, 1.f, 2.f, 3.f };
+	return vld1q_f32 (idx);
+}
+
+C_FUNC void
+arm_neon_linear_ramp (float *dst, uint32_t nframes, float y0, float dy)
+{
+	float32x4_t const vy0  = vdupq_n_f32 (y0);
+	float32x4_t const vdy  = vdupq_n_f32 (dy);
+	float32x4_t const four = vdupq_n_f32 (4.f);
+	float32x4_t       idx  = neon_ramp_index ();
+
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		vst1q_f32 (dst + i, vmlaq_f32 (vy0, idx, vdy));
+		idx = vaddq_f32 (idx, four);
+	}
+	for (; i < nframes; ++i) {
+		dst[i] = y0 + i * dy;
+	}
+}
+
+C_FUNC void
+arm_neon_exp2_ramp (float *dst, uint32_t nframes, float y0, float de)
+{
+	float32x4_t const vy0  = vdupq_n_f32 (y0);
+	float32x4_t const vde  = vdupq_n_f32 (de);
+	float32x4_t const four = vdupq_n_f32 (4.f);
+	float32x4_t       idx  = neon_ramp_index ();
+
+	while (nframes >= 4) {
+		vst1q_f32 (dst, vmulq_f32 (vy0, neon_exp2_ps (vmulq_f32 (idx, vde))));
+		idx = vaddq_f32 (idx, four);
+		dst += 4;
+		nframes -= 4;
+	}
+	if (nframes > 0) {
+		float tmp[4];
+		vst1q_f32 (tmp, vmulq_f32 (vy0, neon_exp2_ps (vmulq_f32 (idx, vde))));
+		for (uint32_t i = 0; i < nframes; ++i) {
+			dst[i] = tmp[i];
+		}
+	}
+}
+
+#ifdef __aarch64__
+static inline float32x4_t
+neon_gain_ps (float32x4_t p, float32x4_t scale)
+{
+	float32x4_t const zero = vdupq_n_f32 (0.f);
+	uint32x4_t const  mask = vcgtq_f32 (p, zero);
+
+	/* position_to_gain (): 2^(33 * p^(1/8) - 32) */
+	float32x4_t q = vsqrtq_f32 (vsqrtq_f32 (vsqrtq_f32 (vmaxq_f32 (p, zero))));
+	float32x4_t g = neon_exp2_ps (vsubq_f32 (vmulq_n_f32 (q, 33.f), vdupq_n_f32 (32.f)));
+	return vreinterpretq_f32_u32 (vandq_u32 (mask, vreinterpretq_u32_f32 (vmulq_f32 (g, scale))));
+}
+
+C_FUNC void
+arm_neon_gain_ramp (float *dst, uint32_t nframes, float p0, float dp, float scale)
+{
+	float32x4_t const vp0  = vdupq_n_f32 (p0);
+	float32x4_t const vdp  = vdupq_n_f32 (dp);
+	float32x4_t const vsc  = vdupq_n_f32 (scale);
+	float32x4_t const four = vdupq_n_f32 (4.f);
+	float32x4_t       idx  = neon_ramp_index ();
+
+	while (nframes >= 4) {
+		vst1q_f32 (dst, neon_gain_ps (vmlaq_f32 (vp0, idx, vdp), vsc));
+		idx = vaddq_f32 (idx, four);
+		dst += 4;
+		nframes -= 4;
+	}
+	if (nframes > 0) {
+		float tmp[4];
+		vst1q_f32 (tmp, neon_gain_ps (vmlaq_f32 (vp0, idx, vdp), vsc));
+		for (uint32_t i = 0; i < nframes; ++i) {
+			dst[i] = tmp[i];
+		}
+	}
+}
+#endif
+
+C_FUNC void
+arm_neon_cubic_ramp (float *dst, uint32_t nframes, float a0, float a1, float a2, float a3, float dt)
+{
+	float32x4_t const va0  = vdupq_n_f32 (a0);
+	float32x4_t const va1  = vdupq_n_f32 (a1);
+	float32x4_t const va2  = vdupq_n_f32 (a2);
+	float32x4_t const va3  = vdupq_n_f32 (a3);
+	float32x4_t const four = vdupq_n_f32 (4.f);
+	float32x4_t       idx  = neon_ramp_index ();
+
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		float32x4_t const t = vmulq_n_f32 (idx, dt);
+		float32x4_t       p = vmlaq_f32 (va2, va3, t);
+		p = vmlaq_f32 (va1, p, t);
+		p = vmlaq_f32 (va0, p, t);
+		vst1q_f32 (dst + i, p);
+		idx = vaddq_f32 (idx, four);
+	}
+	for (; i < nframes; ++i) {
+		const float t = i * dt;
+		dst[i] = a0 + t * (a1 + t * (a2 + t * a3));
+	}
+}
+
+C_FUNC void
+arm_neon_apply_gain_vector (float *dst, const float *gain, uint32_t nframes)
+{
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		vst1q_f32 (dst + i, vmulq_f32 (vld1q_f32 (dst + i), vld1q_f32 (gain + i)));
+	}
+	for (; i < nframes; ++i) {
+		dst[i] *= gain[i];
+	}
+}
+
+C_FUNC void
+arm_neon_mix_buffers_with_gain_vector (float *dst, const float *src, const float *gain, uint32_t nframes)
+{
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		vst1q_f32 (dst + i, vmlaq_f32 (vld1q_f32 (dst + i), vld1q_f32 (src + i), vld1q_f32 (gain + i)));
+	}
+	for (; i < nframes; ++i) {
+		dst[i] += src[i] * gain[i];
+	}
+}
+
+C_FUNC void
+arm_neon_crossfade_buffers (float *dst, const float *src, const float *gain, uint32_t nframes)
+{
+	float32x4_t const one = vdupq_n_f32 (1.f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		float32x4_t const g = vld1q_f32 (gain + i);
+		float32x4_t const d = vmulq_f32 (vld1q_f32 (dst + i), vsubq_f32 (one, g));
+		vst1q_f32 (dst + i, vmlaq_f32 (d, vld1q_f32 (src + i), g));
+	}
+	for (; i < nframes; ++i) {
+		dst[i] = dst[i] * (1.f - gain[i]) + src[i] * gain[i];
+	}
+}
+
 #endif
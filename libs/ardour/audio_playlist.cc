@@ -24,11 +24,13 @@
 #include <algorithm>
 
 #include <cstdlib>
+#include <set>
 
 #include "ardour/types.h"
 #include "ardour/debug.h"
 #include "ardour/audioplaylist.h"
 #include "ardour/audioregion.h"
+#include "ardour/audiosource.h"
 #include "ardour/region_sorters.h"
 #include "ardour/session.h"
 
@@ -161,6 +163,14 @@ struct ReadSorter {
     }
 };
 
+/** Order render plan segments by their end, for std::upper_bound */
+struct PlanSegmentEndCompare {
+	template<typename T>
+	bool operator() (samplepos_t pos, T const& seg) const {
+		return pos < seg.end;
+	}
+};
+
 /** A segment of region that needs to be read */
 struct Segment {
 	Segment (boost::shared_ptr<AudioRegion> r, Temporal::Range a) : region (r), range (a) {}
@@ -201,6 +211,56 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, ti
 
 	Playlist::RegionReadLock rl (this);
 
+	if (_session.solo_selection_active() && SoloSelectedActive()) {
+		/* The set of audible regions depends on the editor selection,
+		 * which the render plan is not built for. Solo-selection is
+		 * an audition feature, so this uses the slower per-read path
+		 * rather than rebuilding the plan with every selection change.
+		 */
+		return read_unplanned (buf, mixdown_buffer, gain_buffer, start, cnt, chan_n);
+	}
+
+	boost::shared_ptr<RenderPlan const> plan = render_plan ();
+
+	samplepos_t const read_start = start.samples ();
+	samplepos_t const read_end   = read_start + scnt;
+
+	/* find the first segment that ends after read_start, and read segments
+	   until the end of the range.
+	*/
+	RenderPlan::const_iterator i = std::upper_bound (plan->begin(), plan->end(), read_start, PlanSegmentEndCompare ());
+
+	for (; i != plan->end() && i->start < read_end; ++i) {
+		samplepos_t const read_pos = max (i->start, read_start);
+		samplecnt_t const read_cnt = min (i->end, read_end) - read_pos;
+
+		for (std::vector<boost::shared_ptr<AudioRegion> >::const_iterator r = i->regions.begin(); r != i->regions.end(); ++r) {
+
+			DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("\tPlaylist %1 read %2 @ %3 for %4, channel %5, buf @ %6 offset %7\n",
+			                                                   name(), (*r)->name(), read_pos,
+			                                                   read_cnt, (int) chan_n,
+			                                                   buf, read_pos - read_start));
+
+			samplecnt_t nread = (*r)->read_at (buf + (read_pos - read_start), mixdown_buffer, gain_buffer, read_pos, read_cnt, chan_n);
+			if (nread != read_cnt) {
+#ifndef NDEBUG
+				/* see read_unplanned() */
+				return timecnt_t (0);
+#endif
+			}
+		}
+	}
+
+	return cnt;
+}
+
+/** Read without a render plan, working out which parts of which regions
+ *  to read for this range only. The caller must hold the region read lock,
+ *  and have zeroed \p buf.
+ */
+ARDOUR::timecnt_t
+AudioPlaylist::read_unplanned (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, timepos_t const & start, timecnt_t const & cnt, uint32_t chan_n)
+{
 	/* Find all the regions that are involved in the bit we are reading,
 	   and sort them by descending layer and ascending position.
 	*/
@@ -275,8 +335,8 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, ti
 
 		samplepos_t read_pos (i->range.start().samples());
 		samplecnt_t read_cnt (i->range.start().distance (i->range.end()).samples());
-		assert (start.distance (i->range.start()).samples() < scnt);
-		assert (start.distance (i->range.start()).samples() + read_cnt <= scnt);
+		assert (start.distance (i->range.start()).samples() < cnt.samples());
+		assert (start.distance (i->range.start()).samples() + read_cnt <= cnt.samples());
 		samplecnt_t nread = i->region->read_at (buf + start.distance (i->range.start()).samples(), mixdown_buffer, gain_buffer, read_pos, read_cnt, chan_n);
 		if (nread != read_cnt) {
 #ifndef NDEBUG
@@ -294,6 +354,183 @@ AudioPlaylist::read (Sample *buf, Sample *mixdown_buffer, float *gain_buffer, ti
 	return cnt;
 }
 
+/** @return the render plan for the whole playlist, building it if the
+ *  regions, their layering or the tempo map have changed since it was last
+ *  built. The caller must hold the region read lock.
+ */
+boost::shared_ptr<AudioPlaylist::RenderPlan const>
+AudioPlaylist::render_plan ()
+{
+	Glib::Threads::Mutex::Lock lm (_render_plan_lock);
+
+	/* music-time regions move (in samples) when the tempo map changes */
+	Temporal::TempoMap::SharedPtr tmap (Temporal::TempoMap::use());
+
+	if (_render_plan && _render_plan_tempo_map == tmap) {
+		return _render_plan;
+	}
+
+	/* This is the same as read_unplanned() works out for a single read,
+	   except that it is done for the whole extent of the playlist, and by
+	   sweeping over the sorted boundaries of all regions rather than
+	   subtracting ranges.
+	*/
+	std::vector<boost::shared_ptr<AudioRegion> > all;
+	all.reserve (regions.size ());
+
+	for (RegionList::const_iterator i = regions.begin(); i != regions.end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+		if (ar && !ar->muted()) {
+			all.push_back (ar);
+		}
+	}
+
+	/* the rank of a region is its index in this order */
+	std::sort (all.begin(), all.end(), ReadSorter ());
+
+	struct Extent {
+		samplepos_t start;
+		samplepos_t end;
+		samplepos_t body_start; // empty body unless opaque
+		samplepos_t body_end;
+	};
+
+	std::vector<Extent>                          extents (all.size ());
+	std::vector<std::pair<samplepos_t, size_t> > starts; // (position, rank)
+	std::vector<std::pair<samplepos_t, size_t> > ends;
+	std::vector<samplepos_t>                     bounds;
+
+	starts.reserve (all.size ());
+	ends.reserve (all.size ());
+	bounds.reserve (all.size () * 4);
+
+	for (size_t n = 0; n < all.size (); ++n) {
+		Temporal::Range rrange = all[n]->range_samples ();
+		Extent& x (extents[n]);
+
+		x.start      = rrange.start().samples();
+		x.end        = x.start + rrange.start().distance (rrange.end()).samples();
+		x.body_start = x.body_end = x.start;
+
+		if (x.end <= x.start) {
+			continue;
+		}
+
+		if (all[n]->opaque ()) {
+			Temporal::Range body = all[n]->body_range ();
+			x.body_start = max (x.start, body.start().samples());
+			x.body_end   = min (x.end, body.start().samples() + body.start().distance (body.end()).samples());
+			bounds.push_back (x.body_start);
+			bounds.push_back (x.body_end);
+		}
+
+		starts.push_back (std::make_pair (x.start, n));
+		ends.push_back (std::make_pair (x.end, n));
+		bounds.push_back (x.start);
+		bounds.push_back (x.end);
+	}
+
+	std::sort (starts.begin(), starts.end());
+	std::sort (ends.begin(), ends.end());
+	std::sort (bounds.begin(), bounds.end());
+	bounds.erase (std::unique (bounds.begin(), bounds.end()), bounds.end());
+
+	boost::shared_ptr<RenderPlan> plan (new RenderPlan);
+
+	/* regions covering the current segment, by rank */
+	std::set<size_t> active;
+	size_t si = 0;
+	size_t ei = 0;
+	std::vector<boost::shared_ptr<AudioRegion> > to_read;
+
+	for (size_t b = 0; b + 1 < bounds.size (); ++b) {
+		samplepos_t const seg_start = bounds[b];
+		samplepos_t const seg_end   = bounds[b + 1];
+
+		while (ei < ends.size () && ends[ei].first <= seg_start) {
+			active.erase (ends[ei++].second);
+		}
+		while (si < starts.size () && starts[si].first <= seg_start) {
+			active.insert (starts[si++].second);
+		}
+
+		/* top-down, up to the first opaque body that covers the segment */
+		to_read.clear ();
+		for (std::set<size_t>::const_iterator r = active.begin(); r != active.end(); ++r) {
+			to_read.push_back (all[*r]);
+			if (extents[*r].body_start <= seg_start && extents[*r].body_end >= seg_end) {
+				break;
+			}
+		}
+
+		if (to_read.empty ()) {
+			continue;
+		}
+
+		/* reads are done bottom-up */
+		std::reverse (to_read.begin(), to_read.end());
+
+		if (!plan->empty () && plan->back().end == seg_start && plan->back().regions == to_read) {
+			plan->back().end = seg_end;
+		} else {
+			plan->push_back (PlanSegment (seg_start, seg_end));
+			plan->back().regions = to_read;
+		}
+	}
+
+	DEBUG_TRACE (DEBUG::AudioPlayback, string_compose ("Playlist %1 built render plan with %2 segments for %3 regions\n", name(), plan->size(), all.size()));
+
+	_render_plan           = plan;
+	_render_plan_tempo_map = tmap;
+
+	return _render_plan;
+}
+
+void
+AudioPlaylist::invalidate_render_plan ()
+{
+	Glib::Threads::Mutex::Lock lm (_render_plan_lock);
+	_render_plan.reset ();
+}
+
+void
+AudioPlaylist::region_layout_invalidated ()
+{
+	invalidate_render_plan ();
+}
+
+void
+AudioPlaylist::prefetch (FileReadAhead& reader, timepos_t const & start, timecnt_t const & cnt)
+{
+	Playlist::RegionReadLock rl (this);
+
+	boost::shared_ptr<RegionList> all = regions_touched_locked (start, start + cnt);
+
+	samplepos_t const s = start.samples ();
+	samplepos_t const e = (start + cnt).samples ();
+
+	for (RegionList::const_iterator i = all->begin(); i != all->end(); ++i) {
+		boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (*i);
+
+		if (!ar || ar->muted ()) {
+			continue;
+		}
+
+		samplepos_t const rs = max (s, ar->position_sample ());
+		samplepos_t const re = min (e, ar->position_sample () + ar->length_samples ());
+
+		if (re <= rs) {
+			continue;
+		}
+
+		samplepos_t const source_pos = ar->start_sample () + (rs - ar->position_sample ());
+
+		for (uint32_t n = 0; n < ar->n_channels (); ++n) {
+			ar->audio_source (n)->queue_prefetch (reader, source_pos, re - rs);
+		}
+	}
+}
+
 void
 AudioPlaylist::dump () const
 {
@@ -369,6 +606,11 @@ AudioPlaylist::destroy_region (boost::shared_ptr<Region> region)
 bool
 AudioPlaylist::region_changed (const PropertyChange& what_changed, boost::shared_ptr<Region> region)
 {
+	/* layering, position, mute, opacity, fades: all of them change
+	 * what has to be read where.
+	 */
+	invalidate_render_plan ();
+
 	if (in_flush || in_set_state) {
 		return false;
 	}
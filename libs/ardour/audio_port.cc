@@ -40,6 +40,7 @@ AudioPort::AudioPort (const std::string& name, PortFlags flags)
 	: Port (name, DataType::AUDIO, flags)
 	, _buffer (new AudioBuffer (0))
 	, _data (0)
+	, _shared_input (0)
 {
 	assert (name.find_first_of (':') == string::npos);
 	_src.setup (resampler_quality ());
@@ -67,6 +68,9 @@ AudioPort::cycle_start (pframes_t nframes)
 
 	if (sends_output()) {
 		_buffer->prepare ();
+	} else if (_shared_input) {
+		/* resampled by another port with the same connections */
+		_src.reset ();
 	} else if (!externally_connected ()) {
 		/* ardour internal port, just silence input, don't resample */
 		_src.reset ();
@@ -142,6 +146,8 @@ AudioPort::get_audio_buffer (pframes_t nframes)
 
 	if (!externally_connected () || (0 != (flags() & TransportSyncPort))) {
 		addr = (Sample *) port_engine.get_buffer (_port_handle, nframes);
+	} else if (_shared_input) {
+		addr = &_shared_input->_data[_global_port_buffer_offset];
 	} else {
 		/* _data was read and resampled as necessary in ::cycle_start */
 		addr = &_data[_global_port_buffer_offset];
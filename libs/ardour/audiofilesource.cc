@@ -163,8 +163,11 @@ AudioFileSource::~AudioFileSource ()
 {
 	DEBUG_TRACE (DEBUG::Destruction, string_compose ("AudioFileSource destructor %1, removable? %2\n", _path, removable()));
 	if (removable()) {
+		unmap_peakfile ();
 		::g_unlink (_path.c_str());
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_pyramid_path ().c_str());
+		::g_unlink (amplitude_stats_path ().c_str());
 	}
 }
 
@@ -261,6 +264,9 @@ AudioFileSource::mark_streaming_write_completed (const WriterLock& lock)
 int
 AudioFileSource::move_dependents_to_trash()
 {
+	unmap_peakfile ();
+	::g_unlink (peak_pyramid_path ().c_str());
+	::g_unlink (amplitude_stats_path ().c_str());
 	return ::g_unlink (_peakpath.c_str());
 }
 
@@ -608,17 +608,12 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 	/* APPLY REGULAR GAIN CURVES AND SCALING TO mixdown_buffer */
 
 	if (envelope_active())  {
-		_envelope->curve().get_vector (timepos_t (internal_offset), timepos_t (internal_offset + to_read), gain_buffer, to_read);
+		_envelope->curve().get_block (timepos_t (internal_offset), timepos_t (internal_offset + to_read), gain_buffer, to_read);
 
 		if (_scale_amplitude != 1.0f) {
-			for (samplecnt_t n = 0; n < to_read; ++n) {
-				mixdown_buffer[n] *= gain_buffer[n] * _scale_amplitude;
-			}
-		} else {
-			for (samplecnt_t n = 0; n < to_read; ++n) {
-				mixdown_buffer[n] *= gain_buffer[n];
-			}
+			apply_gain_to_buffer (gain_buffer, to_read, _scale_amplitude);
 		}
+		apply_gain_vector (mixdown_buffer, gain_buffer, to_read);
 	} else if (_scale_amplitude != 1.0f) {
 		apply_gain_to_buffer (mixdown_buffer, to_read, _scale_amplitude);
 	}
@@ -634,6 +629,9 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 
 	if (fade_in_limit != 0) {
 
+		timepos_t const fade_start (internal_offset);
+		timepos_t const fade_end (internal_offset + fade_in_limit);
+
 		if (is_opaque) {
 			if (_inverse_fade_in) {
 
@@ -641,16 +639,17 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 				 * power), so we have to fetch it.
 				 */
 
-				_inverse_fade_in->curve().get_vector (timepos_t (internal_offset), timepos_t (internal_offset + fade_in_limit), gain_buffer, fade_in_limit);
+				_inverse_fade_in->curve().get_block (fade_start, fade_end, gain_buffer, fade_in_limit);
 
 				/* Fade the data from lower layers out */
-				for (samplecnt_t n = 0; n < fade_in_limit; ++n) {
-					buf[n] *= gain_buffer[n];
-				}
+				apply_gain_vector (buf, gain_buffer, fade_in_limit);
 
 				/* refill gain buffer with the fade in */
 
-				_fade_in->curve().get_vector (timepos_t (internal_offset), timepos_t (internal_offset + fade_in_limit), gain_buffer, fade_in_limit);
+				_fade_in->curve().get_block (fade_start, fade_end, gain_buffer, fade_in_limit);
+
+				/* Mix our newly-read data in, with the fade */
+				mix_buffers_with_gain_vector (buf, mixdown_buffer, gain_buffer, fade_in_limit);
 
 			} else {
 
@@ -658,19 +657,15 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 				 * in) for the fade out of lower layers
 				 */
 
-				_fade_in->curve().get_vector (timepos_t (internal_offset), timepos_t (internal_offset + fade_in_limit), gain_buffer, fade_in_limit);
+				_fade_in->curve().get_block (fade_start, fade_end, gain_buffer, fade_in_limit);
 
-				for (samplecnt_t n = 0; n < fade_in_limit; ++n) {
-					buf[n] *= 1 - gain_buffer[n];
-				}
+				crossfade_buffers (buf, mixdown_buffer, gain_buffer, fade_in_limit);
 			}
 		} else {
-			_fade_in->curve().get_vector (timepos_t (internal_offset), timepos_t (internal_offset + fade_in_limit), gain_buffer, fade_in_limit);
-		}
+			_fade_in->curve().get_block (fade_start, fade_end, gain_buffer, fade_in_limit);
 
-		/* Mix our newly-read data in, with the fade */
-		for (samplecnt_t n = 0; n < fade_in_limit; ++n) {
-			buf[n] += mixdown_buffer[n] * gain_buffer[n];
+			/* Mix our newly-read data in, with the fade */
+			mix_buffers_with_gain_vector (buf, mixdown_buffer, gain_buffer, fade_in_limit);
 		}
 	}
 
@@ -678,19 +673,28 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 
 		samplecnt_t const curve_offset = fade_interval_start - _fade_out->when(false).distance (len_as_tpos ()).samples();
 
+		timepos_t const fade_start (curve_offset);
+		timepos_t const fade_end (curve_offset + fade_out_limit);
+
+		Sample* const dst = buf + fade_out_offset;
+		Sample* const src = mixdown_buffer + fade_out_offset;
+
 		if (is_opaque) {
 			if (_inverse_fade_out) {
 
-				_inverse_fade_out->curve().get_vector (timepos_t (curve_offset), timepos_t (curve_offset + fade_out_limit), gain_buffer, fade_out_limit);
+				_inverse_fade_out->curve().get_block (fade_start, fade_end, gain_buffer, fade_out_limit);
 
 				/* Fade the data from lower levels in */
-				for (samplecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-					buf[m] *= gain_buffer[n];
-				}
+				apply_gain_vector (dst, gain_buffer, fade_out_limit);
 
 				/* fetch the actual fade out */
 
-				_fade_out->curve().get_vector (timepos_t (curve_offset), timepos_t (curve_offset + fade_out_limit), gain_buffer, fade_out_limit);
+				_fade_out->curve().get_block (fade_start, fade_end, gain_buffer, fade_out_limit);
+
+				/* Mix our newly-read data with whatever was already there,
+				   with the fade out applied to our data.
+				*/
+				mix_buffers_with_gain_vector (dst, src, gain_buffer, fade_out_limit);
 
 			} else {
 
@@ -699,21 +703,17 @@ AudioRegion::read_at (Sample *buf, Sample *mixdown_buffer, float *gain_buffer,
 				 * out) for the fade in of lower layers
 				 */
 
-				_fade_out->curve().get_vector (timepos_t (curve_offset), timepos_t (curve_offset + fade_out_limit), gain_buffer, fade_out_limit);
+				_fade_out->curve().get_block (fade_start, fade_end, gain_buffer, fade_out_limit);
 
-				for (samplecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-					buf[m] *= 1 - gain_buffer[n];
-				}
+				crossfade_buffers (dst, src, gain_buffer, fade_out_limit);
 			}
 		} else {
-			_fade_out->curve().get_vector (timepos_t (curve_offset), timepos_t (curve_offset + fade_out_limit), gain_buffer, fade_out_limit);
-		}
+			_fade_out->curve().get_block (fade_start, fade_end, gain_buffer, fade_out_limit);
 
-		/* Mix our newly-read data with whatever was already there,
-		   with the fade out applied to our data.
-		*/
-		for (samplecnt_t n = 0, m = fade_out_offset; n < fade_out_limit; ++n, ++m) {
-			buf[m] += mixdown_buffer[m] * gain_buffer[n];
+			/* Mix our newly-read data with whatever was already there,
+			   with the fade out applied to our data.
+			*/
+			mix_buffers_with_gain_vector (dst, src, gain_buffer, fade_out_limit);
 		}
 	}
 
@@ -795,33 +795,28 @@ AudioRegion::read_from_sources (SourceList const & srcs, samplecnt_t limit, Samp
 	return to_read;
 }
 
-XMLNode&
-AudioRegion::get_basic_state () const
+AudioRegion::StateCopy::StateCopy (AudioRegion const& r, bool basic)
+	: Region::StateCopy (r)
+	, _channels (r._sources.size())
 {
-	XMLNode& node (Region::state ());
-
-	node.set_property ("channels", (uint32_t)_sources.size());
-
-	return node;
-}
+	if (basic) {
+		return;
+	}
 
-XMLNode&
-AudioRegion::state () const
-{
-	XMLNode& node (get_basic_state());
 	XMLNode *child;
 
-	child = node.add_child ("Envelope");
+	child = new XMLNode ("Envelope");
+	_curves.push_back (child);
 
 	bool default_env = false;
 
 	// If there are only two points, the points are in the start of the region and the end of the region
 	// so, if they are both at 1.0f, that means the default region.
 
-	if (_envelope->size() == 2 &&
-	    _envelope->front()->value == GAIN_COEFF_UNITY &&
-	    _envelope->back()->value==GAIN_COEFF_UNITY) {
-		if (_envelope->front()->when == 0 && _envelope->back()->when == len_as_tpos ()) {
+	if (r._envelope->size() == 2 &&
+	    r._envelope->front()->value == GAIN_COEFF_UNITY &&
+	    r._envelope->back()->value==GAIN_COEFF_UNITY) {
+		if (r._envelope->front()->when == 0 && r._envelope->back()->when == r.len_as_tpos ()) {
 			default_env = true;
 		}
 	}
@@ -829,38 +824,79 @@ AudioRegion::state () const
 	if (default_env) {
 		child->set_property ("default", "yes");
 	} else {
-		child->add_child_nocopy (_envelope->get_state ());
+		child->add_child_nocopy (r._envelope->get_state ());
 	}
 
-	child = node.add_child (X_("FadeIn"));
+	child = new XMLNode (X_("FadeIn"));
+	_curves.push_back (child);
 
-	if (_default_fade_in) {
+	if (r._default_fade_in) {
 		child->set_property ("default", "yes");
 	} else {
-		child->add_child_nocopy (_fade_in->get_state ());
+		child->add_child_nocopy (r._fade_in->get_state ());
 	}
 
-	if (_inverse_fade_in) {
-		child = node.add_child (X_("InverseFadeIn"));
-		child->add_child_nocopy (_inverse_fade_in->get_state ());
+	if (r._inverse_fade_in) {
+		child = new XMLNode (X_("InverseFadeIn"));
+		_curves.push_back (child);
+		child->add_child_nocopy (r._inverse_fade_in->get_state ());
 	}
 
-	child = node.add_child (X_("FadeOut"));
+	child = new XMLNode (X_("FadeOut"));
+	_curves.push_back (child);
 
-	if (_default_fade_out) {
+	if (r._default_fade_out) {
 		child->set_property ("default", "yes");
 	} else {
-		child->add_child_nocopy (_fade_out->get_state ());
+		child->add_child_nocopy (r._fade_out->get_state ());
+	}
+
+	if (r._inverse_fade_out) {
+		child = new XMLNode (X_("InverseFadeOut"));
+		_curves.push_back (child);
+		child->add_child_nocopy (r._inverse_fade_out->get_state ());
+	}
+}
+
+AudioRegion::StateCopy::~StateCopy ()
+{
+	for (vector<XMLNode*>::iterator i = _curves.begin(); i != _curves.end(); ++i) {
+		delete *i;
 	}
+}
+
+XMLNode&
+AudioRegion::StateCopy::get_state () const
+{
+	XMLNode& node (Region::StateCopy::get_state ());
 
-	if (_inverse_fade_out) {
-		child = node.add_child (X_("InverseFadeOut"));
-		child->add_child_nocopy (_inverse_fade_out->get_state ());
+	node.set_property ("channels", _channels);
+
+	for (vector<XMLNode*>::const_iterator i = _curves.begin(); i != _curves.end(); ++i) {
+		node.add_child_copy (**i);
 	}
 
 	return node;
 }
 
+boost::shared_ptr<Region::StateCopy const>
+AudioRegion::state_copy () const
+{
+	return boost::shared_ptr<Region::StateCopy const> (new StateCopy (*this, false));
+}
+
+XMLNode&
+AudioRegion::get_basic_state () const
+{
+	return StateCopy (*this, true).get_state ();
+}
+
+XMLNode&
+AudioRegion::state () const
+{
+	return StateCopy (*this, false).get_state ();
+}
+
 int
 AudioRegion::_set_state (const XMLNode& node, int version, PropertyChange& what_changed, bool send)
 {
@@ -1430,6 +1466,26 @@ AudioRegion::maximum_amplitude (Progress* p) const
 	samplepos_t const fend = start_sample() + length_samples();
 	double maxamp = 0;
 
+	/* use the sources' amplitude statistics, if available */
+	{
+		uint32_t n;
+		for (n = 0; n < n_channels(); ++n) {
+			Sample peak;
+			double sum_of_squares;
+			if (audio_source (n)->amplitude_stats (fpos, fend - fpos, peak, sum_of_squares)) {
+				break;
+			}
+			maxamp = max (maxamp, (double) peak);
+		}
+		if (n == n_channels()) {
+			if (p) {
+				p->set_progress (1.0);
+			}
+			return maxamp;
+		}
+		maxamp = 0;
+	}
+
 	samplecnt_t const blocksize = 64 * 1024;
 	Sample buf[blocksize];
 
@@ -1482,6 +1538,26 @@ AudioRegion::rms (Progress* p) const
 		return 0;
 	}
 
+	/* use the sources' amplitude statistics, if available */
+	{
+		uint32_t c;
+		for (c = 0; c < n_chan; ++c) {
+			Sample peak;
+			double sum_of_squares;
+			if (audio_source (c)->amplitude_stats (fpos, fend - fpos, peak, sum_of_squares)) {
+				break;
+			}
+			rms += sum_of_squares;
+		}
+		if (c == n_chan) {
+			if (p) {
+				p->set_progress (1.0);
+			}
+			return sqrt (2. * rms / (double)((fend - fpos) * n_chan));
+		}
+		rms = 0;
+	}
+
 	while (fpos < fend) {
 		samplecnt_t const to_read = min (fend - fpos, blocksize);
 		for (uint32_t c = 0; c < n_chan; ++c) {
@@ -60,9 +60,11 @@
 #include "pbd/xml++.h"
 
 #include "ardour/audiosource.h"
+#include "ardour/filename_extensions.h"
 #include "ardour/rc_configuration.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/session.h"
+#include "ardour/source_factory.h"
 
 #include "pbd/i18n.h"
 
@@ -79,19 +81,31 @@ bool AudioSource::_build_peakfiles = false;
 
 #define _FPP 256
 
+/* Files derived from the audio data (peakfile, peak pyramid, amplitude
+ * statistics) are considered stale if they are older than the file they
+ * were derived from by more than this many seconds. The slop allows for
+ * various disk action "races" and coarse filesystem timestamps.
+ */
+static const time_t derived_file_mtime_slop = 6;
+
+std::atomic<uint64_t> AudioSource::_peak_mapped_reads (0);
+std::atomic<uint64_t> AudioSource::_peak_maps (0);
+
 AudioSource::AudioSource (Session& s, const string& name)
 	: Source (s, DataType::AUDIO, name)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
 	, _peakfile_fd (-1)
+	, _peak_pyramid (_FPP)
+	, _pyramid_pending (false)
+	, _amplitude_stats_pending (false)
+	, _amplitude_stats_tried (false)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
 	, peak_leftovers (0)
 	, peak_leftover_sample (0)
-	, _first_run (true)
-	, _last_scale (0.0)
-	, _last_map_off (0)
-	, _last_raw_map_length (0)
+	, _peak_map_addr (0)
+	, _peak_map_length (0)
 {
 }
 
@@ -100,14 +114,16 @@ AudioSource::AudioSource (Session& s, const XMLNode& node)
 	, _peak_byte_max (0)
 	, _peaks_built (false)
 	, _peakfile_fd (-1)
+	, _peak_pyramid (_FPP)
+	, _pyramid_pending (false)
+	, _amplitude_stats_pending (false)
+	, _amplitude_stats_tried (false)
 	, peak_leftover_cnt (0)
 	, peak_leftover_size (0)
 	, peak_leftovers (0)
 	, peak_leftover_sample (0)
-	, _first_run (true)
-	, _last_scale (0.0)
-	, _last_map_off (0)
-	, _last_raw_map_length (0)
+	, _peak_map_addr (0)
+	, _peak_map_length (0)
 {
 	if (set_state (node, Stateful::loading_state_version)) {
 		throw failed_constructor();
@@ -127,6 +143,8 @@ AudioSource::~AudioSource ()
 		_peakfile_fd = -1;
 	}
 
+	unmap_peakfile ();
+
 	delete [] peak_leftovers;
 }
 
@@ -217,6 +235,8 @@ AudioSource::rename_peakfile (string newpath)
 
 	string oldpath = _peakpath;
 
+	unmap_peakfile ();
+
 	if (Glib::file_test (oldpath, Glib::FILE_TEST_EXISTS)) {
 		if (g_rename (oldpath.c_str(), newpath.c_str()) != 0) {
 			error << string_compose (_("cannot rename peakfile for %1 from %2 to %3 (%4)"), _name, oldpath, newpath, strerror (errno)) << endmsg;
@@ -226,9 +246,47 @@ AudioSource::rename_peakfile (string newpath)
 
 	_peakpath = newpath;
 
+	string oldpyramid = _peak_pyramid.path ();
+	_peak_pyramid.set_path (peak_pyramid_path ());
+
+	if (!oldpyramid.empty () && Glib::file_test (oldpyramid, Glib::FILE_TEST_EXISTS)) {
+		if (g_rename (oldpyramid.c_str(), _peak_pyramid.path ().c_str()) != 0) {
+			/* not fatal, it will be rebuilt */
+			::g_unlink (oldpyramid.c_str());
+		}
+	}
+
+	string oldstats = _amplitude_stats.path ();
+	_amplitude_stats.set_path (amplitude_stats_path ());
+
+	if (!oldstats.empty () && Glib::file_test (oldstats, Glib::FILE_TEST_EXISTS)) {
+		if (g_rename (oldstats.c_str(), _amplitude_stats.path ().c_str()) != 0) {
+			/* not fatal either */
+			::g_unlink (oldstats.c_str());
+		}
+	}
+
 	return 0;
 }
 
+string
+AudioSource::amplitude_stats_path () const
+{
+	if (_peakpath.empty ()) {
+		return string ();
+	}
+	return _peakpath + amplitude_stats_suffix;
+}
+
+string
+AudioSource::peak_pyramid_path () const
+{
+	if (_peakpath.empty ()) {
+		return string ();
+	}
+	return _peakpath + peak_pyramid_suffix;
+}
+
 int
 AudioSource::initialize_peakfile (const string& audio_path, const bool in_session)
 {
@@ -236,6 +294,8 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 	GStatBuf statbuf;
 
 	_peakpath = construct_peak_filepath (audio_path, in_session);
+	_peak_pyramid.set_path (peak_pyramid_path ());
+	_amplitude_stats.set_path (amplitude_stats_path ());
 
 	if (!empty() && !Glib::file_test (_peakpath.c_str(), Glib::FILE_TEST_EXISTS)) {
 		string oldpeak = construct_peak_filepath (audio_path, in_session, true);
@@ -285,11 +345,7 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 
 			} else {
 
-				/* allow 6 seconds slop on checking peak vs. file times because of various
-				   disk action "races"
-				*/
-
-				if (stat_file.st_mtime > statbuf.st_mtime && (stat_file.st_mtime - statbuf.st_mtime > 6)) {
+				if (stat_file.st_mtime > statbuf.st_mtime && (stat_file.st_mtime - statbuf.st_mtime > derived_file_mtime_slop)) {
 					_peaks_built = false;
 					_peak_byte_max = 0;
 				} else {
@@ -302,11 +358,67 @@ AudioSource::initialize_peakfile (const string& audio_path, const bool in_sessio
 
 	if (!empty() && !_peaks_built && _build_missing_peakfiles && _build_peakfiles) {
 		build_peaks_from_scratch ();
+	} else if (!empty() && _peaks_built && _build_peakfiles) {
+		/* migrate peakfiles that were written without a pyramid, or
+		 * modified by a version that does not update it.
+		 */
+		GStatBuf stat_pyramid;
+		if (g_stat (_peak_pyramid.path ().c_str(), &stat_pyramid) != 0
+		    || stat_pyramid.st_mtime + derived_file_mtime_slop < statbuf.st_mtime
+		    || !_peak_pyramid.valid (_peak_byte_max / sizeof (PeakData))) {
+			DEBUG_TRACE(DEBUG::Peaks, string_compose("Queue peak pyramid build for %1\n", _peakpath));
+			_pyramid_pending = true;
+			queue_peak_data ();
+		}
+
+		/* amplitude statistics need the audio data, they are
+		 * built when first used (see ::amplitude_stats()).
+		 */
+		GStatBuf stat_stats;
+		if (g_stat (_amplitude_stats.path ().c_str(), &stat_stats) == 0 && stat_stats.st_mtime + derived_file_mtime_slop < statbuf.st_mtime) {
+			::g_unlink (_amplitude_stats.path ().c_str());
+		}
 	}
 
 	return 0;
 }
 
+void
+AudioSource::queue_peak_data ()
+{
+	boost::shared_ptr<AudioSource> as;
+	try {
+		as = boost::dynamic_pointer_cast<AudioSource> (shared_from_this ());
+	} catch (boost::bad_weak_ptr&) {
+	}
+
+	/* sources are only set up once they are managed by a shared_ptr.
+	 * Otherwise the data remains pending, and readers use the peakfile.
+	 */
+	if (as) {
+		SourceFactory::queue_peak_data (as);
+	}
+}
+
+void
+AudioSource::build_peak_data ()
+{
+	Glib::Threads::Mutex::Lock lm (_initialize_peaks_lock);
+
+	/* if peaks are being written, done_with_peakfile_writes() queues this again */
+	if (_pyramid_pending && _peakfile_fd == -1) {
+		/* this only reads the peakfile, there is no need to hold _lock */
+		DEBUG_TRACE(DEBUG::Peaks, string_compose("Building peak pyramid for %1\n", _peakpath));
+		_peak_pyramid.build_from (_peakpath);
+		_pyramid_pending = false;
+	}
+
+	if (_amplitude_stats_pending) {
+		build_amplitude_stats ();
+		_amplitude_stats_pending = false;
+	}
+}
+
 samplecnt_t
 AudioSource::read (Sample *dst, samplepos_t start, samplecnt_t cnt, int /*channel*/) const
 {
@@ -338,6 +450,151 @@ AudioSource::read_peaks (PeakData *peaks, samplecnt_t npeaks, samplepos_t start,
 	return read_peaks_with_fpp (peaks, npeaks, start, cnt, samples_per_visual_peak, _FPP);
 }
 
+/** Add the absolute peak and sum of squares of [start, start + cnt) to
+ * \p peak and \p sum_of_squares. _lock MUST be held by caller.
+ */
+int
+AudioSource::read_amplitude (samplepos_t start, samplecnt_t cnt, Sample& peak, double& sum_of_squares) const
+{
+	const samplecnt_t bufsize = AmplitudeStats::block_size;
+	Sample buf[bufsize];
+
+	while (cnt > 0) {
+		samplecnt_t const n = min (cnt, bufsize);
+
+		if (read_unlocked (buf, start, n) != n) {
+			return -1;
+		}
+
+		peak = compute_peak (buf, n, peak);
+
+		double sum = 0;
+		for (samplecnt_t i = 0; i < n; ++i) {
+			sum += buf[i] * buf[i];
+		}
+		sum_of_squares += sum;
+
+		start += n;
+		cnt   -= n;
+	}
+
+	return 0;
+}
+
+/** Build amplitude statistics from the audio data. This reads the
+ * whole source, and is called on a peak-building thread. _lock is
+ * only held while reading each chunk, so that the butler is not stalled.
+ */
+int
+AudioSource::build_amplitude_stats ()
+{
+	{
+		Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+
+		/* peaks (and statistics) are being written, see ::done_with_peakfile_writes() */
+		if (_amplitude_stats.path ().empty () || _amplitude_stats.writing () || _peakfile_fd != -1) {
+			return -1;
+		}
+
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Building amplitude statistics %1\n", _amplitude_stats.path ()));
+
+		if (_amplitude_stats.open_for_write ()) {
+			return -1;
+		}
+	}
+
+	const samplecnt_t bufsize = 65536;
+	boost::scoped_array<Sample> buf (new Sample[bufsize]);
+	samplecnt_t const len = _length.samples ();
+	int ret = 0;
+
+	for (samplepos_t pos = 0; pos < len; ) {
+		samplecnt_t const n = min (bufsize, len - pos);
+		samplecnt_t       n_read;
+
+		{
+			/* reads need exclusive access, see AudioSource::read() */
+			WriterLock lm (_lock);
+			n_read = read_unlocked (buf.get (), pos, n);
+		}
+
+		Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+
+		if (n_read != n || _amplitude_stats.add (buf.get (), n, pos)) {
+			ret = -1;
+			break;
+		}
+		pos += n;
+	}
+
+	Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+
+	_amplitude_stats.close ();
+
+	if (ret || !_amplitude_stats.valid (len)) {
+		::g_unlink (_amplitude_stats.path ().c_str ());
+		return -1;
+	}
+
+	return 0;
+}
+
+int
+AudioSource::amplitude_stats (samplepos_t start, samplecnt_t cnt, Sample& peak, double& sum_of_squares) const
+{
+	peak           = 0;
+	sum_of_squares = 0;
+
+	samplecnt_t const len = _length.samples ();
+
+	if (cnt <= 0 || start < 0 || start + cnt > len) {
+		return -1;
+	}
+
+	samplecnt_t const bs  = AmplitudeStats::block_size;
+	samplepos_t const end = start + cnt;
+
+	/* whole blocks in the range. The last block of the source may be partial */
+	samplecnt_t const first_block = (start + bs - 1) / bs;
+	samplecnt_t const end_block   = (end == len) ? (len + bs - 1) / bs : end / bs;
+
+	if (end_block > first_block) {
+		Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+
+		if (!_amplitude_stats.valid (len)) {
+			/* Build the statistics in the background (once), and let the
+			 * caller read the audio data directly meanwhile.
+			 */
+			if (!_amplitude_stats_tried.exchange (true)) {
+				_amplitude_stats_pending = true;
+				const_cast<AudioSource*> (this)->queue_peak_data ();
+			}
+			return -1;
+		}
+
+		if (_amplitude_stats.read (first_block, end_block - first_block, peak, sum_of_squares)) {
+			return -1;
+		}
+	}
+
+	/* edge reads need exclusive access, see AudioSource::read() */
+	WriterLock lm (_lock);
+
+	if (end_block <= first_block) {
+		return read_amplitude (start, cnt, peak, sum_of_squares);
+	}
+
+	if (first_block * bs > start && read_amplitude (start, first_block * bs - start, peak, sum_of_squares)) {
+		return -1;
+	}
+
+	if (end_block * bs < end && read_amplitude (end_block * bs, end - end_block * bs, peak, sum_of_squares)) {
+		return -1;
+	}
+
+	return 0;
+}
+
 /** @param peaks Buffer to write peak data.
  *  @param npeaks Number of peaks to write.
  */
@@ -346,7 +603,11 @@ int
 AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos_t start, samplecnt_t cnt,
 				  double samples_per_visual_peak, samplecnt_t samples_per_file_peak) const
 {
-	WriterLock lm (_lock);
+	/* peak data is read from the shared peakfile mapping, which allows
+	 * concurrent readers. Only the raw data paths need exclusive access,
+	 * see AudioSource::read()
+	 */
+	ReaderLock lm (_lock);
 
 #if 0 // DEBUG ONLY
 	/* Bypass peak-file cache, compute peaks using raw data from source */
@@ -394,23 +655,10 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 	PeakData::PeakDatum xmax;
 	PeakData::PeakDatum xmin;
 	int32_t to_read;
-#ifdef PLATFORM_WINDOWS
-	SYSTEM_INFO system_info;
-        GetSystemInfo (&system_info);
-	const int bufsize = system_info.dwAllocationGranularity;;
-#else
-	const int bufsize = sysconf(_SC_PAGESIZE);
-#endif
 	samplecnt_t read_npeaks = npeaks;
 	samplecnt_t zero_fill = 0;
 
-	GStatBuf statbuf;
-
 	expected_peaks = (cnt / (double) samples_per_file_peak);
-	if (g_stat (_peakpath.c_str(), &statbuf) != 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for size check (%2)"), _peakpath, strerror (errno)) << endmsg;
-		return -1;
-	}
 
 	if (!_captured_for.empty()) {
 
@@ -428,28 +676,21 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 
 		const off_t expected_file_size = (_length.samples() / (double) samples_per_file_peak) * sizeof (PeakData);
 
-		if (statbuf.st_size < expected_file_size) {
-			warning << string_compose (_("peak file %1 is truncated from %2 to %3"), _peakpath, expected_file_size, statbuf.st_size) << endmsg;
+		/* _peak_byte_max is the size of the peakfile when it was
+		 * initialized, or the size of the data written to it since.
+		 */
+		if (_peak_byte_max < expected_file_size) {
+			warning << string_compose (_("peak file %1 is truncated from %2 to %3"), _peakpath, expected_file_size, _peak_byte_max) << endmsg;
 			lm.release(); // build_peaks_from_scratch() takes _lock
 			const_cast<AudioSource*>(this)->build_peaks_from_scratch ();
 			lm.acquire ();
-			if (g_stat (_peakpath.c_str(), &statbuf) != 0) {
-				error << string_compose (_("Cannot open peakfile @ %1 for size check (%2) after rebuild"), _peakpath, strerror (errno)) << endmsg;
-			}
-			if (statbuf.st_size < expected_file_size) {
+			if (_peak_byte_max < expected_file_size) {
 				fatal << "peak file is still truncated after rebuild" << endmsg;
 				abort (); /*NOTREACHED*/
 			}
 		}
 	}
 
-	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
-
-	if (sfd < 0) {
-		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
-		return -1;
-	}
-
 	scale = npeaks/expected_peaks;
 
 
@@ -469,12 +710,31 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 
 	assert (cnt >= 0);
 
+	/* when zoomed out, use the coarsest level of the peak pyramid that
+	 * still has at least one stored peak per visual peak.
+	 */
+	uint32_t level = 0;
+
+	if (scale < 1.0 && samples_per_file_peak == _FPP && !_pyramid_pending) {
+		level = _peak_pyramid.level_for (samples_per_visual_peak, start + cnt);
+	}
+
+	if (level > 0) {
+		samples_per_file_peak = _peak_pyramid.samples_per_peak (level);
+		expected_peaks = (cnt / (double) samples_per_file_peak);
+		scale = npeaks/expected_peaks;
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("using peak pyramid level %1, %2 samples per peak\n", level, samples_per_file_peak));
+	}
+
 	// cerr << "actual npeaks = " << read_npeaks << " zf = " << zero_fill << endl;
 
 	if (npeaks == cnt) {
 
 		DEBUG_TRACE (DEBUG::Peaks, "RAW DATA\n");
 
+		lm.release ();
+		WriterLock lw (_lock);
+
 		/* no scaling at all, just get the sample data and duplicate it for
 		   both max and min peak values.
 		*/
@@ -494,75 +754,24 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		return 0;
 	}
 
-	if (scale == 1.0) {
+	if (scale == 1.0 && level == 0) {
 		off_t first_peak_byte = (start / samples_per_file_peak) * sizeof (PeakData);
 		size_t bytes_to_read = sizeof (PeakData) * read_npeaks;
-		/* open, read, close */
 
 		DEBUG_TRACE (DEBUG::Peaks, "DIRECT PEAKS\n");
 
-		off_t  map_off =  first_peak_byte;
-		off_t  read_map_off = map_off & ~(bufsize - 1);
-		off_t  map_delta = map_off - read_map_off;
-		size_t map_length = bytes_to_read + map_delta;
-
-		if (_first_run  || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length  < bytes_to_read)) {
-			peak_cache.reset (new PeakData[npeaks]);
-			char* addr;
-#ifdef PLATFORM_WINDOWS
-			HANDLE file_handle = (HANDLE) _get_osfhandle(int(sfd));
-			HANDLE map_handle;
-			LPVOID view_handle;
-			bool err_flag;
-
-			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
-			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			addr = (char*) view_handle;
-
-			memcpy ((void*)peak_cache.get(), (void*)(addr + map_delta), bytes_to_read);
-
-			err_flag = UnmapViewOfFile (view_handle);
-			err_flag = CloseHandle(map_handle);
-			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-#else
-			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
-			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			memcpy ((void*)peak_cache.get(), (void*)(addr + map_delta), bytes_to_read);
-			munmap (addr, map_length);
-#endif
-			if (zero_fill) {
-				memset (&peak_cache[read_npeaks], 0, sizeof (PeakData) * zero_fill);
-			}
-
-			_first_run = false;
-			_last_scale = samples_per_visual_peak;
-			_last_map_off = map_off;
-			_last_raw_map_length = bytes_to_read;
+		if (read_peakfile (peaks, first_peak_byte, bytes_to_read)) {
+			return -1;
 		}
 
-		memcpy ((void*)peaks, (void*)peak_cache.get(), npeaks * sizeof(PeakData));
+		if (zero_fill) {
+			memset (&peaks[read_npeaks], 0, sizeof (PeakData) * zero_fill);
+		}
 
 		return 0;
 	}
 
-	if (scale < 1.0) {
+	if (scale < 1.0 || level > 0) {
 
 		DEBUG_TRACE (DEBUG::Peaks, "DOWNSAMPLE\n");
 
@@ -591,92 +800,47 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 
 		current_stored_peak = min (current_stored_peak, stored_peak_before_next_visual_peak);
 
-		/* open ... close during out: handling */
-
 		off_t  map_off =  (uint32_t) (ceil (start / (double) samples_per_file_peak)) * sizeof(PeakData);
-		off_t  read_map_off = map_off & ~(bufsize - 1);
-		off_t  map_delta = map_off - read_map_off;
 		size_t raw_map_length = chunksize * sizeof(PeakData);
-		size_t map_length = (chunksize * sizeof(PeakData)) + map_delta;
 
-		if (_first_run || (_last_scale != samples_per_visual_peak) || (_last_map_off != map_off) || (_last_raw_map_length < raw_map_length)) {
-			peak_cache.reset (new PeakData[npeaks]);
-			boost::scoped_array<PeakData> staging (new PeakData[chunksize]);
+		boost::scoped_array<PeakData> staging (new PeakData[chunksize]);
 
-			char* addr;
-#ifdef PLATFORM_WINDOWS
-			HANDLE file_handle =  (HANDLE) _get_osfhandle(int(sfd));
-			HANDLE map_handle;
-			LPVOID view_handle;
-			bool err_flag;
-
-			map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
-			if (map_handle == NULL) {
-				error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
+		if (level > 0) {
+			if (_peak_pyramid.read (level, staging.get(), map_off / sizeof (PeakData), chunksize)) {
+				error << string_compose (_("could not read peak pyramid %1."), _peak_pyramid.path ()) << endmsg;
 				return -1;
 			}
+		} else if (read_peakfile (staging.get(), map_off, raw_map_length)) {
+			return -1;
+		}
 
-			view_handle = MapViewOfFile(map_handle, FILE_MAP_READ, 0, read_map_off, map_length);
-			if (view_handle == NULL) {
-				error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
+		while (nvisual_peaks < read_npeaks) {
 
-			addr = (char *) view_handle;
+			xmax = -1.0;
+			xmin = 1.0;
 
-			memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
+			while ((current_stored_peak <= stored_peak_before_next_visual_peak) && (i < chunksize)) {
 
-			err_flag = UnmapViewOfFile (view_handle);
-			err_flag = CloseHandle(map_handle);
-			if(!err_flag) {
-				error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
+				xmax = max (xmax, staging[i].max);
+				xmin = min (xmin, staging[i].min);
+				++i;
+				++current_stored_peak;
 			}
-#else
-			addr = (char*) mmap (0, map_length, PROT_READ, MAP_PRIVATE, sfd, read_map_off);
-			if (addr ==  MAP_FAILED) {
-				error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
-				return -1;
-			}
-
-			memcpy ((void*)staging.get(), (void*)(addr + map_delta), raw_map_length);
-			munmap (addr, map_length);
-#endif
-			while (nvisual_peaks < read_npeaks) {
-
-				xmax = -1.0;
-				xmin = 1.0;
-
-				while ((current_stored_peak <= stored_peak_before_next_visual_peak) && (i < chunksize)) {
 
-					xmax = max (xmax, staging[i].max);
-					xmin = min (xmin, staging[i].min);
-					++i;
-					++current_stored_peak;
-				}
-
-				peak_cache[nvisual_peaks].max = xmax;
-				peak_cache[nvisual_peaks].min = xmin;
-				++nvisual_peaks;
-				next_visual_peak_sample = min ((double) start + cnt, (next_visual_peak_sample + samples_per_visual_peak));
-				stored_peak_before_next_visual_peak = (uint32_t) next_visual_peak_sample / samples_per_file_peak;
-			}
+			peaks[nvisual_peaks].max = xmax;
+			peaks[nvisual_peaks].min = xmin;
+			++nvisual_peaks;
+			next_visual_peak_sample = min ((double) start + cnt, (next_visual_peak_sample + samples_per_visual_peak));
+			stored_peak_before_next_visual_peak = (uint32_t) next_visual_peak_sample / samples_per_file_peak;
+		}
 
-			if (zero_fill) {
+		if (zero_fill) {
 #ifndef NDEBUG
-				cerr << "Zero fill '" << _name << "' end of peaks (@ " << read_npeaks << " with " << zero_fill << ")" << endl;
+			cerr << "Zero fill '" << _name << "' end of peaks (@ " << read_npeaks << " with " << zero_fill << ")" << endl;
 #endif
-				memset (&peak_cache[read_npeaks], 0, sizeof (PeakData) * zero_fill);
-			}
-
-			_first_run = false;
-			_last_scale = samples_per_visual_peak;
-			_last_map_off = map_off;
-			_last_raw_map_length = raw_map_length;
+			memset (&peaks[read_npeaks], 0, sizeof (PeakData) * zero_fill);
 		}
 
-		memcpy ((void*)peaks, (void*)peak_cache.get(), npeaks * sizeof(PeakData));
-
 	} else {
 		DEBUG_TRACE (DEBUG::Peaks, "UPSAMPLE\n");
 
@@ -689,6 +853,9 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 		 * data on the fly.
 		*/
 
+		lm.release ();
+		WriterLock lw (_lock);
+
 		samplecnt_t samples_read = 0;
 		samplepos_t current_sample = start;
 		samplecnt_t i = 0;
@@ -763,6 +930,164 @@ AudioSource::read_peaks_with_fpp (PeakData *peaks, samplecnt_t npeaks, samplepos
 	return 0;
 }
 
+/** (Re)map the peakfile. _peak_map_lock must be held as writer. */
+int
+AudioSource::map_peakfile () const
+{
+	GStatBuf statbuf;
+
+	if (g_stat (_peakpath.c_str(), &statbuf) != 0 || statbuf.st_size == 0) {
+		error << string_compose (_("Cannot open peakfile @ %1 for size check (%2)"), _peakpath, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	size_t length = statbuf.st_size;
+
+	if (_peak_map_addr && length == _peak_map_length) {
+		return 0;
+	}
+
+	ScopedFileDescriptor sfd (g_open (_peakpath.c_str(), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		error << string_compose (_("Cannot open peakfile @ %1 for reading (%2)"), _peakpath, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	char* addr;
+#ifdef PLATFORM_WINDOWS
+	HANDLE file_handle = (HANDLE) _get_osfhandle(int(sfd));
+	HANDLE map_handle;
+
+	map_handle = CreateFileMapping(file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (map_handle == NULL) {
+		error << string_compose (_("map failed - could not create file mapping for peakfile %1."), _peakpath) << endmsg;
+		return -1;
+	}
+
+	/* the view keeps the mapping object alive */
+	addr = (char*) MapViewOfFile(map_handle, FILE_MAP_READ, 0, 0, length);
+	CloseHandle (map_handle);
+
+	if (addr == NULL) {
+		error << string_compose (_("map failed - could not map peakfile %1."), _peakpath) << endmsg;
+		return -1;
+	}
+#else
+	/* shared, so that data written to the file later is visible */
+	addr = (char*) mmap (0, length, PROT_READ, MAP_SHARED, sfd, 0);
+	if (addr == MAP_FAILED) {
+		error << string_compose (_("map failed - could not mmap peakfile %1."), _peakpath) << endmsg;
+		return -1;
+	}
+#endif
+
+	if (_peak_map_addr) {
+#ifdef PLATFORM_WINDOWS
+		UnmapViewOfFile (_peak_map_addr);
+#else
+		munmap (_peak_map_addr, _peak_map_length);
+#endif
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Mapped peakfile %1, %2 bytes\n", _peakpath, length));
+
+	_peak_map_addr   = addr;
+	_peak_map_length = length;
+	++_peak_maps;
+
+	return 0;
+}
+
+void
+AudioSource::unmap_peakfile () const
+{
+	Glib::Threads::RWLock::WriterLock lm (_peak_map_lock);
+
+	if (!_peak_map_addr) {
+		return;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	if (!UnmapViewOfFile (_peak_map_addr)) {
+		error << string_compose (_("unmap failed - could not unmap peakfile %1."), _peakpath) << endmsg;
+	}
+#else
+	munmap (_peak_map_addr, _peak_map_length);
+#endif
+
+	_peak_map_addr   = 0;
+	_peak_map_length = 0;
+}
+
+/** Copy peak data from the shared mapping of the peakfile, (re)mapping
+ * it if needed. Data beyond the end of the file is zero-filled.
+ */
+int
+AudioSource::read_peakfile (PeakData* dst, off_t offset, size_t n_bytes) const
+{
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_peak_map_lock);
+		if (_peak_map_addr && offset + n_bytes <= _peak_map_length) {
+			memcpy ((void*) dst, (void*) (_peak_map_addr + offset), n_bytes);
+			++_peak_mapped_reads;
+			return 0;
+		}
+	}
+
+	/* not mapped yet, or the file has grown (capture) */
+	Glib::Threads::RWLock::WriterLock lm (_peak_map_lock);
+
+	if (!_peak_map_addr || offset + n_bytes > _peak_map_length) {
+		if (map_peakfile ()) {
+			return -1;
+		}
+	}
+
+	size_t avail = offset < (off_t) _peak_map_length ? min (n_bytes, _peak_map_length - offset) : 0;
+
+	if (avail > 0) {
+		memcpy ((void*) dst, (void*) (_peak_map_addr + offset), avail);
+	}
+	if (avail < n_bytes) {
+		memset ((char*) dst + avail, 0, n_bytes - avail);
+	}
+
+	++_peak_mapped_reads;
+	return 0;
+}
+
+AudioSource::PeakReadStats
+AudioSource::peak_read_stats ()
+{
+	PeakReadStats s;
+	uint64_t const pf_reads = _peak_mapped_reads;
+	uint64_t const pf_maps  = _peak_maps;
+	uint64_t const pp_reads = PeakPyramid::mapped_reads ();
+	uint64_t const pp_maps  = PeakPyramid::maps ();
+
+	s.mapped_reads  = pf_reads + pp_reads;
+	s.maps          = pf_maps + pp_maps;
+	s.pyramid_reads = pp_reads;
+
+	/* without the mapping, every peakfile read did stat, open, mmap, munmap
+	 * and close. A (re)map costs stat, open, mmap, close and eventually a munmap.
+	 * Every pyramid read did open, lseek, read and close twice (header
+	 * lookup and data), plus another lseek and read for the data.
+	 */
+	s.syscalls_avoided  = pf_reads > pf_maps ? 5 * (pf_reads - pf_maps) : 0;
+	s.syscalls_avoided += pp_reads > pp_maps ? 10 * (pp_reads - pp_maps) : 0;
+	return s;
+}
+
+void
+AudioSource::reset_peak_read_stats ()
+{
+	_peak_mapped_reads = 0;
+	_peak_maps         = 0;
+	PeakPyramid::reset_stats ();
+}
+
 int
 AudioSource::build_peaks_from_scratch ()
 {
@@ -831,6 +1156,7 @@ AudioSource::build_peaks_from_scratch ()
   out:
 	if (ret) {
 		DEBUG_TRACE (DEBUG::Peaks, string_compose("Could not write peak data, attempting to remove peakfile %1\n", _peakpath));
+		unmap_peakfile ();
 		::g_unlink (_peakpath.c_str());
 	}
 
@@ -845,8 +1171,17 @@ AudioSource::close_peakfile ()
 		close (_peakfile_fd);
 		_peakfile_fd = -1;
 	}
+	_peak_pyramid.close ();
+	_peak_pyramid.unmap ();
+	{
+		Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+		_amplitude_stats.close ();
+	}
+	unmap_peakfile ();
 	if (!_peakpath.empty()) {
 		::g_unlink (_peakpath.c_str());
+		::g_unlink (peak_pyramid_path ().c_str());
+		::g_unlink (amplitude_stats_path ().c_str());
 	}
 	_peaks_built = false;
 	return 0;
@@ -863,6 +1198,15 @@ AudioSource::prepare_for_peakfile_writes ()
 		error << string_compose(_("AudioSource: cannot open _peakpath (c) \"%1\" (%2)"), _peakpath, strerror (errno)) << endmsg;
 		return -1;
 	}
+
+	/* not fatal, readers fall back to the peakfile */
+	_peak_pyramid.open_for_write ();
+	/* not fatal either, see ::amplitude_stats() */
+	{
+		Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+		_amplitude_stats.open_for_write ();
+	}
+
 	return 0;
 }
 
@@ -874,6 +1218,11 @@ AudioSource::done_with_peakfile_writes (bool done)
 			close (_peakfile_fd);
 			_peakfile_fd = -1;
 		}
+		_peak_pyramid.close ();
+		{
+			Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+			_amplitude_stats.close ();
+		}
 		return;
 	}
 
@@ -886,6 +1235,21 @@ AudioSource::done_with_peakfile_writes (bool done)
 		_peakfile_fd = -1;
 	}
 
+	bool const rebuild_pyramid = done && (_peak_pyramid.stale () || _pyramid_pending);
+	_peak_pyramid.close ();
+
+	if (rebuild_pyramid) {
+		/* peaks were not written in order, or a build was skipped */
+		_pyramid_pending = true;
+		queue_peak_data ();
+	}
+	/* stale statistics are invalid, and rebuilt when needed */
+	{
+		Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+		_amplitude_stats.close ();
+	}
+	_amplitude_stats_tried = false;
+
 	if (done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		_peaks_built = true;
@@ -921,6 +1285,11 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 		}
 	}
 
+	if (buf && cnt > 0 && fpp == _FPP) {
+		Glib::Threads::Mutex::Lock ls (_amplitude_stats_lock);
+		_amplitude_stats.add (buf, cnt, first_sample);
+	}
+
   restart:
 	if (peak_leftover_cnt) {
 
@@ -952,6 +1321,10 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 
 			_peak_byte_max = max (_peak_byte_max, (off_t) (byte + sizeof(PeakData)));
 
+			if (fpp == _FPP) {
+				_peak_pyramid.add (&x, 1, peak_leftover_sample / fpp);
+			}
+
 			{
 				Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 				PeakRangeReady (peak_leftover_sample, peak_leftover_cnt); /* EMIT SIGNAL */
@@ -1080,6 +1453,13 @@ AudioSource::compute_and_write_peaks (Sample* buf, samplecnt_t first_sample, sam
 
 	_peak_byte_max = max (_peak_byte_max, (off_t) (first_peak_byte + bytes_to_write));
 
+	if (fpp == _FPP && peaks_computed > 0) {
+		_peak_pyramid.add (peakbuf.get(), peaks_computed, first_sample / fpp);
+		if (intermediate_peaks_ready) {
+			_peak_pyramid.flush ();
+		}
+	}
+
 	if (samples_done) {
 		Glib::Threads::Mutex::Lock lm (_peaks_ready_lock);
 		PeakRangeReady (first_sample, samples_done); /* EMIT SIGNAL */
@@ -1106,6 +1486,8 @@ AudioSource::truncate_peakfile ()
 
 	if (end > _peak_byte_max) {
 		DEBUG_TRACE(DEBUG::Peaks, string_compose ("Truncating Peakfile  %1\n", _peakpath));
+		/* accessing a mapping beyond the end of the file is fatal */
+		unmap_peakfile ();
 		if (ftruncate (_peakfile_fd, _peak_byte_max)) {
 			error << string_compose (_("could not truncate peakfile %1 to %2 (error: %3)"),
 						 _peakpath, _peak_byte_max, errno) << endmsg;
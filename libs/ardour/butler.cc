@@ -20,6 +20,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <errno.h>
 #include <fcntl.h>
 #include <unistd.h>
@@ -39,6 +40,7 @@
 #include "ardour/debug.h"
 #include "ardour/disk_io.h"
 #include "ardour/disk_reader.h"
+#include "ardour/file_read_ahead.h"
 #include "ardour/io.h"
 #include "ardour/session.h"
 #include "ardour/track.h"
@@ -59,8 +61,14 @@ Butler::Butler (Session& s)
 	, _midi_buffer_size (0)
 	, pool_trash (16)
 	, _xthread (true)
+	, _io_work_sem ("butler_io_work", 0)
+	, _io_done_sem ("butler_io_done", 0)
+	, _io_task (Refill)
+	, _prefetch (0)
 {
 	g_atomic_int_set (&should_do_transport_work, 0);
+	g_atomic_int_set (&_io_quit, 0);
+	g_atomic_int_set (&_io_next, 0);
 	SessionEvent::pool->set_trash (&pool_trash);
 
 	/* catch future changes to parameters */
@@ -144,6 +152,12 @@ Butler::start_thread ()
 	//pthread_detach (thread);
 	have_thread = true;
 
+	start_io_threads ();
+
+	if (Config->get_disk_read_queue_depth () > 0) {
+		_prefetch = new FileReadAhead (Config->get_disk_read_queue_depth ());
+	}
+
 	// we are ready to request buffer adjustments
 	_session.adjust_capture_buffering ();
 	_session.adjust_playback_buffering ();
@@ -159,9 +173,47 @@ Butler::terminate_thread ()
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1: ask butler to quit @ %2\n", DEBUG_THREAD_SELF, g_get_monotonic_time ()));
 		queue_request (Request::Quit);
 		pthread_join (thread, &status);
+		terminate_io_threads ();
+		delete _prefetch;
+		_prefetch = 0;
 	}
 }
 
+void
+Butler::start_io_threads ()
+{
+	/* the butler thread itself is one of them */
+	uint32_t n_threads = std::max<uint32_t> (1, Config->get_butler_io_threads ());
+
+	g_atomic_int_set (&_io_quit, 0);
+
+	for (uint32_t i = 1; i < n_threads; ++i) {
+		pthread_t t;
+		if (pthread_create_and_store (string_compose ("butler io %1", i), &t, _io_thread_work, this)) {
+			error << _("Session: could not create butler I/O thread") << endmsg;
+			break;
+		}
+		_io_threads.push_back (t);
+	}
+}
+
+void
+Butler::terminate_io_threads ()
+{
+	g_atomic_int_set (&_io_quit, 1);
+
+	for (size_t i = 0; i < _io_threads.size (); ++i) {
+		_io_work_sem.signal ();
+	}
+
+	for (auto const& t : _io_threads) {
+		void* status;
+		pthread_join (t, &status);
+	}
+
+	_io_threads.clear ();
+}
+
 void*
 Butler::_thread_work (void* arg)
 {
@@ -170,12 +222,39 @@ Butler::_thread_work (void* arg)
 	return ((Butler*)arg)->thread_work ();
 }
 
+void*
+Butler::_io_thread_work (void* arg)
+{
+	SessionEvent::create_per_thread_pool ("butler io events", 64);
+	pthread_set_name (X_("butler io"));
+	return ((Butler*)arg)->io_thread_work ();
+}
+
+void*
+Butler::io_thread_work ()
+{
+	DiskReader::allocate_thread_working_buffers ();
+
+	while (true) {
+		_io_work_sem.wait ();
+
+		if (g_atomic_int_get (&_io_quit)) {
+			break;
+		}
+
+		Temporal::TempoMap::fetch ();
+		io_work ();
+		_io_done_sem.signal ();
+	}
+
+	return 0;
+}
+
 void*
 Butler::thread_work ()
 {
 	uint32_t            err                   = 0;
 	bool                disk_work_outstanding = false;
-	RouteList::iterator i;
 
 	while (true) {
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("%1 butler main loop, disk work outstanding ? %2 @ %3\n", DEBUG_THREAD_SELF, disk_work_outstanding, g_get_monotonic_time ()));
@@ -251,40 +330,11 @@ Butler::thread_work ()
 
 		DEBUG_TRACE (DEBUG::Butler, string_compose ("butler starts refill loop, twr = %1\n", transport_work_requested ()));
 
-		for (i = rl_with_auditioner.begin (); !transport_work_requested () && should_run && i != rl_with_auditioner.end (); ++i) {
-			boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
-
-			if (!tr) {
-				continue;
-			}
-
-			boost::shared_ptr<IO> io = tr->input ();
-
-			if (io && !io->active ()) {
-				/* don't read inactive tracks */
-				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler skips inactive track %1\n", tr->name()));
-				continue;
-			}
-			// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", tr->name(), tr->playback_buffer_load()));
-			switch (tr->do_refill ()) {
-				case 0:
-					//DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", tr->name()));
-					break;
-
-				case 1:
-					DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", tr->name ()));
-					disk_work_outstanding = true;
-					break;
-
-				default:
-					error << string_compose (_("Butler read ahead failure on dstream %1"), (*i)->name ()) << endmsg;
-					std::cerr << string_compose (_("Butler read ahead failure on dstream %1"), (*i)->name ()) << std::endl;
-					break;
-			}
+		if (_prefetch && should_run && !transport_work_requested ()) {
+			prefetch_tracks (rl_with_auditioner);
 		}
 
-		if (i != rl_with_auditioner.begin () && i != rl_with_auditioner.end ()) {
-			/* we didn't get to all the streams */
+		if (refill_tracks (rl_with_auditioner)) {
 			disk_work_outstanding = true;
 		}
 
@@ -333,50 +383,194 @@ Butler::thread_work ()
 	return (0);
 }
 
+/** Hint to the kernel which file data all tracks will need for the
+ * following refill, so that it can start reading it into the page cache
+ * while the refill works through the tracks. Nothing is read here, the
+ * refill still reads the data itself.
+ */
+void
+Butler::prefetch_tracks (RouteList const& rl)
+{
+	for (auto const& r : rl) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (r);
+
+		if (!tr) {
+			continue;
+		}
+
+		boost::shared_ptr<IO> io = tr->input ();
+		if (io && !io->active ()) {
+			continue;
+		}
+
+		tr->queue_prefetch (*_prefetch);
+	}
+
+	if (_prefetch->n_queued () == 0) {
+		return;
+	}
+
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("read-ahead %1 blocks @ %2\n", _prefetch->n_queued (), g_get_monotonic_time ()));
+	_prefetch->run ();
+	DEBUG_TRACE (DEBUG::Butler, string_compose ("read-ahead hints issued @ %1\n", g_get_monotonic_time ()));
+}
+
 bool
-Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+Butler::refill_tracks (RouteList const& rl)
 {
-	bool disk_work_outstanding = false;
+	bool disk_work_outstanding = run_io_tasks (Refill, rl);
 
-	for (RouteList::iterator i = rl->begin (); !transport_work_requested () && should_run && i != rl->end (); ++i) {
-		// cerr << "write behind for " << (*i)->name () << endl;
+	for (size_t i = 0; i < _io_tracks.size (); ++i) {
+		switch (_io_results[i]) {
+			case 0:
+				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill done %1\n", _io_tracks[i]->name()));
+				break;
 
-		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (*i);
+			case 1:
+				DEBUG_TRACE (DEBUG::Butler, string_compose ("\ttrack refill unfinished %1\n", _io_tracks[i]->name ()));
+				disk_work_outstanding = true;
+				break;
 
-		if (!tr) {
-			continue;
+			default:
+				error << string_compose (_("Butler read ahead failure on dstream %1"), _io_tracks[i]->name ()) << endmsg;
+				std::cerr << string_compose (_("Butler read ahead failure on dstream %1"), _io_tracks[i]->name ()) << std::endl;
+				break;
 		}
+	}
 
-		/* note that we still try to flush diskstreams attached to inactive routes
-		 */
+	_io_tracks.clear ();
+	return disk_work_outstanding;
+}
 
-		int ret;
+bool
+Butler::flush_tracks_to_disk_normal (boost::shared_ptr<RouteList> rl, uint32_t& errors)
+{
+	bool disk_work_outstanding = run_io_tasks (Flush, *rl);
 
-		// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", tr->name(), tr->capture_buffer_load()));
-		ret = tr->do_flush (ButlerContext, false);
-		switch (ret) {
+	for (size_t i = 0; i < _io_tracks.size (); ++i) {
+		switch (_io_results[i]) {
 			case 0:
-				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", tr->name()));
+				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush complete for %1\n", _io_tracks[i]->name()));
 				break;
 
 			case 1:
-				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", tr->name()));
+				//DEBUG_TRACE (DEBUG::Butler, string_compose ("\tflush not finished for %1\n", _io_tracks[i]->name()));
 				disk_work_outstanding = true;
 				break;
 
 			default:
+				/* all streams were tried, in case they are split across disks. */
 				errors++;
-				error << string_compose (_("Butler write-behind failure on dstream %1"), (*i)->name ()) << endmsg;
-				std::cerr << string_compose (_("Butler write-behind failure on dstream %1"), (*i)->name ()) << std::endl;
-				/* don't break - try to flush all streams in case they
-			   are split across disks.
-			*/
+				error << string_compose (_("Butler write-behind failure on dstream %1"), _io_tracks[i]->name ()) << endmsg;
+				std::cerr << string_compose (_("Butler write-behind failure on dstream %1"), _io_tracks[i]->name ()) << std::endl;
 		}
 	}
 
+	_io_tracks.clear ();
 	return disk_work_outstanding;
 }
 
+struct IOTaskSorter {
+	bool operator() (std::pair<float, boost::shared_ptr<Track> > const& a, std::pair<float, boost::shared_ptr<Track> > const& b) const
+	{
+		return a.first < b.first;
+	}
+};
+
+/** Distribute refill or flush of the given tracks over the butler and the
+ * I/O threads. Tracks with the most urgent buffers are handled first:
+ * the emptiest playback buffers for refill, the fullest capture buffers for flush.
+ * Like the single-threaded loop, no new tracks are started once transport work
+ * is requested or the butler is paused.
+ *
+ * On return _io_tracks and _io_results hold the tracks and the return
+ * values of Track::do_refill or Track::do_flush. Tracks that were not reached
+ * have a result of 0.
+ *
+ * @return true if only some tracks were handled
+ */
+bool
+Butler::run_io_tasks (IOTask task, RouteList const& rl)
+{
+	std::vector<std::pair<float, boost::shared_ptr<Track> > > tracks;
+
+	for (auto const& r : rl) {
+		boost::shared_ptr<Track> tr = boost::dynamic_pointer_cast<Track> (r);
+
+		if (!tr) {
+			continue;
+		}
+
+		if (task == Refill) {
+			boost::shared_ptr<IO> io = tr->input ();
+			if (io && !io->active ()) {
+				/* don't read inactive tracks */
+				continue;
+			}
+			tracks.push_back (std::make_pair (tr->playback_buffer_load (), tr));
+		} else {
+			/* note that we still try to flush diskstreams attached to inactive routes */
+			tracks.push_back (std::make_pair (-tr->capture_buffer_load (), tr));
+		}
+	}
+
+	std::stable_sort (tracks.begin (), tracks.end (), IOTaskSorter ());
+
+	_io_task = task;
+	_io_tracks.clear ();
+	for (auto const& t : tracks) {
+		_io_tracks.push_back (t.second);
+	}
+	_io_results.assign (_io_tracks.size (), 0);
+	g_atomic_int_set (&_io_next, 0);
+
+	if (_io_tracks.empty ()) {
+		return false;
+	}
+
+	/* the butler thread takes part as well */
+	size_t n_helpers = std::min (_io_threads.size (), _io_tracks.size () - 1);
+
+	for (size_t i = 0; i < n_helpers; ++i) {
+		_io_work_sem.signal ();
+	}
+
+	io_work ();
+
+	for (size_t i = 0; i < n_helpers; ++i) {
+		_io_done_sem.wait ();
+	}
+
+	gint started = std::min<gint> (g_atomic_int_get (&_io_next), _io_tracks.size ());
+
+	/* we didn't get to all the streams */
+	return started > 0 && started < (gint)_io_tracks.size ();
+}
+
+/** Called by the butler and I/O threads, take tracks from _io_tracks until none are left */
+void
+Butler::io_work ()
+{
+	while (!transport_work_requested () && should_run) {
+		gint i = g_atomic_int_add (&_io_next, 1);
+
+		if (i >= (gint)_io_tracks.size ()) {
+			break;
+		}
+
+		switch (_io_task) {
+			case Refill:
+				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler refills %1, playback load = %2\n", _io_tracks[i]->name(), _io_tracks[i]->playback_buffer_load()));
+				_io_results[i] = _io_tracks[i]->do_refill ();
+				break;
+			case Flush:
+				// DEBUG_TRACE (DEBUG::Butler, string_compose ("butler flushes track %1 capture load %2\n", _io_tracks[i]->name(), _io_tracks[i]->capture_buffer_load()));
+				_io_results[i] = _io_tracks[i]->do_flush (ButlerContext, false);
+				break;
+		}
+	}
+}
+
 void
 Butler::schedule_transport_work ()
 {
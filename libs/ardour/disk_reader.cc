@@ -52,6 +52,8 @@ PBD::Signal0<void>    DiskReader::Underrun;
 Sample*               DiskReader::_sum_buffer     = 0;
 Sample*               DiskReader::_mixdown_buffer = 0;
 gain_t*               DiskReader::_gain_buffer    = 0;
+
+Glib::Threads::Private<DiskReader::WorkingBuffers> DiskReader::_thread_working_buffers;
 GATOMIC_QUAL gint     DiskReader::_no_disk_output (0);
 DiskReader::Declicker DiskReader::loop_declick_in;
 DiskReader::Declicker DiskReader::loop_declick_out;
@@ -146,6 +148,28 @@ DiskReader::free_working_buffers ()
 	_gain_buffer    = 0;
 }
 
+DiskReader::WorkingBuffers::WorkingBuffers ()
+	: sum_buffer (new Sample[2 * 1048576])
+	, mixdown_buffer (new Sample[2 * 1048576])
+	, gain_buffer (new gain_t[2 * 1048576])
+{
+}
+
+DiskReader::WorkingBuffers::~WorkingBuffers ()
+{
+	delete[] sum_buffer;
+	delete[] mixdown_buffer;
+	delete[] gain_buffer;
+}
+
+void
+DiskReader::allocate_thread_working_buffers ()
+{
+	if (!_thread_working_buffers.get ()) {
+		_thread_working_buffers.set (new WorkingBuffers);
+	}
+}
+
 samplecnt_t
 DiskReader::default_chunk_samples ()
 {
@@ -1101,9 +1125,51 @@ int
 DiskReader::do_refill ()
 {
 	const bool reversed = !_session.transport_will_roll_forwards ();
+
+	WorkingBuffers* wb = _thread_working_buffers.get ();
+	if (wb) {
+		return refill (wb->sum_buffer, wb->mixdown_buffer, wb->gain_buffer, 0, reversed);
+	}
 	return refill (_sum_buffer, _mixdown_buffer, _gain_buffer, 0, reversed);
 }
 
+void
+DiskReader::queue_prefetch (FileReadAhead& reader)
+{
+	if (_session.loading () || _last_read_reversed || !_session.transport_will_roll_forwards ()) {
+		return;
+	}
+
+	boost::shared_ptr<AudioPlaylist> pl = audio_playlist ();
+	boost::shared_ptr<ChannelList>   c  = channels.reader ();
+
+	if (!pl || c->empty ()) {
+		return;
+	}
+
+	/* same conditions and size as refill_audio() */
+	samplecnt_t total_space = c->front ()->rbuf->write_space ();
+
+	if (total_space == 0 || ((total_space < _chunk_samples) && fabs (_session.transport_speed ()) < 2.0f)) {
+		return;
+	}
+
+	samplepos_t fsa = file_sample[DataType::AUDIO];
+
+	if (fsa > max_samplepos - total_space) {
+		return;
+	}
+
+	const size_t bits_per_sample    = format_data_width (_session.config.get_native_file_data_format ());
+	size_t       byte_size_for_read = max ((size_t) (256 * 1024), min ((size_t) (4 * 1048576), (size_t) (total_space * bits_per_sample / 8)));
+
+	byte_size_for_read = (byte_size_for_read / 16384) * 16384;
+
+	samplecnt_t to_read = min (total_space, (samplecnt_t) (byte_size_for_read / (bits_per_sample / 8)));
+
+	pl->prefetch (reader, timepos_t (fsa), timecnt_t (to_read));
+}
+
 int
 DiskReader::do_refill_with_alloc (bool partial_fill, bool reversed)
 {
@@ -0,0 +1,258 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+
+#include <boost/bind.hpp>
+
+#include "pbd/compose.h"
+#include "pbd/error.h"
+
+#include "ardour/dsp_profiler.h"
+#include "ardour/io_plug.h"
+#include "ardour/processor.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "pbd/i18n.h"
+
+using namespace ARDOUR;
+using namespace PBD;
+
+DSPProfiler::DSPProfiler (Session& s)
+	: _session (s)
+	, _trace_cycles (0)
+	, _cycles_left (0)
+	, _cycle_start (0)
+{
+	g_atomic_int_set (&_enabled, 0);
+	g_atomic_int_set (&_trace_state, TraceIdle);
+	g_atomic_int_set (&_n_events, 0);
+}
+
+void
+DSPProfiler::set_enabled (bool yn)
+{
+	g_atomic_int_set (&_enabled, yn ? 1 : 0);
+}
+
+static void
+reset_processor_stats (boost::weak_ptr<Processor> wp)
+{
+	boost::shared_ptr<Processor> p = wp.lock ();
+	if (p) {
+		p->reset_process_histogram ();
+	}
+}
+
+void
+DSPProfiler::reset_stats ()
+{
+	boost::shared_ptr<RouteList const> rl = _session.get_routes ();
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		(*i)->reset_process_histogram ();
+		(*i)->foreach_processor (boost::bind (&reset_processor_stats, _1));
+	}
+
+	boost::shared_ptr<IOPlugList const> iop = _session.io_plugs ();
+	for (IOPlugList::const_iterator i = iop->begin (); i != iop->end (); ++i) {
+		(*i)->reset_process_histogram ();
+	}
+}
+
+int
+DSPProfiler::start_trace (uint32_t n_cycles, uint32_t max_events)
+{
+	if (n_cycles == 0 || max_events == 0) {
+		return -1;
+	}
+
+	int state = g_atomic_int_get (&_trace_state);
+	if (state == TraceArmed || state == TraceRecording) {
+		return -1;
+	}
+
+	/* the process threads do not access the trace while idle or complete */
+	_events.resize (max_events);
+	_trace_cycles = n_cycles;
+
+	g_atomic_int_set (&_trace_state, TraceArmed);
+	return 0;
+}
+
+void
+DSPProfiler::cycle_start ()
+{
+	switch (g_atomic_int_get (&_trace_state)) {
+		case TraceArmed:
+			_cycles_left = _trace_cycles;
+			g_atomic_int_set (&_n_events, 0);
+			g_atomic_int_set (&_trace_state, TraceRecording);
+			break;
+		case TraceRecording:
+			if (--_cycles_left == 0) {
+				g_atomic_int_set (&_trace_state, TraceComplete);
+				return;
+			}
+			break;
+		default:
+			return;
+	}
+	_cycle_start = get_microseconds ();
+}
+
+void
+DSPProfiler::cycle_end ()
+{
+	if (tracing ()) {
+		record (&_session, Cycle, _cycle_start, get_microseconds ());
+	}
+}
+
+void
+DSPProfiler::record (void const* obj, Category cat, microseconds_t start, microseconds_t end)
+{
+	if (!tracing ()) {
+		return;
+	}
+
+	/* claim a slot, events that do not fit are dropped */
+	guint n = g_atomic_int_add (&_n_events, 1);
+	if (n >= _events.size ()) {
+		return;
+	}
+
+	Event& ev (_events[n]);
+	ev.obj    = obj;
+	ev.cat    = cat;
+	ev.thread = pthread_self ();
+	ev.start  = start;
+	ev.end    = end;
+}
+
+static std::string
+json_escape (std::string const& s)
+{
+	std::string rv;
+	for (std::string::const_iterator c = s.begin (); c != s.end (); ++c) {
+		if (*c == '"' || *c == '\\') {
+			rv += '\\';
+			rv += *c;
+		} else if ((unsigned char) *c < 0x20) {
+			char buf[8];
+			snprintf (buf, sizeof (buf), "\\u%04x", (unsigned char) *c);
+			rv += buf;
+		} else {
+			rv += *c;
+		}
+	}
+	return rv;
+}
+
+typedef std::map<void const*, std::string> ProfileNames;
+
+static void
+add_processor_name (boost::weak_ptr<Processor> wp, std::string const& route, ProfileNames* names)
+{
+	boost::shared_ptr<Processor> p = wp.lock ();
+	if (p) {
+		(*names)[p.get ()] = route + ": " + p->display_name ();
+	}
+}
+
+int
+DSPProfiler::write_trace (std::string const& path) const
+{
+	if (!trace_complete ()) {
+		return -1;
+	}
+
+	/* Events only store the address of the route or processor. Resolve
+	 * names of the objects that still exist, without dereferencing the
+	 * recorded pointers.
+	 */
+	ProfileNames names;
+	names[&_session] = X_("Cycle");
+
+	boost::shared_ptr<RouteList const> rl = _session.get_routes ();
+	for (RouteList::const_iterator i = rl->begin (); i != rl->end (); ++i) {
+		names[static_cast<GraphNode const*> (i->get ())] = (*i)->name ();
+		(*i)->foreach_processor (boost::bind (&add_processor_name, _1, (*i)->name (), &names));
+	}
+
+	boost::shared_ptr<IOPlugList const> iop = _session.io_plugs ();
+	for (IOPlugList::const_iterator i = iop->begin (); i != iop->end (); ++i) {
+		names[static_cast<GraphNode const*> (i->get ())] = (*i)->name ();
+	}
+
+	std::ofstream out (path.c_str ());
+	if (!out) {
+		error << string_compose (_("Could not open DSP trace file \"%1\""), path) << endmsg;
+		return -1;
+	}
+
+	static const char* categories[] = { "cycle", "node", "processor" };
+
+	size_t const           n_events = std::min<size_t> (g_atomic_int_get (&_n_events), _events.size ());
+	std::vector<pthread_t> threads;
+	microseconds_t         t0 = 0;
+
+	for (size_t i = 0; i < n_events; ++i) {
+		if (i == 0 || _events[i].start < t0) {
+			t0 = _events[i].start;
+		}
+	}
+
+	out << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[";
+
+	for (size_t i = 0; i < n_events; ++i) {
+		Event const& ev (_events[i]);
+
+		size_t tid = 0;
+		while (tid < threads.size () && !pthread_equal (threads[tid], ev.thread)) {
+			++tid;
+		}
+		if (tid == threads.size ()) {
+			threads.push_back (ev.thread);
+		}
+
+		ProfileNames::const_iterator n = names.find (ev.obj);
+
+		out << (i > 0 ? ",\n" : "\n")
+		    << "{\"name\":\"" << (n != names.end () ? json_escape (n->second) : std::string (X_("(deleted)"))) << "\""
+		    << ",\"cat\":\"" << categories[ev.cat] << "\""
+		    << ",\"ph\":\"X\",\"pid\":1"
+		    << ",\"tid\":" << tid
+		    << ",\"ts\":" << (ev.start - t0)
+		    << ",\"dur\":" << (ev.end - ev.start)
+		    << "}";
+	}
+
+	for (size_t tid = 0; tid < threads.size (); ++tid) {
+		out << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << tid
+		    << ",\"args\":{\"name\":\"Process Thread " << tid << "\"}}";
+	}
+
+	out << "\n]}\n";
+
+	if (!out.good ()) {
+		error << string_compose (_("Could not write DSP trace file \"%1\""), path) << endmsg;
+		return -1;
+	}
+	return 0;
+}
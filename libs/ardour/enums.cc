@@ -90,6 +90,7 @@ setup_enum_writer ()
 	PFLPosition _PFLPosition;
 	AFLPosition _AFLPosition;
 	DenormalModel _DenormalModel;
+	GraphScheduling _GraphScheduling;
 	ClockDeltaMode _ClockDeltaMode;
 	LayerModel _LayerModel;
 	InsertMergePolicy _InsertMergePolicy;
@@ -372,6 +373,10 @@ setup_enum_writer ()
 	REGISTER_ENUM (DenormalFTZDAZ);
 	REGISTER (_DenormalModel);
 
+	REGISTER_ENUM (SharedTriggerQueue);
+	REGISTER_ENUM (WorkStealing);
+	REGISTER (_GraphScheduling);
+
 	/*
 	 * EditorOrdered has been deprecated
 	 * since the removal of independent
@@ -0,0 +1,246 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+
+#ifndef PLATFORM_WINDOWS
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+#ifdef HAVE_LIBURING
+#include <liburing.h>
+#endif
+
+#include "pbd/compose.h"
+
+#include "ardour/debug.h"
+#include "ardour/file_read_ahead.h"
+
+using namespace ARDOUR;
+
+#ifndef PLATFORM_WINDOWS
+/* ask the kernel to start reading a range of \p fd into the page cache.
+ * @return true if the hint was accepted
+ */
+static bool
+advise_willneed (int fd, int64_t offset, size_t length)
+{
+#ifdef __APPLE__
+	struct radvisory ra;
+	ra.ra_offset = offset;
+	ra.ra_count  = (int)length;
+	return fcntl (fd, F_RDADVISE, &ra) != -1;
+#else
+	return posix_fadvise (fd, offset, length, POSIX_FADV_WILLNEED) == 0;
+#endif
+}
+#endif
+
+#ifdef HAVE_LIBURING
+struct FileReadAhead::URing {
+	URing (uint32_t depth)
+		: ok (false)
+	{
+		if (io_uring_queue_init (depth, &ring, 0) < 0) {
+			return;
+		}
+		/* read-ahead hints need Linux 5.6 or later */
+		struct io_uring_probe* probe = io_uring_get_probe_ring (&ring);
+		ok = probe && io_uring_opcode_supported (probe, IORING_OP_FADVISE);
+		if (probe) {
+			io_uring_free_probe (probe);
+		}
+		if (!ok) {
+			io_uring_queue_exit (&ring);
+		}
+	}
+
+	~URing ()
+	{
+		if (ok) {
+			io_uring_queue_exit (&ring);
+		}
+	}
+
+	bool            ok;
+	struct io_uring ring;
+};
+#else
+struct FileReadAhead::URing {
+};
+#endif
+
+FileReadAhead::FileReadAhead (uint32_t queue_depth, size_t block_size)
+	: _queue_depth (std::max<uint32_t> (1, queue_depth))
+	, _block_size (block_size)
+	, _uring (0)
+{
+	_requests.reserve (1024);
+
+#ifdef HAVE_LIBURING
+	_uring = new URing (_queue_depth);
+	if (_uring->ok) {
+		DEBUG_TRACE (DEBUG::Butler, string_compose ("FileReadAhead: using io_uring, queue depth %1\n", _queue_depth));
+		return;
+	}
+	delete _uring;
+	_uring = 0;
+#endif
+}
+
+FileReadAhead::~FileReadAhead ()
+{
+	close_fds ();
+	delete _uring;
+}
+
+bool
+FileReadAhead::uses_io_uring () const
+{
+	return _uring != 0;
+}
+
+void
+FileReadAhead::queue (void const* owner, int fd, int64_t offset, size_t length)
+{
+#ifdef PLATFORM_WINDOWS
+	/* no read-ahead hint */
+	return;
+#else
+	if (fd < 0) {
+		return;
+	}
+
+	std::map<void const*, int>::const_iterator i = _fds.find (owner);
+	if (i != _fds.end ()) {
+		fd = i->second;
+	} else {
+		fd = ::dup (fd);
+		if (fd < 0) {
+			return;
+		}
+		_fds[owner] = fd;
+	}
+
+	while (length > 0) {
+		size_t len = std::min (length, _block_size);
+		_requests.push_back (Request (fd, offset, len));
+		offset += len;
+		length -= len;
+	}
+#endif
+}
+
+void
+FileReadAhead::close_fds ()
+{
+#ifndef PLATFORM_WINDOWS
+	for (auto const& f : _fds) {
+		::close (f.second);
+	}
+#endif
+	_fds.clear ();
+}
+
+uint64_t
+FileReadAhead::run ()
+{
+	uint64_t rv = 0;
+
+	if (!_requests.empty ()) {
+		if (_uring) {
+			rv = run_io_uring ();
+		} else {
+			rv = run_sequential ();
+		}
+	}
+
+	_requests.clear ();
+	close_fds ();
+	return rv;
+}
+
+uint64_t
+FileReadAhead::run_sequential ()
+{
+	uint64_t bytes = 0;
+#ifndef PLATFORM_WINDOWS
+	for (auto const& r : _requests) {
+		if (advise_willneed (r.fd, r.offset, r.length)) {
+			bytes += r.length;
+		}
+	}
+#endif
+	return bytes;
+}
+
+uint64_t
+FileReadAhead::run_io_uring ()
+{
+#ifdef HAVE_LIBURING
+	struct io_uring* ring = &_uring->ring;
+
+	size_t   next      = 0;
+	size_t   in_flight = 0;
+	uint64_t bytes     = 0;
+
+	while (next < _requests.size () || in_flight > 0) {
+		/* fill the submission queue */
+		while (next < _requests.size () && in_flight < _queue_depth) {
+			struct io_uring_sqe* sqe = io_uring_get_sqe (ring);
+			if (!sqe) {
+				break;
+			}
+			Request const& r = _requests[next++];
+			io_uring_prep_fadvise (sqe, r.fd, r.offset, r.length, POSIX_FADV_WILLNEED);
+			io_uring_sqe_set_data (sqe, (void*)(uintptr_t)r.length);
+			++in_flight;
+		}
+
+		if (io_uring_submit (ring) < 0) {
+			break;
+		}
+
+		/* reap at least one completion, and all others that are ready */
+		struct io_uring_cqe* cqe;
+		if (io_uring_wait_cqe (ring, &cqe) < 0) {
+			break;
+		}
+		do {
+			if (cqe->res == 0) {
+				bytes += (uintptr_t)io_uring_cqe_get_data (cqe);
+			}
+			io_uring_cqe_seen (ring, cqe);
+			--in_flight;
+		} while (in_flight > 0 && io_uring_peek_cqe (ring, &cqe) == 0);
+	}
+
+	/* on error, collect remaining completions before the descriptors are closed */
+	while (in_flight > 0) {
+		struct io_uring_cqe* cqe;
+		if (io_uring_wait_cqe (ring, &cqe) < 0) {
+			break;
+		}
+		io_uring_cqe_seen (ring, cqe);
+		--in_flight;
+	}
+
+	return bytes;
+#else
+	return 0;
+#endif
+}
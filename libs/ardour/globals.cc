@@ -132,6 +132,8 @@
 
 #include "audiographer/routines.h"
 
+#include "evoral/Curve.h"
+
 #if defined(__APPLE__)
 #include <CoreFoundation/CoreFoundation.h>
 #endif
@@ -154,6 +156,14 @@ apply_gain_to_buffer_t  ARDOUR::apply_gain_to_buffer  = 0;
 mix_buffers_with_gain_t ARDOUR::mix_buffers_with_gain = 0;
 mix_buffers_no_gain_t   ARDOUR::mix_buffers_no_gain   = 0;
 copy_vector_t           ARDOUR::copy_vector           = 0;
+linear_ramp_t           ARDOUR::linear_ramp           = 0;
+exp2_ramp_t             ARDOUR::exp2_ramp             = 0;
+gain_ramp_t             ARDOUR::gain_ramp             = 0;
+cubic_ramp_t            ARDOUR::cubic_ramp            = 0;
+
+apply_gain_vector_t            ARDOUR::apply_gain_vector            = 0;
+mix_buffers_with_gain_vector_t ARDOUR::mix_buffers_with_gain_vector = 0;
+crossfade_buffers_t            ARDOUR::crossfade_buffers            = 0;
 
 PBD::Signal1<void, std::string>                    ARDOUR::BootMessage;
 PBD::Signal3<void, std::string, std::string, bool> ARDOUR::PluginScanMessage;
@@ -185,7 +195,8 @@ static PBD::ScopedConnection config_connection;
 void
 setup_hardware_optimization (bool try_optimization)
 {
-	bool generic_mix_functions = true;
+	bool generic_mix_functions  = true;
+	bool generic_ramp_functions = true;
 
 	if (try_optimization) {
 		FPU* fpu = FPU::instance ();
@@ -205,6 +216,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+			apply_gain_vector            = x86_sse_avx_apply_gain_vector;
+			mix_buffers_with_gain_vector = x86_fma_mix_buffers_with_gain_vector;
+			crossfade_buffers            = x86_fma_crossfade_buffers;
+
 			generic_mix_functions = false;
 
 		} else
@@ -220,6 +235,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 			copy_vector           = x86_sse_avx_copy_vector;
 
+			apply_gain_vector            = x86_sse_avx_apply_gain_vector;
+			mix_buffers_with_gain_vector = x86_sse_avx_mix_buffers_with_gain_vector;
+			crossfade_buffers            = x86_sse_avx_crossfade_buffers;
+
 			generic_mix_functions = false;
 
 		} else if (fpu->has_sse ()) {
@@ -233,6 +252,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_vector            = x86_sse_apply_gain_vector;
+			mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+			crossfade_buffers            = x86_sse_crossfade_buffers;
+
 			generic_mix_functions = false;
 		}
 
@@ -248,6 +271,10 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 			copy_vector           = arm_neon_copy_vector;
 
+			apply_gain_vector            = arm_neon_apply_gain_vector;
+			mix_buffers_with_gain_vector = arm_neon_mix_buffers_with_gain_vector;
+			crossfade_buffers            = arm_neon_crossfade_buffers;
+
 			generic_mix_functions = false;
 		}
 
@@ -261,12 +288,40 @@ setup_hardware_optimization (bool try_optimization)
 			mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 			copy_vector           = default_copy_vector;
 
+			apply_gain_vector            = default_apply_gain_vector;
+			mix_buffers_with_gain_vector = default_mix_buffers_with_gain_vector;
+			crossfade_buffers            = default_crossfade_buffers;
+
 			generic_mix_functions = false;
 
 			info << "Apple VecLib H/W specific optimizations in use" << endmsg;
 		}
 #endif
 
+#if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS) && defined(__SSE2__)
+		if (fpu->has_sse2 ()) {
+			linear_ramp = x86_sse_linear_ramp;
+			exp2_ramp   = x86_sse_exp2_ramp;
+			gain_ramp   = x86_sse_gain_ramp;
+			cubic_ramp  = x86_sse_cubic_ramp;
+
+			generic_ramp_functions = false;
+		}
+#elif defined ARM_NEON_SUPPORT
+		if (fpu->has_neon ()) {
+			linear_ramp = arm_neon_linear_ramp;
+			exp2_ramp   = arm_neon_exp2_ramp;
+#ifdef __aarch64__
+			gain_ramp   = arm_neon_gain_ramp;
+#else
+			gain_ramp   = default_gain_ramp;
+#endif
+			cubic_ramp  = arm_neon_cubic_ramp;
+
+			generic_ramp_functions = false;
+		}
+#endif
+
 		/* consider FPU denormal handling to be "h/w optimization" */
 
 		setup_fpu ();
@@ -280,11 +335,27 @@ setup_hardware_optimization (bool try_optimization)
 		mix_buffers_no_gain   = default_mix_buffers_no_gain;
 		copy_vector           = default_copy_vector;
 
+		apply_gain_vector            = default_apply_gain_vector;
+		mix_buffers_with_gain_vector = default_mix_buffers_with_gain_vector;
+		crossfade_buffers            = default_crossfade_buffers;
+
 		info << "No H/W specific optimizations in use" << endmsg;
 	}
 
+	if (generic_ramp_functions) {
+		linear_ramp = default_linear_ramp;
+		exp2_ramp   = default_exp2_ramp;
+		gain_ramp   = default_gain_ramp;
+		cubic_ramp  = default_cubic_ramp;
+	}
+
 	AudioGrapher::Routines::override_compute_peak (compute_peak);
 	AudioGrapher::Routines::override_apply_gain_to_buffer (apply_gain_to_buffer);
+
+	Evoral::Curve::override_linear_ramp (linear_ramp);
+	Evoral::Curve::override_exp2_ramp (exp2_ramp);
+	Evoral::Curve::override_gain_ramp (gain_ramp);
+	Evoral::Curve::override_cubic_ramp (cubic_ramp);
 }
 
 static void
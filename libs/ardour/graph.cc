@@ -20,11 +20,14 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <algorithm>
 #include <cmath>
+#include <map>
 #include <stdio.h>
 
 #include "pbd/compose.h"
 #include "pbd/debug_rt_alloc.h"
+#include "pbd/microseconds.h"
 #include "pbd/pthread_utils.h"
 
 #include "temporal/superclock.h"
@@ -32,9 +35,11 @@
 
 #include "ardour/audioengine.h"
 #include "ardour/debug.h"
+#include "ardour/dsp_profiler.h"
 #include "ardour/graph.h"
 #include "ardour/io_plug.h"
 #include "ardour/process_thread.h"
+#include "ardour/rc_configuration.h"
 #include "ardour/route.h"
 #include "ardour/rt_task.h"
 #include "ardour/rt_tasklist.h"
@@ -62,8 +67,19 @@ alloc_allowed ()
 
 #define g_atomic_uint_get(x) static_cast<guint> (g_atomic_int_get (x))
 
+static void
+do_not_delete_the_worker (void*)
+{
+	/* Graph::_workers owns them */
+}
+
+Glib::Threads::Private<Graph::Worker> Graph::_thread_worker (do_not_delete_the_worker);
+
 Graph::Graph (Session& session)
 	: SessionHandleRef (session)
+	, _work_stealing (false)
+	, _cycle_deadline (0)
+	, _period_us (0)
 	, _execution_sem ("graph_execution", 0)
 	, _callback_start_sem ("graph_start", 0)
 	, _callback_done_sem ("graph_done", 0)
@@ -123,6 +139,8 @@ Graph::reset_thread_list ()
 		drop_threads ();
 	}
 
+	reset_workers (num_threads);
+
 	/* Allow threads to run */
 	g_atomic_int_set (&_terminate, 0);
 
@@ -141,6 +159,27 @@ Graph::reset_thread_list ()
 	}
 }
 
+/** Allocate per thread state for the work-stealing scheduler.
+ * Worker objects are only released when the session goes away,
+ * since a thread may still hold a reference to it.
+ */
+void
+Graph::reset_workers (uint32_t num_threads)
+{
+	if (num_threads == 0) {
+		for (auto& w : _workers) {
+			delete w;
+		}
+		_workers.clear ();
+		return;
+	}
+
+	while (_workers.size () < num_threads) {
+		_workers.push_back (new Worker (_workers.size ()));
+		_workers.back ()->queue.reserve (1024);
+	}
+}
+
 uint32_t
 Graph::n_threads () const
 {
@@ -155,6 +194,7 @@ Graph::session_going_away ()
 	/* now drop all references on the nodes. */
 	g_atomic_int_set (&_trigger_queue_size, 0);
 	_trigger_queue.clear ();
+	reset_workers (0);
 	_graph_chain = 0;
 }
 
@@ -199,10 +239,32 @@ Graph::drop_threads ()
 #endif
 }
 
+/** Called by the process callback, while all graph threads are idle */
+void
+Graph::select_scheduler ()
+{
+	_work_stealing = _workers.size () > 1 && Config->get_graph_scheduling () == WorkStealing;
+}
+
 void
 Graph::prep ()
 {
+	AudioEngine* e = AudioEngine::instance ();
+	_period_us     = 1e6 * e->samples_per_cycle () / e->sample_rate ();
+
+	if (_work_stealing) {
+		_cycle_deadline = PBD::get_microseconds () + _period_us;
+	}
+
 	if (!_graph_chain) {
+		if (_work_stealing) {
+			/* RTTaskList, tasks are in the shared queue */
+			guint work_avail = g_atomic_uint_get (&_trigger_queue_size);
+			guint wakeup     = std::min (g_atomic_uint_get (&_idle_thread_cnt), work_avail > 0 ? work_avail - 1 : 0);
+			for (guint i = 0; i < wakeup; ++i) {
+				_execution_sem.signal ();
+			}
+		}
 		return;
 	}
 	_graph_empty = true;
@@ -222,10 +284,37 @@ Graph::prep ()
 
 	g_atomic_int_set (&_terminal_refcnt, _graph_chain->_n_terminal_nodes);
 
-	/* Trigger the initial nodes for processing, which are the ones at the `input' end */
-	for (auto const& i : _graph_chain->_init_trigger_list) {
+	/* Start nodes on the longest path first */
+	_graph_chain->update_critical_path ();
+
+	if (!_work_stealing) {
+		/* Trigger the initial nodes for processing, which are the ones at the `input' end */
+		for (auto const& i : _graph_chain->_init_trigger_rt) {
+			g_atomic_int_inc (&_trigger_queue_size);
+			_trigger_queue.push_back (i);
+		}
+		return;
+	}
+
+	/* Distribute the initial nodes over all worker queues (all other threads are idle) */
+	size_t   n_nodes = _graph_chain->_nodes_rt.size ();
+	uint32_t n_init  = 0;
+
+	for (auto const& w : _workers) {
+		if (w->queue.capacity () < n_nodes) {
+			w->queue.reserve (n_nodes);
+		}
+	}
+
+	for (auto const& i : _graph_chain->_init_trigger_rt) {
 		g_atomic_int_inc (&_trigger_queue_size);
-		_trigger_queue.push_back (i.get ());
+		_workers[n_init++ % _workers.size ()]->queue.push_back (i);
+	}
+
+	/* wake up idle threads, the calling thread itself will also process nodes */
+	guint wakeup = std::min<guint> (g_atomic_uint_get (&_idle_thread_cnt), n_init > 0 ? n_init - 1 : 0);
+	for (guint i = 0; i < wakeup; ++i) {
+		_execution_sem.signal ();
 	}
 }
 
@@ -233,7 +322,34 @@ void
 Graph::trigger (ProcessNode* n)
 {
 	g_atomic_int_inc (&_trigger_queue_size);
-	_trigger_queue.push_back (n);
+
+	if (!_work_stealing) {
+		_trigger_queue.push_back (n);
+		return;
+	}
+
+	Worker* w = _thread_worker.get ();
+	assert (w);
+
+	/* The first node that becomes ready is run by the thread that
+	 * completed its last feeder, reusing warm caches.
+	 */
+	if (!w->next) {
+		w->next = n;
+		return;
+	}
+
+	/* prefer the node on the longer remaining path, queue the other */
+	if (n->critical_path_us () > w->next->critical_path_us ()) {
+		std::swap (n, w->next);
+	}
+
+	w->queue.push_back (n);
+
+	/* Other threads are spinning or busy, and will steal or process the node */
+	if (g_atomic_uint_get (&_idle_thread_cnt) > 0) {
+		_execution_sem.signal ();
+	}
 }
 
 /** Called when a node at the `output' end of the chain (ie one that has no-one to feed)
@@ -290,6 +406,16 @@ Graph::reached_terminal_node ()
 /** Called by both the main thread and all helpers. */
 void
 Graph::run_one ()
+{
+	if (_work_stealing) {
+		run_one_stealing ();
+	} else {
+		run_one_shared ();
+	}
+}
+
+void
+Graph::run_one_shared ()
 {
 	ProcessNode* to_run = NULL;
 
@@ -329,6 +455,11 @@ Graph::run_one ()
 
 		g_atomic_int_dec_and_test (&_idle_thread_cnt);
 
+		if (_work_stealing) {
+			/* scheduler was changed while this thread was asleep */
+			return;
+		}
+
 		/* Try to find some work to do */
 		_trigger_queue.pop_front (to_run);
 	}
@@ -348,11 +479,74 @@ Graph::run_one ()
 	DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 has finished run_one()\n", pthread_name ()));
 }
 
+/** Try to take a node from the shared queue, or from another thread's queue */
+bool
+Graph::steal (Worker const& self, ProcessNode*& to_run)
+{
+	/* RTTaskList uses the shared queue */
+	if (_trigger_queue.pop_front (to_run)) {
+		return true;
+	}
+
+	size_t n_workers = _workers.size ();
+	for (size_t i = 1; i < n_workers; ++i) {
+		if (_workers[(self.id + i) % n_workers]->queue.pop_front (to_run)) {
+			return true;
+		}
+	}
+	return false;
+}
+
+void
+Graph::run_one_stealing ()
+{
+	Worker* w = _thread_worker.get ();
+	assert (w);
+
+	ProcessNode* to_run = w->next;
+	w->next             = 0;
+
+	if (!to_run && !w->queue.pop_front (to_run)) {
+		uint32_t spin = 0;
+		while (!steal (*w, to_run)) {
+			/* Spin while the cycle is in progress, but no longer than
+			 * the cycle's deadline. Then wait for work.
+			 */
+			if (g_atomic_int_get (&_terminate)) {
+				return;
+			}
+
+			if (g_atomic_uint_get (&_terminal_refcnt) > 0 && (++spin & 63 || PBD::get_microseconds () < _cycle_deadline)) {
+				continue;
+			}
+
+			g_atomic_int_inc (&_idle_thread_cnt);
+			assert (g_atomic_uint_get (&_idle_thread_cnt) <= g_atomic_uint_get (&_n_workers));
+
+			DEBUG_TRACE (DEBUG::ProcessThreads, string_compose ("%1 parks\n", pthread_name ()));
+			_execution_sem.wait ();
+
+			if (g_atomic_int_get (&_terminate)) {
+				return;
+			}
+
+			g_atomic_int_dec_and_test (&_idle_thread_cnt);
+			/* re-evaluate scheduler and queues */
+			return;
+		}
+	}
+
+	Temporal::TempoMap::fetch ();
+
+	/* Process the graph-node */
+	g_atomic_int_dec_and_test (&_trigger_queue_size);
+	to_run->run (_graph_chain);
+}
+
 void
 Graph::helper_thread ()
 {
-	g_atomic_int_inc (&_n_workers);
-	guint id = g_atomic_uint_get (&_n_workers);
+	guint id = g_atomic_int_add (&_n_workers, 1) + 1;
 
 	/* This is needed for ARDOUR::Session requests called from rt-processors
 	 * in particular Lua scripts may do cross-thread calls */
@@ -370,10 +564,15 @@ Graph::helper_thread ()
 
 	pt->get_buffers ();
 
+	assert (id < _workers.size ());
+	_thread_worker.set (_workers[id]);
+
 	while (!g_atomic_int_get (&_terminate)) {
 		run_one ();
 	}
 
+	_thread_worker.set (0);
+
 	pt->drop_buffers ();
 	delete pt;
 }
@@ -400,6 +599,8 @@ Graph::main_thread ()
 
 	pt->get_buffers ();
 
+	_thread_worker.set (_workers[0]);
+
 	/* Wait for initial process callback */
 again:
 	_callback_start_sem.wait ();
@@ -407,6 +608,7 @@ again:
 	DEBUG_TRACE (DEBUG::ProcessThreads, "main thread is awake\n");
 
 	if (g_atomic_int_get (&_terminate)) {
+		_thread_worker.set (0);
 		pt->drop_buffers ();
 		delete (pt);
 		return;
@@ -427,6 +629,7 @@ again:
 		run_one ();
 	}
 
+	_thread_worker.set (0);
 	pt->drop_buffers ();
 	delete (pt);
 }
@@ -449,6 +652,8 @@ Graph::process_routes (boost::shared_ptr<GraphChain> chain, pframes_t nframes, s
 	_process_retval      = 0;
 	_process_need_butler = false;
 
+	select_scheduler ();
+
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for non-silent process\n");
 	_callback_start_sem.signal ();
 	_callback_done_sem.wait ();
@@ -478,6 +683,8 @@ Graph::routes_no_roll (boost::shared_ptr<GraphChain> chain, pframes_t nframes, s
 	_process_need_butler    = false;
 	_process_non_rt_pending = non_rt_pending;
 
+	select_scheduler ();
+
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for no-roll process\n");
 	_callback_start_sem.signal ();
 	_callback_done_sem.wait ();
@@ -501,6 +708,8 @@ Graph::silence_routes (boost::shared_ptr<GraphChain> chain, pframes_t nframes)
 	_process_retval      = 0;
 	_process_need_butler = false;
 
+	select_scheduler ();
+
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for silence process\n");
 	_callback_start_sem.signal ();
 	_callback_done_sem.wait ();
@@ -522,6 +731,8 @@ Graph::process_io_plugs (boost::shared_ptr<GraphChain> chain, pframes_t nframes,
 	_process_nframes      = nframes;
 	_process_start_sample = start_sample;
 
+	select_scheduler ();
+
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for IOPlug processing\n");
 	_callback_start_sem.signal ();
 	_callback_done_sem.wait ();
@@ -574,6 +785,12 @@ Graph::in_process_thread () const
 	return AudioEngine::instance ()->in_process_thread ();
 }
 
+DSPProfiler&
+Graph::dsp_profiler () const
+{
+	return _session.dsp_profiler ();
+}
+
 /* ****************************************************************************/
 
 void
@@ -595,6 +812,8 @@ Graph::process_tasklist (RTTaskList const& rt)
 	}
 
 	_graph_chain = 0;
+	select_scheduler ();
+
 	DEBUG_TRACE (DEBUG::ProcessThreads, "wake graph for RTTask processing\n");
 	_callback_start_sem.signal ();
 	_callback_done_sem.wait ();
@@ -658,9 +877,97 @@ GraphChain::GraphChain (GraphNodeList const& nodelist, GraphEdges const& edges)
 			_n_terminal_nodes += 1;
 		}
 	}
+
+	/* Sort nodes topologically for critical-path analysis */
+	std::map<GraphNode const*, int>    refcnt;
+	std::map<GraphNode const*, size_t> index;
+	std::list<GraphNode*>              ready;
+
+	for (auto const& ni : _nodes_rt) {
+		refcnt[ni.get ()] = ni->init_refcount (this);
+	}
+	for (auto const& ni : _init_trigger_list) {
+		ready.push_back (ni.get ());
+	}
+	while (!ready.empty ()) {
+		GraphNode* n = ready.front ();
+		ready.pop_front ();
+		index[n] = _topo_order.size ();
+		_topo_order.push_back (n);
+		for (auto const& ai : n->activation_set (this)) {
+			if (--refcnt[ai.get ()] == 0) {
+				ready.push_back (ai.get ());
+			}
+		}
+	}
+	assert (_topo_order.size () == _nodes_rt.size ());
+
+	_topo_feeds.resize (_topo_order.size ());
+	for (size_t i = 0; i < _topo_order.size (); ++i) {
+		for (auto const& ai : _topo_order[i]->activation_set (this)) {
+			_topo_feeds[i].push_back (index[ai.get ()]);
+		}
+	}
+
+	for (auto const& ni : _init_trigger_list) {
+		_init_trigger_rt.push_back (ni.get ());
+	}
+
 	dump ();
 }
 
+void
+GraphChain::update_critical_path ()
+{
+	/* walk backwards from the terminal nodes */
+	for (size_t i = _topo_order.size (); i > 0; --i) {
+		GraphNode* n   = _topo_order[i - 1];
+		float      max = 0;
+		for (auto const& f : _topo_feeds[i - 1]) {
+			max = std::max (max, _topo_order[f]->_critical_path_us);
+		}
+		n->_critical_path_us = n->process_time_us () + max;
+	}
+
+	/* insertion sort, the order rarely changes from one cycle to the next */
+	for (size_t i = 1; i < _init_trigger_rt.size (); ++i) {
+		GraphNode* n = _init_trigger_rt[i];
+		size_t     j = i;
+		for (; j > 0 && _init_trigger_rt[j - 1]->_critical_path_us < n->_critical_path_us; --j) {
+			_init_trigger_rt[j] = _init_trigger_rt[j - 1];
+		}
+		_init_trigger_rt[j] = n;
+	}
+}
+
+float
+GraphChain::critical_path_us () const
+{
+	return _init_trigger_rt.empty () ? 0 : _init_trigger_rt.front ()->_critical_path_us;
+}
+
+/** Collect the nodes on the longest path, as measured during the most recent cycles */
+void
+GraphChain::critical_path (std::set<GraphNode const*>& path) const
+{
+	GraphNode const* n = 0;
+	for (auto const& ni : _init_trigger_list) {
+		if (!n || ni->_critical_path_us > n->_critical_path_us) {
+			n = ni.get ();
+		}
+	}
+	while (n) {
+		path.insert (n);
+		GraphNode const* next = 0;
+		for (auto const& ai : n->activation_set (this)) {
+			if (!next || ai->_critical_path_us > next->_critical_path_us) {
+				next = ai.get ();
+			}
+		}
+		n = next;
+	}
+}
+
 GraphChain::~GraphChain ()
 {
 	/* clear chain */
@@ -682,11 +989,20 @@ GraphChain::plot (std::string const& file_name) const
 	node_set_t::const_iterator  ai;
 	stringstream                ss;
 
+	std::set<GraphNode const*> cp;
+	critical_path (cp);
+
 	ss << "digraph {\n";
 	ss << "  node [shape = ellipse];\n";
+	ss << string_compose ("  label = \"critical path: %1 us\";\n", critical_path_us ());
 
 	for (auto const& ni : _nodes_rt) {
 		std::string sn = string_compose ("%1 (%2)", ni->graph_node_name (), ni->init_refcount (this));
+		ss << "  \"" << sn << "\"[label=\"" << sn << "\\n" << string_compose ("%1 / %2 us", ni->process_time_us (), ni->critical_path_us ()) << "\"";
+		if (cp.find (ni.get ()) != cp.end ()) {
+			ss << ",color=red,penwidth=2";
+		}
+		ss << "];\n";
 		if (ni->init_refcount (this) == 0 && ni->activation_set (this).size () == 0) {
 			ss << "  \"" << sn << "\"[style=filled,fillcolor=gold1];\n";
 		} else if (ni->init_refcount (this) == 0) {
@@ -701,7 +1017,11 @@ GraphChain::plot (std::string const& file_name) const
 			if (sends_only) {
 				ss << "  edge [style=dashed];\n";
 			}
-			ss << "  \"" << sn << "\" -> \"" << dn << "\"\n";
+			ss << "  \"" << sn << "\" -> \"" << dn << "\"";
+			if (cp.find (ni.get ()) != cp.end () && cp.find (ai.get ()) != cp.end ()) {
+				ss << "[color=red,penwidth=2]";
+			}
+			ss << "\n";
 			if (sends_only) {
 				ss << "  edge [style=solid];\n";
 			}
@@ -738,6 +1058,15 @@ GraphChain::dump () const
 	}
 
 	DEBUG_TRACE (DEBUG::Graph, string_compose ("final activation refcount: %1\n", _n_terminal_nodes));
+
+	std::set<GraphNode const*> cp;
+	critical_path (cp);
+	DEBUG_TRACE (DEBUG::Graph, string_compose (" --- critical path: %1 us ---\n", critical_path_us ()));
+	for (auto const& ni : _topo_order) {
+		if (cp.find (ni) != cp.end ()) {
+			DEBUG_TRACE (DEBUG::Graph, string_compose ("GraphNode: %1  process: %2 us  path: %3 us\n", ni->graph_node_name (), ni->process_time_us (), ni->critical_path_us ()));
+		}
+	}
 	DEBUG_TRACE (DEBUG::Graph, "-->8-- END Graph dump ------------------------\n");
 #endif
 }
@@ -18,6 +18,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "pbd/microseconds.h"
+
+#include "ardour/dsp_profiler.h"
 #include "ardour/graphnode.h"
 #include "ardour/graph.h"
 #include "ardour/route.h"
@@ -48,6 +51,7 @@ GraphActivision::init_refcount (GraphChain const* const g) const
 
 GraphNode::GraphNode (boost::shared_ptr<Graph> graph)
 	: _graph (graph)
+	, _critical_path_us (0)
 {
 	g_atomic_int_set (&_refcount, 0);
 }
@@ -57,25 +61,56 @@ GraphNode::prep (GraphChain const* chain)
 {
 	/* This is the number of nodes that directly feed us */
 	g_atomic_int_set (&_refcount, init_refcount (chain));
+
+	int64_t period_us = _graph->period_us ();
+	if (period_us > 0 && period_us != _dsp_load.get_max_time_us ()) {
+		_dsp_load.set_max_time_us (period_us);
+	}
 }
 
 void
 GraphNode::run (GraphChain const* chain)
 {
+	bool measure = _dsp_load.get_max_time_us () > 0;
+
+	PBD::microseconds_t start = 0;
+
+	if (measure) {
+		start = PBD::get_microseconds ();
+		_dsp_load.set_start_timestamp_us (start);
+	}
+
 	process ();
+
+	if (measure) {
+		PBD::microseconds_t const end = PBD::get_microseconds ();
+		_dsp_load.set_stop_timestamp_us (end);
+		_process_histogram.add (end - start);
+
+		DSPProfiler& profiler (_graph->dsp_profiler ());
+		if (profiler.tracing ()) {
+			profiler.record_node (this, start, end);
+		}
+	}
+
 	finish (chain);
 }
 
+/** Called by an upstream node, when it has completed processing.
+ * @return true if all nodes that feed this node have completed
+ */
+bool
+GraphNode::release ()
+{
+	return g_atomic_int_dec_and_test (&_refcount);
+}
+
 /** Called by an upstream node, when it has completed processing */
 void
 GraphNode::trigger ()
 {
 	/* check if we can run */
-	if (g_atomic_int_dec_and_test (&_refcount)) {
-#if 0 // TODO optimize: remove prep()
-		/* reset reference count for next cycle */
-		g_atomic_int_set (&_refcount, _init_refcount[chain]);
-#endif
+	if (release ()) {
 		/* All nodes that feed this node have completed, so this node be processed now. */
 		_graph->trigger (this);
 	}
@@ -84,13 +119,39 @@ GraphNode::trigger ()
 void
 GraphNode::finish (GraphChain const* chain)
 {
-	node_set_t::iterator i;
-	bool                 feeds = false;
+	bool feeds = false;
+
+	/* Nodes that became ready, to be queued on the longest remaining path
+	 * first (see GraphChain::update_critical_path). If more nodes than
+	 * fit here become ready at once, the others are queued right away.
+	 */
+	static const size_t max_ready = 32;
+	GraphNode*          ready[max_ready];
+	size_t              n_ready = 0;
 
 	/* Notify downstream nodes that depend on this node */
 	for (auto const& i : activation_set (chain)) {
-		i->trigger ();
 		feeds = true;
+
+		if (!i->release ()) {
+			continue;
+		}
+
+		if (n_ready == max_ready) {
+			_graph->trigger (i.get ());
+			continue;
+		}
+
+		/* insertion sort, longest remaining path first */
+		size_t j = n_ready++;
+		for (; j > 0 && ready[j - 1]->_critical_path_us < i->_critical_path_us; --j) {
+			ready[j] = ready[j - 1];
+		}
+		ready[j] = i.get ();
+	}
+
+	for (size_t j = 0; j < n_ready; ++j) {
+		_graph->trigger (ready[j]);
 	}
 
 	if (!feeds) {
@@ -51,6 +51,7 @@
 #include "ardour/disk_reader.h"
 #include "ardour/disk_writer.h"
 #include "ardour/dsp_filter.h"
+#include "ardour/dsp_profiler.h"
 #include "ardour/file_source.h"
 #include "ardour/filesystem_paths.h"
 #include "ardour/fluid_synth.h"
@@ -465,6 +466,15 @@ LuaBindings::common (lua_State* L)
 
 		.beginStdVector <PBD::ID> ("IdVector").endClass ()
 
+		.beginClass <PBD::TimingHistogram> ("TimingHistogram")
+		.addConst ("n_buckets", PBD::TimingHistogram::n_buckets)
+		.addStaticFunction ("bucket_limit", &PBD::TimingHistogram::bucket_limit)
+		.addFunction ("count", &PBD::TimingHistogram::count)
+		.addFunction ("total", &PBD::TimingHistogram::total)
+		.addFunction ("max", &PBD::TimingHistogram::max)
+		.addFunction ("percentile", &PBD::TimingHistogram::percentile)
+		.endClass ()
+
 		.beginClass <XMLNode> ("XMLNode")
 		.addFunction ("name", &XMLNode::name)
 		.endClass ()
@@ -1065,6 +1075,15 @@ LuaBindings::common (lua_State* L)
 		.beginClass <Progress> ("Progress")
 		.endClass ()
 
+		.beginClass <DSPProfiler> ("DSPProfiler")
+		.addFunction ("enabled", &DSPProfiler::enabled)
+		.addFunction ("set_enabled", &DSPProfiler::set_enabled)
+		.addFunction ("reset_stats", &DSPProfiler::reset_stats)
+		.addFunction ("start_trace", &DSPProfiler::start_trace)
+		.addFunction ("trace_complete", &DSPProfiler::trace_complete)
+		.addFunction ("write_trace", &DSPProfiler::write_trace)
+		.endClass ()
+
 		.beginClass <TimelineRange> ("TimelineRange")
 		.addConstructor <void (*) (Temporal::timepos_t, Temporal::timepos_t, uint32_t)> ()
 		.addFunction ("length", &TimelineRange::length)
@@ -1403,6 +1422,7 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("set_active", &Route::set_active)
 		.addFunction ("nth_plugin", &Route::nth_plugin)
 		.addFunction ("nth_processor", &Route::nth_processor)
+		.addFunction ("process_histogram", &Route::process_histogram)
 		.addFunction ("nth_send", &Route::nth_send)
 		.addFunction ("add_foldback_send", &Route::add_foldback_send)
 		.addFunction ("add_processor_by_index", &Route::add_processor_by_index)
@@ -1808,6 +1828,7 @@ LuaBindings::common (lua_State* L)
 		.addFunction ("output_streams", &Processor::output_streams)
 		.addFunction ("input_streams", &Processor::input_streams)
 		.addFunction ("signal_latency", &Processor::signal_latency)
+		.addFunction ("process_histogram", &Processor::process_histogram)
 		.endClass ()
 
 		.deriveWSPtrClass <DiskIOProcessor, Processor> ("DiskIOProcessor")
@@ -2517,6 +2538,11 @@ LuaBindings::common (lua_State* L)
 		.addConst ("DenormalFTZDAZ", ARDOUR::DenormalModel(DenormalFTZDAZ))
 		.endNamespace ()
 
+		.beginNamespace ("GraphScheduling")
+		.addConst ("SharedTriggerQueue", ARDOUR::GraphScheduling(SharedTriggerQueue))
+		.addConst ("WorkStealing", ARDOUR::GraphScheduling(WorkStealing))
+		.endNamespace ()
+
 		.beginNamespace ("BufferingPreset")
 		.addConst ("Small", ARDOUR::BufferingPreset(Small))
 		.addConst ("Medium", ARDOUR::BufferingPreset(Medium))
@@ -2795,6 +2821,7 @@ LuaBindings::common (lua_State* L)
 		.beginNamespace ("ARDOUR")
 		.beginClass <Session> ("Session")
 		.addFunction ("scripts_changed", &Session::scripts_changed) // used internally
+		.addFunction ("dsp_profiler", &Session::dsp_profiler)
 		.addFunction ("engine_speed", &Session::engine_speed)
 		.addFunction ("actual_speed", &Session::actual_speed)
 		.addFunction ("transport_speed", &Session::transport_speed)
@@ -269,6 +269,9 @@ MidiModel::NoteDiffCommand::operator() ()
 				assert (i->note);
 			}
 
+			/* notes are changed in place, mark both old and new extent */
+			_model->mark_dirty (i->note->time(), i->note->end_time());
+
 			switch (prop) {
 			case NoteNumber:
 				if (temporary_removals.find (i->note) == temporary_removals.end()) {
@@ -306,6 +309,8 @@ MidiModel::NoteDiffCommand::operator() ()
 				break;
 
 			}
+
+			_model->mark_dirty (i->note->time(), i->note->end_time());
 		}
 
 		for (set<NotePtr>::iterator i = temporary_removals.begin(); i != temporary_removals.end(); ++i) {
@@ -368,6 +373,8 @@ MidiModel::NoteDiffCommand::undo ()
 		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
 			Property prop = i->property;
 
+			_model->mark_dirty (i->note->time(), i->note->end_time());
+
 			switch (prop) {
 			case NoteNumber:
 				if (temporary_removals.find (i->note) == temporary_removals.end() &&
@@ -420,6 +427,8 @@ MidiModel::NoteDiffCommand::undo ()
 				i->note->set_length (i->old_value.get_beats());
 				break;
 			}
+
+			_model->mark_dirty (i->note->time(), i->note->end_time());
 		}
 
 		for (NoteList::iterator i = _removed_notes.begin(); i != _removed_notes.end(); ++i) {
@@ -721,7 +730,9 @@ MidiModel::SysExDiffCommand::operator() ()
 		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
 			switch (i->property) {
 			case Time:
+				_model->mark_dirty (i->sysex->time(), i->sysex->time());
 				i->sysex->set_time (i->new_time);
+				_model->mark_dirty (i->sysex->time(), i->sysex->time());
 			}
 		}
 	}
@@ -751,7 +762,9 @@ MidiModel::SysExDiffCommand::undo ()
 		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
 			switch (i->property) {
 			case Time:
+				_model->mark_dirty (i->sysex->time(), i->sysex->time());
 				i->sysex->set_time (i->old_time);
+				_model->mark_dirty (i->sysex->time(), i->sysex->time());
 				break;
 			}
 		}
@@ -957,6 +970,8 @@ MidiModel::PatchChangeDiffCommand::operator() ()
 		set<PatchChangePtr> temporary_removals;
 
 		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
+			_model->mark_dirty (i->patch->time(), i->patch->time());
+
 			switch (i->property) {
 			case Time:
 				if (temporary_removals.find (i->patch) == temporary_removals.end()) {
@@ -1014,6 +1029,8 @@ MidiModel::PatchChangeDiffCommand::undo ()
 		set<PatchChangePtr> temporary_removals;
 
 		for (ChangeList::iterator i = _changes.begin(); i != _changes.end(); ++i) {
+			_model->mark_dirty (i->patch->time(), i->patch->time());
+
 			switch (i->property) {
 			case Time:
 				if (temporary_removals.find (i->patch) == temporary_removals.end()) {
@@ -1266,6 +1283,35 @@ MidiModel::sync_to_source (const Source::WriterLock& source_lock)
 	   on the next roll if time progresses linearly. */
 	_midi_source.invalidate(source_lock);
 
+	/* If the changes since the last sync are known, and the source still
+	 * holds what we wrote then, only rewrite the range that changed.
+	 */
+	TimeType dirty_start;
+	TimeType dirty_end;
+
+	if (dirty_range (dirty_start, dirty_end)) {
+
+		if (dirty_start <= dirty_end) {
+			extend_to_whole_notes (dirty_start, dirty_end);
+		}
+
+		if (_midi_source.mark_range_write_started (source_lock, dirty_start, dirty_end)) {
+
+			if (dirty_start <= dirty_end) {
+				for (Evoral::Sequence<TimeType>::const_iterator i = begin (dirty_start, true); i != end() && i->time() <= dirty_end; ++i) {
+					_midi_source.append_event_beats (source_lock, *i);
+				}
+			}
+
+			_midi_source.mark_range_write_completed (source_lock);
+
+			clear_dirty ();
+			set_edited (false);
+
+			return true;
+		}
+	}
+
 	/* as of March 2022 or long before , the note mode argument does nothing */
 	_midi_source.mark_streaming_midi_write_started (source_lock, Sustained);
 
@@ -1275,11 +1321,38 @@ MidiModel::sync_to_source (const Source::WriterLock& source_lock)
 
 	_midi_source.mark_streaming_write_completed (source_lock);
 
+	clear_dirty ();
 	set_edited (false);
 
 	return true;
 }
 
+/** Extend [start, end] so that no note crosses its boundaries.
+ *
+ * A partial rewrite replaces all events in the range, so it must not
+ * separate a note-on from its note-off.
+ */
+void
+MidiModel::extend_to_whole_notes (TimeType& start, TimeType& end) const
+{
+	bool changed = true;
+
+	while (changed) {
+		changed = false;
+
+		for (Notes::const_iterator n = notes().begin(); n != notes().end() && (*n)->time() <= end; ++n) {
+			if ((*n)->time() < start && (*n)->end_time() >= start) {
+				start   = (*n)->time();
+				changed = true;
+			}
+			if ((*n)->end_time() > end) {
+				end     = (*n)->end_time();
+				changed = true;
+			}
+		}
+	}
+}
+
 /** Write part or all of the model to a MidiSource (i.e. save the model).
  * This is different from manually using read to write to a source in that
  * note off events are written regardless of the track mode.  This is so the
@@ -1375,17 +1448,11 @@ MidiModel::find_note (NotePtr other)
 Evoral::Sequence<MidiModel::TimeType>::NotePtr
 MidiModel::find_note (Evoral::event_id_t note_id)
 {
-	/* used only for looking up notes when reloading history from disk,
-	   so we don't care about performance *too* much.
-	*/
-
-	for (Notes::iterator l = notes().begin(); l != notes().end(); ++l) {
-		if ((*l)->id() == note_id) {
-			return *l;
-		}
-	}
+	/* used when reloading history from disk, once per note of every
+	 * NoteDiffCommand, so it must not scan all notes.
+	 */
 
-	return NotePtr();
+	return note_by_id (note_id);
 }
 
 MidiModel::PatchChangePtr
@@ -1481,6 +1548,9 @@ MidiModel::resolve_overlaps_unlocked (const NotePtr note, void* arg)
 			             "\toverlap is %1 for (%2,%3) vs (%4,%5)\n",
 			             enum_2_string(overlap), sa, ea, sb, eb));
 
+		/* existing notes may be changed in place below */
+		mark_dirty (min (sa, sb), max (ea, eb));
+
 		if (insert_merge_policy() == InsertMergeReject) {
 			DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1 just reject\n", this));
 			return -1;
@@ -25,10 +25,13 @@
 #include <iostream>
 #include <utility>
 
+#include <boost/bind.hpp>
+
 #include "evoral/EventList.h"
 #include "evoral/Control.h"
 
 #include "ardour/debug.h"
+#include "ardour/midi_channel_filter.h"
 #include "ardour/midi_model.h"
 #include "ardour/midi_playlist.h"
 #include "ardour/midi_region.h"
@@ -50,6 +53,10 @@ using namespace std;
 MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 	: Playlist (session, node, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _render_filter (0)
+	, _render_filter_mode (AllChannels)
+	, _render_filter_mask (0)
+	, _render_note_mode (Sustained)
 {
 #ifndef NDEBUG
 	XMLProperty const * prop = node.property("type");
@@ -68,12 +75,20 @@ MidiPlaylist::MidiPlaylist (Session& session, const XMLNode& node, bool hidden)
 MidiPlaylist::MidiPlaylist (Session& session, string name, bool hidden)
 	: Playlist (session, name, DataType::MIDI, hidden)
 	, _note_mode(Sustained)
+	, _render_filter (0)
+	, _render_filter_mode (AllChannels)
+	, _render_filter_mask (0)
+	, _render_note_mode (Sustained)
 {
 }
 
 MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other, string name, bool hidden)
 	: Playlist (other, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _render_filter (0)
+	, _render_filter_mode (AllChannels)
+	, _render_filter_mask (0)
+	, _render_note_mode (Sustained)
 {
 }
 
@@ -84,6 +99,10 @@ MidiPlaylist::MidiPlaylist (boost::shared_ptr<const MidiPlaylist> other,
                             bool                                  hidden)
 	: Playlist (other, start, dur, name, hidden)
 	, _note_mode(other->_note_mode)
+	, _render_filter (0)
+	, _render_filter_mode (AllChannels)
+	, _render_filter_mask (0)
+	, _render_note_mode (Sustained)
 {
 }
 
@@ -91,23 +110,85 @@ MidiPlaylist::~MidiPlaylist ()
 {
 }
 
+static inline bool
+is_midi_event_type (Evoral::EventType t)
+{
+	return t == Evoral::MIDI_EVENT || t == Evoral::LIVE_MIDI_EVENT;
+}
+
+template <typename Time>
+static inline bool
+event_sorts_before (Time at, Evoral::EventType atype, uint8_t const* abuf, Time bt, Evoral::EventType btype, uint8_t const* bbuf)
+{
+	if (at == bt) {
+		if (is_midi_event_type (atype) && is_midi_event_type (btype)) {
+			/* negate return value since we must return whether
+			 * or not a should sort before b, not b before a
+			 */
+			return !MidiBuffer::second_simultaneous_midi_byte_is_first (abuf[0], bbuf[0]);
+		}
+		return (abuf[0] & 0xf0) < (bbuf[0] & 0xf0);
+	}
+	return at < bt;
+}
+
 template <typename Time>
 struct EventsSortByTimeAndType {
 	bool operator() (const Evoral::Event<Time>* a, const Evoral::Event<Time>* b)
 	{
-		if (a->time () == b->time ()) {
-			if (a->is_midi () && b->is_midi ()) {
-				/* negate return value since we must return whether
-				 * or not a should sort before b, not b before a
-				 */
-				return !MidiBuffer::second_simultaneous_midi_byte_is_first (a->buffer ()[0], b->buffer ()[0]);
-			}
-			return a->type () < b->type ();
-		}
-		return a->time () < b->time ();
+		return event_sorts_before (a->time (), a->event_type (), a->buffer (), b->time (), b->event_type (), b->buffer ());
 	}
 };
 
+MidiPlaylist::RenderedRegion::RenderedRegion (boost::shared_ptr<MidiRegion> const& mr)
+	: _position (mr->position ())
+	, _start (mr->start ())
+	, _length (mr->length ())
+{
+}
+
+uint32_t
+MidiPlaylist::RenderedRegion::write (samplepos_t time, Evoral::EventType type, uint32_t size, const uint8_t* buf)
+{
+	Item i;
+	i.time   = time;
+	i.type   = type;
+	i.size   = size;
+	i.offset = _data.size ();
+
+	_data.insert (_data.end (), buf, buf + size);
+	_items.push_back (i);
+
+	return size;
+}
+
+bool
+MidiPlaylist::RenderedRegion::before (Item const& a, Item const& b) const
+{
+	return event_sorts_before (a.time, a.type, buffer (a), b.time, b.type, buffer (b));
+}
+
+void
+MidiPlaylist::RenderedRegion::sort ()
+{
+	/* stable, so that the result is the same as sorting an EventList */
+	std::stable_sort (_items.begin (), _items.end (), boost::bind (&RenderedRegion::before, this, _1, _2));
+}
+
+void
+MidiPlaylist::RenderedRegion::copy_to (Evoral::EventSink<samplepos_t>& dst) const
+{
+	for (std::vector<Item>::const_iterator i = _items.begin (); i != _items.end (); ++i) {
+		dst.write (i->time, i->type, i->size, buffer (*i));
+	}
+}
+
+bool
+MidiPlaylist::RenderedRegion::stale (boost::shared_ptr<MidiRegion> const& mr) const
+{
+	return !(mr->position () == _position && mr->start () == _start && mr->length () == _length);
+}
+
 void
 MidiPlaylist::remove_dependents (boost::shared_ptr<Region> region)
 {
@@ -122,6 +203,20 @@ MidiPlaylist::region_going_away (boost::weak_ptr<Region> region)
 	}
 }
 
+bool
+MidiPlaylist::region_changed (const PBD::PropertyChange& what_changed, boost::shared_ptr<Region> region)
+{
+	/* any change (contents, bounds, filtered parameters..) requires
+	 * rendering the region again, the next time that render() is called.
+	 */
+	{
+		Glib::Threads::Mutex::Lock lm (_render_invalid_lock);
+		_render_invalid.insert (region->id ());
+	}
+
+	return Playlist::region_changed (what_changed, region);
+}
+
 int
 MidiPlaylist::set_state (const XMLNode& node, int version)
 {
@@ -282,6 +377,86 @@ MidiPlaylist::contained_automation()
 	return ret;
 }
 
+boost::shared_ptr<MidiPlaylist::RenderedRegion>
+MidiPlaylist::rendered_region (boost::shared_ptr<MidiRegion> const& mr, MidiChannelFilter* filter, RenderCache& used)
+{
+	RenderCache::iterator i = _render_cache.find (mr->id ());
+
+	if (i != _render_cache.end () && !i->second->stale (mr)) {
+		used.insert (*i);
+		return i->second;
+	}
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("render from %1\n", mr->name()));
+
+	boost::shared_ptr<RenderedRegion> rr (new RenderedRegion (mr));
+	mr->render (*rr, 0, _note_mode, filter);
+	rr->sort ();
+
+	used.insert (make_pair (mr->id (), rr));
+	return rr;
+}
+
+namespace {
+/* a position in one of the regions being merged by MidiPlaylist::merge_rendered() */
+struct MergeCursor {
+	size_t region; /* index, top-most region first */
+	size_t item;
+};
+}
+
+void
+MidiPlaylist::merge_rendered (std::vector<boost::shared_ptr<RenderedRegion> > const& rendered)
+{
+	/* k-way merge of the (sorted) regions into _rendered. Events at the
+	 * same time and of the same kind keep their order within a region,
+	 * and the upper region comes first, the same as when sorting the
+	 * events of all regions together.
+	 */
+
+	auto later = [&rendered] (MergeCursor const& a, MergeCursor const& b) {
+		RenderedRegion const& ra (*rendered[a.region]);
+		RenderedRegion const& rb (*rendered[b.region]);
+		RenderedRegion::Item const& ia (ra.items ()[a.item]);
+		RenderedRegion::Item const& ib (rb.items ()[b.item]);
+
+		if (event_sorts_before (ib.time, ib.type, rb.buffer (ib), ia.time, ia.type, ra.buffer (ia))) {
+			return true;
+		}
+		if (event_sorts_before (ia.time, ia.type, ra.buffer (ia), ib.time, ib.type, rb.buffer (ib))) {
+			return false;
+		}
+		return a.region > b.region;
+	};
+
+	std::vector<MergeCursor> heap;
+	heap.reserve (rendered.size ());
+
+	for (size_t n = 0; n < rendered.size (); ++n) {
+		if (!rendered[n]->items ().empty ()) {
+			MergeCursor c = { n, 0 };
+			heap.push_back (c);
+		}
+	}
+
+	std::make_heap (heap.begin (), heap.end (), later);
+
+	while (!heap.empty ()) {
+		std::pop_heap (heap.begin (), heap.end (), later);
+		MergeCursor& c (heap.back ());
+
+		RenderedRegion const& rr (*rendered[c.region]);
+		RenderedRegion::Item const& i (rr.items ()[c.item]);
+		_rendered.write (i.time, i.type, i.size, rr.buffer (i));
+
+		if (++c.item < rr.items ().size ()) {
+			std::push_heap (heap.begin (), heap.end (), later);
+		} else {
+			heap.pop_back ();
+		}
+	}
+}
+
 void
 MidiPlaylist::render (MidiChannelFilter* filter)
 {
@@ -311,10 +486,47 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 		regs.push_back (mr);
 	}
 
+	Glib::Threads::Mutex::Lock lm (_render_lock);
+
+	/* Regions are rendered in samples, using the current tempo map and
+	 * channel filter. If either changed, all regions need to be rendered
+	 * again. Otherwise only those that changed since the last call.
+	 */
+
+	ChannelMode filter_mode = AllChannels;
+	uint16_t    filter_mask = 0;
+
+	if (filter) {
+		filter->get_mode_and_mask (&filter_mode, &filter_mask);
+	}
+
+	Temporal::TempoMap::SharedPtr tmap (Temporal::TempoMap::use ());
+
+	if (tmap != _render_tempo_map || filter != _render_filter || filter_mode != _render_filter_mode || filter_mask != _render_filter_mask || _note_mode != _render_note_mode) {
+		_render_cache.clear ();
+		_render_tempo_map   = tmap;
+		_render_filter      = filter;
+		_render_filter_mode = filter_mode;
+		_render_filter_mask = filter_mask;
+		_render_note_mode   = _note_mode;
+	}
+
+	{
+		Glib::Threads::Mutex::Lock lx (_render_invalid_lock);
+		for (std::set<PBD::ID>::const_iterator i = _render_invalid.begin(); i != _render_invalid.end(); ++i) {
+			_render_cache.erase (*i);
+		}
+		_render_invalid.clear ();
+	}
+
+	/* regions that are not rendered this time are dropped from the cache */
+	RenderCache used;
+
 	/* RAII */
 	RTMidiBuffer::WriteProtectRender wpr (_rendered);
 
 	if (regs.empty()) {
+		_render_cache.clear ();
 		wpr.acquire ();
 		_rendered.clear ();
 		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
@@ -322,11 +534,11 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 	}
 
 	if (regs.size() == 1) {
+		boost::shared_ptr<RenderedRegion> rr = rendered_region (regs.front (), filter, used);
+		_render_cache.swap (used);
 		wpr.acquire ();
 		_rendered.clear ();
-		boost::shared_ptr<MidiRegion> mr = regs.front ();
-		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("render from %1\n", mr->name()));
-		mr->render (_rendered, 0, _note_mode, filter);
+		rr->copy_to (_rendered);
 		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
 		return;
 	}
@@ -344,82 +556,92 @@ MidiPlaylist::render (MidiChannelFilter* filter)
 		}
 	}
 
-	Evoral::EventList<samplepos_t> evlist;
-
 	if (all_transparent) {
 
 		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 regions to read\n", regs.size()));
 
+		std::vector<boost::shared_ptr<RenderedRegion> > rendered;
+		rendered.reserve (regs.size ());
+
+		/* top-most region first */
 		for (auto i = regs.rbegin(); i != regs.rend(); ++i) {
-			boost::shared_ptr<MidiRegion> mr = *i;
-			DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("render from %1\n", mr->name()));
-			mr->render (evlist, 0, _note_mode, filter);
+			rendered.push_back (rendered_region (*i, filter, used));
 		}
-		EventsSortByTimeAndType<samplepos_t> cmp;
-		evlist.sort (cmp);
 
-	} else {
+		_render_cache.swap (used);
 
-		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 layered regions to read\n", regs.size()));
+		wpr.acquire ();
+		_rendered.clear ();
+		merge_rendered (rendered);
 
-		bool top = true;
-		std::vector<samplepos_t> bounds;
-		EventsSortByTimeAndType<samplepos_t> cmp;
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("---- End MidiPlaylist::render, events: %1\n", _rendered.size()));
+		return;
+	}
 
-		/* iterate, top-most region first */
-		for (auto i = regs.rbegin(); i != regs.rend(); ++i) {
-			boost::shared_ptr<MidiRegion> mr = *i;
-			DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("maybe render from %1\n", mr->name()));
-
-			if (top) {
-				/* render topmost region as-is */
-				mr->render (evlist, 0, _note_mode, filter);
-				top = false;
-			} else {
-				Evoral::EventList<samplepos_t> tmp;
-				mr->render (tmp, 0, _note_mode, filter);
-
-				/* insert region-bound markers of opaque regions above */
-				for (auto const& p : bounds) {
-					tmp.write (p, Evoral::NO_EVENT, 0, 0);
-				}
-				tmp.sort (cmp);
-
-				MidiStateTracker mtr;
-				Evoral::EventList<samplepos_t> const slist (evlist);
-
-				for (Evoral::EventList<samplepos_t>::iterator e = tmp.begin(); e != tmp.end(); ++e) {
-					Evoral::Event<samplepos_t>* ev (*e);
-					timepos_t t (ev->time());
-
-					if (ev->event_type () == Evoral::NO_EVENT) {
-						/* reached region bound of an opaque region above this region. */
-						mtr.resolve_state (evlist, slist, ev->time());
-					} else if (region_is_audible_at (mr, t)) {
-						/* no opaque region above this event */
-						uint8_t* evbuf = ev->buffer();
-						if (3 == ev->size() && (evbuf[0] & 0xf0) == MIDI_CMD_NOTE_OFF && !mtr.active (evbuf[1], evbuf[0] & 0x0f)) {
-							; /* skip note off */
-						} else {
-							evlist.write (ev->time(), ev->event_type(), ev->size(), evbuf);
-							mtr.track (evbuf);
-						}
+	Evoral::EventList<samplepos_t> evlist;
+
+	DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("\t%1 layered regions to read\n", regs.size()));
+
+	bool top = true;
+	std::vector<samplepos_t> bounds;
+	EventsSortByTimeAndType<samplepos_t> ecmp;
+
+	/* iterate, top-most region first */
+	for (auto i = regs.rbegin(); i != regs.rend(); ++i) {
+		boost::shared_ptr<MidiRegion> mr = *i;
+		DEBUG_TRACE (DEBUG::MidiPlaylistIO, string_compose ("maybe render from %1\n", mr->name()));
+
+		boost::shared_ptr<RenderedRegion> rr = rendered_region (mr, filter, used);
+
+		if (top) {
+			/* render topmost region as-is */
+			rr->copy_to (evlist);
+			top = false;
+		} else {
+			Evoral::EventList<samplepos_t> tmp;
+			rr->copy_to (tmp);
+
+			/* insert region-bound markers of opaque regions above */
+			for (auto const& p : bounds) {
+				tmp.write (p, Evoral::NO_EVENT, 0, 0);
+			}
+			tmp.sort (ecmp);
+
+			MidiStateTracker mtr;
+			Evoral::EventList<samplepos_t> const slist (evlist);
+
+			for (Evoral::EventList<samplepos_t>::iterator e = tmp.begin(); e != tmp.end(); ++e) {
+				Evoral::Event<samplepos_t>* ev (*e);
+				timepos_t t (ev->time());
+
+				if (ev->event_type () == Evoral::NO_EVENT) {
+					/* reached region bound of an opaque region above this region. */
+					mtr.resolve_state (evlist, slist, ev->time());
+				} else if (region_is_audible_at (mr, t)) {
+					/* no opaque region above this event */
+					uint8_t* evbuf = ev->buffer();
+					if (3 == ev->size() && (evbuf[0] & 0xf0) == MIDI_CMD_NOTE_OFF && !mtr.active (evbuf[1], evbuf[0] & 0x0f)) {
+						; /* skip note off */
 					} else {
-						/* there is an opaque region above this event, skip this event. */
+						evlist.write (ev->time(), ev->event_type(), ev->size(), evbuf);
+						mtr.track (evbuf);
 					}
-					delete ev;
+				} else {
+					/* there is an opaque region above this event, skip this event. */
 				}
+				delete ev;
 			}
+		}
 
-			if (mr->opaque ()) {
-				bounds.push_back (mr->position ().samples ());
-			}
-
-			EventsSortByTimeAndType<samplepos_t> cmp;
-			evlist.sort (cmp);
+		if (mr->opaque ()) {
+			bounds.push_back (mr->position ().samples ());
 		}
+
+		evlist.sort (ecmp);
 	}
 
+	_render_cache.swap (used);
+
 	wpr.acquire ();
 	_rendered.clear ();
 
@@ -454,6 +454,7 @@ MidiRegion::clobber_sources (boost::shared_ptr<MidiSource> s)
 
        s->DropReferences.connect_same_thread (*this, boost::bind (&Region::source_deleted, this, boost::weak_ptr<Source>(s)));
 
+       RegionFactory::reindex_sources (*this);
 }
 
 void
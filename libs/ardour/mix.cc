@@ -21,6 +21,8 @@
  */
 
 #include <cmath>
+#include "pbd/control_math.h"
+
 #include "ardour/types.h"
 #include "ardour/utils.h"
 #include "ardour/mix.h"
@@ -145,6 +147,64 @@ default_copy_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, pframes_t
 	memcpy(dst, src, nframes*sizeof(ARDOUR::Sample));
 }
 
+void
+default_linear_ramp (ARDOUR::Sample * dst, pframes_t nframes, float y0, float dy)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] = y0 + i * dy;
+	}
+}
+
+void
+default_exp2_ramp (ARDOUR::Sample * dst, pframes_t nframes, float y0, float de)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] = y0 * exp2 (i * (double) de);
+	}
+}
+
+void
+default_gain_ramp (ARDOUR::Sample * dst, pframes_t nframes, float p0, float dp, float scale)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		const double p = p0 + i * (double) dp;
+		dst[i] = p > 0 ? scale * position_to_gain (p) : 0;
+	}
+}
+
+void
+default_cubic_ramp (ARDOUR::Sample * dst, pframes_t nframes, float a0, float a1, float a2, float a3, float dt)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		const float t = i * dt;
+		dst[i] = a0 + t * (a1 + t * (a2 + t * a3));
+	}
+}
+
+void
+default_apply_gain_vector (ARDOUR::Sample * dst, const float * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] *= gain[i];
+	}
+}
+
+void
+default_mix_buffers_with_gain_vector (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const float * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] += src[i] * gain[i];
+	}
+}
+
+void
+default_crossfade_buffers (ARDOUR::Sample * dst, const ARDOUR::Sample * src, const float * gain, pframes_t nframes)
+{
+	for (pframes_t i = 0; i < nframes; ++i) {
+		dst[i] = dst[i] * (1.f - gain[i]) + src[i] * gain[i];
+	}
+}
+
 #if defined (__APPLE__) && defined (BUILD_VECLIB_OPTIMIZATIONS)
 #include <Accelerate/Accelerate.h>
 
@@ -0,0 +1,722 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#ifdef COMPILER_MSVC
+#include <io.h> // Microsoft's nearest equivalent to <unistd.h>
+#else
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cerrno>
+#include <cstring>
+#include <fcntl.h>
+
+#ifdef PLATFORM_WINDOWS
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#endif
+
+#include <glib.h>
+#include "pbd/gstdio_compat.h"
+
+#include "pbd/compose.h"
+#include "pbd/scoped_file_descriptor.h"
+
+#include "ardour/debug.h"
+#include "ardour/peak_pyramid.h"
+
+#include "pbd/i18n.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char    pyramid_magic[4] = { 'A', 'P', 'K', 'P' };
+static const int64_t initial_capacity = 65536; // level 0 peaks, ~6 minutes @ 48kHz
+
+std::atomic<uint64_t> PeakPyramid::_mapped_reads (0);
+std::atomic<uint64_t> PeakPyramid::_maps (0);
+
+static inline void
+merge_peak (PeakData& acc, PeakData const& p)
+{
+	acc.min = min (acc.min, p.min);
+	acc.max = max (acc.max, p.max);
+}
+
+PeakPyramid::PeakPyramid (samplecnt_t base_fpp)
+	: _base_fpp (base_fpp)
+	, _fd (-1)
+	, _stale (false)
+	, _modified (false)
+	, _map_addr (0)
+	, _map_length (0)
+	, _map_failed (false)
+{
+	init_header (initial_capacity);
+	reset ();
+}
+
+PeakPyramid::~PeakPyramid ()
+{
+	close ();
+	unmap ();
+}
+
+void
+PeakPyramid::set_path (std::string const& path)
+{
+	close ();
+	unmap ();
+	_path = path;
+}
+
+int64_t
+PeakPyramid::level_size (uint32_t level, int64_t capacity)
+{
+	int64_t div = 1;
+	for (uint32_t l = 0; l < level; ++l) {
+		div *= factor;
+	}
+	return (capacity + div - 1) / div;
+}
+
+off_t
+PeakPyramid::level_offset (uint32_t level, int64_t capacity) const
+{
+	off_t off = sizeof (Header);
+	for (uint32_t l = 1; l < level; ++l) {
+		off += level_size (l, capacity) * sizeof (PeakData);
+	}
+	return off;
+}
+
+samplecnt_t
+PeakPyramid::samples_per_peak (uint32_t level) const
+{
+	samplecnt_t spp = _base_fpp;
+	for (uint32_t l = 0; l < level; ++l) {
+		spp *= factor;
+	}
+	return spp;
+}
+
+void
+PeakPyramid::init_header (int64_t capacity)
+{
+	memset (&_header, 0, sizeof (Header));
+	memcpy (_header.magic, pyramid_magic, sizeof (pyramid_magic));
+	_header.version  = version;
+	_header.base_fpp = _base_fpp;
+	_header.factor   = factor;
+	_header.n_levels = max_levels;
+	_header.capacity = capacity;
+}
+
+void
+PeakPyramid::reset ()
+{
+	for (uint32_t i = 0; i < max_levels; ++i) {
+		_acc_cnt[i]    = 0;
+		_n_complete[i] = 0;
+		_pending[i].clear ();
+	}
+	_next_base_peak = 0;
+	_stale          = false;
+}
+
+bool
+PeakPyramid::header_ok (Header const& h) const
+{
+	return 0 == memcmp (h.magic, pyramid_magic, sizeof (pyramid_magic))
+		&& h.version == version
+		&& h.base_fpp == (uint32_t) _base_fpp
+		&& h.factor == factor
+		&& h.n_levels == max_levels
+		&& h.capacity > 0;
+}
+
+int
+PeakPyramid::read_header (int fd, Header& h) const
+{
+	if (lseek (fd, 0, SEEK_SET) != 0) {
+		return -1;
+	}
+	if (::read (fd, &h, sizeof (Header)) != sizeof (Header)) {
+		return -1;
+	}
+	return header_ok (h) ? 0 : -1;
+}
+
+int
+PeakPyramid::write_header ()
+{
+	if (lseek (_fd, 0, SEEK_SET) != 0) {
+		return -1;
+	}
+	if (::write (_fd, &_header, sizeof (Header)) != sizeof (Header)) {
+		error << string_compose (_("%1: could not write peak pyramid header (%2)"), _path, strerror (errno)) << endmsg;
+		return -1;
+	}
+	return 0;
+}
+
+int
+PeakPyramid::write_peaks (uint32_t level, PeakData const* peaks, samplecnt_t first_peak, samplecnt_t n_peaks)
+{
+	off_t byte = level_offset (level, _header.capacity) + first_peak * sizeof (PeakData);
+
+	if (lseek (_fd, byte, SEEK_SET) != byte) {
+		return -1;
+	}
+
+	ssize_t bytes_to_write = n_peaks * sizeof (PeakData);
+
+	if (::write (_fd, peaks, bytes_to_write) != bytes_to_write) {
+		error << string_compose (_("%1: could not write peak pyramid data (%2)"), _path, strerror (errno)) << endmsg;
+		return -1;
+	}
+	return 0;
+}
+
+int
+PeakPyramid::open_for_write ()
+{
+	if (_fd >= 0) {
+		return 0;
+	}
+
+	if (_path.empty ()) {
+		return -1;
+	}
+
+	/* the file may be truncated, and readers may map a newly created file */
+	unmap ();
+
+	if ((_fd = g_open (_path.c_str (), O_CREAT | O_RDWR, 0664)) == -1) {
+		error << string_compose (_("PeakPyramid: cannot open \"%1\" (%2)"), _path, strerror (errno)) << endmsg;
+		return -1;
+	}
+
+	Header h;
+	if (read_header (_fd, h) == 0) {
+		_header = h;
+	} else {
+		/* missing, older version or corrupt. Start over */
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Initialize peak pyramid %1\n", _path));
+		init_header (initial_capacity);
+		if (ftruncate (_fd, 0) || write_header ()) {
+			::close (_fd);
+			_fd = -1;
+			return -1;
+		}
+	}
+
+	reset ();
+	_modified = false;
+	return 0;
+}
+
+void
+PeakPyramid::close ()
+{
+	if (_fd < 0) {
+		return;
+	}
+	flush ();
+	::close (_fd);
+	_fd = -1;
+}
+
+void
+PeakPyramid::push (uint32_t level, PeakData const& p)
+{
+	uint32_t const i = level - 1;
+
+	if (_acc_cnt[i] == 0) {
+		_acc[i] = p;
+	} else {
+		merge_peak (_acc[i], p);
+	}
+
+	if (++_acc_cnt[i] < factor) {
+		return;
+	}
+
+	_pending[i].push_back (_acc[i]);
+	_acc_cnt[i] = 0;
+
+	if (level < max_levels) {
+		push (level + 1, _pending[i].back ());
+	}
+}
+
+int
+PeakPyramid::add (PeakData const* peaks, samplecnt_t n_peaks, samplecnt_t first_peak)
+{
+	if (_fd < 0) {
+		return -1;
+	}
+
+	if (first_peak == 0) {
+		reset ();
+	} else if (first_peak != _next_base_peak) {
+		/* seek, partially accumulated peaks are lost */
+		DEBUG_TRACE (DEBUG::Peaks, string_compose ("Peak pyramid %1 is stale (%2 vs %3)\n", _path, first_peak, _next_base_peak));
+		_stale = true;
+	}
+
+	_modified       = true;
+	_next_base_peak = first_peak + n_peaks;
+
+	if (_stale) {
+		return 0;
+	}
+
+	if (_next_base_peak > _header.capacity && grow (_next_base_peak)) {
+		_stale = true;
+		return -1;
+	}
+
+	for (samplecnt_t n = 0; n < n_peaks; ++n) {
+		push (1, peaks[n]);
+	}
+
+	for (uint32_t i = 0; i < max_levels; ++i) {
+		if (_pending[i].empty ()) {
+			continue;
+		}
+		if (write_peaks (i + 1, &_pending[i][0], _n_complete[i], _pending[i].size ())) {
+			_stale = true;
+			return -1;
+		}
+		_n_complete[i] += _pending[i].size ();
+		_pending[i].clear ();
+	}
+
+	return 0;
+}
+
+int
+PeakPyramid::flush ()
+{
+	if (_fd < 0 || !_modified) {
+		return 0;
+	}
+
+	/* Write the partially accumulated peak of each level, so that readers
+	 * can use the pyramid up to the end of the data added so far.
+	 * The partial peak of a level includes the partial peak of the level
+	 * below, and is overwritten once it is complete.
+	 */
+	PeakData carry;
+	bool     have_carry = false;
+
+	for (uint32_t i = 0; i < max_levels; ++i) {
+		if (_stale) {
+			_header.n_peaks[i] = 0;
+			continue;
+		}
+
+		PeakData p;
+		bool     partial = false;
+
+		if (_acc_cnt[i] > 0) {
+			p       = _acc[i];
+			partial = true;
+		}
+
+		if (have_carry) {
+			if (partial) {
+				merge_peak (p, carry);
+			} else {
+				p = carry;
+			}
+			partial = true;
+		}
+
+		if (partial) {
+			if (write_peaks (i + 1, &p, _n_complete[i], 1)) {
+				return -1;
+			}
+			carry      = p;
+			have_carry = true;
+		}
+
+		_header.n_peaks[i] = _n_complete[i] + (partial ? 1 : 0);
+	}
+
+	if (write_header ()) {
+		return -1;
+	}
+
+	/* let readers retry to map the file */
+	Glib::Threads::RWLock::WriterLock lm (_map_lock);
+	_map_failed = false;
+	return 0;
+}
+
+int
+PeakPyramid::grow (samplecnt_t n_base_peaks)
+{
+	int64_t capacity = _header.capacity;
+
+	while (capacity < n_base_peaks) {
+		capacity *= 2;
+	}
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Grow peak pyramid %1 to %2 peaks\n", _path, capacity));
+
+	/* read all complete peaks, partial ones are re-written on flush */
+	std::vector<PeakData> data[max_levels];
+
+	for (uint32_t i = 0; i < max_levels; ++i) {
+		if (_n_complete[i] == 0) {
+			continue;
+		}
+		data[i].resize (_n_complete[i]);
+
+		off_t   byte          = level_offset (i + 1, _header.capacity);
+		ssize_t bytes_to_read = _n_complete[i] * sizeof (PeakData);
+
+		if (lseek (_fd, byte, SEEK_SET) != byte || ::read (_fd, &data[i][0], bytes_to_read) != bytes_to_read) {
+			return -1;
+		}
+	}
+
+	/* readers must not apply the old header to moved data, or the new
+	 * header to data which has not been moved yet.
+	 */
+	Glib::Threads::RWLock::WriterLock lm (_map_lock);
+
+	_header.capacity = capacity;
+
+	/* write in reverse order; higher levels move further, and all
+	 * data is in memory, so there is no overlap issue either way.
+	 */
+	for (uint32_t i = max_levels; i > 0; --i) {
+		if (!data[i - 1].empty () && write_peaks (i, &data[i - 1][0], 0, data[i - 1].size ())) {
+			return -1;
+		}
+		_header.n_peaks[i - 1] = _n_complete[i - 1];
+	}
+
+	int ret = write_header ();
+
+	/* the file has grown, readers map it again */
+	unmap_unlocked ();
+
+	return ret;
+}
+
+int
+PeakPyramid::build_from (std::string const& peakpath)
+{
+	ScopedFileDescriptor sfd (g_open (peakpath.c_str (), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return -1;
+	}
+
+	GStatBuf statbuf;
+	if (g_stat (peakpath.c_str (), &statbuf) != 0) {
+		return -1;
+	}
+
+	samplecnt_t const n_base_peaks = statbuf.st_size / sizeof (PeakData);
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Build peak pyramid %1 from %2 (%3 peaks)\n", _path, peakpath, n_base_peaks));
+
+	close ();
+	unmap ();
+	::g_unlink (_path.c_str ());
+
+	if (open_for_write ()) {
+		return -1;
+	}
+
+	if (n_base_peaks > _header.capacity && grow (n_base_peaks)) {
+		close ();
+		return -1;
+	}
+
+	const samplecnt_t     bufsize = 16384;
+	std::vector<PeakData> buf (bufsize);
+	samplecnt_t           pos = 0;
+	int                   ret = 0;
+
+	while (pos < n_base_peaks) {
+		samplecnt_t n              = min (bufsize, n_base_peaks - pos);
+		ssize_t     bytes_to_read  = n * sizeof (PeakData);
+		if (::read (sfd, &buf[0], bytes_to_read) != bytes_to_read || add (&buf[0], n, pos)) {
+			ret = -1;
+			break;
+		}
+		pos += n;
+	}
+
+	if (ret) {
+		_stale = true;
+	}
+
+	close ();
+
+	return ret;
+}
+
+void
+PeakPyramid::reset_stats ()
+{
+	_mapped_reads = 0;
+	_maps         = 0;
+}
+
+/** (Re)map the file. _map_lock must be held as writer. */
+int
+PeakPyramid::map () const
+{
+	GStatBuf statbuf;
+
+	if (_path.empty () || g_stat (_path.c_str (), &statbuf) != 0 || statbuf.st_size < (off_t) sizeof (Header)) {
+		return -1;
+	}
+
+	size_t length = statbuf.st_size;
+
+	if (_map_addr && length == _map_length) {
+		return 0;
+	}
+
+	ScopedFileDescriptor sfd (g_open (_path.c_str (), O_RDONLY, 0444));
+
+	if (sfd < 0) {
+		return -1;
+	}
+
+	char* addr;
+#ifdef PLATFORM_WINDOWS
+	HANDLE file_handle = (HANDLE) _get_osfhandle (int (sfd));
+	HANDLE map_handle  = CreateFileMapping (file_handle, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (map_handle == NULL) {
+		return -1;
+	}
+	/* the view keeps the mapping object alive */
+	addr = (char*) MapViewOfFile (map_handle, FILE_MAP_READ, 0, 0, length);
+	CloseHandle (map_handle);
+	if (addr == NULL) {
+		return -1;
+	}
+#else
+	/* shared, so that data and headers written later are visible */
+	addr = (char*) mmap (0, length, PROT_READ, MAP_SHARED, sfd, 0);
+	if (addr == MAP_FAILED) {
+		return -1;
+	}
+#endif
+
+	unmap_unlocked ();
+
+	DEBUG_TRACE (DEBUG::Peaks, string_compose ("Mapped peak pyramid %1, %2 bytes\n", _path, length));
+
+	_map_addr   = addr;
+	_map_length = length;
+	++_maps;
+
+	return 0;
+}
+
+void
+PeakPyramid::unmap_unlocked () const
+{
+	_map_failed = false;
+
+	if (!_map_addr) {
+		return;
+	}
+
+#ifdef PLATFORM_WINDOWS
+	UnmapViewOfFile (_map_addr);
+#else
+	munmap (_map_addr, _map_length);
+#endif
+
+	_map_addr   = 0;
+	_map_length = 0;
+}
+
+void
+PeakPyramid::unmap () const
+{
+	Glib::Threads::RWLock::WriterLock lm (_map_lock);
+	unmap_unlocked ();
+}
+
+/** Copy the header from the mapping, mapping the file if needed.
+ * A failed attempt is not repeated until the writer modifies the file.
+ */
+bool
+PeakPyramid::map_header (Header& h) const
+{
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_map_lock);
+		if (_map_addr) {
+			memcpy (&h, _map_addr, sizeof (Header));
+			return header_ok (h);
+		}
+		if (_map_failed) {
+			return false;
+		}
+	}
+
+	Glib::Threads::RWLock::WriterLock lm (_map_lock);
+
+	if (!_map_addr && (_map_failed || map ())) {
+		_map_failed = true;
+		return false;
+	}
+
+	memcpy (&h, _map_addr, sizeof (Header));
+	return header_ok (h);
+}
+
+bool
+PeakPyramid::valid (samplecnt_t n_base_peaks) const
+{
+	Header h;
+	if (!map_header (h)) {
+		return false;
+	}
+
+	return h.n_peaks[0] >= level_size (1, n_base_peaks);
+}
+
+uint32_t
+PeakPyramid::level_for (double samples_per_visual_peak, samplepos_t end) const
+{
+	if (samples_per_visual_peak < samples_per_peak (1)) {
+		return 0;
+	}
+
+	Header h;
+	if (!map_header (h)) {
+		return 0;
+	}
+
+	for (uint32_t level = max_levels; level > 0; --level) {
+		samplecnt_t spp = samples_per_peak (level);
+		if (spp > samples_per_visual_peak) {
+			continue;
+		}
+		if (h.n_peaks[level - 1] * spp < end) {
+			/* not (yet) written up to the requested range */
+			continue;
+		}
+		return level;
+	}
+
+	return 0;
+}
+
+/** Copy peaks of the given level from the mapping, as described by the
+ * header in the same mapping. _map_lock must be held and the file mapped.
+ * \p truncated is set if the peaks extend beyond the end of the mapping.
+ * @return the number of peaks copied, or -1 if the header is invalid.
+ */
+samplecnt_t
+PeakPyramid::copy_mapped (uint32_t level, PeakData* dst, samplecnt_t first_peak, samplecnt_t n_peaks, bool& truncated) const
+{
+	Header h;
+	memcpy (&h, _map_addr, sizeof (Header));
+
+	if (!header_ok (h)) {
+		return -1;
+	}
+
+	samplecnt_t to_read = max ((samplecnt_t) 0, min (n_peaks, (samplecnt_t) h.n_peaks[level - 1] - first_peak));
+
+	if (to_read == 0) {
+		return 0;
+	}
+
+	size_t const byte          = level_offset (level, h.capacity) + first_peak * sizeof (PeakData);
+	size_t       bytes_to_read = to_read * sizeof (PeakData);
+
+	if (byte + bytes_to_read > _map_length) {
+		/* the file has grown since it was mapped (capture) */
+		truncated     = true;
+		to_read       = byte < _map_length ? (_map_length - byte) / sizeof (PeakData) : 0;
+		bytes_to_read = to_read * sizeof (PeakData);
+	}
+
+	memcpy ((void*) dst, (void*) (_map_addr + byte), bytes_to_read);
+
+	return to_read;
+}
+
+int
+PeakPyramid::read (uint32_t level, PeakData* dst, samplecnt_t first_peak, samplecnt_t n_peaks) const
+{
+	if (level == 0 || level > max_levels) {
+		return -1;
+	}
+
+	/* the header and the data are read under the same lock, so that
+	 * the writer cannot move the data in between (see grow()).
+	 */
+	samplecnt_t copied    = 0;
+	bool        truncated = false;
+	bool        remap     = true;
+
+	{
+		Glib::Threads::RWLock::ReaderLock lm (_map_lock);
+		if (_map_addr) {
+			copied = copy_mapped (level, dst, first_peak, n_peaks, truncated);
+			if (copied < 0) {
+				return -1;
+			}
+			remap = truncated;
+		} else if (_map_failed) {
+			return -1;
+		}
+	}
+
+	if (remap) {
+		Glib::Threads::RWLock::WriterLock lm (_map_lock);
+
+		if (map ()) {
+			if (!_map_addr) {
+				_map_failed = true;
+			}
+			return -1;
+		}
+
+		truncated = false;
+		copied    = copy_mapped (level, dst, first_peak, n_peaks, truncated);
+
+		if (copied < 0) {
+			return -1;
+		}
+	}
+
+	if (copied < n_peaks) {
+		memset (&dst[copied], 0, (n_peaks - copied) * sizeof (PeakData));
+	}
+
+	++_mapped_reads;
+	return 0;
+}
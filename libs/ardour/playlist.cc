@@ -481,6 +481,8 @@ Playlist::notify_layering_changed ()
 void
 Playlist::notify_region_removed (boost::shared_ptr<Region> r)
 {
+	invalidate_region_index ();
+
 	if (holding_state ()) {
 		pending_removes.insert (r);
 		pending_contents_change = true;
@@ -499,6 +501,8 @@ Playlist::notify_region_moved (boost::shared_ptr<Region> r)
 {
 	Temporal::RangeMove move (r->last_position (), r->last_length (), r->position ());
 
+	invalidate_region_index ();
+
 	if (holding_state ()) {
 		pending_range_moves.push_back (move);
 
@@ -555,6 +559,8 @@ Playlist::notify_region_added (boost::shared_ptr<Region> r)
 	 * as though it could be.
 	 */
 
+	invalidate_region_index ();
+
 	if (holding_state ()) {
 		pending_adds.insert (r);
 		pending_contents_change = true;
@@ -771,6 +777,7 @@ Playlist::add_region_internal (boost::shared_ptr<Region> region, timepos_t const
 
 	regions.insert (upper_bound (regions.begin (), regions.end (), region, cmp), region);
 	all_regions.insert (region);
+	invalidate_region_index ();
 
 	if (!holding_state ()) {
 		/* layers get assigned from XML state, and are not reset during undo/redo */
@@ -830,6 +837,7 @@ Playlist::remove_region_internal (boost::shared_ptr<Region> region, ThawList& th
 		if (*i == region) {
 
 			regions.erase (i);
+			invalidate_region_index ();
 
 			if (!holding_state ()) {
 				relayer ();
@@ -1576,6 +1584,8 @@ Playlist::ripple_unlocked (timepos_t const & at, timecnt_t const & distance, Reg
 void
 Playlist::region_bounds_changed (const PropertyChange& what_changed, boost::shared_ptr<Region> region)
 {
+	invalidate_region_index ();
+
 	if (in_set_state || _rippling || _nudging || _shuffling) {
 		return;
 	}
@@ -1634,6 +1644,14 @@ Playlist::region_changed (const PropertyChange& what_changed, boost::shared_ptr<
 	PropertyChange bounds;
 	bool           save = false;
 
+	bounds.add (Properties::start);
+	bounds.add (Properties::length);
+
+	if (what_changed.contains (bounds)) {
+		/* also while the list is not being re-sorted */
+		invalidate_region_index ();
+	}
+
 	if (in_set_state || in_flush) {
 		return false;
 	}
@@ -1644,9 +1662,6 @@ Playlist::region_changed (const PropertyChange& what_changed, boost::shared_ptr<
 	our_interests.add (Properties::contents);
 	our_interests.add (Properties::time_domain);
 
-	bounds.add (Properties::start);
-	bounds.add (Properties::length);
-
 	bool send_contents = false;
 
 	if (what_changed.contains (bounds)) {
@@ -1691,6 +1706,7 @@ Playlist::drop_regions ()
 	RegionWriteLock rl (this);
 	regions.clear ();
 	all_regions.clear ();
+	invalidate_region_index ();
 }
 
 void
@@ -1719,6 +1735,7 @@ Playlist::clear (bool with_signals)
 		}
 
 		regions.clear ();
+		invalidate_region_index ();
 
 		for (auto & r : pending_removes) {
 			remove_dependents (r);
@@ -1771,7 +1788,10 @@ Playlist::count_regions_at (timepos_t const & pos) const
 	RegionReadLock rlock (const_cast<Playlist*> (this));
 	uint32_t       cnt = 0;
 
-	for (auto const & r : regions) {
+	std::vector<boost::shared_ptr<Region> > candidates;
+	find_region_candidates (pos, pos, candidates);
+
+	for (auto const & r : candidates) {
 		if (r->covers (pos)) {
 			cnt++;
 		}
@@ -1892,7 +1912,10 @@ Playlist::find_regions_at (timepos_t const & pos)
 
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
-	for (auto & r : regions) {
+	std::vector<boost::shared_ptr<Region> > candidates;
+	find_region_candidates (pos, pos, candidates);
+
+	for (auto & r : candidates) {
 		if (r->covers (pos)) {
 			rlist->push_back (r);
 		}
@@ -1943,7 +1966,10 @@ Playlist::regions_touched_locked (timepos_t const & start, timepos_t const & end
 {
 	boost::shared_ptr<RegionList> rlist (new RegionList);
 
-	for (auto & r : regions) {
+	std::vector<boost::shared_ptr<Region> > candidates;
+	find_region_candidates (start, end, candidates);
+
+	for (auto & r : candidates) {
 		if (r->coverage (start, end) != Temporal::OverlapNone) {
 			rlist->push_back (r);
 		}
@@ -1952,6 +1978,34 @@ Playlist::regions_touched_locked (timepos_t const & start, timepos_t const & end
 	return rlist;
 }
 
+void
+Playlist::invalidate_region_index ()
+{
+	{
+		Glib::Threads::Mutex::Lock lm (_region_index_lock);
+		_region_index.invalidate ();
+	}
+
+	region_layout_invalidated ();
+}
+
+/** Find regions that may overlap [start, end] using the interval index,
+ * in the order of `regions'. Callers must test each candidate.
+ */
+void
+Playlist::find_region_candidates (timepos_t const & start, timepos_t const & end, std::vector<boost::shared_ptr<Region> >& result) const
+{
+	/* Caller must hold lock */
+
+	Glib::Threads::Mutex::Lock lm (_region_index_lock);
+
+	if (!_region_index.valid ()) {
+		_region_index.build (regions.begin (), regions.end ());
+	}
+
+	_region_index.find (start.superclocks (), end.superclocks (), result);
+}
+
 samplepos_t
 Playlist::find_next_transient (timepos_t const & from, int dir)
 {
@@ -2354,12 +2408,26 @@ XMLNode&
 Playlist::state (bool full_state) const
 {
 	XMLNode* node = new XMLNode (X_("Playlist"));
+	add_state (*node, full_state, 0);
+	return *node;
+}
+
+/** Write the full state, one region at a time */
+void
+Playlist::write_state (XMLWriter& writer) const
+{
+	XMLNode node (X_("Playlist"));
+	add_state (node, true, &writer);
+}
 
-	node->set_property (X_("id"), id ());
-	node->set_property (X_("name"), name ());
-	node->set_property (X_("type"), _type);
-	node->set_property (X_("orig-track-id"), _orig_track_id);
-	node->set_property (X_("pgroup-id"), _pgroup_id);
+void
+Playlist::add_properties (XMLNode& node, bool full_state) const
+{
+	node.set_property (X_("id"), id ());
+	node.set_property (X_("name"), name ());
+	node.set_property (X_("type"), _type);
+	node.set_property (X_("orig-track-id"), _orig_track_id);
+	node.set_property (X_("pgroup-id"), _pgroup_id);
 
 	string                        shared_ids;
 	list<PBD::ID>::const_iterator it = _shared_with_ids.begin ();
@@ -2370,25 +2438,88 @@ Playlist::state (bool full_state) const
 		shared_ids.erase (0, 1);
 	}
 
-	node->set_property (X_("shared-with-ids"), shared_ids);
-	node->set_property (X_("frozen"), _frozen);
+	node.set_property (X_("shared-with-ids"), shared_ids);
+	node.set_property (X_("frozen"), _frozen);
+
+	if (full_state) {
+		node.set_property ("combine-ops", _combine_ops);
+	}
+}
+
+void
+Playlist::add_state (XMLNode& node, bool full_state, XMLWriter* writer) const
+{
+	add_properties (node, full_state);
 
 	if (full_state) {
 		RegionReadLock rlock (this);
 
-		node->set_property ("combine-ops", _combine_ops);
+		if (writer) {
+			writer->open (node);
+		}
 
 		for (auto const & r : regions) {
 			assert (r->sources ().size () > 0 && r->master_sources ().size () > 0);
-			node->add_child_nocopy (r->get_state ());
+			node.add_child_nocopy (r->get_state ());
+			if (writer) {
+				writer->flush ();
+			}
 		}
+	} else if (writer) {
+		writer->open (node);
 	}
 
 	if (_extra_xml) {
-		node->add_child_copy (*_extra_xml);
+		node.add_child_copy (*_extra_xml);
 	}
 
-	return *node;
+	if (writer) {
+		writer->close ();
+	}
+}
+
+Playlist::StateCopy::StateCopy (Playlist const& pl)
+	: _node (X_("Playlist"))
+	, _extra_xml (0)
+{
+	pl.add_properties (_node, true);
+
+	{
+		RegionReadLock rlock (&pl);
+
+		for (auto const & r : pl.regions) {
+			assert (r->sources ().size () > 0 && r->master_sources ().size () > 0);
+			_regions.push_back (r->state_copy ());
+		}
+	}
+
+	if (pl._extra_xml) {
+		_extra_xml = new XMLNode (*pl._extra_xml);
+	}
+}
+
+Playlist::StateCopy::~StateCopy ()
+{
+	delete _extra_xml;
+}
+
+/** Write the state, one region at a time. This may be called in any thread */
+void
+Playlist::StateCopy::write_state (XMLWriter& writer)
+{
+	writer.open (_node);
+
+	for (auto const & r : _regions) {
+		XMLNode& node (r->get_state ());
+		writer.write (node);
+		delete &node;
+	}
+
+	if (_extra_xml) {
+		writer.write (*_extra_xml);
+	}
+
+	writer.close ();
 }
 
 bool
@@ -2664,6 +2795,8 @@ Playlist::relayer ()
 		r->set_layer (j);
 	}
 
+	region_layout_invalidated ();
+
 	/* It's a little tricky to know when we could avoid calling this; e.g. if we are
 	 * relayering because we just removed the only region on the top layer, nothing will
 	 * appear to have changed, but the StreamView must still sort itself out.  We could
@@ -3006,6 +3139,7 @@ Playlist::update_after_tempo_map_change ()
 		RegionList      copy (regions.rlist ());
 
 		freeze_locked ();
+		invalidate_region_index ();
 
 		for (auto & r : copy) {
 			rlock.thawlist.add (r);
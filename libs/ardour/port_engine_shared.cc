@@ -32,6 +32,7 @@ BackendPort::BackendPort (PortEngineSharedImpl &b, const std::string& name, Port
 	: _backend (b)
 	, _name  (name)
 	, _flags (flags)
+	, _rt_connections (new ConnectionList)
 {
 	_capture_latency_range.min = 0;
 	_capture_latency_range.max = 0;
@@ -96,6 +97,7 @@ void
 BackendPort::store_connection (BackendPortHandle port)
 {
 	_connections.insert (port);
+	update_rt_connections ();
 }
 
 int
@@ -125,6 +127,7 @@ void BackendPort::remove_connection (BackendPortHandle port)
 	std::set<BackendPortPtr>::iterator it = _connections.find (port);
 	assert (it != _connections.end ());
 	_connections.erase (it);
+	update_rt_connections ();
 }
 
 
@@ -136,6 +139,18 @@ void BackendPort::disconnect_all (BackendPortHandle self)
 		_backend.port_connect_callback (name(), (*it)->name(), false);
 		_connections.erase (it);
 	}
+	update_rt_connections ();
+}
+
+void
+BackendPort::update_rt_connections ()
+{
+	{
+		RCUWriter<ConnectionList> writer (_rt_connections);
+		boost::shared_ptr<ConnectionList> cl = writer.get_copy ();
+		cl->assign (_connections.begin (), _connections.end ());
+	}
+	_rt_connections.flush ();
 }
 
 bool
@@ -253,6 +253,8 @@ PortManager::PortManager ()
 	: _ports (new Ports)
 	, _port_remove_in_progress (false)
 	, _port_deletions_pending (8192) /* ick, arbitrary sizing */
+	, _port_table (new PortTable)
+	, _shared_inputs (new SharedInputs)
 	, _midi_info_dirty (true)
 	, _audio_input_ports (new AudioInputPorts)
 	, _midi_input_ports (new MIDIInputPorts)
@@ -291,10 +293,14 @@ PortManager::remove_all_ports ()
 		ps->clear ();
 	}
 
+	update_port_table ();
+
 	/* clear dead wood list in RCU */
 
 	_ports.flush ();
 
+	update_shared_inputs ();
+
 	/* clear out pending port deletion list. we know this is safe because
 	 * the auto connect thread in Session is already dead when this is
 	 * done. It doesn't use shared_ptr<Port> anyway.
@@ -517,15 +523,60 @@ PortManager::get_port_by_name (const string& portname)
 void
 PortManager::port_renamed (const std::string& old_relative_name, const std::string& new_relative_name)
 {
-	RCUWriter<Ports>         writer (_ports);
-	boost::shared_ptr<Ports> p = writer.get_copy ();
-	Ports::iterator          x = p->find (old_relative_name);
+	{
+		RCUWriter<Ports>         writer (_ports);
+		boost::shared_ptr<Ports> p = writer.get_copy ();
+		Ports::iterator          x = p->find (old_relative_name);
+
+		if (x != p->end ()) {
+			boost::shared_ptr<Port> port = x->second;
+			p->erase (x);
+			p->insert (make_pair (new_relative_name, port));
+		}
+	}
+
+	update_port_table ();
+}
+
+void
+PortManager::update_port_table ()
+{
+	{
+		RCUWriter<PortTable>         writer (_port_table);
+		boost::shared_ptr<PortTable> pt = writer.get_copy ();
+
+		/* read the map while holding the writer, so that the last update
+		 * always publishes the current map, even with concurrent writers.
+		 */
+		pt->map = _ports.reader ();
+
+		pt->audio_inputs.clear ();
+		pt->audio_outputs.clear ();
+		pt->midi_inputs.clear ();
+		pt->midi_outputs.clear ();
+		pt->all.clear ();
+
+		for (Ports::const_iterator p = pt->map->begin (); p != pt->map->end (); ++p) {
+			Port* port = p->second.get ();
+			if (port->type () == DataType::AUDIO) {
+				AudioPort* ap = static_cast<AudioPort*> (port);
+				(port->receives_input () ? pt->audio_inputs : pt->audio_outputs).push_back (ap);
+			} else {
+				(port->receives_input () ? pt->midi_inputs : pt->midi_outputs).push_back (port);
+			}
+		}
+
+		pt->all.reserve (pt->map->size ());
+		pt->all.insert (pt->all.end (), pt->audio_inputs.begin (), pt->audio_inputs.end ());
+		pt->all.insert (pt->all.end (), pt->audio_outputs.begin (), pt->audio_outputs.end ());
+		pt->all.insert (pt->all.end (), pt->midi_inputs.begin (), pt->midi_inputs.end ());
+		pt->all.insert (pt->all.end (), pt->midi_outputs.begin (), pt->midi_outputs.end ());
 
-	if (x != p->end ()) {
-		boost::shared_ptr<Port> port = x->second;
-		p->erase (x);
-		p->insert (make_pair (new_relative_name, port));
+		/* writer goes out of scope, forces update */
 	}
+
+	/* drop previous tables, and with them references to previous maps */
+	_port_table.flush ();
 }
 
 int
@@ -644,6 +695,8 @@ PortManager::register_port (DataType dtype, const string& portname, bool input,
 		throw PortRegistrationFailure (string_compose ("unable to create port '%1': %2", portname, _("(unknown error)")));
 	}
 
+	update_port_table ();
+
 	DEBUG_TRACE (DEBUG::Ports, string_compose ("\t%2 port registration success, ports now = %1\n", _ports.reader ()->size (), this));
 	return newport;
 }
@@ -684,8 +737,13 @@ PortManager::unregister_port (boost::shared_ptr<Port> port)
 		/* writer goes out of scope, forces update */
 	}
 
+	/* the port table holds a reference to the previous map */
+	update_port_table ();
+
 	_ports.flush ();
 
+	update_shared_inputs ();
+
 	return 0;
 }
 
@@ -1203,94 +1261,211 @@ PortManager::graph_order_callback ()
 	DEBUG_TRACE (DEBUG::BackendCallbacks, "graph order callback\n");
 
 	if (!_port_remove_in_progress) {
+		/* connections changed */
+		update_shared_inputs ();
 		GraphReordered (); /* EMIT SIGNAL */
 	}
 
 	return 0;
 }
 
+/* Running the port tasks in parallel has a fixed cost to wake up and
+ * synchronize process threads. It only pays off if there is enough
+ * resampling to be done: the number of samples that are resampled in
+ * total per cycle must exceed this threshold.
+ */
+static const samplecnt_t parallel_resampling_threshold = 4096;
+
+static bool
+resample_in_parallel (boost::shared_ptr<RTTaskList> const& tl, size_t n_resampling, pframes_t nframes)
+{
+	if (!tl || fabs (Port::resample_ratio ()) == 1.0) {
+		/* the resampler only copies data */
+		return false;
+	}
+	return n_resampling > 1 && n_resampling * nframes >= (size_t) parallel_resampling_threshold;
+}
+
 void
-PortManager::cycle_start (pframes_t nframes, Session* s)
+PortManager::update_shared_inputs ()
 {
-	Port::set_global_port_buffer_offset (0);
-	Port::set_cycle_samplecnt (nframes);
+	/* Ports with the same connections have the same data. Group them, in
+	 * order to resample each external input only once per cycle, no matter
+	 * how many input ports are connected to it.
+	 */
+	typedef std::map<std::vector<std::string>, std::vector<boost::shared_ptr<AudioPort> > > ByConnections;
 
-	_cycle_ports = _ports.reader ();
+	ByConnections            groups;
+	boost::shared_ptr<Ports> pr = _ports.reader ();
 
-	/* pre-calc/cache value */
-	falloff_cache.calc (nframes, s ? s->nominal_sample_rate () : 0);
+	for (Ports::iterator p = pr->begin (); p != pr->end (); ++p) {
+		boost::shared_ptr<AudioPort> ap = boost::dynamic_pointer_cast<AudioPort> (p->second);
+		if (!ap || !ap->receives_input () || !ap->externally_connected () || (ap->flags () & TransportSyncPort)) {
+			continue;
+		}
+		std::vector<std::string> c;
+		ap->get_connections (c);
+		std::sort (c.begin (), c.end ());
+		groups[c].push_back (ap);
+	}
+
+	{
+		RCUWriter<SharedInputs>         writer (_shared_inputs);
+		boost::shared_ptr<SharedInputs> si = writer.get_copy ();
+		si->clear ();
+		for (ByConnections::const_iterator g = groups.begin (); g != groups.end (); ++g) {
+			if (g->second.size () > 1) {
+				DEBUG_TRACE (DEBUG::Ports, string_compose ("%1 inputs share the resampled data of %2\n", g->second.size () - 1, g->second.front ()->name ()));
+				si->push_back (g->second);
+			}
+		}
+	}
+
+	/* drop references to ports that are gone */
+	_shared_inputs.flush ();
+}
+
+void
+PortManager::cycle_start_ports (pframes_t nframes, bool with_resampling)
+{
+	for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_inputs.begin (); p != _cycle_ports->audio_inputs.end (); ++p) {
+		if (!((*p)->flags () & TransportSyncPort) && (with_resampling || !(*p)->resampling ())) {
+			(*p)->cycle_start (nframes);
+		}
+	}
+	for (std::vector<Port*>::const_iterator p = _cycle_ports->all.begin () + _cycle_ports->audio_inputs.size (); p != _cycle_ports->all.end (); ++p) {
+		if (!((*p)->flags () & TransportSyncPort)) {
+			(*p)->cycle_start (nframes);
+		}
+	}
+}
+
+void
+PortManager::cycle_end_ports (pframes_t nframes, bool with_resampling)
+{
+	for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_inputs.begin (); p != _cycle_ports->audio_inputs.end (); ++p) {
+		if (!((*p)->flags () & TransportSyncPort)) {
+			(*p)->cycle_end (nframes);
+		}
+	}
+	for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_outputs.begin (); p != _cycle_ports->audio_outputs.end (); ++p) {
+		if (!((*p)->flags () & TransportSyncPort) && (with_resampling || !(*p)->resampling ())) {
+			(*p)->cycle_end (nframes);
+		}
+	}
+	for (std::vector<Port*>::const_iterator p = _cycle_ports->all.begin () + _cycle_ports->audio_inputs.size () + _cycle_ports->audio_outputs.size (); p != _cycle_ports->all.end (); ++p) {
+		if (!((*p)->flags () & TransportSyncPort)) {
+			(*p)->cycle_end (nframes);
+		}
+	}
+}
 
-	/* TODO optimize
-	 *  - when speed == 1.0, the resampler copies data without processing
-	 *   it may (or may not) be more efficient to just run all in sequence.
-	 *
-	 *  - single sequential task for 'lightweight' tasks would make sense
-	 *    (run it in parallel with 'heavy' resampling.
-	 *    * output ports (sends_output()) only set a flag
-	 *    * midi-ports only scale event timestamps
-	 *
-	 *  - a threshold parallel vs searial processing may be appropriate.
-	 *    amount of work (how many connected ports are there, how
-	 *    many resamplers need to run) vs. available CPU cores and semaphore
-	 *    synchronization overhead.
-	 *
-	 *  - input ports: it would make sense to resample each input only once
-	 *    (rather than resample into each ardour-owned input port).
-	 *    A single external source-port may be connected to many ardour
-	 *    input-ports. Currently re-sampling is per input.
+void
+PortManager::release_cycle_ports ()
+{
+	for (SharedInputs::const_iterator g = _cycle_shared_inputs->begin (); g != _cycle_shared_inputs->end (); ++g) {
+		for (size_t i = 1; i < g->size (); ++i) {
+			(*g)[i]->_shared_input = 0;
+		}
+	}
+	_cycle_shared_inputs.reset ();
+	_cycle_ports.reset ();
+}
+
+void
+PortManager::run_cycle_end (pframes_t nframes, Session* s)
+{
+	/* resample outputs in parallel only if that is worth the cost of
+	 * waking the RT task threads, see resample_in_parallel()
 	 */
 	boost::shared_ptr<RTTaskList> tl;
 	if (s) {
 		tl = s->rt_tasklist ();
 	}
-	if (tl && fabs (Port::resample_ratio ()) != 1.0) {
-		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
-			if (!(p->second->flags () & TransportSyncPort)) {
-				tl->push_back (boost::bind (&Port::cycle_start, p->second, nframes));
+
+	size_t n_resampling = 0;
+	for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_outputs.begin (); p != _cycle_ports->audio_outputs.end (); ++p) {
+		if ((*p)->resampling ()) {
+			++n_resampling;
+		}
+	}
+
+	if (resample_in_parallel (tl, n_resampling, nframes)) {
+		for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_outputs.begin (); p != _cycle_ports->audio_outputs.end (); ++p) {
+			if ((*p)->resampling ()) {
+				tl->push_back (boost::bind (&AudioPort::cycle_end, *p, nframes));
 			}
 		}
-		tl->push_back (boost::bind (&PortManager::run_input_meters, this, nframes, s ? s->nominal_sample_rate () : 0));
+		tl->push_back (boost::bind (&PortManager::cycle_end_ports, this, nframes, false));
 		tl->process ();
 	} else {
-		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
-			if (!(p->second->flags () & TransportSyncPort)) {
-				p->second->cycle_start (nframes);
-			}
-		}
-		run_input_meters (nframes, s ? s->nominal_sample_rate () : 0);
+		cycle_end_ports (nframes, true);
 	}
 }
 
 void
-PortManager::cycle_end (pframes_t nframes, Session* s)
+PortManager::cycle_start (pframes_t nframes, Session* s)
 {
-	// see optimzation note in ::cycle_start()
+	Port::set_global_port_buffer_offset (0);
+	Port::set_cycle_samplecnt (nframes);
+
+	_cycle_ports         = _port_table.reader ();
+	_cycle_shared_inputs = _shared_inputs.reader ();
+
+	/* pre-calc/cache value */
+	falloff_cache.calc (nframes, s ? s->nominal_sample_rate () : 0);
+
+	for (SharedInputs::const_iterator g = _cycle_shared_inputs->begin (); g != _cycle_shared_inputs->end (); ++g) {
+		for (size_t i = 1; i < g->size (); ++i) {
+			(*g)[i]->_shared_input = g->front ().get ();
+		}
+	}
+
+	/* Resampling inputs is the expensive part, and each resampler runs in
+	 * its own task, if there is enough work to warrant parallel processing.
+	 * All other ports are lightweight (output ports only prepare buffers,
+	 * MIDI ports only scale event timestamps), and are handled sequentially
+	 * in a single task.
+	 */
 	boost::shared_ptr<RTTaskList> tl;
 	if (s) {
 		tl = s->rt_tasklist ();
 	}
-	if (tl && fabs (Port::resample_ratio ()) != 1.0) {
-		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
-			if (!(p->second->flags () & TransportSyncPort)) {
-				tl->push_back (boost::bind (&Port::cycle_end, p->second, nframes));
+
+	size_t n_resampling = 0;
+	for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_inputs.begin (); p != _cycle_ports->audio_inputs.end (); ++p) {
+		if ((*p)->resampling ()) {
+			++n_resampling;
+		}
+	}
+
+	if (resample_in_parallel (tl, n_resampling, nframes)) {
+		for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_inputs.begin (); p != _cycle_ports->audio_inputs.end (); ++p) {
+			if ((*p)->resampling ()) {
+				tl->push_back (boost::bind (&AudioPort::cycle_start, *p, nframes));
 			}
 		}
+		tl->push_back (boost::bind (&PortManager::cycle_start_ports, this, nframes, false));
+		tl->push_back (boost::bind (&PortManager::run_input_meters, this, nframes, s ? s->nominal_sample_rate () : 0));
 		tl->process ();
 	} else {
-		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
-			if (!(p->second->flags () & TransportSyncPort)) {
-				p->second->cycle_end (nframes);
-			}
-		}
+		cycle_start_ports (nframes, true);
+		run_input_meters (nframes, s ? s->nominal_sample_rate () : 0);
 	}
+}
+
+void
+PortManager::cycle_end (pframes_t nframes, Session* s)
+{
+	run_cycle_end (nframes, s);
 
-	for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
+	for (std::vector<Port*>::const_iterator p = _cycle_ports->all.begin (); p != _cycle_ports->all.end (); ++p) {
 		/* AudioEngine::split_cycle flushes buffers until Port::port_offset.
 		 * Now only flush remaining events (after Port::port_offset) */
-		p->second->flush_buffers (nframes * Port::resample_ratio () - Port::port_offset ());
+		(*p)->flush_buffers (nframes * Port::resample_ratio () - Port::port_offset ());
 	}
 
-	_cycle_ports.reset ();
+	release_cycle_ports ();
 
 	/* we are done */
 }
@@ -1298,22 +1473,25 @@ PortManager::cycle_end (pframes_t nframes, Session* s)
 void
 PortManager::silence (pframes_t nframes, Session* s)
 {
-	for (Ports::iterator i = _cycle_ports->begin (); i != _cycle_ports->end (); ++i) {
-		if (s && i->second == s->mtc_output_port ()) {
-			continue;
-		}
-		if (s && i->second == s->midi_clock_output_port ()) {
-			continue;
+	Port const* ltc = s ? s->ltc_output_port ().get () : 0;
+
+	for (std::vector<AudioPort*>::const_iterator i = _cycle_ports->audio_outputs.begin (); i != _cycle_ports->audio_outputs.end (); ++i) {
+		if (*i != ltc) {
+			(*i)->get_audio_buffer (nframes).silence (nframes);
 		}
-		if (s && i->second == s->ltc_output_port ()) {
+	}
+
+	Port const* mtc        = s ? s->mtc_output_port ().get () : 0;
+	Port const* midi_clock = s ? s->midi_clock_output_port ().get () : 0;
+
+	for (std::vector<Port*>::const_iterator i = _cycle_ports->midi_outputs.begin (); i != _cycle_ports->midi_outputs.end (); ++i) {
+		if (*i == mtc || *i == midi_clock) {
 			continue;
 		}
-		if (boost::dynamic_pointer_cast<AsyncMIDIPort> (i->second)) {
+		if (dynamic_cast<AsyncMIDIPort*> (*i)) {
 			continue;
 		}
-		if (i->second->sends_output ()) {
-			i->second->get_buffer (nframes).silence (nframes);
-		}
+		(*i)->get_buffer (nframes).silence (nframes);
 	}
 }
 void
@@ -1366,15 +1544,15 @@ PortManager::silence_outputs (pframes_t nframes)
 void
 PortManager::check_monitoring ()
 {
-	for (Ports::iterator i = _cycle_ports->begin (); i != _cycle_ports->end (); ++i) {
+	for (std::vector<Port*>::const_iterator i = _cycle_ports->all.begin (); i != _cycle_ports->all.end (); ++i) {
 		bool x;
 
-		if (i->second->last_monitor () != (x = i->second->monitoring_input ())) {
-			i->second->set_last_monitor (x);
+		if ((*i)->last_monitor () != (x = (*i)->monitoring_input ())) {
+			(*i)->set_last_monitor (x);
 			/* XXX I think this is dangerous, due to
 			   a likely mutex in the signal handlers ...
 			*/
-			i->second->MonitorInputChanged (x); /* EMIT SIGNAL */
+			(*i)->MonitorInputChanged (x); /* EMIT SIGNAL */
 		}
 	}
 }
@@ -1382,43 +1560,22 @@ PortManager::check_monitoring ()
 void
 PortManager::cycle_end_fade_out (gain_t base_gain, gain_t gain_step, pframes_t nframes, Session* s)
 {
-	// see optimzation note in ::cycle_start()
-	boost::shared_ptr<RTTaskList> tl;
-	if (s) {
-		tl = s->rt_tasklist ();
-	}
-	if (tl && fabs (Port::resample_ratio ()) != 1.0) {
-		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
-			if (!(p->second->flags () & TransportSyncPort)) {
-				tl->push_back (boost::bind (&Port::cycle_end, p->second, nframes));
-			}
-		}
-		tl->process ();
-	} else {
-		for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
-			if (!(p->second->flags () & TransportSyncPort)) {
-				p->second->cycle_end (nframes);
-			}
-		}
-	}
+	run_cycle_end (nframes, s);
 
-	for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
-		p->second->flush_buffers (nframes);
+	for (std::vector<Port*>::const_iterator p = _cycle_ports->all.begin (); p != _cycle_ports->all.end (); ++p) {
+		(*p)->flush_buffers (nframes);
+	}
 
-		if (p->second->sends_output ()) {
-			boost::shared_ptr<AudioPort> ap = boost::dynamic_pointer_cast<AudioPort> (p->second);
-			if (ap) {
-				Sample* s = ap->engine_get_whole_audio_buffer ();
-				gain_t  g = base_gain;
+	for (std::vector<AudioPort*>::const_iterator p = _cycle_ports->audio_outputs.begin (); p != _cycle_ports->audio_outputs.end (); ++p) {
+		Sample* s = (*p)->engine_get_whole_audio_buffer ();
+		gain_t  g = base_gain;
 
-				for (pframes_t n = 0; n < nframes; ++n) {
-					*s++ *= g;
-					g -= gain_step;
-				}
-			}
+		for (pframes_t n = 0; n < nframes; ++n) {
+			*s++ *= g;
+			g -= gain_step;
 		}
 	}
-	_cycle_ports.reset ();
+	release_cycle_ports ();
 	/* we are done */
 }
 
@@ -1994,7 +2151,7 @@ PortManager::list_all_ports () const
 void
 PortManager::list_cycle_ports () const
 {
-	for (Ports::iterator p = _cycle_ports->begin (); p != _cycle_ports->end (); ++p) {
+	for (Ports::iterator p = _cycle_ports->map->begin (); p != _cycle_ports->map->end (); ++p) {
 		std::cout << p->first << "\n";
 	}
 }
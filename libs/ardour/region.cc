@@ -1243,26 +1243,74 @@ Region::set_layer (layer_t l)
 	_layer = l;
 }
 
-XMLNode&
-Region::state () const
+Region::StateCopy::StateCopy (Region const& r)
+	: _id (r.id ())
+	, _type (r._type)
+	, _first_edit (r._first_edit)
+	, _nested_sources (0)
+	, _extra_xml (0)
 {
-	XMLNode *node = new XMLNode ("Region");
-	char buf2[64];
-
 	/* custom version of 'add_properties (*node);'
 	 * skip values that have have dedicated save functions
 	 * in AudioRegion::state()
 	 */
-	for (OwnedPropertyList::iterator i = _properties->begin(); i != _properties->end(); ++i) {
+	for (OwnedPropertyList::iterator i = r._properties->begin(); i != r._properties->end(); ++i) {
 		if (!strcmp(i->second->property_name(), (const char*)"Envelope")) continue;
 		if (!strcmp(i->second->property_name(), (const char*)"FadeIn")) continue;
 		if (!strcmp(i->second->property_name(), (const char*)"FadeOut")) continue;
 		if (!strcmp(i->second->property_name(), (const char*)"InverseFadeIn")) continue;
 		if (!strcmp(i->second->property_name(), (const char*)"InverseFadeOut")) continue;
+		_properties.add (i->second->clone ());
+	}
+
+	for (SourceList::const_iterator s = r._sources.begin(); s != r._sources.end(); ++s) {
+		_sources.push_back ((*s)->id ());
+	}
+
+	for (SourceList::const_iterator s = r._master_sources.begin(); s != r._master_sources.end(); ++s) {
+		_master_sources.push_back ((*s)->id ());
+	}
+
+	/* Only store nested sources for the whole-file region that acts
+	   as the parent/root of all regions using it.
+	*/
+
+	if (r._whole_file && r.max_source_level() > 0) {
+
+		/* region is compound - get its playlist and
+		   store that before we list the region that
+		   needs it ...
+		*/
+
+		_nested_sources = new XMLNode (X_("NestedSource"));
+
+		for (SourceList::const_iterator s = r._sources.begin(); s != r._sources.end(); ++s) {
+			_nested_sources->add_child_nocopy ((*s)->get_state ());
+		}
+	}
+
+	if (r._extra_xml) {
+		_extra_xml = new XMLNode (*r._extra_xml);
+	}
+}
+
+Region::StateCopy::~StateCopy ()
+{
+	delete _nested_sources;
+	delete _extra_xml;
+}
+
+XMLNode&
+Region::StateCopy::get_state () const
+{
+	XMLNode *node = new XMLNode ("Region");
+	char buf2[64];
+
+	for (PropertyList::const_iterator i = _properties.begin(); i != _properties.end(); ++i) {
 		i->second->get_value (*node);
 	}
 
-	node->set_property ("id", id ());
+	node->set_property ("id", _id);
 	node->set_property ("type", _type);
 
 	std::string fe;
@@ -1288,34 +1336,16 @@ Region::state () const
 
 	for (uint32_t n=0; n < _sources.size(); ++n) {
 		snprintf (buf2, sizeof(buf2), "source-%d", n);
-		node->set_property (buf2, _sources[n]->id());
+		node->set_property (buf2, _sources[n]);
 	}
 
 	for (uint32_t n=0; n < _master_sources.size(); ++n) {
 		snprintf (buf2, sizeof(buf2), "master-source-%d", n);
-		node->set_property (buf2, _master_sources[n]->id ());
+		node->set_property (buf2, _master_sources[n]);
 	}
 
-	/* Only store nested sources for the whole-file region that acts
-	   as the parent/root of all regions using it.
-	*/
-
-	if (_whole_file && max_source_level() > 0) {
-
-		XMLNode* nested_node = new XMLNode (X_("NestedSource"));
-
-		/* region is compound - get its playlist and
-		   store that before we list the region that
-		   needs it ...
-		*/
-
-		for (SourceList::const_iterator s = _sources.begin(); s != _sources.end(); ++s) {
-			nested_node->add_child_nocopy ((*s)->get_state ());
-		}
-
-		if (nested_node) {
-			node->add_child_nocopy (*nested_node);
-		}
+	if (_nested_sources) {
+		node->add_child_copy (*_nested_sources);
 	}
 
 	if (_extra_xml) {
@@ -1325,6 +1355,18 @@ Region::state () const
 	return *node;
 }
 
+boost::shared_ptr<Region::StateCopy const>
+Region::state_copy () const
+{
+	return boost::shared_ptr<StateCopy const> (new StateCopy (*this));
+}
+
+XMLNode&
+Region::state () const
+{
+	return StateCopy (*this).get_state ();
+}
+
 XMLNode&
 Region::get_state () const
 {
@@ -1577,6 +1619,8 @@ Region::set_master_sources (const SourceList& srcs)
 	for (SourceList::const_iterator i = _master_sources.begin (); i != _master_sources.end(); ++i) {
 		(*i)->inc_use_count ();
 	}
+
+	RegionFactory::reindex_sources (*this);
 }
 
 bool
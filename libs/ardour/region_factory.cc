@@ -31,6 +31,7 @@
 #include "ardour/boost_debug.h"
 #include "ardour/midi_region.h"
 #include "ardour/midi_source.h"
+#include "ardour/playlist_source.h"
 #include "ardour/region.h"
 #include "ardour/region_factory.h"
 #include "ardour/session.h"
@@ -50,6 +51,9 @@ Glib::Threads::Mutex                           RegionFactory::region_name_maps_m
 std::map<std::string, uint32_t>                RegionFactory::region_name_number_map;
 std::map<std::string, PBD::ID>                 RegionFactory::region_name_map;
 RegionFactory::CompoundAssociations            RegionFactory::_compound_associations;
+RegionFactory::IDSetMap                        RegionFactory::regions_by_source;
+RegionFactory::IDSetMap                        RegionFactory::sources_by_region;
+std::set<PBD::ID>                              RegionFactory::compound_regions;
 
 boost::shared_ptr<Region>
 RegionFactory::create (boost::shared_ptr<const Region> region, bool announce, bool fork, ThawList* tl)
@@ -322,6 +326,7 @@ RegionFactory::map_add (boost::shared_ptr<Region> r)
 	{
 		Glib::Threads::Mutex::Lock lm (region_map_lock);
 		region_map.insert (p);
+		index_sources_locked (*r);
 	}
 
 	if (!region_list_connections) {
@@ -347,10 +352,80 @@ RegionFactory::map_remove (boost::weak_ptr<Region> w)
 
 	if (i != region_map.end ()) {
 		remove_from_region_name_map (i->second->name ());
+		unindex_sources_locked (i->first);
 		region_map.erase (i);
 	}
 }
 
+void
+RegionFactory::reindex_sources (Region const& r)
+{
+	Glib::Threads::Mutex::Lock lm (region_map_lock);
+
+	/* regions are indexed when they are added to the map */
+	if (region_map.find (r.id ()) != region_map.end ()) {
+		index_sources_locked (r);
+	}
+}
+
+void
+RegionFactory::index_sources_locked (Region const& r)
+{
+	unindex_sources_locked (r.id ());
+
+	std::set<PBD::ID>& srcs (sources_by_region[r.id ()]);
+
+	SourceList const* lists[] = { &r.sources (), &r.master_sources () };
+
+	for (size_t n = 0; n < 2; ++n) {
+		for (SourceList::const_iterator i = lists[n]->begin (); i != lists[n]->end (); ++i) {
+			srcs.insert ((*i)->id ());
+			regions_by_source[(*i)->id ()].insert (r.id ());
+			if (boost::dynamic_pointer_cast<PlaylistSource> (*i)) {
+				compound_regions.insert (r.id ());
+			}
+		}
+	}
+}
+
+void
+RegionFactory::unindex_sources_locked (PBD::ID const& rid)
+{
+	IDSetMap::iterator i = sources_by_region.find (rid);
+
+	if (i == sources_by_region.end ()) {
+		return;
+	}
+
+	for (std::set<PBD::ID>::const_iterator s = i->second.begin (); s != i->second.end (); ++s) {
+		IDSetMap::iterator r = regions_by_source.find (*s);
+		if (r != regions_by_source.end ()) {
+			r->second.erase (rid);
+			if (r->second.empty ()) {
+				regions_by_source.erase (r);
+			}
+		}
+	}
+
+	sources_by_region.erase (i);
+	compound_regions.erase (rid);
+}
+
+/** Collect the IDs of all regions that may use \p s, sorted by region-ID.
+ * Callers still have to check Region::uses_source().
+ */
+void
+RegionFactory::region_candidates_for_source_locked (boost::shared_ptr<Source> s, std::set<PBD::ID>& ids)
+{
+	IDSetMap::const_iterator i = regions_by_source.find (s->id ());
+
+	if (i != regions_by_source.end ()) {
+		ids = i->second;
+	}
+
+	ids.insert (compound_regions.begin (), compound_regions.end ());
+}
+
 boost::shared_ptr<Region>
 RegionFactory::region_by_id (const PBD::ID& id)
 {
@@ -395,6 +470,9 @@ RegionFactory::clear_map ()
 	{
 		Glib::Threads::Mutex::Lock lm (region_map_lock);
 		region_map.clear ();
+		regions_by_source.clear ();
+		sources_by_region.clear ();
+		compound_regions.clear ();
 		_compound_associations.clear ();
 		region_name_map.clear ();
 	}
@@ -625,9 +703,13 @@ boost::shared_ptr<Region>
 RegionFactory::get_whole_region_for_source (boost::shared_ptr<Source> s)
 {
 	Glib::Threads::Mutex::Lock lm (region_map_lock);
+	std::set<PBD::ID>          ids;
+
+	region_candidates_for_source_locked (s, ids);
 
-	for (RegionMap::const_iterator i = region_map.begin (); i != region_map.end (); ++i) {
-		if (i->second->uses_source (s) && i->second->whole_file ()) {
+	for (std::set<PBD::ID>::const_iterator id = ids.begin (); id != ids.end (); ++id) {
+		RegionMap::const_iterator i = region_map.find (*id);
+		if (i != region_map.end () && i->second->uses_source (s) && i->second->whole_file ()) {
 			return (i->second);
 		}
 	}
@@ -639,9 +721,13 @@ void
 RegionFactory::get_regions_using_source (boost::shared_ptr<Source> s, std::set<boost::shared_ptr<Region> >& r)
 {
 	Glib::Threads::Mutex::Lock lm (region_map_lock);
+	std::set<PBD::ID>          ids;
+
+	region_candidates_for_source_locked (s, ids);
 
-	for (RegionMap::const_iterator i = region_map.begin (); i != region_map.end (); ++i) {
-		if (i->second->uses_source (s)) {
+	for (std::set<PBD::ID>::const_iterator id = ids.begin (); id != ids.end (); ++id) {
+		RegionMap::const_iterator i = region_map.find (*id);
+		if (i != region_map.end () && i->second->uses_source (s)) {
 			r.insert (i->second);
 		}
 	}
@@ -652,8 +738,13 @@ RegionFactory::remove_regions_using_source (boost::shared_ptr<Source> src)
 {
 	Glib::Threads::Mutex::Lock lm (region_map_lock);
 	RegionList                 remove_regions;
-	for (RegionMap::const_iterator i = region_map.begin (); i != region_map.end (); ++i) {
-		if (i->second->uses_source (src)) {
+	std::set<PBD::ID>          ids;
+
+	region_candidates_for_source_locked (src, ids);
+
+	for (std::set<PBD::ID>::const_iterator id = ids.begin (); id != ids.end (); ++id) {
+		RegionMap::const_iterator i = region_map.find (*id);
+		if (i != region_map.end () && i->second->uses_source (src)) {
 			remove_regions.push_back (i->second);
 		}
 	}
@@ -0,0 +1,137 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <algorithm>
+#include <iterator>
+#include <limits>
+
+#include "ardour/region.h"
+#include "ardour/region_interval_index.h"
+
+using namespace ARDOUR;
+using namespace Temporal;
+
+RegionIntervalIndex::RegionIntervalIndex ()
+	: _valid (false)
+{
+}
+
+void
+RegionIntervalIndex::clear ()
+{
+	_entries.clear ();
+	_max_end.clear ();
+	_regions.clear ();
+	_valid = false;
+}
+
+void
+RegionIntervalIndex::build (RegionList::const_iterator begin, RegionList::const_iterator end)
+{
+	clear ();
+
+	/* Regions with a position in BeatTime are converted using the
+	 * current tempo map, which may round differently than comparing
+	 * timepos_t in the caller's time domain. Widen all extents by a
+	 * (less than) one sample margin, callers do the exact test.
+	 */
+	superclock_t const slop = superclock_ticks_per_second () / 8000;
+
+	size_t const n = std::distance (begin, end);
+
+	_entries.reserve (n);
+	_regions.reserve (n);
+
+	for (RegionList::const_iterator i = begin; i != end; ++i) {
+		boost::shared_ptr<Region> const& r (*i);
+		superclock_t const s = r->position ().superclocks ();
+		superclock_t const e = r->end ().superclocks ();
+		_entries.push_back (Entry (s - slop, std::max (s, e) + slop, _regions.size ()));
+		_regions.push_back (r);
+	}
+
+	/* the RegionList is usually sorted by position already, in which
+	 * case so are the entries and the build is O(n). Playlist::ripple()
+	 * et al. do not re-sort it while moving regions though.
+	 */
+	if (!std::is_sorted (_entries.begin (), _entries.end ())) {
+		std::sort (_entries.begin (), _entries.end ());
+	}
+
+	_max_end.resize (_entries.size ());
+	build_max_end (0, _entries.size ());
+
+	_valid = true;
+}
+
+superclock_t
+RegionIntervalIndex::build_max_end (size_t lo, size_t hi)
+{
+	if (lo >= hi) {
+		return std::numeric_limits<superclock_t>::min ();
+	}
+
+	size_t const mid = lo + (hi - lo) / 2;
+
+	superclock_t m = _entries[mid].end;
+	m = std::max (m, build_max_end (lo, mid));
+	m = std::max (m, build_max_end (mid + 1, hi));
+
+	_max_end[mid] = m;
+	return m;
+}
+
+void
+RegionIntervalIndex::find (size_t lo, size_t hi, superclock_t start, superclock_t end, std::vector<size_t>& orders) const
+{
+	while (lo < hi) {
+		size_t const mid = lo + (hi - lo) / 2;
+
+		if (_max_end[mid] < start) {
+			/* nothing in this subtree reaches start */
+			return;
+		}
+
+		find (lo, mid, start, end, orders);
+
+		if (_entries[mid].start > end) {
+			/* this and all later entries begin after end */
+			return;
+		}
+
+		if (_entries[mid].end >= start) {
+			orders.push_back (_entries[mid].order);
+		}
+
+		/* continue with the right subtree */
+		lo = mid + 1;
+	}
+}
+
+void
+RegionIntervalIndex::find (superclock_t start, superclock_t end, std::vector<boost::shared_ptr<Region> >& result) const
+{
+	_orders.clear ();
+
+	find (0, _entries.size (), start, end, _orders);
+
+	/* restore RegionList order */
+	std::sort (_orders.begin (), _orders.end ());
+
+	for (auto const& o : _orders) {
+		result.push_back (_regions[o]);
+	}
+}
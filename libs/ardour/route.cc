@@ -63,6 +63,7 @@
 #include "ardour/delivery.h"
 #include "ardour/disk_reader.h"
 #include "ardour/disk_writer.h"
+#include "ardour/dsp_profiler.h"
 #include "ardour/event_type_map.h"
 #include "ardour/gain_control.h"
 #include "ardour/graph.h"
@@ -484,6 +485,9 @@ Route::process_output_buffers (BufferSet& bufs,
 
 	samplecnt_t latency = 0;
 
+	DSPProfiler& profiler (_session.dsp_profiler ());
+	bool const   profile = profiler.enabled () || profiler.tracing ();
+
 	for (ProcessorList::const_iterator i = _processors.begin(); i != _processors.end(); ++i) {
 
 		bool re_inject_oob_data = false;
@@ -537,12 +541,22 @@ Route::process_output_buffers (BufferSet& bufs,
 			}
 		}
 
+		PBD::microseconds_t const t0 = profile ? PBD::get_microseconds () : 0;
+
 		if (speed < 0) {
 			(*i)->run (bufs, start_sample + latency, end_sample + latency, pspeed, nframes, *i != _processors.back());
 		} else {
 			(*i)->run (bufs, start_sample - latency, end_sample - latency, pspeed, nframes, *i != _processors.back());
 		}
 
+		if (profile) {
+			PBD::microseconds_t const t1 = PBD::get_microseconds ();
+			(*i)->add_process_time (t1 - t0);
+			if (profiler.tracing ()) {
+				profiler.record_processor (i->get (), t0, t1);
+			}
+		}
+
 		bufs.set_count ((*i)->output_streams());
 
 		if (re_inject_oob_data) {
@@ -2654,6 +2668,12 @@ Route::state (bool save_template) const
 	return *node;
 }
 
+void
+Route::id_changed (PBD::ID const& previous)
+{
+	_session.route_id_changed (*this, previous);
+}
+
 int
 Route::set_state (const XMLNode& node, int version)
 {
@@ -78,6 +78,7 @@
 #include "ardour/debug.h"
 #include "ardour/disk_reader.h"
 #include "ardour/directory_names.h"
+#include "ardour/dsp_profiler.h"
 #include "ardour/filename_extensions.h"
 #include "ardour/gain_control.h"
 #include "ardour/graph.h"
@@ -244,6 +245,8 @@ Session::Session (AudioEngine &eng,
 	, _state_of_the_state (StateOfTheState (CannotSave | InitialConnecting | Loading))
 	, _save_queued (false)
 	, _save_queued_pending (false)
+	, _save_thread (0)
+	, _background_save (0)
 	, _last_roll_location (0)
 	, _last_roll_or_reversal_location (0)
 	, _last_record_location (0)
@@ -285,6 +288,7 @@ Session::Session (AudioEngine &eng,
 	, _punch_or_loop (NoConstraint)
 	, _all_route_group (new RouteGroup (*this, "all"))
 	, routes (new RouteList)
+	, _route_id_map (new RouteIDMap)
 	, _adding_routes_in_progress (false)
 	, _reconnecting_routes_in_progress (false)
 	, _route_deletion_in_progress (false)
@@ -325,6 +329,7 @@ Session::Session (AudioEngine &eng,
 	, _mmc (0)
 	, _vca_manager (new VCAManager (*this))
 	, _selection (new CoreSelection (*this))
+	, _dsp_profiler (new DSPProfiler (*this))
 	, _global_locate_pending (false)
 	, _had_destructive_tracks (false)
 	, _pending_cue (-1)
@@ -332,6 +337,7 @@ Session::Session (AudioEngine &eng,
 	, tb_with_filled_slots (0)
 {
 	g_atomic_int_set (&_suspend_save, 0);
+	g_atomic_int_set (&_background_save_done, 0);
 	g_atomic_int_set (&_playback_load, 0);
 	g_atomic_int_set (&_capture_load, 0);
 	g_atomic_int_set (&_post_transport_work, 0);
@@ -614,7 +620,7 @@ Session::destroy ()
 	vector<void*> debug_pointers;
 
 	/* if we got to here, leaving pending capture state around
-	   is a mistake.
+	   is a mistake. This also waits for a background save to finish.
 	*/
 
 	remove_pending_capture_state ();
@@ -783,6 +789,7 @@ Session::destroy ()
 		r->clear ();
 		/* writer goes out of scope and updates master */
 	}
+	update_route_id_map ();
 	routes.flush ();
 
 	{
@@ -860,6 +867,9 @@ Session::destroy ()
 	delete _selection;
 	_selection = 0;
 
+	delete _dsp_profiler;
+	_dsp_profiler = 0;
+
 	_transport_fsm->stop ();
 
 	DEBUG_TRACE (DEBUG::Destruction, "Session::destroy() done\n");
@@ -3248,6 +3258,8 @@ Session::add_routes_inner (RouteList& new_routes, bool input_auto_connect, bool
 		}
 	}
 
+	update_route_id_map ();
+
 	/* monitor is not part of the order */
 	if (_monitor_out) {
 		assert (n_routes > 0);
@@ -3553,6 +3565,8 @@ Session::remove_routes (boost::shared_ptr<RouteList> routes_to_remove)
 
 	} // end of RCU Writer scope
 
+	update_route_id_map ();
+
 	if (mute_changed) {
 		MuteChanged (); /* EMIT SIGNAL */
 	}
@@ -4159,14 +4173,60 @@ Session::route_by_name (string name) const
 	return boost::shared_ptr<Route> ((Route*) 0);
 }
 
+void
+Session::update_route_id_map ()
+{
+	boost::shared_ptr<RouteList> r = routes.reader ();
+
+	RCUWriter<RouteIDMap> writer (_route_id_map);
+	boost::shared_ptr<RouteIDMap> m = writer.get_copy ();
+
+	m->clear ();
+	for (RouteList::const_iterator i = r->begin(); i != r->end(); ++i) {
+		(*m)[(*i)->id()] = *i;
+	}
+}
+
+void
+Session::route_id_changed (Route& route, PBD::ID const& previous)
+{
+	{
+		boost::shared_ptr<RouteIDMap> m = _route_id_map.reader ();
+		RouteIDMap::const_iterator ri = m->find (previous);
+		if (ri == m->end() || ri->second.lock().get() != &route) {
+			/* not (yet) indexed, e.g. while the route is being loaded */
+			return;
+		}
+	}
+
+	RCUWriter<RouteIDMap> writer (_route_id_map);
+	boost::shared_ptr<RouteIDMap> m = writer.get_copy ();
+
+	RouteIDMap::iterator ri = m->find (previous);
+	if (ri != m->end()) {
+		boost::weak_ptr<Route> wr = ri->second;
+		m->erase (ri);
+		(*m)[route.id()] = wr;
+	}
+}
+
 boost::shared_ptr<Route>
 Session::route_by_id (PBD::ID id) const
 {
-	boost::shared_ptr<RouteList> r = routes.reader ();
+	boost::shared_ptr<RouteIDMap> m = _route_id_map.reader ();
+	RouteIDMap::const_iterator ri = m->find (id);
 
-	for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
-		if ((*i)->id() == id) {
-			return *i;
+	if (ri != m->end()) {
+		return ri->second.lock ();
+	}
+
+	if (DEBUG_ENABLED (PBD::DEBUG::Stateful)) {
+		boost::shared_ptr<RouteList> r = routes.reader ();
+		for (RouteList::iterator i = r->begin(); i != r->end(); ++i) {
+			if ((*i)->id() == id) {
+				DEBUG_TRACE (PBD::DEBUG::Stateful, string_compose ("Route %1 (%2) is missing from the ID index\n", (*i)->name(), id));
+				break;
+			}
 		}
 	}
 
@@ -419,30 +419,41 @@ get_id_sorted_playlists (const List& playlists, IDSortedList& id_sorted_playlist
 
 } // anonymous namespace
 
+/** Add playlist state to @a node. If @a writer is given, @a node is the
+ *  innermost node that it has open, and playlists are written one at a time.
+ */
 void
-SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unused) const
+SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unused, XMLWriter* writer) const
 {
 	XMLNode* child = node->add_child ("Playlists");
 
+	if (writer) {
+		writer->open (*child);
+	}
+
 	IDSortedList id_sorted_playlists;
 	get_id_sorted_playlists (playlists, id_sorted_playlists);
 
 	for (IDSortedList::const_iterator i = id_sorted_playlists.begin (); i != id_sorted_playlists.end (); ++i) {
 		if (!(*i)->hidden ()) {
-			if (save_template) {
-				child->add_child_nocopy ((*i)->get_template ());
-			} else {
-				child->add_child_nocopy ((*i)->get_state ());
-			}
+			add_playlist_state (child, **i, save_template, writer);
 		}
 	}
 
+	if (writer) {
+		writer->close ();
+	}
+
 	if (!include_unused) {
 		return;
 	}
 
 	child = node->add_child ("UnusedPlaylists");
 
+	if (writer) {
+		writer->open (*child);
+	}
+
 	IDSortedList id_sorted_unused_playlists;
 	get_id_sorted_playlists (unused_playlists, id_sorted_unused_playlists);
 
@@ -450,14 +461,52 @@ SessionPlaylists::add_state (XMLNode* node, bool save_template, bool include_unu
 	     i != id_sorted_unused_playlists.end (); ++i) {
 		if (!(*i)->hidden()) {
 			if (!(*i)->empty()) {
-				if (save_template) {
-					child->add_child_nocopy ((*i)->get_template());
-				} else {
-					child->add_child_nocopy ((*i)->get_state());
-				}
+				add_playlist_state (child, **i, save_template, writer);
 			}
 		}
 	}
+
+	if (writer) {
+		writer->close ();
+	}
+}
+
+void
+SessionPlaylists::add_playlist_state (XMLNode* node, Playlist& pl, bool save_template, XMLWriter* writer) const
+{
+	if (save_template) {
+		node->add_child_nocopy (pl.get_template ());
+		if (writer) {
+			writer->flush ();
+		}
+	} else if (writer) {
+		pl.write_state (*writer);
+	} else {
+		node->add_child_nocopy (pl.get_state ());
+	}
+}
+
+/** Copy the state of the playlists that add_state() saves, in the order it saves them */
+void
+SessionPlaylists::state_copies (vector<boost::shared_ptr<Playlist::StateCopy> >& used, vector<boost::shared_ptr<Playlist::StateCopy> >& unused) const
+{
+	IDSortedList id_sorted_playlists;
+	get_id_sorted_playlists (playlists, id_sorted_playlists);
+
+	for (IDSortedList::const_iterator i = id_sorted_playlists.begin (); i != id_sorted_playlists.end (); ++i) {
+		if (!(*i)->hidden ()) {
+			used.push_back (boost::shared_ptr<Playlist::StateCopy> (new Playlist::StateCopy (**i)));
+		}
+	}
+
+	IDSortedList id_sorted_unused_playlists;
+	get_id_sorted_playlists (unused_playlists, id_sorted_unused_playlists);
+
+	for (IDSortedList::const_iterator i = id_sorted_unused_playlists.begin (); i != id_sorted_unused_playlists.end (); ++i) {
+		if (!(*i)->hidden () && !(*i)->empty ()) {
+			unused.push_back (boost::shared_ptr<Playlist::StateCopy> (new Playlist::StateCopy (**i)));
+		}
+	}
 }
 
 /** @return true for `stop cleanup', otherwise false */
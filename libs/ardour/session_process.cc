@@ -43,6 +43,7 @@
 #include "ardour/cycle_timer.h"
 #include "ardour/debug.h"
 #include "ardour/disk_reader.h"
+#include "ardour/dsp_profiler.h"
 #include "ardour/graph.h"
 #include "ardour/io_plug.h"
 #include "ardour/port.h"
@@ -96,6 +97,8 @@ Session::process (pframes_t nframes)
 
 	samplepos_t transport_at_start = _transport_sample;
 
+	_dsp_profiler->cycle_start ();
+
 	setup_thread_local_variables ();
 
 	if (non_realtime_work_pending()) {
@@ -188,6 +191,8 @@ Session::process (pframes_t nframes)
 		/* don't bother with a message */
 	}
 
+	_dsp_profiler->cycle_end ();
+
 	SendFeedback (); /* EMIT SIGNAL */
 }
 
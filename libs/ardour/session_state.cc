@@ -678,16 +678,23 @@ void
 Session::maybe_write_autosave()
 {
 	if (dirty() && record_status() != Recording) {
-		save_state("", true);
+		save_state_in_background (true);
 	}
 }
 
 void
 Session::remove_pending_capture_state ()
+{
+	wait_for_background_save ();
+	remove_pending_state_file (_current_snapshot_name);
+}
+
+void
+Session::remove_pending_state_file (std::string const& snapshot_name) const
 {
 	std::string pending_state_file_path(_session_dir->root_path());
 
-	pending_state_file_path = Glib::build_filename (pending_state_file_path, legalize_for_path (_current_snapshot_name) + pending_suffix);
+	pending_state_file_path = Glib::build_filename (pending_state_file_path, legalize_for_path (snapshot_name) + pending_suffix);
 
 	if (!Glib::file_test (pending_state_file_path, Glib::FILE_TEST_EXISTS)) {
 		return;
@@ -773,9 +780,6 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 	/* pending saves are for current snapshot only */
 	assert (!pending || ((snapshot_name.empty () || snapshot_name == _current_snapshot_name) && !template_only && !for_archive));
 
-	XMLTree tree;
-	std::string xml_path(_session_dir->root_path());
-
 	/* prevent concurrent saves from different threads */
 
 	Glib::Threads::Mutex::Lock lm (save_state_lock);
@@ -788,6 +792,8 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		return 1;
 	}
 
+	wait_for_background_save ();
+
 	if (g_atomic_int_get(&_suspend_save)) {
 		/* StateProtector cannot be used for templates or save-as */
 		assert (!template_only && !switch_to_snapshot && !for_archive && (snapshot_name.empty () || snapshot_name == _current_snapshot_name));
@@ -829,13 +835,27 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		mark_as_clean = false;
 	}
 
+	std::string tmp_path = Glib::build_filename (_session_dir->root_path(), legalize_for_path (snapshot_name.empty() ? _current_snapshot_name : snapshot_name) + temp_suffix);
+
+	/* write the state to a temporary file while it is produced, rather
+	 * than building the complete tree first
+	 */
+	XMLWriter writer;
+	XMLNode   root (X_("Session"));
+
+	writer.start (tmp_path);
+
 	if (template_only) {
 		mark_as_clean = false;
-		tree.set_root (&get_template());
+		/* see get_template() */
+		disable_record (false);
+		state (root, &writer, true, NormalSave, false, false);
 	} else {
-		tree.set_root (&state (false, fork_state, for_archive, only_used_assets));
+		state (root, &writer, false, fork_state, for_archive, only_used_assets);
 	}
 
+	bool const written = writer.finish ();
+
 	if (snapshot_name.empty()) {
 		snapshot_name = _current_snapshot_name;
 	} else if (switch_to_snapshot) {
@@ -843,6 +863,38 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 	}
 
 	assert (!snapshot_name.empty());
+	assert (!pending || snapshot_name == _current_snapshot_name);
+
+	if (install_state_file (tmp_path, snapshot_name, written, pending)) {
+		return -1;
+	}
+
+	if (!pending && !for_archive) {
+
+		save_history (snapshot_name);
+
+		if (mark_as_clean) {
+			unset_dirty (/* EMIT SIGNAL */ true);
+		}
+
+		StateSaved (snapshot_name); /* EMIT SIGNAL */
+	}
+
+	if (!pending && !for_archive && ! template_only) {
+		remove_pending_capture_state ();
+	}
+
+	return 0;
+}
+
+/** Move a state file written to \p tmp_path into place, after making a
+ *  backup of the previous state. This does not use any session state that
+ *  may change while saving, so it can be called from the save thread.
+ */
+int
+Session::install_state_file (std::string const& tmp_path, std::string const& snapshot_name, bool written, bool pending) const
+{
+	std::string xml_path(_session_dir->root_path());
 
 	if (!pending) {
 
@@ -854,19 +906,16 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 
 		if (Glib::file_test (xml_path, Glib::FILE_TEST_EXISTS) && !create_backup_file (xml_path)) {
 			// create_backup_file will log the error
+			g_remove (tmp_path.c_str());
 			return -1;
 		}
 
 	} else {
-		assert (snapshot_name == _current_snapshot_name);
 		/* pending save: use pending_suffix (.pending in English) */
 		xml_path = Glib::build_filename (xml_path, legalize_for_path (snapshot_name) + pending_suffix);
 	}
 
-	std::string tmp_path(_session_dir->root_path());
-	tmp_path = Glib::build_filename (tmp_path, legalize_for_path (snapshot_name) + temp_suffix);
-
-	if (!tree.write (tmp_path)) {
+	if (!written) {
 		error << string_compose (_("state could not be saved to %1"), tmp_path) << endmsg;
 		if (g_remove (tmp_path.c_str()) != 0) {
 			error << string_compose(_("Could not remove temporary session file at path \"%1\" (%2)"),
@@ -901,7 +950,7 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 			strftime (timebuf, sizeof(timebuf), "%y-%m-%d.%H", &local_time);
 			std::string save_path(session_directory().backup_path());
 			save_path += G_DIR_SEPARATOR;
-			save_path += legalize_for_path(_current_snapshot_name);
+			save_path += legalize_for_path(snapshot_name);
 			save_path += "-";
 			save_path += timebuf;
 			save_path += statefile_suffix;
@@ -912,24 +961,213 @@ Session::save_state (string snapshot_name, bool pending, bool switch_to_snapshot
 		}
 	}
 
-	if (!pending && !for_archive) {
+	return 0;
+}
 
-		save_history (snapshot_name);
+/** The session state as captured by state() for save_state_in_background().
+ *
+ * Most of the state is complete children of the root node. The regions and
+ * playlists are empty nodes, and copies of the state of the objects to
+ * write into them are listed instead. See write_state_snapshot().
+ */
+struct Session::StateSnapshot {
+	typedef std::vector<boost::shared_ptr<Region::StateCopy const> > RegionStates;
+	typedef std::vector<boost::shared_ptr<Playlist::StateCopy> >     PlaylistStates;
+
+	StateSnapshot ()
+		: root (X_("Session"))
+		, regions_node (0)
+		, playlists_node (0)
+		, unused_playlists_node (0)
+	{}
+
+	XMLNode        root;
+	XMLNode*       regions_node;
+	RegionStates   regions;
+	XMLNode*       playlists_node;
+	PlaylistStates playlists;
+	XMLNode*       unused_playlists_node;
+	PlaylistStates unused_playlists;
+};
 
-		if (mark_as_clean) {
-			unset_dirty (/* EMIT SIGNAL */ true);
+int
+Session::save_state_in_background (bool pending)
+{
+	DEBUG_TRACE (DEBUG::Locale, string_compose ("Session::save_state_in_background locale '%1'\n", setlocale (LC_NUMERIC, NULL)));
+
+	Glib::Threads::Mutex::Lock lm (save_state_lock);
+	Glib::Threads::Mutex::Lock lx (save_source_lock);
+
+	if (!_writable || cannot_save()) {
+		return 1;
+	}
+
+	if (g_atomic_int_get(&_suspend_save)) {
+		if (pending) {
+			_save_queued_pending = true;
+		} else {
+			_save_queued = true;
+		}
+		return 1;
+	}
+	if (pending) {
+		_save_queued_pending = false;
+	} else {
+		_save_queued = false;
+	}
+
+	/* one save at a time: the previous one uses the same temporary file */
+	wait_for_background_save ();
+
+	for (SourceMap::const_iterator i = sources.begin(); i != sources.end(); ++i) {
+		try {
+			i->second->session_saved();
+		} catch (Evoral::SMF::FileError& e) {
+			error << string_compose ("Could not write to MIDI file %1; MIDI data not saved.", e.file_name ()) << endmsg;
 		}
+	}
 
-		StateSaved (snapshot_name); /* EMIT SIGNAL */
+	SessionSaveUnderway (); /* EMIT SIGNAL */
+
+	/* take the snapshot while holding the save lock. Session objects are
+	 * not thread-safe: playlists and regions are copied as values, which
+	 * the save thread serializes, the rest is serialized here. The undo
+	 * history is serialized here as well, since transactions are deleted
+	 * as new ones are committed; the saved history depth limits its size.
+	 */
+	BackgroundSave* bs = new BackgroundSave;
+
+	bs->snapshot_name = _current_snapshot_name;
+	bs->tmp_path      = Glib::build_filename (_session_dir->root_path(), legalize_for_path (_current_snapshot_name) + temp_suffix);
+	bs->pending       = pending;
+	bs->state         = new StateSnapshot;
+
+	state (bs->state->root, 0, false, NormalSave, false, false, bs->state);
+
+	if (!pending) {
+		bs->history = history_state ();
+		/* edits from now on are not part of this save. If it fails,
+		 * the session is marked dirty again when the save is finished.
+		 */
+		unset_dirty (/* EMIT SIGNAL */ true);
 	}
 
-	if (!pending && !for_archive && ! template_only) {
-		remove_pending_capture_state ();
+	{
+		Glib::Threads::Mutex::Lock lt (save_thread_lock);
+		g_atomic_int_set (&_background_save_done, 0);
+		_background_save = bs;
+		_save_thread = PBD::Thread::create (boost::bind (&Session::background_save, this, bs), "SessionSave");
+		if (!_save_thread) {
+			_background_save = 0;
+		}
+	}
+
+	if (!_background_save) {
+		error << _("Cannot create thread for background session save, saving now") << endmsg;
+		background_save (bs);
+		background_save_done (bs);
 	}
 
 	return 0;
 }
 
+Session::BackgroundSave::~BackgroundSave ()
+{
+	delete state;
+	delete history;
+}
+
+Session::BackgroundSave*
+Session::join_save_thread ()
+{
+	/* caller must hold save_thread_lock */
+	if (!_save_thread) {
+		return 0;
+	}
+
+	_save_thread->join ();
+	delete _save_thread;
+	_save_thread = 0;
+
+	BackgroundSave* bs = _background_save;
+	_background_save = 0;
+	return bs;
+}
+
+void
+Session::wait_for_background_save ()
+{
+	BackgroundSave* bs;
+
+	{
+		Glib::Threads::Mutex::Lock lm (save_thread_lock);
+		bs = join_save_thread ();
+	}
+
+	if (bs) {
+		background_save_done (bs);
+	}
+}
+
+bool
+Session::finish_background_save ()
+{
+	BackgroundSave* bs;
+
+	{
+		Glib::Threads::Mutex::Lock lm (save_thread_lock);
+		if (_save_thread && !g_atomic_int_get (&_background_save_done)) {
+			return false;
+		}
+		bs = join_save_thread ();
+	}
+
+	if (bs) {
+		background_save_done (bs);
+	}
+
+	return true;
+}
+
+void
+Session::background_save (BackgroundSave* bs)
+{
+	/* runs in the save thread: only touch files and `bs'. Dirty state
+	 * and signals are handled by background_save_done().
+	 */
+	XMLWriter writer;
+
+	if (writer.start (bs->tmp_path)) {
+		write_state_snapshot (writer, *bs->state);
+	}
+
+	bs->ok = install_state_file (bs->tmp_path, bs->snapshot_name, writer.finish (), bs->pending) == 0;
+
+	if (bs->ok && !bs->pending) {
+		write_history (bs->snapshot_name, bs->history);
+		bs->history = 0;
+		remove_pending_state_file (bs->snapshot_name);
+	}
+
+	g_atomic_int_set (&_background_save_done, 1);
+}
+
+void
+Session::background_save_done (BackgroundSave* bs)
+{
+	if (!bs->pending) {
+		if (bs->ok) {
+			StateSaved (bs->snapshot_name); /* EMIT SIGNAL */
+		} else {
+			set_dirty ();
+		}
+	}
+
+	BackgroundSaveFinished (bs->snapshot_name, bs->ok); /* EMIT SIGNAL */
+
+	delete bs;
+}
+
 int
 Session::restore_state (string snapshot_name)
 {
@@ -1183,19 +1421,77 @@ struct route_id_compare {
 		return r1->id () < r2->id ();
 	}
 };
+
+/* Add the state of @a s to @a parent, or write it directly if @a writer is
+ * given (in which case @a parent is the innermost node that it has open).
+ */
+void
+add_child_state (XMLNode* parent, XMLWriter* writer, Stateful const& s)
+{
+	if (writer) {
+		s.write_state (*writer);
+	} else {
+		parent->add_child_nocopy (s.get_state ());
+	}
+}
+
 } // anon namespace
 
 XMLNode&
 Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive, bool only_used_assets) const
 {
-	LocaleGuard lg;
 	XMLNode* node = new XMLNode("Session");
+	state (*node, 0, save_template, snapshot_type, for_archive, only_used_assets);
+	return *node;
+}
+
+/** Add the session state to @a root. If @a writer is given, @a root is
+ *  written while it is produced, and its children are deleted once they are
+ *  written. The state of large objects is written one object at a time.
+ *
+ *  If @a snapshot is given, the state of regions and playlists is not
+ *  added; copies of it are kept in @a snapshot instead.
+ */
+void
+Session::state (XMLNode& root, XMLWriter* writer, bool save_template, snapshot_t snapshot_type, bool for_archive, bool only_used_assets, StateSnapshot* snapshot) const
+{
+	/* snapshots are only taken for normal saves */
+	assert (!snapshot || (!writer && !save_template && snapshot_type == NormalSave && !for_archive && !only_used_assets));
+
+	LocaleGuard lg;
+	XMLNode* node = &root;
 	XMLNode* child;
 
 	PBD::Unwinder<bool> uw (Automatable::skip_saving_automation, save_template);
 
+	/* all properties of the root node must be set before it is written */
+
 	node->set_property("version", CURRENT_SESSION_FILE_VERSION);
 
+	if (!save_template) {
+		node->set_property ("name", _name);
+		node->set_property ("sample-rate", _base_sample_rate);
+		node->set_property ("session-range-is-free", _session_range_is_free);
+	}
+
+	/* save the ID counter */
+
+	node->set_property ("id-counter", ID::counter());
+
+	node->set_property ("name-counter", name_id_counter ());
+
+	/* save the event ID counter */
+
+	node->set_property ("event-counter", Evoral::event_id_counter());
+
+	/* save the VCA counter */
+
+	node->set_property ("vca-counter", VCA::get_next_vca_number());
+
+	if (writer) {
+		writer->open (*node);
+	}
+
 	child = node->add_child ("ProgramVersion");
 	child->set_property("created-with", created_with);
 
@@ -1206,9 +1502,6 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 
 	if (!save_template) {
 
-		node->set_property ("name", _name);
-		node->set_property ("sample-rate", _base_sample_rate);
-
 		/* store the last engine device we we can avoid autostarting on a different device with wrong i/o count */
 		boost::shared_ptr<AudioBackend> backend = _engine.current_backend();
 		if (!for_archive && _engine.running () && backend && _engine.setup_required ()) {
@@ -1251,23 +1544,8 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 			child = node->add_child ("Path");
 			child->add_content (p);
 		}
-		node->set_property ("session-range-is-free", _session_range_is_free);
 	}
 
-	/* save the ID counter */
-
-	node->set_property ("id-counter", ID::counter());
-
-	node->set_property ("name-counter", name_id_counter ());
-
-	/* save the event ID counter */
-
-	node->set_property ("event-counter", Evoral::event_id_counter());
-
-	/* save the VCA counter */
-
-	node->set_property ("vca-counter", VCA::get_next_vca_number());
-
 	/* various options */
 
 	list<XMLNode*> midi_port_nodes = _midi_ports->get_midi_port_states();
@@ -1292,6 +1570,10 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 
 	child = node->add_child ("Sources");
 
+	if (writer) {
+		writer->open (*child);
+	}
+
 	if (!save_template) {
 		Glib::Threads::Mutex::Lock sl (source_lock);
 
@@ -1343,14 +1625,22 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 				}
 			}
 
-			child->add_child_nocopy (siter->second->get_state());
+			add_child_state (child, writer, *siter->second);
 		}
 	}
 
+	if (writer) {
+		writer->close ();
+	}
+
 	node->add_child_nocopy (*TriggerBox::get_custom_midi_binding_state());
 
 	child = node->add_child ("Regions");
 
+	if (writer) {
+		writer->open (*child);
+	}
+
 	if (!save_template) {
 		Glib::Threads::Mutex::Lock rl (region_lock);
 
@@ -1362,10 +1652,20 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 				assert (r->sources().size() > 0 && r->master_sources().size() > 0);
 				/* only store regions not attached to playlists */
 				if (r->playlist() == 0) {
-					if (boost::dynamic_pointer_cast<AudioRegion>(r)) {
+					if (snapshot) {
+						boost::shared_ptr<AudioRegion> ar = boost::dynamic_pointer_cast<AudioRegion> (r);
+						if (ar) {
+							snapshot->regions.push_back (boost::shared_ptr<Region::StateCopy const> (new AudioRegion::StateCopy (*ar, true)));
+						} else {
+							snapshot->regions.push_back (r->state_copy ());
+						}
+					} else if (boost::dynamic_pointer_cast<AudioRegion>(r)) {
 						child->add_child_nocopy ((boost::dynamic_pointer_cast<AudioRegion>(r))->get_basic_state ());
+						if (writer) {
+							writer->flush ();
+						}
 					} else {
-						child->add_child_nocopy (r->get_state ());
+						add_child_state (child, writer, *r);
 					}
 				}
 			}
@@ -1394,7 +1694,7 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 				boost::shared_ptr<Region> r = i->second;
 
 				if (tr.find (r) != tr.end()) {
-					child->add_child_nocopy (r->get_state ());
+					add_child_state (child, writer, *r);
 					continue;
 				}
 
@@ -1416,7 +1716,7 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 					}
 				}
 				if (!found) {
-					child->add_child_nocopy (r->get_state ());
+					add_child_state (child, writer, *r);
 				}
 			}
 		}
@@ -1446,6 +1746,15 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 		}
 	}
 
+	if (writer) {
+		/* also writes "Regions" children that were added above */
+		writer->close ();
+	}
+
+	if (snapshot) {
+		snapshot->regions_node = child;
+	}
+
 	if (!save_template) {
 
 		node->add_child_nocopy (_selection->get_state());
@@ -1490,6 +1799,11 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 	node->add_child_nocopy (_vca_manager->get_state());
 
 	child = node->add_child ("Routes");
+
+	if (writer) {
+		writer->open (*child);
+	}
+
 	{
 		boost::shared_ptr<RouteList> r = routes.reader ();
 
@@ -1501,14 +1815,27 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 			if (!(*i)->is_auditioner()) {
 				if (save_template) {
 					child->add_child_nocopy ((*i)->get_template());
+					if (writer) {
+						writer->flush ();
+					}
 				} else {
-					child->add_child_nocopy ((*i)->get_state());
+					add_child_state (child, writer, **i);
 				}
 			}
 		}
 	}
 
-	_playlists->add_state (node, save_template, !only_used_assets);
+	if (writer) {
+		writer->close ();
+	}
+
+	if (snapshot) {
+		snapshot->playlists_node        = node->add_child ("Playlists");
+		snapshot->unused_playlists_node = node->add_child ("UnusedPlaylists");
+		_playlists->state_copies (snapshot->playlists, snapshot->unused_playlists);
+	} else {
+		_playlists->add_state (node, save_template, !only_used_assets, writer);
+	}
 
 	child = node->add_child ("RouteGroups");
 	for (list<RouteGroup *>::const_iterator i = _route_groups.begin(); i != _route_groups.end(); ++i) {
@@ -1586,7 +1913,53 @@ Session::state (bool save_template, snapshot_t snapshot_type, bool for_archive,
 		node->add_child_nocopy (*iop_node);
 	}
 
-	return *node;
+	if (writer) {
+		writer->close ();
+	}
+}
+
+/** Write a snapshot taken by state(). This runs in the save thread, and
+ *  does not use any session object. The output is in the order of state(),
+ *  so the file is the same as one written by save_state().
+ */
+void
+Session::write_state_snapshot (XMLWriter& writer, StateSnapshot& snapshot)
+{
+	LocaleGuard lg;
+
+	/* opening each empty node writes the state which precedes it, and
+	 * closing it removes it from the root node. Copies are released once
+	 * they are written.
+	 */
+	writer.open (snapshot.root);
+
+	writer.open (*snapshot.regions_node);
+	for (StateSnapshot::RegionStates::iterator i = snapshot.regions.begin(); i != snapshot.regions.end(); ++i) {
+		XMLNode& node ((*i)->get_state ());
+		writer.write (node);
+		delete &node;
+		i->reset ();
+	}
+	writer.close ();
+
+	writer.open (*snapshot.playlists_node);
+	for (StateSnapshot::PlaylistStates::iterator i = snapshot.playlists.begin(); i != snapshot.playlists.end(); ++i) {
+		(*i)->write_state (writer);
+		i->reset ();
+	}
+	writer.close ();
+
+	writer.open (*snapshot.unused_playlists_node);
+	for (StateSnapshot::PlaylistStates::iterator i = snapshot.unused_playlists.begin(); i != snapshot.unused_playlists.end(); ++i) {
+		(*i)->write_state (writer);
+		i->reset ();
+	}
+	writer.close ();
+
+	/* the remaining state, and the end of the session node */
+	writer.close ();
+
+	snapshot.regions_node = snapshot.playlists_node = snapshot.unused_playlists_node = 0;
 }
 
 bool
@@ -3965,6 +4338,8 @@ Session::cleanup_sources (CleanupReport& rep)
 				::g_rename (newpath.c_str (), _path.c_str ());
 				goto out;
 			}
+			::g_unlink ((peakpath + peak_pyramid_suffix).c_str ());
+			::g_unlink ((peakpath + amplitude_stats_suffix).c_str ());
 		}
 
 		rep.paths.push_back (*x);
@@ -4121,8 +4496,6 @@ Session::instant_xml (const string& node_name)
 int
 Session::save_history (string snapshot_name)
 {
-	XMLTree tree;
-
 	if (!_writable) {
 	        return 0;
 	}
@@ -4131,6 +4504,31 @@ Session::save_history (string snapshot_name)
 		snapshot_name = _current_snapshot_name;
 	}
 
+	return write_history (snapshot_name, history_state ());
+}
+
+/** @return the undo history to save, or 0 if no history should be saved */
+XMLNode*
+Session::history_state ()
+{
+	if (!Config->get_save_history() || Config->get_saved_history_depth() < 0 ||
+	    (_history.undo_depth() == 0 && _history.redo_depth() == 0)) {
+		return 0;
+	}
+
+	return &_history.get_state (Config->get_saved_history_depth());
+}
+
+/** Write the undo history of \p snapshot_name, after making a backup of the
+ *  previous one. Takes ownership of \p history, which may be 0.
+ */
+int
+Session::write_history (std::string const& snapshot_name, XMLNode* history) const
+{
+	XMLTree tree;
+
+	tree.set_root (history);
+
 	const string history_filename = legalize_for_path (snapshot_name) + history_suffix;
 	const string backup_filename = history_filename + backup_suffix;
 	const std::string xml_path(Glib::build_filename (_session_dir->root_path(), history_filename));
@@ -4143,13 +4541,10 @@ Session::save_history (string snapshot_name)
 		}
 	}
 
-	if (!Config->get_save_history() || Config->get_saved_history_depth() < 0 ||
-	    (_history.undo_depth() == 0 && _history.redo_depth() == 0)) {
+	if (!history) {
 		return 0;
 	}
 
-	tree.set_root (&_history.get_state (Config->get_saved_history_depth()));
-
 	if (!tree.write (xml_path))
 	{
 		error << string_compose (_("history could not be saved to %1"), xml_path) << endmsg;
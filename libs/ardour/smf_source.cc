@@ -23,6 +23,7 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include <limits>
 #include <vector>
 
 #include <sys/time.h>
@@ -69,6 +70,7 @@ SMFSource::SMFSource (Session& s, const string& path, Source::Flag flags)
 	, FileSource(s, DataType::MIDI, path, string(), flags)
 	, Evoral::SMF()
 	, _open (false)
+	, _written_revision (std::numeric_limits<uint64_t>::max ())
 	, _last_ev_time_samples(0)
 {
 	/* note that origin remains empty */
@@ -106,6 +108,7 @@ SMFSource::SMFSource (Session& s, const string& path)
 	, FileSource(s, DataType::MIDI, path, string(), Source::Flag (0))
 	, Evoral::SMF()
 	, _open (false)
+	, _written_revision (std::numeric_limits<uint64_t>::max ())
 	, _last_ev_time_samples(0)
 {
 	/* note that origin remains empty */
@@ -133,6 +136,7 @@ SMFSource::SMFSource (Session& s, const XMLNode& node, bool must_exist)
 	, MidiSource(s, node)
 	, FileSource(s, node, must_exist)
 	, _open (false)
+	, _written_revision (std::numeric_limits<uint64_t>::max ())
 	, _last_ev_time_samples(0)
 {
 	if (set_state(node, Stateful::loading_state_version)) {
@@ -587,6 +591,7 @@ SMFSource::mark_midi_streaming_write_completed (const WriterLock& lm, Evoral::Se
 
 	try {
 		Evoral::SMF::end_write (_path);
+		_written_revision = track_revision ();
 	} catch (std::exception & e) {
 		error << string_compose (_("Exception while writing %1, file may be corrupt/unusable"), _path) << endmsg;
 	}
@@ -596,6 +601,63 @@ SMFSource::mark_midi_streaming_write_completed (const WriterLock& lm, Evoral::Se
 	mark_nonremovable ();
 }
 
+bool
+SMFSource::mark_range_write_started (const WriterLock& lock, Temporal::Beats const & start, Temporal::Beats const & end)
+{
+	if (!_open || _writing || !writable() || track_revision () != _written_revision) {
+		return false;
+	}
+
+	/* Kept and rewritten events only line up if beat-time can be
+	 * represented exactly in the file's resolution.
+	 */
+	if (ppqn () % Temporal::Beats::PPQN) {
+		return false;
+	}
+
+	size_t first = 0;
+	size_t last  = 0;
+
+	if (start <= end) {
+		first = start.to_ticks (ppqn ());
+		last  = end.to_ticks (ppqn ());
+	} else {
+		/* nothing changed, the file is rewritten as-is */
+		first = std::numeric_limits<size_t>::max ();
+	}
+
+	size_t prev;
+
+	if (!Evoral::SMF::begin_replace (first, last, prev)) {
+		return false;
+	}
+
+	/* subsequent calls to ::append_event_beats() compute their delta time
+	 * from this.
+	 */
+	_last_ev_time_beats = Temporal::Beats::ticks (prev / (ppqn () / Temporal::Beats::PPQN));
+	_writing = true;
+
+	return true;
+}
+
+void
+SMFSource::mark_range_write_completed (const WriterLock& lock)
+{
+	Evoral::SMF::end_replace ();
+	_writing = false;
+
+	try {
+		Evoral::SMF::end_write (_path);
+		_written_revision = track_revision ();
+	} catch (std::exception & e) {
+		error << string_compose (_("Exception while writing %1, file may be corrupt/unusable"), _path) << endmsg;
+	}
+
+	mark_nonremovable ();
+	invalidate (lock);
+}
+
 bool
 SMFSource::valid_midi_file (const string& file)
 {
@@ -34,6 +34,10 @@
 
 #include <sys/stat.h>
 
+#ifndef PLATFORM_WINDOWS
+#include <unistd.h>
+#endif
+
 #include <glib.h>
 #include "pbd/gstdio_compat.h"
 
@@ -47,6 +51,7 @@
 #include <glibmm/fileutils.h>
 #include <glibmm/miscutils.h>
 
+#include "ardour/file_read_ahead.h"
 #include "ardour/runtime_functions.h"
 #include "ardour/sndfilesource.h"
 #include "ardour/sndfile_helpers.h"
@@ -338,6 +343,8 @@ SndFileSource::init_sndfile ()
 	*/
 
 	memset (&_info, 0, sizeof(_info));
+	_sndfile_fd  = -1;
+	_data_offset = -1;
 
 	AudioFileSource::HeaderPositionOffsetChanged.connect_same_thread (header_position_connection, boost::bind (&SndFileSource::handle_header_position_change, this));
 }
@@ -346,8 +353,13 @@ void
 SndFileSource::close ()
 {
 	if (_sndfile) {
-		sf_close (_sndfile);
-		_sndfile = 0;
+		{
+			Glib::Threads::Mutex::Lock lm (_fd_lock);
+			sf_close (_sndfile);
+			_sndfile = 0;
+			_sndfile_fd  = -1;
+			_data_offset = -1;
+		}
 		file_closed ();
 	}
 }
@@ -397,6 +409,19 @@ SndFileSource::open ()
 		return -1;
 	}
 
+	{
+		Glib::Threads::Mutex::Lock lm (_fd_lock);
+		_sndfile_fd  = fd;
+		_data_offset = -1;
+#ifndef PLATFORM_WINDOWS
+		/* libsndfile does not expose the file offset of the sample data,
+		 * but seeking to the first sample leaves the descriptor there.
+		 */
+		if (!writable () && sf_seek (_sndfile, 0, SEEK_SET) == 0) {
+			_data_offset = ::lseek (fd, 0, SEEK_CUR);
+		}
+#endif
+	}
 
 	_length = timecnt_t (_info.frames);
 
@@ -500,6 +525,60 @@ SndFileSource::sample_rate () const
 	return _info.samplerate;
 }
 
+bool
+SndFileSource::queue_prefetch (FileReadAhead& reader, samplepos_t start, samplecnt_t cnt) const
+{
+	if (writable () || _info.channels < 1) {
+		return false;
+	}
+
+	/* only uncompressed data maps linearly to file offsets */
+	size_t bytes_per_sample;
+	switch (_info.format & SF_FORMAT_SUBMASK) {
+		case SF_FORMAT_PCM_16:
+			bytes_per_sample = 2;
+			break;
+		case SF_FORMAT_PCM_24:
+			bytes_per_sample = 3;
+			break;
+		case SF_FORMAT_PCM_32:
+		case SF_FORMAT_FLOAT:
+			bytes_per_sample = 4;
+			break;
+		case SF_FORMAT_DOUBLE:
+			bytes_per_sample = 8;
+			break;
+		default:
+			return false;
+	}
+
+	switch (_info.format & SF_FORMAT_TYPEMASK) {
+		case SF_FORMAT_WAV:
+		case SF_FORMAT_WAVEX:
+		case SF_FORMAT_RF64:
+		case SF_FORMAT_W64:
+		case SF_FORMAT_AIFF:
+		case SF_FORMAT_CAF:
+		case SF_FORMAT_RAW:
+			break;
+		default:
+			return false;
+	}
+
+	const size_t frame_size = bytes_per_sample * _info.channels;
+
+	/* The reader duplicates the descriptor, so the batch remains valid
+	 * even if the file is closed before the hints are issued.
+	 * Closed files are not prefetched, the next read re-opens them.
+	 */
+	Glib::Threads::Mutex::Lock lm (_fd_lock);
+	if (_sndfile_fd < 0 || _data_offset < 0) {
+		return false;
+	}
+	reader.queue (this, _sndfile_fd, _data_offset + (int64_t)start * frame_size, cnt * frame_size);
+	return true;
+}
+
 samplecnt_t
 SndFileSource::read_unlocked (Sample *dst, samplepos_t start, samplecnt_t cnt) const
 {
@@ -56,6 +56,7 @@ PBD::Signal1<void, boost::shared_ptr<Source>> SourceFactory::SourceCreated;
 Glib::Threads::Cond                           SourceFactory::PeaksToBuild;
 Glib::Threads::Mutex                          SourceFactory::peak_building_lock;
 std::list<boost::weak_ptr<AudioSource>>       SourceFactory::files_with_peaks;
+std::list<boost::weak_ptr<AudioSource>>       SourceFactory::files_with_peak_data;
 std::vector<PBD::Thread*>                     SourceFactory::peak_thread_pool;
 bool                                          SourceFactory::peak_thread_run = false;
 
@@ -71,7 +72,7 @@ peak_thread_work ()
 		SourceFactory::peak_building_lock.lock ();
 
 	wait:
-		if (SourceFactory::files_with_peaks.empty () && SourceFactory::peak_thread_run) {
+		if (SourceFactory::files_with_peaks.empty () && SourceFactory::files_with_peak_data.empty () && SourceFactory::peak_thread_run) {
 			SourceFactory::PeaksToBuild.wait (SourceFactory::peak_building_lock);
 			(void) Temporal::TempoMap::fetch();
 		}
@@ -81,12 +82,16 @@ peak_thread_work ()
 			return;
 		}
 
-		if (SourceFactory::files_with_peaks.empty ()) {
+		if (SourceFactory::files_with_peaks.empty () && SourceFactory::files_with_peak_data.empty ()) {
 			goto wait;
 		}
 
-		boost::shared_ptr<AudioSource> as (SourceFactory::files_with_peaks.front ().lock ());
-		SourceFactory::files_with_peaks.pop_front ();
+		/* peakfiles first, derived data is built from them */
+		bool const peak_data = SourceFactory::files_with_peaks.empty ();
+		std::list<boost::weak_ptr<AudioSource>>& queue (peak_data ? SourceFactory::files_with_peak_data : SourceFactory::files_with_peaks);
+
+		boost::shared_ptr<AudioSource> as (queue.front ().lock ());
+		queue.pop_front ();
 		if (as) {
 			++active_threads;
 		}
@@ -96,7 +101,11 @@ peak_thread_work ()
 			continue;
 		}
 
-		as->setup_peakfile ();
+		if (peak_data) {
+			as->build_peak_data ();
+		} else {
+			as->setup_peakfile ();
+		}
 		SourceFactory::peak_building_lock.lock ();
 		--active_threads;
 		SourceFactory::peak_building_lock.unlock ();
@@ -108,7 +117,7 @@ SourceFactory::peak_work_queue_length ()
 {
 	// ideally we'd loop over the queue and check for duplicates
 	// and existing valid peak-files..
-	return SourceFactory::files_with_peaks.size () + active_threads;
+	return SourceFactory::files_with_peaks.size () + SourceFactory::files_with_peak_data.size () + active_threads;
 }
 
 void
@@ -159,6 +168,17 @@ SourceFactory::setup_peakfile (boost::shared_ptr<Source> s, bool async)
 	return 0;
 }
 
+/** Schedule building data that is derived from the peakfile
+ * (see AudioSource::build_peak_data) on the peak-building threads.
+ */
+void
+SourceFactory::queue_peak_data (boost::shared_ptr<AudioSource> as)
+{
+	Glib::Threads::Mutex::Lock lm (peak_building_lock);
+	files_with_peak_data.push_back (boost::weak_ptr<AudioSource> (as));
+	PeaksToBuild.broadcast ();
+}
+
 boost::shared_ptr<Source>
 SourceFactory::createSilent (Session& s, const XMLNode& node, samplecnt_t nframes, float sr)
 {
@@ -18,7 +18,10 @@
  */
 
 #include <xmmintrin.h>
-#include "ardour/types.h"
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include "ardour/mix.h"
 
 void
 x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *min, float *max)
@@ -114,5 +117,175 @@ x86_sse_find_peaks(const ARDOUR::Sample* buf, ARDOUR::pframes_t nframes, float *
 	_mm_store_ss(max, work);
 }
 
+/* per-sample gain, used for region fades and envelopes */
+
+void
+x86_sse_apply_gain_vector (float* dst, float const* gain, uint32_t nframes)
+{
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		_mm_storeu_ps (dst + i, _mm_mul_ps (_mm_loadu_ps (dst + i), _mm_loadu_ps (gain + i)));
+	}
+	for (; i < nframes; ++i) {
+		dst[i] *= gain[i];
+	}
+}
+
+void
+x86_sse_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes)
+{
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		__m128 const s = _mm_mul_ps (_mm_loadu_ps (src + i), _mm_loadu_ps (gain + i));
+		_mm_storeu_ps (dst + i, _mm_add_ps (_mm_loadu_ps (dst + i), s));
+	}
+	for (; i < nframes; ++i) {
+		dst[i] += src[i] * gain[i];
+	}
+}
+
+void
+x86_sse_crossfade_buffers (float* dst, float const* src, float const* gain, uint32_t nframes)
+{
+	__m128 const one = _mm_set1_ps (1.f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		__m128 const g = _mm_loadu_ps (gain + i);
+		__m128 const d = _mm_mul_ps (_mm_loadu_ps (dst + i), _mm_sub_ps (one, g));
+		_mm_storeu_ps (dst + i, _mm_add_ps (d, _mm_mul_ps (_mm_loadu_ps (src + i), g)));
+	}
+	for (; i < nframes; ++i) {
+		dst[i] = dst[i] * (1.f - gain[i]) + src[i] * gain[i];
+	}
+}
+
+#ifdef __SSE2__
+
+/* 2^x, polynomial approximation (Cephes exp2f), relative error < 2e-7 */
+static inline __m128
+sse_exp2_ps (__m128 x)
+{
+	x = _mm_min_ps (_mm_max_ps (x, _mm_set1_ps (-126.f)), _mm_set1_ps (126.f));
+
+	/* split into integer and fractional part, f in [-.5, .5] */
+	__m128i const n = _mm_cvtps_epi32 (x);
+	__m128 const  f = _mm_sub_ps (x, _mm_cvtepi32_ps (n));
+
+	__m128 p = _mm_set1_ps (1.535336188319500e-4f);
+	p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (1.339887440266574e-3f));
+	p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (9.618437357674640e-3f));
+	p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (5.550332471162809e-2f));
+	p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (2.402264791363012e-1f));
+	p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (6.931472028550421e-1f));
+	p = _mm_add_ps (_mm_mul_ps (p, f), _mm_set1_ps (1.f));
+
+	/* 2^n */
+	__m128i const e = _mm_slli_epi32 (_mm_add_epi32 (n, _mm_set1_epi32 (127)), 23);
+	return _mm_mul_ps (p, _mm_castsi128_ps (e));
+}
+
+void
+x86_sse_linear_ramp (float* dst, uint32_t nframes, float y0, float dy)
+{
+	__m128 const vy0  = _mm_set1_ps (y0);
+	__m128 const vdy  = _mm_set1_ps (dy);
+	__m128 const four = _mm_set1_ps (4.f);
+	__m128       idx  = _mm_set_ps (3.f, 2.f, 1.f, 0.f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		_mm_storeu_ps (dst + i, _mm_add_ps (vy0, _mm_mul_ps (idx, vdy)));
+		idx = _mm_add_ps (idx, four);
+	}
+	for (; i < nframes; ++i) {
+		dst[i] = y0 + i * dy;
+	}
+}
+
+void
+x86_sse_exp2_ramp (float* dst, uint32_t nframes, float y0, float de)
+{
+	__m128 const vy0  = _mm_set1_ps (y0);
+	__m128 const vde  = _mm_set1_ps (de);
+	__m128 const four = _mm_set1_ps (4.f);
+	__m128       idx  = _mm_set_ps (3.f, 2.f, 1.f, 0.f);
+
+	while (nframes >= 4) {
+		_mm_storeu_ps (dst, _mm_mul_ps (vy0, sse_exp2_ps (_mm_mul_ps (idx, vde))));
+		idx = _mm_add_ps (idx, four);
+		dst += 4;
+		nframes -= 4;
+	}
+	if (nframes > 0) {
+		float tmp[4];
+		_mm_storeu_ps (tmp, _mm_mul_ps (vy0, sse_exp2_ps (_mm_mul_ps (idx, vde))));
+		for (uint32_t i = 0; i < nframes; ++i) {
+			dst[i] = tmp[i];
+		}
+	}
+}
+
+static inline __m128
+sse_gain_ps (__m128 p, __m128 scale)
+{
+	__m128 const zero = _mm_setzero_ps ();
+	__m128 const mask = _mm_cmpgt_ps (p, zero);
+
+	/* position_to_gain (): 2^(33 * p^(1/8) - 32) */
+	__m128 q = _mm_sqrt_ps (_mm_sqrt_ps (_mm_sqrt_ps (_mm_max_ps (p, zero))));
+	__m128 g = sse_exp2_ps (_mm_sub_ps (_mm_mul_ps (q, _mm_set1_ps (33.f)), _mm_set1_ps (32.f)));
+	return _mm_and_ps (mask, _mm_mul_ps (g, scale));
+}
+
+void
+x86_sse_gain_ramp (float* dst, uint32_t nframes, float p0, float dp, float scale)
+{
+	__m128 const vp0  = _mm_set1_ps (p0);
+	__m128 const vdp  = _mm_set1_ps (dp);
+	__m128 const vsc  = _mm_set1_ps (scale);
+	__m128 const four = _mm_set1_ps (4.f);
+	__m128       idx  = _mm_set_ps (3.f, 2.f, 1.f, 0.f);
 
+	while (nframes >= 4) {
+		_mm_storeu_ps (dst, sse_gain_ps (_mm_add_ps (vp0, _mm_mul_ps (idx, vdp)), vsc));
+		idx = _mm_add_ps (idx, four);
+		dst += 4;
+		nframes -= 4;
+	}
+	if (nframes > 0) {
+		float tmp[4];
+		_mm_storeu_ps (tmp, sse_gain_ps (_mm_add_ps (vp0, _mm_mul_ps (idx, vdp)), vsc));
+		for (uint32_t i = 0; i < nframes; ++i) {
+			dst[i] = tmp[i];
+		}
+	}
+}
+
+void
+x86_sse_cubic_ramp (float* dst, uint32_t nframes, float a0, float a1, float a2, float a3, float dt)
+{
+	__m128 const va0  = _mm_set1_ps (a0);
+	__m128 const va1  = _mm_set1_ps (a1);
+	__m128 const va2  = _mm_set1_ps (a2);
+	__m128 const va3  = _mm_set1_ps (a3);
+	__m128 const vdt  = _mm_set1_ps (dt);
+	__m128 const four = _mm_set1_ps (4.f);
+	__m128       idx  = _mm_set_ps (3.f, 2.f, 1.f, 0.f);
+
+	uint32_t i = 0;
+	for (; i + 4 <= nframes; i += 4) {
+		__m128 const t = _mm_mul_ps (idx, vdt);
+		__m128       p = _mm_add_ps (_mm_mul_ps (va3, t), va2);
+		p = _mm_add_ps (_mm_mul_ps (p, t), va1);
+		p = _mm_add_ps (_mm_mul_ps (p, t), va0);
+		_mm_storeu_ps (dst + i, p);
+		idx = _mm_add_ps (idx, four);
+	}
+	for (; i < nframes; ++i) {
+		const float t = i * dt;
+		dst[i] = a0 + t * (a1 + t * (a2 + t * a3));
+	}
+}
 
+#endif /* __SSE2__ */
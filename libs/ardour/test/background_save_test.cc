@@ -0,0 +1,155 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <set>
+
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/xml++.h"
+
+#include "ardour/audioregion.h"
+#include "ardour/filename_extensions.h"
+#include "ardour/playlist.h"
+#include "ardour/route.h"
+#include "ardour/session.h"
+
+#include "background_save_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (BackgroundSaveTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+void
+BackgroundSaveTest::save_finished (std::string, bool ok)
+{
+	g_atomic_int_inc (&_n_finished);
+	if (!pthread_equal (pthread_self (), _test_thread)) {
+		g_atomic_int_inc (&_n_other_thread);
+	}
+	if (!ok) {
+		g_atomic_int_inc (&_n_failed);
+	}
+}
+
+/** Add, rename and remove routes while the session is saved in the
+ *  background. Each saved file must be complete, and hold the routes
+ *  as they were when the save was started.
+ */
+void
+BackgroundSaveTest::editWhileSavingTest ()
+{
+	g_atomic_int_set (&_n_finished, 0);
+	g_atomic_int_set (&_n_failed, 0);
+	g_atomic_int_set (&_n_other_thread, 0);
+	_test_thread = pthread_self ();
+
+	_session->BackgroundSaveFinished.connect_same_thread (_connection, boost::bind (&BackgroundSaveTest::save_finished, this, _1, _2));
+
+	std::string const path = Glib::build_filename (_session->path (), _session->name () + statefile_suffix);
+	int const n_saves = 25;
+
+	for (int n = 0; n < n_saves; ++n) {
+
+		_session->new_audio_route (2, 2, 0, 1, "Bus", PresentationInfo::AudioBus, PresentationInfo::max_order);
+
+		boost::shared_ptr<RouteList const> saved = _session->get_routes ();
+
+		std::set<std::string> expected;
+		for (RouteList::const_iterator i = saved->begin (); i != saved->end (); ++i) {
+			if (!(*i)->is_auditioner ()) {
+				expected.insert ((*i)->name ());
+			}
+		}
+
+		CPPUNIT_ASSERT_EQUAL (0, _session->save_state_in_background ());
+
+		/* edit while the state is written */
+		for (RouteList::const_iterator i = saved->begin (); i != saved->end (); ++i) {
+			if (!(*i)->is_auditioner () && !(*i)->is_master () && !(*i)->is_monitor ()) {
+				(*i)->set_name (string_compose ("%1 %2", (*i)->name (), n));
+			}
+		}
+		RouteList added = _session->new_audio_route (1, 2, 0, 4, "Extra", PresentationInfo::AudioBus, PresentationInfo::max_order);
+		for (RouteList::iterator i = added.begin (); i != added.end (); ++i) {
+			_session->remove_route (*i);
+		}
+
+		_session->wait_for_background_save ();
+
+		CPPUNIT_ASSERT_EQUAL (n + 1, (int) g_atomic_int_get (&_n_finished));
+		CPPUNIT_ASSERT_EQUAL (0, (int) g_atomic_int_get (&_n_failed));
+		/* the result is handed back to the thread that waited */
+		CPPUNIT_ASSERT_EQUAL (0, (int) g_atomic_int_get (&_n_other_thread));
+		CPPUNIT_ASSERT (_session->finish_background_save ());
+
+		XMLTree tree;
+		CPPUNIT_ASSERT (tree.read (path));
+		CPPUNIT_ASSERT_EQUAL (std::string ("Session"), tree.root ()->name ());
+
+		XMLNode* routes = tree.root ()->child ("Routes");
+		CPPUNIT_ASSERT (routes);
+
+		/* the file holds the routes from when the save was started,
+		 * with their names at that time.
+		 */
+		std::set<std::string> names;
+		for (XMLNodeConstIterator i = routes->children ().begin (); i != routes->children ().end (); ++i) {
+			names.insert ((*i)->property ("name")->value ());
+		}
+		CPPUNIT_ASSERT (names == expected);
+	}
+}
+
+/** Edit a playlist, its regions and a region which is not in a playlist
+ *  while the session is saved in the background. The file must be the
+ *  same as the one written by save_state() just before.
+ */
+void
+BackgroundSaveTest::regionStateTest ()
+{
+	for (int i = 0; i < 4; ++i) {
+		_playlist->add_region (_r[i], timepos_t (i * 200));
+	}
+
+	/* non-default fades and envelope */
+	_ar[1]->set_fade_in_length (50);
+	_ar[2]->set_fade_out_length (20);
+	_ar[3]->envelope ()->add (timepos_t (50), 0.5);
+
+	std::string const path = Glib::build_filename (_session->path (), _session->name () + statefile_suffix);
+
+	CPPUNIT_ASSERT_EQUAL (0, _session->save_state (""));
+	std::string const expected = Glib::file_get_contents (path);
+
+	CPPUNIT_ASSERT_EQUAL (0, _session->save_state_in_background ());
+
+	/* edit while the state is written */
+	_r[0]->set_name ("renamed");
+	_r[1]->set_position (timepos_t (1000));
+	_ar[1]->set_fade_in_length (10);
+	_ar[3]->envelope ()->clear ();
+	_playlist->remove_region (_r[2]);
+	_playlist->set_name ("renamed");
+	_ar[4]->set_scale_amplitude (0.25);
+
+	_session->wait_for_background_save ();
+
+	CPPUNIT_ASSERT (Glib::file_get_contents (path) == expected);
+}
@@ -0,0 +1,43 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include <pthread.h>
+
+#include "pbd/signals.h"
+
+#include "audio_region_test.h"
+
+/** Tests for Session::save_state_in_background() */
+class BackgroundSaveTest : public AudioRegionTest
+{
+	CPPUNIT_TEST_SUITE (BackgroundSaveTest);
+	CPPUNIT_TEST (editWhileSavingTest);
+	CPPUNIT_TEST (regionStateTest);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void editWhileSavingTest ();
+	void regionStateTest ();
+
+private:
+	void save_finished (std::string, bool);
+
+	PBD::ScopedConnection _connection;
+	GATOMIC_QUAL gint     _n_finished;
+	GATOMIC_QUAL gint     _n_failed;
+	GATOMIC_QUAL gint     _n_other_thread;
+	pthread_t             _test_thread;
+};
@@ -68,6 +68,19 @@ FPUTest::run (size_t align_max, float const max_diff)
 			default_mix_buffers_with_gain (&_comp1[off], &_comp2[off], cnt, 0.45);
 			compare (string_compose ("Mix Buffers w/gain not aligned off: %1 cnt: %2", off, cnt), cnt, max_diff);
 
+			/* per-sample gain (fades, envelope) */
+			apply_gain_vector (&_test1[off], &_test2[off], cnt);
+			default_apply_gain_vector (&_comp1[off], &_comp2[off], cnt);
+			compare_ramp (string_compose ("Apply Gain Vector not aligned off: %1 cnt: %2", off, cnt), off, cnt, 0);
+
+			mix_buffers_with_gain_vector (&_test1[off], &_test2[off], &_test2[align_max - off], cnt);
+			default_mix_buffers_with_gain_vector (&_comp1[off], &_comp2[off], &_comp2[align_max - off], cnt);
+			compare_ramp (string_compose ("Mix Buffers w/gain vector not aligned off: %1 cnt: %2", off, cnt), off, cnt, max_diff);
+
+			crossfade_buffers (&_test1[off], &_test2[off], &_test2[align_max - off], cnt);
+			default_crossfade_buffers (&_comp1[off], &_comp2[off], &_comp2[align_max - off], cnt);
+			compare_ramp (string_compose ("Crossfade not aligned off: %1 cnt: %2", off, cnt), off, cnt, max_diff);
+
 			/* copy vector */
 			copy_vector (&_test1[off], &_test2[off], cnt);
 			default_copy_vector (&_comp1[off], &_comp2[off], cnt);
@@ -83,6 +96,27 @@ FPUTest::run (size_t align_max, float const max_diff)
 			CPPUNIT_ASSERT_MESSAGE (string_compose ("Find peaks not aligned off: %1 cnt: %2", off, cnt), fabsf (pk_test - pk_comp) < 2e-6 && fabsf (pk_test_max - pk_comp_max) < 2e-6);
 		}
 	}
+
+	/* automation ramps */
+	for (size_t off = 0; off < 4; ++off) {
+		for (size_t cnt = 1; cnt < _size - off; cnt += 61) {
+			linear_ramp (&_test1[off], cnt, 0.5, -1.f / cnt);
+			default_linear_ramp (&_comp1[off], cnt, 0.5, -1.f / cnt);
+			compare_ramp (string_compose ("Linear ramp off: %1 cnt: %2", off, cnt), off, cnt, 1e-6);
+
+			exp2_ramp (&_test1[off], cnt, 20.f, 10.f / cnt);
+			default_exp2_ramp (&_comp1[off], cnt, 20.f, 10.f / cnt);
+			compare_ramp (string_compose ("Exp2 ramp off: %1 cnt: %2", off, cnt), off, cnt, 2e-6);
+
+			gain_ramp (&_test1[off], cnt, 0.1, 0.9f / cnt, 1.f);
+			default_gain_ramp (&_comp1[off], cnt, 0.1, 0.9f / cnt, 1.f);
+			compare_ramp (string_compose ("Gain ramp off: %1 cnt: %2", off, cnt), off, cnt, 1e-5);
+
+			cubic_ramp (&_test1[off], cnt, 0.2f, 1.5f, -0.9f, 0.2f, 1.f / cnt);
+			default_cubic_ramp (&_comp1[off], cnt, 0.2f, 1.5f, -0.9f, 0.2f, 1.f / cnt);
+			compare_ramp (string_compose ("Cubic ramp off: %1 cnt: %2", off, cnt), off, cnt, 1e-6);
+		}
+	}
 }
 
 void
@@ -97,8 +131,37 @@ FPUTest::compare (std::string msg, size_t cnt, float max_diff)
 	CPPUNIT_ASSERT_MESSAGE (msg, err == 0);
 }
 
+/* compare [off, off + cnt), relative to the magnitude of values > 1 */
+void
+FPUTest::compare_ramp (std::string msg, size_t off, size_t cnt, float max_diff)
+{
+	size_t err = 0;
+	for (size_t i = off; i < off + cnt; ++i) {
+		if (fabsf (_test1[i] - _comp1[i]) > max_diff * std::max (1.f, fabsf (_comp1[i]))) {
+			++err;
+		}
+	}
+	CPPUNIT_ASSERT_MESSAGE (msg, err == 0);
+}
+
 #if defined(ARCH_X86) && defined(BUILD_SSE_OPTIMIZATIONS)
 
+static void
+set_x86_ramps (ARDOUR::linear_ramp_t& linear_ramp, ARDOUR::exp2_ramp_t& exp2_ramp, ARDOUR::gain_ramp_t& gain_ramp, ARDOUR::cubic_ramp_t& cubic_ramp)
+{
+#ifdef __SSE2__
+	linear_ramp = x86_sse_linear_ramp;
+	exp2_ramp   = x86_sse_exp2_ramp;
+	gain_ramp   = x86_sse_gain_ramp;
+	cubic_ramp  = x86_sse_cubic_ramp;
+#else
+	linear_ramp = default_linear_ramp;
+	exp2_ramp   = default_exp2_ramp;
+	gain_ramp   = default_gain_ramp;
+	cubic_ramp  = default_cubic_ramp;
+#endif
+}
+
 void
 FPUTest::avxFmaTest ()
 {
@@ -123,6 +186,12 @@ FPUTest::avxFmaTest ()
 	mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 	copy_vector           = x86_sse_avx_copy_vector;
 
+	apply_gain_vector            = x86_sse_avx_apply_gain_vector;
+	mix_buffers_with_gain_vector = x86_fma_mix_buffers_with_gain_vector;
+	crossfade_buffers            = x86_fma_crossfade_buffers;
+
+	set_x86_ramps (linear_ramp, exp2_ramp, gain_ramp, cubic_ramp);
+
 	run (align_max, FLT_EPSILON);
 }
 
@@ -150,6 +219,12 @@ FPUTest::avxTest ()
 	mix_buffers_no_gain   = x86_sse_avx_mix_buffers_no_gain;
 	copy_vector           = x86_sse_avx_copy_vector;
 
+	apply_gain_vector            = x86_sse_avx_apply_gain_vector;
+	mix_buffers_with_gain_vector = x86_sse_avx_mix_buffers_with_gain_vector;
+	crossfade_buffers            = x86_sse_avx_crossfade_buffers;
+
+	set_x86_ramps (linear_ramp, exp2_ramp, gain_ramp, cubic_ramp);
+
 	run (align_max);
 }
 
@@ -177,6 +252,12 @@ FPUTest::sseTest ()
 	mix_buffers_no_gain   = x86_sse_mix_buffers_no_gain;
 	copy_vector           = default_copy_vector;
 
+	apply_gain_vector            = x86_sse_apply_gain_vector;
+	mix_buffers_with_gain_vector = x86_sse_mix_buffers_with_gain_vector;
+	crossfade_buffers            = x86_sse_crossfade_buffers;
+
+	set_x86_ramps (linear_ramp, exp2_ramp, gain_ramp, cubic_ramp);
+
 	run (align_max);
 }
 
@@ -200,6 +281,18 @@ FPUTest::neonTest ()
 	mix_buffers_with_gain = arm_neon_mix_buffers_with_gain;
 	mix_buffers_no_gain   = arm_neon_mix_buffers_no_gain;
 	copy_vector           = arm_neon_copy_vector;
+	linear_ramp           = arm_neon_linear_ramp;
+	exp2_ramp             = arm_neon_exp2_ramp;
+#ifdef __aarch64__
+	gain_ramp             = arm_neon_gain_ramp;
+#else
+	gain_ramp             = default_gain_ramp;
+#endif
+	cubic_ramp            = arm_neon_cubic_ramp;
+
+	apply_gain_vector            = arm_neon_apply_gain_vector;
+	mix_buffers_with_gain_vector = arm_neon_mix_buffers_with_gain_vector;
+	crossfade_buffers            = arm_neon_crossfade_buffers;
 
 	run (128);
 }
@@ -224,6 +317,14 @@ FPUTest::veclibTest ()
 	mix_buffers_with_gain = veclib_mix_buffers_with_gain;
 	mix_buffers_no_gain   = veclib_mix_buffers_no_gain;
 	copy_vector           = default_copy_vector;
+	linear_ramp           = default_linear_ramp;
+	exp2_ramp             = default_exp2_ramp;
+	gain_ramp             = default_gain_ramp;
+	cubic_ramp            = default_cubic_ramp;
+
+	apply_gain_vector            = default_apply_gain_vector;
+	mix_buffers_with_gain_vector = default_mix_buffers_with_gain_vector;
+	crossfade_buffers            = default_crossfade_buffers;
 
 #ifdef  __aarch64__
 	run (16, FLT_EPSILON);
@@ -38,6 +38,7 @@ public:
 private:
 	void run (size_t, float const max_diff = 0);
 	void compare (std::string, size_t, float const max_diff = 0);
+	void compare_ramp (std::string, size_t off, size_t cnt, float const max_diff);
 
 	ARDOUR::compute_peak_t          compute_peak;
 	ARDOUR::find_peaks_t            find_peaks;
@@ -45,6 +46,14 @@ private:
 	ARDOUR::mix_buffers_with_gain_t mix_buffers_with_gain;
 	ARDOUR::mix_buffers_no_gain_t   mix_buffers_no_gain;
 	ARDOUR::copy_vector_t           copy_vector;
+	ARDOUR::linear_ramp_t           linear_ramp;
+	ARDOUR::exp2_ramp_t             exp2_ramp;
+	ARDOUR::gain_ramp_t             gain_ramp;
+	ARDOUR::cubic_ramp_t            cubic_ramp;
+
+	ARDOUR::apply_gain_vector_t            apply_gain_vector;
+	ARDOUR::mix_buffers_with_gain_vector_t mix_buffers_with_gain_vector;
+	ARDOUR::crossfade_buffers_t            crossfade_buffers;
 
 	size_t _size;
 
@@ -0,0 +1,120 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/playlist.h"
+#include "ardour/region.h"
+#include "ardour/region_factory.h"
+#include "playlist_region_index_test.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (PlaylistRegionIndexTest);
+
+using namespace std;
+using namespace ARDOUR;
+using namespace Temporal;
+
+/** Check regions_at(), count_regions_at() and regions_touched() at every
+ *  position in [0, end) against a scan of the region list.
+ */
+void
+PlaylistRegionIndexTest::check_queries (samplepos_t end)
+{
+	RegionList const all (_playlist->region_list_property ().rlist ());
+
+	for (samplepos_t s = 0; s < end; ++s) {
+		timepos_t const pos (s);
+
+		RegionList at;
+		for (RegionList::const_iterator i = all.begin (); i != all.end (); ++i) {
+			if ((*i)->covers (pos)) {
+				at.push_back (*i);
+			}
+		}
+
+		CPPUNIT_ASSERT (*_playlist->regions_at (pos) == at);
+		CPPUNIT_ASSERT_EQUAL ((uint32_t) at.size (), _playlist->count_regions_at (pos));
+
+		for (samplecnt_t len = 0; len < 150; len += 37) {
+			timepos_t const range_end (s + len);
+
+			RegionList touched;
+			for (RegionList::const_iterator i = all.begin (); i != all.end (); ++i) {
+				if ((*i)->coverage (pos, range_end) != OverlapNone) {
+					touched.push_back (*i);
+				}
+			}
+
+			CPPUNIT_ASSERT (*_playlist->regions_touched (pos, range_end) == touched);
+		}
+	}
+}
+
+void
+PlaylistRegionIndexTest::overlapTest ()
+{
+	/* 16 regions of length 100, each overlapping the next two */
+	for (int i = 0; i < 16; ++i) {
+		_playlist->add_region (_r[i], timepos_t (i * 40));
+	}
+
+	/* a stack of identical regions, and zero-length regions inside and
+	 * at the edges of others
+	 */
+	PropertyList plist;
+	plist.add (Properties::start, timepos_t (0));
+	plist.add (Properties::length, 100);
+	for (int i = 0; i < 3; ++i) {
+		_playlist->add_region (RegionFactory::create (_source, plist), timepos_t (200));
+	}
+
+	PropertyList zero;
+	zero.add (Properties::start, timepos_t (0));
+	zero.add (Properties::length, timecnt_t (0));
+	samplepos_t const zero_length_at[] = { 0, 40, 139, 250, 700 };
+	for (size_t i = 0; i < sizeof (zero_length_at) / sizeof (zero_length_at[0]); ++i) {
+		boost::shared_ptr<Region> r (RegionFactory::create (_source, zero));
+		CPPUNIT_ASSERT (r->length ().is_zero ());
+		_playlist->add_region (r, timepos_t (zero_length_at[i]));
+	}
+
+	check_queries (800);
+}
+
+void
+PlaylistRegionIndexTest::editTest ()
+{
+	for (int i = 0; i < 16; ++i) {
+		_playlist->add_region (_r[i], timepos_t (i * 100));
+	}
+
+	check_queries (1700);
+
+	/* moves, including some that leave the region list out of position
+	 * order, and trims at both ends
+	 */
+	_r[3]->set_position (timepos_t (1550));
+	_r[12]->set_position (timepos_t (10));
+	_r[7]->set_position (timepos_t (_r[7]->position ().samples () + 1));
+	_r[5]->trim_front (timepos_t (_r[5]->position ().samples () + 30));
+	_r[9]->trim_end (timepos_t (_r[9]->position ().samples () + 19));
+	_r[14]->set_length (timecnt_t (250));
+
+	check_queries (1700);
+
+	/* and a region removed after it has been found */
+	_playlist->remove_region (_r[12]);
+
+	check_queries (1700);
+}
@@ -0,0 +1,121 @@
+#include <cmath>
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/microseconds.h"
+
+#include "ardour/ardour.h"
+#include "ardour/amplitude_stats.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+static void
+scan (std::vector<Sample> const& audio, samplepos_t start, samplecnt_t cnt, Sample& peak, double& sum_of_squares)
+{
+	for (samplepos_t i = start; i < start + cnt; ++i) {
+		peak            = std::max (peak, fabsf (audio[i]));
+		sum_of_squares += audio[i] * audio[i];
+	}
+}
+
+/** Compute peak and RMS of many regions of a source, once by scanning the
+ * audio, and once from the amplitude statistics plus the edges, in the same
+ * way as AudioSource::amplitude_stats().
+ */
+int
+main (int argc, char* argv[])
+{
+	double   minutes   = argc > 1 ? atof (argv[1]) : 10.0;
+	uint32_t n_regions = argc > 2 ? atoi (argv[2]) : 500;
+
+	ARDOUR::init (true, localedir);
+
+	std::string dir  = Glib::build_filename (g_get_tmp_dir (), "amplitude_stats_bench");
+	std::string path = Glib::build_filename (dir, "source.peak.ams");
+	g_mkdir_with_parents (dir.c_str (), 0755);
+
+	samplecnt_t const length = minutes * 60 * 48000;
+	std::vector<Sample> audio (length);
+
+	srand (0);
+	for (samplecnt_t i = 0; i < length; ++i) {
+		audio[i] = sinf (i * 0.01f) * (0.25f + 0.5f * ((i / 48000) % 7) / 7.f);
+	}
+
+	AmplitudeStats stats;
+	stats.set_path (path);
+
+	microseconds_t t0 = get_microseconds ();
+	stats.open_for_write ();
+	for (samplecnt_t pos = 0; pos < length; pos += 8192) {
+		stats.add (&audio[pos], std::min ((samplecnt_t) 8192, length - pos), pos);
+	}
+	stats.close ();
+
+	if (!stats.valid (length)) {
+		cerr << "Cannot write amplitude statistics\n";
+		return 1;
+	}
+
+	cout << string_compose ("%1 minutes, %2 regions, build: %3 ms\n", minutes, n_regions, (get_microseconds () - t0) / 1000.0);
+
+	std::vector<samplepos_t> starts;
+	std::vector<samplecnt_t> lengths;
+	for (uint32_t r = 0; r < n_regions; ++r) {
+		samplecnt_t len = 1 + rand () % (length / 4);
+		starts.push_back (rand () % (length - len));
+		lengths.push_back (len);
+	}
+
+	std::vector<Sample> peak_scan (n_regions);
+	std::vector<double> sum_scan (n_regions);
+
+	t0 = get_microseconds ();
+	for (uint32_t r = 0; r < n_regions; ++r) {
+		peak_scan[r] = 0;
+		sum_scan[r]  = 0;
+		scan (audio, starts[r], lengths[r], peak_scan[r], sum_scan[r]);
+	}
+	cout << string_compose ("scan : %1 ms\n", (get_microseconds () - t0) / 1000.0);
+
+	samplecnt_t const bs = AmplitudeStats::block_size;
+	uint32_t n_mismatch = 0;
+
+	t0 = get_microseconds ();
+	for (uint32_t r = 0; r < n_regions; ++r) {
+		Sample      peak = 0;
+		double      sum  = 0;
+		samplepos_t end  = starts[r] + lengths[r];
+		samplecnt_t b0   = (starts[r] + bs - 1) / bs;
+		samplecnt_t b1   = end / bs;
+
+		if (b1 <= b0) {
+			scan (audio, starts[r], lengths[r], peak, sum);
+		} else {
+			scan (audio, starts[r], b0 * bs - starts[r], peak, sum);
+			stats.read (b0, b1 - b0, peak, sum);
+			scan (audio, b1 * bs, end - b1 * bs, peak, sum);
+		}
+
+		if (peak != peak_scan[r] || fabs (sum - sum_scan[r]) > 1e-6 * sum_scan[r]) {
+			++n_mismatch;
+		}
+	}
+	cout << string_compose ("stats: %1 ms, %2 mismatches\n", (get_microseconds () - t0) / 1000.0, n_mismatch);
+
+	::g_unlink (path.c_str ());
+	::g_rmdir (dir.c_str ());
+
+	ARDOUR::cleanup ();
+	return n_mismatch ? 1 : 0;
+}
@@ -0,0 +1,118 @@
+#include <algorithm>
+#include <inttypes.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+#include "pbd/microseconds.h"
+#include "pbd/pbd.h"
+#include "temporal/tempo.h"
+#include "evoral/ControlList.h"
+
+using namespace Evoral;
+using namespace Temporal;
+
+/* value of the point at \p i, points are 64 samples apart */
+static double
+point_value (int64_t i)
+{
+	return (i * 7) % 1024;
+}
+
+static boost::shared_ptr<ControlList>
+make_list (int64_t n_points)
+{
+	Evoral::ParameterDescriptor desc;
+	desc.upper = 1024;
+
+	boost::shared_ptr<ControlList> cl (new ControlList (Evoral::Parameter (0), desc, Temporal::AudioTime));
+
+	for (int64_t i = 0; i < n_points; ++i) {
+		cl->fast_simple_add (timepos_t (i * 64), point_value (i));
+	}
+	return cl;
+}
+
+/* the previous implementation, walking the list */
+static double
+list_lookup (boost::shared_ptr<ControlList> cl, timepos_t const& x)
+{
+	ControlEvent const cp (x, 0);
+	ControlList::const_iterator i = std::lower_bound (cl->events ().begin (), cl->events ().end (), &cp, ControlList::time_comparator);
+	return i == cl->events ().end () ? cl->events ().back ()->value : (*i)->value;
+}
+
+/** Time loading, editing and evaluating automation lists of 1k points
+ *  up to the given number of points (default: 1M).
+ */
+int
+main (int argc, char* argv[])
+{
+	int64_t max_points = argc > 1 ? atoll (argv[1]) : 1000000;
+
+	if (!PBD::init ()) {
+		return 1;
+	}
+	Temporal::init ();
+
+	printf ("%10s %12s %12s %12s %12s %12s %12s %12s\n", "points", "load [ms]", "add [us]", "eval [us]", "list [us]", "erase [ms]", "thin [ms]", "paste [ms]");
+
+	for (int64_t n_points = 1000; n_points <= max_points; n_points *= 10) {
+
+		PBD::microseconds_t t0 = PBD::get_microseconds ();
+		boost::shared_ptr<ControlList> cl = make_list (n_points);
+		double const t_load = (PBD::get_microseconds () - t0) / 1000.0;
+
+		int const n_eval = 10000;
+		int64_t const range = n_points * 64;
+		double sum = 0;
+
+		/* add single points between existing ones */
+		int const n_add = 100;
+		srand (0);
+		t0 = PBD::get_microseconds ();
+		for (int i = 0; i < n_add; ++i) {
+			cl->add (timepos_t ((rand () % n_points) * 64 + 32), 512, false, false);
+			sum += cl->eval (timepos_t (rand () % range));
+		}
+		double const t_add = (PBD::get_microseconds () - t0) / (double) n_add;
+
+		srand (0);
+		t0 = PBD::get_microseconds ();
+		for (int i = 0; i < n_eval; ++i) {
+			sum += cl->eval (timepos_t (rand () % range));
+		}
+		double const t_eval = (PBD::get_microseconds () - t0) / (double) n_eval;
+
+		/* the list walk is O(N) per lookup, limit the total work */
+		int const n_list = std::max<int64_t> (10, std::min<int64_t> (n_eval, 100000000 / n_points));
+		srand (0);
+		t0 = PBD::get_microseconds ();
+		for (int i = 0; i < n_list; ++i) {
+			sum += list_lookup (cl, timepos_t (rand () % range));
+		}
+		double const t_list = (PBD::get_microseconds () - t0) / (double) n_list;
+
+		boost::shared_ptr<ControlList> cp = cl->copy (timepos_t (0), timepos_t (range / 4));
+
+		t0 = PBD::get_microseconds ();
+		cl->erase_range (timepos_t (range / 4), timepos_t (range / 2));
+		double const t_erase = (PBD::get_microseconds () - t0) / 1000.0;
+
+		t0 = PBD::get_microseconds ();
+		cl->thin (20);
+		double const t_thin = (PBD::get_microseconds () - t0) / 1000.0;
+
+		t0 = PBD::get_microseconds ();
+		cl->paste (*cp, timepos_t (range / 4));
+		double const t_paste = (PBD::get_microseconds () - t0) / 1000.0;
+
+		if (sum <= 0 || cl->size () == 0) {
+			fprintf (stderr, "unexpected result\n");
+			return 1;
+		}
+
+		printf ("%10" PRId64 " %12.2f %12.2f %12.3f %12.3f %12.2f %12.2f %12.2f\n", n_points, t_load, t_add, t_eval, t_list, t_erase, t_thin, t_paste);
+	}
+
+	return 0;
+}
@@ -0,0 +1,125 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "test_ui.h"
+#include "test_util.h"
+#include "ardour/ardour.h"
+#include "ardour/audio_track.h"
+#include "ardour/midi_model.h"
+#include "ardour/midi_region.h"
+#include "ardour/midi_track.h"
+#include "ardour/playlist.h"
+#include "ardour/region_factory.h"
+#include "ardour/session.h"
+#include "pbd/controllable.h"
+#include "pbd/microseconds.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+static void
+report (char const* what, microseconds_t t0, uint32_t n_queries, size_t n_found)
+{
+	cout << "  " << what << ": " << (get_microseconds () - t0) / (double) n_queries << " us (" << n_found << " found)\n";
+}
+
+/** Time ID-keyed lookups of routes, controllables, regions and notes */
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_objects = argc > 1 ? atoi (argv[1]) : 200;
+	uint32_t n_queries = argc > 2 ? atoi (argv[2]) : 10000;
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI();
+	create_and_start_dummy_backend ();
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	{
+
+	/* Routes and their controls */
+	session->new_audio_track (1, 2, 0, n_objects, "Audio", PresentationInfo::max_order, Normal, false);
+
+	boost::shared_ptr<RouteList> routes = session->get_routes ();
+	vector<PBD::ID> route_ids;
+	vector<PBD::ID> control_ids;
+	for (RouteList::const_iterator i = routes->begin(); i != routes->end(); ++i) {
+		route_ids.push_back ((*i)->id ());
+		control_ids.push_back ((*i)->gain_control ()->id ());
+	}
+
+	/* Regions sharing the source of the MIDI region */
+	boost::shared_ptr<MidiTrack> track;
+	for (RouteList::const_iterator i = routes->begin(); i != routes->end() && !track; ++i) {
+		track = boost::dynamic_pointer_cast<MidiTrack> (*i);
+	}
+	assert (track);
+	boost::shared_ptr<Playlist> playlist = track->playlist ();
+	boost::shared_ptr<MidiRegion> region = boost::dynamic_pointer_cast<MidiRegion> (playlist->region_list_property().rlist().front());
+	assert (region);
+
+	playlist->duplicate (region, timepos_t (region->last_sample () + 1), n_objects);
+
+	/* Notes */
+	boost::shared_ptr<MidiModel> model = region->model ();
+	MidiModel::NoteDiffCommand* cmd = model->new_note_diff_command ("add notes");
+	for (uint32_t i = 0; i < n_objects * 10; ++i) {
+		Temporal::Beats const t = Temporal::Beats::ticks (i * 120);
+		cmd->add (MidiModel::NotePtr (new Evoral::Note<Temporal::Beats> (0, t, Temporal::Beats::ticks (60), 60 + (i % 12), 100)));
+	}
+	model->apply_diff_command_as_commit (*session, cmd);
+
+	vector<Evoral::event_id_t> note_ids;
+	for (MidiModel::Notes::const_iterator i = model->notes ().begin (); i != model->notes ().end (); ++i) {
+		note_ids.push_back ((*i)->id ());
+	}
+
+	cout << route_ids.size () << " routes, " << RegionFactory::nregions () << " regions, " << note_ids.size () << " notes\n";
+
+	size_t n_found = 0;
+	microseconds_t t0 = get_microseconds ();
+	for (uint32_t i = 0; i < n_queries; ++i) {
+		if (session->route_by_id (route_ids[i % route_ids.size ()])) {
+			++n_found;
+		}
+	}
+	report ("Session::route_by_id            ", t0, n_queries, n_found);
+
+	n_found = 0;
+	t0 = get_microseconds ();
+	for (uint32_t i = 0; i < n_queries; ++i) {
+		if (Controllable::by_id (control_ids[i % control_ids.size ()])) {
+			++n_found;
+		}
+	}
+	report ("Controllable::by_id             ", t0, n_queries, n_found);
+
+	n_found = 0;
+	t0 = get_microseconds ();
+	for (uint32_t i = 0; i < n_queries; ++i) {
+		std::set<boost::shared_ptr<Region> > r;
+		RegionFactory::get_regions_using_source (region->source (), r);
+		n_found += r.size ();
+	}
+	report ("RegionFactory::get_regions_using", t0, n_queries, n_found);
+
+	n_found = 0;
+	t0 = get_microseconds ();
+	for (uint32_t i = 0; i < n_queries; ++i) {
+		if (model->find_note (note_ids[i % note_ids.size ()])) {
+			++n_found;
+		}
+	}
+	report ("MidiModel::find_note            ", t0, n_queries, n_found);
+
+	}
+
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -1,24 +1,48 @@
 #include "test_ui.h"
 #include "test_util.h"
 #include "pbd/failed_constructor.h"
+#include "pbd/timing.h"
 #include "ardour/ardour.h"
 #include "ardour/audioengine.h"
 #include "ardour/session.h"
+#include <algorithm>
 #include <iostream>
 #include <cstdlib>
 
+#ifndef PLATFORM_WINDOWS
+#include <sys/resource.h>
+#endif
+
 using namespace std;
 using namespace ARDOUR;
 
 static const char* localedir = LOCALEDIR;
 
+/** @return peak resident set size in kB, or 0 if unknown */
+static long
+peak_rss ()
+{
+#ifndef PLATFORM_WINDOWS
+	struct rusage ru;
+	if (getrusage (RUSAGE_SELF, &ru) == 0) {
+		return ru.ru_maxrss;
+	}
+#endif
+	return 0;
+}
+
+/** Load a session, and optionally save it a number of times, reporting the
+ *  time per save and how much saving grew the peak RSS.
+ */
 int main (int argc, char* argv[])
 {
-	if (argc != 3) {
-		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name>\n";
+	if (argc != 3 && argc != 4) {
+		cerr << "Syntax: " << argv[0] << " <dir> <snapshot-name> [<number-of-saves>]\n";
 		exit (EXIT_FAILURE);
 	}
 
+	int const n_saves = argc > 3 ? atoi (argv[3]) : 0;
+
 	ARDOUR::init (true, localedir);
 	TestUI* test_ui = new TestUI();
 	create_and_start_dummy_backend ();
@@ -41,6 +65,30 @@ int main (int argc, char* argv[])
 		exit (EXIT_FAILURE);
 	}
 
+	if (n_saves > 0) {
+		long const rss_loaded = peak_rss ();
+
+		PBD::microseconds_t total = 0;
+		PBD::microseconds_t worst = 0;
+		for (int i = 0; i < n_saves; ++i) {
+			PBD::Timing save_timing;
+			if (s->save_state ("")) {
+				cerr << "Could not save session\n";
+				exit (EXIT_FAILURE);
+			}
+			save_timing.update ();
+			total += save_timing.elapsed ();
+			worst  = std::max (worst, save_timing.elapsed ());
+		}
+
+		long const rss_saved = peak_rss ();
+
+		cout << "save: " << total / (1000.0 * n_saves) << " ms avg, "
+		     << worst / 1000.0 << " ms max\n"
+		     << "peak RSS: " << rss_loaded << " kB after load, "
+		     << rss_saved << " kB after saving (+" << rss_saved - rss_loaded << " kB)\n";
+	}
+
 	AudioEngine::instance()->remove_session ();
 	delete s;
 	AudioEngine::instance()->stop ();
@@ -1,3 +1,6 @@
+#include <cstdlib>
+#include <iostream>
+
 #include "test_ui.h"
 #include "test_util.h"
 #include "ardour/ardour.h"
@@ -5,6 +8,7 @@
 #include "ardour/midi_region.h"
 #include "ardour/session.h"
 #include "ardour/playlist.h"
+#include "pbd/microseconds.h"
 #include "pbd/stateful_diff_command.h"
 
 using namespace std;
@@ -13,9 +17,52 @@ using namespace PBD;
 
 static const char* localedir = LOCALEDIR;
 
+/** Time region lookups, which use the playlist's interval index */
+static void
+time_queries (boost::shared_ptr<Playlist> playlist, uint32_t n_queries)
+{
+	pair<timepos_t, timepos_t> extent = playlist->get_extent ();
+	samplepos_t const start = extent.first.samples ();
+	samplepos_t const len   = extent.second.samples () - start;
+	samplecnt_t const block = 8192; /* similar to a butler refill */
+
+	size_t n_found = 0;
+
+	microseconds_t t0 = get_microseconds ();
+	for (uint32_t i = 0; i < n_queries; ++i) {
+		samplepos_t const s = start + (samplepos_t) ((double) len * i / n_queries);
+		n_found += playlist->regions_touched (timepos_t (s), timepos_t (s + block))->size ();
+	}
+	double const t_touched = (get_microseconds () - t0) / (double) n_queries;
+
+	t0 = get_microseconds ();
+	for (uint32_t i = 0; i < n_queries; ++i) {
+		timepos_t pos (start + (samplepos_t) ((double) len * i / n_queries));
+		n_found += playlist->regions_at (pos)->size ();
+	}
+	double const t_at = (get_microseconds () - t0) / (double) n_queries;
+
+	t0 = get_microseconds ();
+	for (uint32_t i = 0; i < n_queries; ++i) {
+		timepos_t pos (start + (samplepos_t) ((double) len * i / n_queries));
+		if (playlist->top_region_at (pos)) {
+			++n_found;
+		}
+	}
+	double const t_top = (get_microseconds () - t0) / (double) n_queries;
+
+	cout << playlist->n_regions () << " regions, " << n_found << " found\n"
+	     << "  regions_touched: " << t_touched << " us\n"
+	     << "  regions_at:      " << t_at << " us\n"
+	     << "  top_region_at:   " << t_top << " us\n";
+}
+
 int
 main (int argc, char* argv[])
 {
+	uint32_t n_copies  = argc > 1 ? atoi (argv[1]) : 1000;
+	uint32_t n_queries = argc > 2 ? atoi (argv[2]) : 10000;
+
 	ARDOUR::init (true, localedir);
 	TestUI* test_ui = new TestUI();
 	create_and_start_dummy_backend ();
@@ -41,7 +88,7 @@ main (int argc, char* argv[])
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
 	timepos_t pos (region->last_sample() + 1);
-	playlist->duplicate (region, pos, 1000);
+	playlist->duplicate (region, pos, n_copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
 
@@ -52,10 +99,12 @@ main (int argc, char* argv[])
 	session->begin_reversible_command ("foo");
 	playlist->clear_changes ();
 	timepos_t pos2 (region->last_sample() + 1);
-	playlist->duplicate (region, pos2, 1000);
+	playlist->duplicate (region, pos2, n_copies);
 	session->add_command (new StatefulDiffCommand (playlist));
 	session->commit_reversible_command ();
 
+	time_queries (playlist, n_queries);
+
 	}
 
 	delete session;
@@ -0,0 +1,75 @@
+#include <cstdlib>
+#include <iostream>
+
+#include "test_ui.h"
+#include "test_util.h"
+#include "ardour/ardour.h"
+#include "ardour/midi_playlist.h"
+#include "ardour/midi_region.h"
+#include "ardour/midi_track.h"
+#include "ardour/session.h"
+#include "pbd/microseconds.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+/** Time MidiPlaylist::render() of a playlist with many regions, from scratch
+ *  and after moving a single region.
+ */
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_regions = argc > 1 ? atoi (argv[1]) : 200;
+	uint32_t n_passes  = argc > 2 ? atoi (argv[2]) : 20;
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI();
+	create_and_start_dummy_backend ();
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	{
+
+	boost::shared_ptr<RouteList> routes = session->get_routes ();
+	boost::shared_ptr<MidiTrack> track;
+	for (RouteList::const_iterator i = routes->begin(); i != routes->end() && !track; ++i) {
+		track = boost::dynamic_pointer_cast<MidiTrack> (*i);
+	}
+	assert (track);
+
+	boost::shared_ptr<MidiPlaylist> playlist = boost::dynamic_pointer_cast<MidiPlaylist> (track->playlist ());
+	boost::shared_ptr<Region> region = playlist->region_list_property().rlist().front();
+	assert (playlist && region);
+
+	playlist->duplicate (region, timepos_t (region->last_sample () + 1), n_regions);
+
+	MidiChannelFilter* filter = &track->playback_filter ();
+
+	microseconds_t t0 = get_microseconds ();
+	playlist->render (filter);
+	cout << playlist->region_list_property().rlist().size() << " regions, " << playlist->rendered ()->size () << " events\n";
+	cout << "  first render: " << (get_microseconds () - t0) << " us\n";
+
+	t0 = get_microseconds ();
+	for (uint32_t n = 0; n < n_passes; ++n) {
+		playlist->render (filter);
+	}
+	cout << "  unchanged   : " << (get_microseconds () - t0) / (double) n_passes << " us\n";
+
+	t0 = get_microseconds ();
+	for (uint32_t n = 0; n < n_passes; ++n) {
+		region->set_position (timepos_t (region->position ().samples () + (n % 2 ? -1 : 1)));
+		playlist->render (filter);
+	}
+	cout << "  one moved   : " << (get_microseconds () - t0) / (double) n_passes << " us\n";
+
+	}
+
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,102 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "ardour/ardour.h"
+#include "ardour/event_type_map.h"
+#include "evoral/Sequence.h"
+#include "evoral/midi_events.h"
+#include "pbd/microseconds.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+typedef Temporal::Beats Time;
+
+static const char* localedir = LOCALEDIR;
+
+class NoteSequence : public Evoral::Sequence<Time>
+{
+public:
+	NoteSequence () : Evoral::Sequence<Time> (EventTypeMap::instance ()) {}
+	NoteSequence (NoteSequence const& other) : Evoral::ControlSet (other), Evoral::Sequence<Time> (other) {}
+
+	boost::shared_ptr<Evoral::Control> control_factory (Evoral::Parameter const& param) {
+		Evoral::ParameterDescriptor desc;
+		desc.upper = 127;
+		boost::shared_ptr<Evoral::ControlList> list (new Evoral::ControlList (param, desc, Temporal::BeatTime));
+		return boost::shared_ptr<Evoral::Control> (new Evoral::Control (param, desc, list));
+	}
+};
+
+/** Time appending, iterating, copying, ID lookups and removal of notes in
+ *  Evoral::Sequence, from 1k notes up to the given number (default: 100k).
+ */
+int
+main (int argc, char* argv[])
+{
+	int64_t max_notes = argc > 1 ? atoll (argv[1]) : 100000;
+
+	ARDOUR::init (true, localedir);
+
+	for (int64_t n_notes = 1000; n_notes <= max_notes; n_notes *= 10) {
+		NoteSequence s;
+
+		/* a dense four-voice part */
+		microseconds_t t0 = get_microseconds ();
+		s.start_write ();
+		for (int64_t i = 0; i < n_notes; ++i) {
+			Time const t = Time::ticks ((i / 4) * 240);
+			uint8_t const pitch = 48 + (i % 4) * 7;
+			uint8_t on[3]  = { MIDI_CMD_NOTE_ON, pitch, 100 };
+			uint8_t off[3] = { MIDI_CMD_NOTE_OFF, pitch, 0 };
+			s.append (Evoral::Event<Time> (Evoral::MIDI_EVENT, t, 3, on), Evoral::next_event_id ());
+			s.append (Evoral::Event<Time> (Evoral::MIDI_EVENT, t + Time::ticks (200), 3, off), Evoral::next_event_id ());
+		}
+		s.end_write (Evoral::Sequence<Time>::Relax);
+		cout << s.notes ().size () << " notes\n";
+		cout << "  append : " << (get_microseconds () - t0) / 1000.0 << " ms\n";
+
+		t0 = get_microseconds ();
+		size_t n_events = 0;
+		for (NoteSequence::const_iterator i = s.begin (); i != s.end (); ++i) {
+			++n_events;
+		}
+		cout << "  iterate: " << (get_microseconds () - t0) / 1000.0 << " ms (" << n_events << " events)\n";
+
+		t0 = get_microseconds ();
+		NoteSequence copy (s);
+		cout << "  copy   : " << (get_microseconds () - t0) / 1000.0 << " ms\n";
+
+		vector<Evoral::event_id_t> ids;
+		for (NoteSequence::Notes::const_iterator i = s.notes ().begin (); i != s.notes ().end (); ++i) {
+			ids.push_back ((*i)->id ());
+		}
+
+		int const n_lookups = 10000;
+		size_t n_found = 0;
+		srand (0);
+		t0 = get_microseconds ();
+		for (int i = 0; i < n_lookups; ++i) {
+			if (s.note_by_id (ids[rand () % ids.size ()])) {
+				++n_found;
+			}
+		}
+		cout << "  by id  : " << (get_microseconds () - t0) / (double) n_lookups << " us (" << n_found << " found)\n";
+
+		/* remove every tenth note */
+		vector<NoteSequence::NotePtr> removed;
+		for (size_t i = 0; i < ids.size (); i += 10) {
+			removed.push_back (s.note_by_id (ids[i]));
+		}
+		t0 = get_microseconds ();
+		for (vector<NoteSequence::NotePtr>::const_iterator i = removed.begin (); i != removed.end (); ++i) {
+			s.remove_note_unlocked (*i);
+		}
+		cout << "  remove : " << (get_microseconds () - t0) / 1000.0 << " ms (" << removed.size () << " notes)\n";
+	}
+
+	ARDOUR::cleanup ();
+	return 0;
+}
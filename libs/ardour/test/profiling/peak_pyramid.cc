@@ -0,0 +1,137 @@
+#include <cstdlib>
+#include <fcntl.h>
+#include <unistd.h>
+#include <iostream>
+#include <vector>
+
+#include <glib.h>
+#include <glibmm/fileutils.h>
+#include <glibmm/miscutils.h>
+
+#include "pbd/compose.h"
+#include "pbd/gstdio_compat.h"
+#include "pbd/microseconds.h"
+#include "pbd/scoped_file_descriptor.h"
+
+#include "ardour/ardour.h"
+#include "ardour/peak_pyramid.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char*       localedir = LOCALEDIR;
+static const samplecnt_t fpp       = 256; // same as AudioSource
+
+/** Reduce stored peaks to `n_visual` peaks, similar to
+ * AudioSource::read_peaks_with_fpp()
+ */
+static void
+reduce (std::vector<PeakData> const& stored, samplecnt_t n_stored, std::vector<PeakData>& visual)
+{
+	size_t const n_visual = visual.size ();
+	for (size_t v = 0; v < n_visual; ++v) {
+		samplecnt_t s0 = v * n_stored / n_visual;
+		samplecnt_t s1 = std::max (s0 + 1, (samplecnt_t) ((v + 1) * n_stored / n_visual));
+
+		visual[v].min = 1.f;
+		visual[v].max = -1.f;
+		for (samplecnt_t s = s0; s < s1 && s < n_stored; ++s) {
+			visual[v].min = std::min (visual[v].min, stored[s].min);
+			visual[v].max = std::max (visual[v].max, stored[s].max);
+		}
+	}
+}
+
+int
+main (int argc, char* argv[])
+{
+	double   hours    = argc > 1 ? atof (argv[1]) : 3.0;
+	uint32_t width    = argc > 2 ? atoi (argv[2]) : 2000;
+	uint32_t n_redraw = argc > 3 ? atoi (argv[3]) : 100;
+
+	ARDOUR::init (true, localedir);
+
+	std::string dir      = Glib::build_filename (g_get_tmp_dir (), "peak_pyramid_bench");
+	std::string peakpath = Glib::build_filename (dir, "source.peak");
+	g_mkdir_with_parents (dir.c_str (), 0755);
+
+	samplecnt_t const n_peaks = hours * 3600 * 48000 / fpp;
+	samplecnt_t const length  = n_peaks * fpp;
+
+	/* write a synthetic peakfile */
+	{
+		ScopedFileDescriptor sfd (g_open (peakpath.c_str (), O_CREAT | O_TRUNC | O_RDWR, 0664));
+		std::vector<PeakData> buf (65536);
+		for (samplecnt_t p = 0; p < n_peaks; p += buf.size ()) {
+			samplecnt_t n = std::min ((samplecnt_t) buf.size (), n_peaks - p);
+			for (samplecnt_t i = 0; i < n; ++i) {
+				buf[i].max = ((p + i) % 4099) / 4099.f;
+				buf[i].min = -buf[i].max;
+			}
+			if (::write (sfd, &buf[0], n * sizeof (PeakData)) != (ssize_t) (n * sizeof (PeakData))) {
+				cerr << "Cannot write peakfile " << peakpath << "\n";
+				return 1;
+			}
+		}
+	}
+
+	cout << string_compose ("%1 hours, %2 peaks (%3 MB), %4 pixels\n", hours, n_peaks, n_peaks * sizeof (PeakData) / 1048576.0, width);
+
+	/* migrate, build pyramid from peakfile */
+	PeakPyramid pyramid (fpp);
+	pyramid.set_path (peakpath + ".mip");
+
+	microseconds_t t0 = get_microseconds ();
+	if (pyramid.build_from (peakpath) || !pyramid.valid (n_peaks)) {
+		cerr << "Cannot build peak pyramid\n";
+		return 1;
+	}
+	cout << string_compose ("build pyramid: %1 ms\n", (get_microseconds () - t0) / 1000.0);
+
+	double const          spp = length / (double) width;
+	std::vector<PeakData> visual (width);
+
+	/* redraw, fully zoomed out, using the peakfile */
+	{
+		std::vector<PeakData> stored (n_peaks);
+		t0 = get_microseconds ();
+		for (uint32_t i = 0; i < n_redraw; ++i) {
+			ScopedFileDescriptor sfd (g_open (peakpath.c_str (), O_RDONLY, 0444));
+			if (::read (sfd, &stored[0], n_peaks * sizeof (PeakData)) < 0) {
+				return 1;
+			}
+			reduce (stored, n_peaks, visual);
+		}
+		cout << string_compose ("peakfile: %1 ms per redraw, %2 kB read\n",
+		                        (get_microseconds () - t0) / (1000.0 * n_redraw), n_peaks * sizeof (PeakData) / 1024);
+	}
+
+	/* redraw, fully zoomed out, using the pyramid */
+	{
+		uint32_t    level = pyramid.level_for (spp, length);
+		samplecnt_t n     = level > 0 ? (length + pyramid.samples_per_peak (level) - 1) / pyramid.samples_per_peak (level) : 0;
+
+		if (level == 0) {
+			cerr << "No usable pyramid level\n";
+			return 1;
+		}
+
+		std::vector<PeakData> stored (n);
+		t0 = get_microseconds ();
+		for (uint32_t i = 0; i < n_redraw; ++i) {
+			pyramid.level_for (spp, length);
+			pyramid.read (level, &stored[0], 0, n);
+			reduce (stored, n, visual);
+		}
+		cout << string_compose ("pyramid level %1: %2 ms per redraw, %3 kB read\n",
+		                        level, (get_microseconds () - t0) / (1000.0 * n_redraw), n * sizeof (PeakData) / 1024);
+	}
+
+	::g_unlink ((peakpath + ".mip").c_str ());
+	::g_unlink (peakpath.c_str ());
+	::g_rmdir (dir.c_str ());
+
+	ARDOUR::cleanup ();
+	return 0;
+}
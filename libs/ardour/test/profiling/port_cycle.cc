@@ -0,0 +1,99 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include <glibmm/timer.h>
+
+#include "pbd/compose.h"
+#include "pbd/timing.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/port.h"
+#include "ardour/session.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+/** Let the engine run for \p seconds, and report the time spent in the process callback */
+static void
+measure (std::string const& name, double seconds)
+{
+	AudioEngine*  engine = AudioEngine::instance ();
+	TimingStats&  stats  = engine->dsp_stats[AudioEngine::ProcessCallback];
+
+	stats.queue_reset ();
+	Glib::usleep (seconds * 1e6);
+
+	microseconds_t min, max;
+	double         avg, dev;
+
+	if (!stats.get_stats (min, max, avg, dev)) {
+		cerr << name << ": no process callbacks\n";
+		return;
+	}
+
+	cout << string_compose ("%1: avg %2 us, min %3 us, max %4 us, dev %5 us per callback, DSP load %6%%\n",
+	                        name, avg, min, max, dev, 100.f * engine->get_dsp_load ());
+}
+
+/** Measure the overhead of the process callback with the Dummy backend at
+ *  16 sample periods, without and with many (unconnected) ports, which the
+ *  PortManager has to visit in every cycle.
+ */
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_ports = argc > 1 ? atoi (argv[1]) : 2000;
+	double   seconds = argc > 2 ? atof (argv[2]) : 5;
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI ();
+
+	AudioEngine* engine = AudioEngine::create ();
+
+	if (!engine->set_backend ("None (Dummy)", "Unit-Test", "") || engine->set_buffer_size (16) || engine->start ()) {
+		cerr << "Cannot start the Dummy backend\n";
+		return 1;
+	}
+
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	cout << string_compose ("%1 sample periods at %2 Hz\n", engine->samples_per_cycle (), engine->sample_rate ());
+
+	measure ("session ports", seconds);
+
+	std::vector<boost::shared_ptr<Port> > ports;
+
+	for (uint32_t i = 0; i < n_ports; ++i) {
+		DataType    t    = (i % 4) < 3 ? DataType::AUDIO : DataType::MIDI;
+		std::string name = string_compose ("bench %1", i);
+		if (i % 2) {
+			ports.push_back (engine->register_output_port (t, name));
+		} else {
+			ports.push_back (engine->register_input_port (t, name));
+		}
+	}
+
+	measure (string_compose ("%1 extra ports", n_ports), seconds);
+
+	{
+		Glib::Threads::Mutex::Lock lm (engine->process_lock ());
+		for (std::vector<boost::shared_ptr<Port> >::iterator p = ports.begin (); p != ports.end (); ++p) {
+			engine->unregister_port (*p);
+		}
+		ports.clear ();
+	}
+
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,161 @@
+#include <cstdlib>
+#include <iostream>
+#include <stdint.h>
+
+#include "pbd/compose.h"
+#include "pbd/enumwriter.h"
+#include "pbd/microseconds.h"
+
+#include "ardour/ardour.h"
+#include "ardour/audioengine.h"
+#include "ardour/graph.h"
+#include "ardour/graph_edges.h"
+#include "ardour/graphnode.h"
+#include "ardour/rc_configuration.h"
+#include "ardour/session.h"
+
+#include "test_ui.h"
+#include "test_util.h"
+
+using namespace std;
+using namespace ARDOUR;
+using namespace PBD;
+
+static const char* localedir = LOCALEDIR;
+
+/** A synthetic graph node that spends a fixed amount of work per cycle */
+class BenchNode : public GraphNode
+{
+public:
+	BenchNode (boost::shared_ptr<Graph> g, std::string const& name, uint32_t work)
+		: GraphNode (g)
+		, _name (name)
+		, _work (work)
+	{
+		for (uint32_t i = 0; i < sizeof (_buf) / sizeof (float); ++i) {
+			_buf[i] = i / 1024.f;
+		}
+	}
+
+	std::string graph_node_name () const { return _name; }
+
+	bool direct_feeds_according_to_reality (boost::shared_ptr<GraphNode>, bool* via_send_only = 0)
+	{
+		return false;
+	}
+
+protected:
+	void process ()
+	{
+		/* something resembling a small filter chain */
+		for (uint32_t w = 0; w < _work; ++w) {
+			for (uint32_t i = 1; i < sizeof (_buf) / sizeof (float); ++i) {
+				_buf[i] = _buf[i] * .99f + _buf[i - 1] * .01f;
+			}
+		}
+	}
+
+private:
+	std::string _name;
+	uint32_t    _work;
+	float       _buf[256];
+};
+
+/** Build a session-like topology: `n_tracks` tracks, each feeding one of
+ * `n_busses` busses, all busses feeding a master-bus.
+ */
+static boost::shared_ptr<GraphChain>
+build_chain (boost::shared_ptr<Graph> graph, GraphNodeList& nodes, uint32_t n_tracks, uint32_t n_busses, uint32_t work)
+{
+	GraphEdges edges;
+
+	boost::shared_ptr<GraphNode> master (new BenchNode (graph, "master", work));
+	nodes.push_back (master);
+
+	std::vector<boost::shared_ptr<GraphNode> > busses;
+	for (uint32_t b = 0; b < n_busses; ++b) {
+		boost::shared_ptr<GraphNode> bus (new BenchNode (graph, string_compose ("bus %1", b), work));
+		edges.add (bus, master, false);
+		busses.push_back (bus);
+		nodes.push_back (bus);
+	}
+
+	for (uint32_t t = 0; t < n_tracks; ++t) {
+		/* heavier plugin chains on some tracks */
+		boost::shared_ptr<GraphNode> track (new BenchNode (graph, string_compose ("track %1", t), (t % 7) == 0 ? 4 * work : work));
+		if (n_busses > 0) {
+			edges.add (track, busses[t % n_busses], false);
+		} else {
+			edges.add (track, master, false);
+		}
+		nodes.push_back (track);
+	}
+
+	return boost::shared_ptr<GraphChain> (new GraphChain (nodes, edges));
+}
+
+static void
+run_bench (Session* session, boost::shared_ptr<GraphChain> chain, GraphScheduling gs, uint32_t n_cycles, std::string const& name)
+{
+	Config->set_graph_scheduling (gs);
+
+	boost::shared_ptr<Graph> graph  = session->process_graph ();
+	pframes_t                nframes = session->engine ().samples_per_cycle ();
+	bool                     need_butler;
+
+	/* warm up */
+	for (uint32_t i = 0; i < 64; ++i) {
+		graph->process_routes (chain, nframes, 0, nframes, need_butler);
+	}
+
+	microseconds_t min = INT64_MAX;
+	microseconds_t max = 0;
+	microseconds_t sum = 0;
+
+	for (uint32_t i = 0; i < n_cycles; ++i) {
+		microseconds_t t0 = get_microseconds ();
+		graph->process_routes (chain, nframes, i * nframes, (i + 1) * nframes, need_butler);
+		microseconds_t dt = get_microseconds () - t0;
+		min               = std::min (min, dt);
+		max               = std::max (max, dt);
+		sum += dt;
+	}
+
+	cout << string_compose ("%1 %2: avg %3 us, min %4 us, max %5 us per cycle\n",
+	                        name, enum_2_string (gs), sum / (double)n_cycles, min, max);
+}
+
+int
+main (int argc, char* argv[])
+{
+	uint32_t n_tracks = argc > 1 ? atoi (argv[1]) : 300;
+	uint32_t n_busses = argc > 2 ? atoi (argv[2]) : 16;
+	uint32_t n_cycles = argc > 3 ? atoi (argv[3]) : 8192;
+	uint32_t work     = argc > 4 ? atoi (argv[4]) : 4;
+
+	ARDOUR::init (true, localedir);
+	TestUI* test_ui = new TestUI ();
+	create_and_start_dummy_backend ();
+
+	Session* session = load_session ("../libs/ardour/test/profiling/sessions/1region", "1region");
+
+	cout << "INFO: " << session->process_graph ()->n_threads () << " process threads.\n";
+
+	{
+		GraphNodeList nodes;
+		boost::shared_ptr<GraphChain> chain (build_chain (session->process_graph (), nodes, n_tracks, n_busses, work));
+
+		/* prevent the engine from processing the session concurrently */
+		Glib::Threads::Mutex::Lock lm (AudioEngine::instance ()->process_lock ());
+
+		std::string name = string_compose ("%1 tracks, %2 busses", n_tracks, n_busses);
+		run_bench (session, chain, SharedTriggerQueue, n_cycles, name);
+		run_bench (session, chain, WorkStealing, n_cycles, name);
+	}
+
+	delete session;
+	stop_and_destroy_backend ();
+	delete test_ui;
+	ARDOUR::cleanup ();
+	return 0;
+}
@@ -0,0 +1,69 @@
+#include <cstdlib>
+#include <iostream>
+#include <vector>
+
+#include "pbd/microseconds.h"
+#include "pbd/pbd.h"
+#include "temporal/tempo.h"
+
+using namespace std;
+using namespace Temporal;
+using namespace PBD;
+
+/** Time single and batch tempo map lookups in a map with a tempo change at
+ *  every bar (default: 2000 bars) and a meter change every 8 bars.
+ */
+int
+main (int argc, char* argv[])
+{
+	int    n_bars = argc > 1 ? atoi (argv[1]) : 2000;
+	size_t n_pos  = argc > 2 ? atoi (argv[2]) : 100000;
+
+	if (!PBD::init ()) {
+		return 1;
+	}
+	Temporal::init ();
+
+	TempoMap::WritableSharedPtr tmap (TempoMap::write_copy ());
+
+	microseconds_t t0 = get_microseconds ();
+	for (int bar = 2; bar <= n_bars; ++bar) {
+		tmap->set_tempo (Tempo (90 + (bar % 64), 4), BBT_Time (bar, 1, 0));
+		if ((bar % 8) == 0) {
+			tmap->set_meter (Meter ((bar % 16) ? 3 : 4, 4), BBT_Time (bar, 1, 0));
+		}
+	}
+	cout << "TempoMap with " << tmap->n_tempos () << " tempos, " << tmap->n_meters () << " meters\n";
+	cout << "  build         : " << (get_microseconds () - t0) / 1000.0 << " ms\n";
+
+	superclock_t const end = tmap->superclock_at (BBT_Time (n_bars, 1, 0));
+
+	vector<timepos_t> audio;
+	audio.reserve (n_pos);
+	for (size_t i = 0; i < n_pos; ++i) {
+		audio.push_back (timepos_t::from_superclock (end / n_pos * i));
+	}
+
+	/* individual lookups, in random order */
+	srand (42);
+	vector<Beats> single (n_pos);
+	t0 = get_microseconds ();
+	for (size_t i = 0; i < n_pos; ++i) {
+		single[i] = tmap->quarters_at_superclock (audio[rand () % n_pos].superclocks ());
+	}
+	cout << "  lookup        : " << (get_microseconds () - t0) / (double) n_pos << " us\n";
+
+	/* batch conversion of sorted positions */
+	vector<timepos_t> b (audio);
+	t0 = get_microseconds ();
+	tmap->convert (&b[0], b.size (), BeatTime);
+	cout << "  batch to beats: " << (get_microseconds () - t0) / (double) n_pos << " us\n";
+
+	/* and back */
+	t0 = get_microseconds ();
+	tmap->convert (&b[0], b.size (), AudioTime);
+	cout << "  batch to audio: " << (get_microseconds () - t0) / (double) n_pos << " us\n";
+
+	tmap->abort_update ();
+	return 0;
+}
@@ -523,6 +523,12 @@ Track::do_refill ()
 	return _disk_reader->do_refill ();
 }
 
+void
+Track::queue_prefetch (FileReadAhead& reader)
+{
+	_disk_reader->queue_prefetch (reader);
+}
+
 int
 Track::do_flush (RunContext c, bool force)
 {
@@ -0,0 +1,79 @@
+/*
+ * This program is free software; you can redistribute it and/or modify
+ * it under the terms of the GNU General Public License as published by
+ * the Free Software Foundation; either version 2 of the License, or
+ * (at your option) any later version.
+ *
+ * This program is distributed in the hope that it will be useful,
+ * but WITHOUT ANY WARRANTY; without even the implied warranty of
+ * MERCHANTABILITY or FITNESS FOR A PARTICULAR PURPOSE.  See the
+ * GNU General Public License for more details.
+ *
+ * You should have received a copy of the GNU General Public License along
+ * with this program; if not, write to the Free Software Foundation, Inc.,
+ * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
+ */
+
+#include "ardour/mix.h"
+
+#include <immintrin.h>
+#include <xmmintrin.h>
+
+#ifndef __AVX__
+#error "__AVX__ must be enabled for this module to work"
+#endif
+
+/* AVX routines that apply a per-sample gain, used for region fades and
+ * envelopes. Buffers are not necessarily aligned: gain and mixdown
+ * buffers are offset by the fade position.
+ */
+
+void
+x86_sse_avx_apply_gain_vector (float* dst, float const* gain, uint32_t nframes)
+{
+	uint32_t i = 0;
+	for (; i + 8 <= nframes; i += 8) {
+		_mm256_storeu_ps (dst + i, _mm256_mul_ps (_mm256_loadu_ps (dst + i), _mm256_loadu_ps (gain + i)));
+	}
+
+	_mm256_zeroupper ();
+
+	for (; i < nframes; ++i) {
+		dst[i] *= gain[i];
+	}
+}
+
+void
+x86_sse_avx_mix_buffers_with_gain_vector (float* dst, float const* src, float const* gain, uint32_t nframes)
+{
+	uint32_t i = 0;
+	for (; i + 8 <= nframes; i += 8) {
+		__m256 const s = _mm256_mul_ps (_mm256_loadu_ps (src + i), _mm256_loadu_ps (gain + i));
+		_mm256_storeu_ps (dst + i, _mm256_add_ps (_mm256_loadu_ps (dst + i), s));
+	}
+
+	_mm256_zeroupper ();
+
+	for (; i < nframes; ++i) {
+		dst[i] += src[i] * gain[i];
+	}
+}
+
+void
+x86_sse_avx_crossfade_buffers (float* dst, float const* src, float const* gain, uint32_t nframes)
+{
+	__m256 const one = _mm256_set1_ps (1.f);
+
+	uint32_t i = 0;
+	for (; i + 8 <= nframes; i += 8) {
+		__m256 const g = _mm256_loadu_ps (gain + i);
+		__m256 const d = _mm256_mul_ps (_mm256_loadu_ps (dst + i), _mm256_sub_ps (one, g));
+		_mm256_storeu_ps (dst + i, _mm256_add_ps (d, _mm256_mul_ps (_mm256_loadu_ps (src + i), g)));
+	}
+
+	_mm256_zeroupper ();
+
+	for (; i < nframes; ++i) {
+		dst[i] = dst[i] * (1.f - gain[i]) + src[i] * gain[i];
+	}
+}
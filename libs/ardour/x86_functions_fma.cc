@@ -138,4 +138,59 @@ x86_fma_mix_buffers_with_gain(
 	} while (0);
 }
 
+/**
+ * @brief x86-64 AVX/FMA optimized routine for mixing a buffer with
+ * per-sample gain: dst[i] += src[i] * gain[i]
+ */
+void
+x86_fma_mix_buffers_with_gain_vector(
+    float       *dst,
+    const float *src,
+    const float *gain,
+    uint32_t     nframes)
+{
+	uint32_t i = 0;
+	for (; i + 8 <= nframes; i += 8) {
+		__m256 s0 = _mm256_loadu_ps(src + i);
+		__m256 g0 = _mm256_loadu_ps(gain + i);
+		__m256 d0 = _mm256_loadu_ps(dst + i);
+		_mm256_storeu_ps(dst + i, _mm256_fmadd_ps(s0, g0, d0));
+	}
+
+	_mm256_zeroupper();
+
+	for (; i < nframes; ++i) {
+		dst[i] += src[i] * gain[i];
+	}
+}
+
+/**
+ * @brief x86-64 AVX/FMA optimized crossfade:
+ * dst[i] = dst[i] * (1 - gain[i]) + src[i] * gain[i]
+ */
+void
+x86_fma_crossfade_buffers(
+    float       *dst,
+    const float *src,
+    const float *gain,
+    uint32_t     nframes)
+{
+	const __m256 one = _mm256_set1_ps(1.0f);
+
+	uint32_t i = 0;
+	for (; i + 8 <= nframes; i += 8) {
+		__m256 s0 = _mm256_loadu_ps(src + i);
+		__m256 g0 = _mm256_loadu_ps(gain + i);
+		__m256 d0 = _mm256_loadu_ps(dst + i);
+		d0 = _mm256_mul_ps(d0, _mm256_sub_ps(one, g0));
+		_mm256_storeu_ps(dst + i, _mm256_fmadd_ps(s0, g0, d0));
+	}
+
+	_mm256_zeroupper();
+
+	for (; i < nframes; ++i) {
+		dst[i] = dst[i] * (1.f - gain[i]) + src[i] * gain[i];
+	}
+}
+
 #endif // FPU_AVX_FMA_SUPPORT
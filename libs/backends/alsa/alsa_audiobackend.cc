@@ -38,6 +38,7 @@
 #include "ardour/debug.h"
 #include "ardour/filesystem_paths.h"
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 #include "ardouralsautil/devicelist.h"
 #include "pbd/i18n.h"
 
@@ -2333,22 +2334,19 @@ void*
 AlsaAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		std::set<BackendPortPtr>::const_iterator it = connections.begin ();
-		if (it == connections.end ()) {
+		boost::shared_ptr<const ConnectionList> connections = rt_connections ();
+		ConnectionList::const_iterator it = connections->begin ();
+		if (it == connections->end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
 		} else {
-			boost::shared_ptr<const AlsaAudioPort> source = boost::dynamic_pointer_cast<const AlsaAudioPort> (*it);
-			assert (source && source->is_output ());
+			/* connect () only allows to connect ports of the same type */
+			const AlsaAudioPort* source = static_cast<const AlsaAudioPort*> (it->get ());
+			assert (source->is_output ());
 			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
-			while (++it != connections.end ()) {
-				source = boost::dynamic_pointer_cast<const AlsaAudioPort> (*it);
-				assert (source && source->is_output ());
-				Sample*       dst = buffer ();
-				const Sample* src = source->const_buffer ();
-				for (uint32_t s = 0; s < n_samples; ++s, ++dst, ++src) {
-					*dst += *src;
-				}
+			while (++it != connections->end ()) {
+				source = static_cast<const AlsaAudioPort*> (it->get ());
+				assert (source->is_output ());
+				mix_buffers_no_gain (_buffer, source->const_buffer (), n_samples);
 			}
 		}
 	}
@@ -2384,11 +2382,11 @@ void* AlsaMidiPort::get_buffer (pframes_t /* nframes */)
 {
 	if (is_input ()) {
 		(_buffer[_bufperiod]).clear ();
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		for (std::set<BackendPortPtr>::const_iterator i = connections.begin ();
-		     i != connections.end ();
+		boost::shared_ptr<const ConnectionList> connections = rt_connections ();
+		for (ConnectionList::const_iterator i = connections->begin ();
+		     i != connections->end ();
 		     ++i) {
-			const AlsaMidiBuffer* src = boost::dynamic_pointer_cast<const AlsaMidiPort> (*i)->const_buffer ();
+			const AlsaMidiBuffer* src = static_cast<const AlsaMidiPort*> (i->get ())->const_buffer ();
 			for (AlsaMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
 				(_buffer[_bufperiod]).push_back (*it);
 			}
@@ -40,6 +40,7 @@
 
 #include "ardour/debug.h"
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 
 #include "pbd/i18n.h"
 
@@ -66,6 +67,8 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 	, _freewheel (false)
 	, _freewheeling (false)
 	, _speedup (1.0)
+	, _fixed_seed (false)
+	, _seed (0)
 	, _device ("")
 	, _samplerate (48000)
 	, _samples_per_period (1024)
@@ -82,6 +85,12 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 	_instance_name = s_instance_name;
 	_device = _("Silence");
 
+	const char* seed = g_getenv ("ARDOUR_DUMMY_SEED");
+	if (seed) {
+		_fixed_seed = true;
+		_seed = strtoul (seed, NULL, 10);
+	}
+
 	if (_driver_speed.empty()) {
 		_driver_speed.push_back (DriverSpeed (_("Half Speed"),   2.0f));
 		_driver_speed.push_back (DriverSpeed (_("Normal Speed"), 1.0f));
@@ -91,6 +100,7 @@ DummyAudioBackend::DummyAudioBackend (AudioEngine& e, AudioBackendInfo& info)
 		_driver_speed.push_back (DriverSpeed (_("15x Speed"),    0.06666f));
 		_driver_speed.push_back (DriverSpeed (_("20x Speed"),    0.05f));
 		_driver_speed.push_back (DriverSpeed (_("50x Speed"),    0.02f));
+		_driver_speed.push_back (DriverSpeed (_("As Fast As Possible"), 0.0f));
 	}
 
 }
@@ -991,7 +1001,9 @@ DummyAudioBackend::main_process_thread ()
 
 			const int64_t elapsed_time = _dsp_load_calc.elapsed_time_us ();
 			const int64_t nominal_time = _dsp_load_calc.get_max_time_us ();
-			if (elapsed_time < nominal_time) {
+			if (_speedup == 0) {
+				; // as fast as possible, start next cycle right away
+			} else if (elapsed_time < nominal_time) {
 				const int64_t sleepy = _speedup * (nominal_time - elapsed_time);
 				Glib::usleep (std::max ((int64_t) 100, sleepy));
 			} else {
@@ -999,7 +1011,9 @@ DummyAudioBackend::main_process_thread ()
 			}
 		} else {
 			_dsp_load = 1.0f;
-			Glib::usleep (100); // don't hog cpu
+			if (_speedup != 0) {
+				Glib::usleep (100); // don't hog cpu
+			}
 		}
 
 		/* beginning of next cycle */
@@ -1119,6 +1133,12 @@ DummyPort::~DummyPort ()
 
 void DummyPort::setup_random_number_generator ()
 {
+	if (_engine.fixed_seed ()) {
+		/* same signal in every run, but distinct per port */
+		_rseed = (g_str_hash (name ().c_str ()) ^ _engine.seed ()) % INT_MAX;
+		if (_rseed == 0) _rseed = 1;
+		return;
+	}
 #ifdef PLATFORM_WINDOWS
 	LARGE_INTEGER Count;
 	if (QueryPerformanceCounter (&Count)) {
@@ -1614,28 +1634,25 @@ void*
 DummyAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		std::set<BackendPortPtr>::const_iterator it = connections.begin ();
-		if (it == connections.end ()) {
+		boost::shared_ptr<const ConnectionList> connections = rt_connections ();
+		ConnectionList::const_iterator it = connections->begin ();
+		if (it == connections->end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
 		} else {
-			boost::shared_ptr<DummyAudioPort> source = boost::dynamic_pointer_cast<DummyAudioPort>(*it);
-			assert (source && source->is_output ());
+			/* connect () only allows to connect ports of the same type */
+			DummyAudioPort* source = static_cast<DummyAudioPort*> (it->get ());
+			assert (source->is_output ());
 			if (source->is_physical() && source->is_terminal()) {
 				source->get_buffer(n_samples); // generate signal.
 			}
 			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
-			while (++it != connections.end ()) {
-				source = boost::dynamic_pointer_cast<DummyAudioPort>(*it);
-				assert (source && source->is_output ());
-				Sample* dst = buffer ();
+			while (++it != connections->end ()) {
+				source = static_cast<DummyAudioPort*> (it->get ());
+				assert (source->is_output ());
 				if (source->is_physical() && source->is_terminal()) {
 					source->get_buffer(n_samples); // generate signal.
 				}
-				const Sample* src = source->const_buffer ();
-				for (uint32_t s = 0; s < n_samples; ++s, ++dst, ++src) {
-					*dst += *src;
-				}
+				mix_buffers_no_gain (_buffer, source->const_buffer (), n_samples);
 			}
 		}
 	} else if (is_output () && is_physical () && is_terminal()) {
@@ -1854,11 +1871,11 @@ void* DummyMidiPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
 		_buffer.clear ();
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		for (std::set<BackendPortPtr>::const_iterator i = connections.begin ();
-				i != connections.end ();
+		boost::shared_ptr<const ConnectionList> connections = rt_connections ();
+		for (ConnectionList::const_iterator i = connections->begin ();
+				i != connections->end ();
 				++i) {
-			boost::shared_ptr<DummyMidiPort> source = boost::dynamic_pointer_cast<DummyMidiPort>(*i);
+			DummyMidiPort* source = static_cast<DummyMidiPort*> (i->get ());
 			if (source->is_physical() && source->is_terminal()) {
 				source->get_buffer(n_samples); // generate signal.
 			}
@@ -90,7 +90,7 @@ class DummyPort : public BackendPort {
 		Glib::Threads::Mutex generator_lock;
 
         private:
-		AudioBackend& _engine;
+		DummyAudioBackend& _engine;
 
 }; // class DummyPort
 
@@ -191,6 +191,14 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl {
 
 		bool is_running () const { return _running; }
 
+		/** true if signal generators use a fixed seed, so that every run
+		 * processes the same input (e.g. for benchmarks). This is set by
+		 * the ARDOUR_DUMMY_SEED environment variable, the value of which
+		 * is the seed, and is independent of the driver (speed).
+		 */
+		bool fixed_seed () const { return _fixed_seed; }
+		uint32_t seed () const { return _seed; }
+
 		/* AUDIOBACKEND API */
 
 		std::string name () const;
@@ -364,6 +372,9 @@ class DummyAudioBackend : public AudioBackend, public PortEngineSharedImpl {
 		bool  _freewheeling;
 		float _speedup;
 
+		bool     _fixed_seed;
+		uint32_t _seed;
+
 		std::string _device;
 
 		float  _samplerate;
@@ -32,6 +32,7 @@
 #include "pbd/pthread_utils.h"
 
 #include "ardour/port_manager.h"
+#include "ardour/runtime_functions.h"
 
 #include "pulseaudio_backend.h"
 
@@ -1203,23 +1204,19 @@ void*
 PulseAudioPort::get_buffer (pframes_t n_samples)
 {
 	if (is_input ()) {
-		const std::set<BackendPortPtr>&          connections = get_connections ();
-		std::set<BackendPortPtr>::const_iterator it          = connections.begin ();
-
-		if (it == connections.end ()) {
+		boost::shared_ptr<const ConnectionList> connections = rt_connections ();
+		ConnectionList::const_iterator it = connections->begin ();
+		if (it == connections->end ()) {
 			memset (_buffer, 0, n_samples * sizeof (Sample));
 		} else {
-			boost::shared_ptr<PulseAudioPort> source = boost::dynamic_pointer_cast<PulseAudioPort> (*it);
-			assert (source && source->is_output ());
+			/* connect () only allows to connect ports of the same type */
+			const PulseAudioPort* source = static_cast<const PulseAudioPort*> (it->get ());
+			assert (source->is_output ());
 			memcpy (_buffer, source->const_buffer (), n_samples * sizeof (Sample));
-			while (++it != connections.end ()) {
-				source = boost::dynamic_pointer_cast<PulseAudioPort> (*it);
-				assert (source && source->is_output ());
-				Sample*       dst = _buffer;
-				const Sample* src = source->const_buffer ();
-				for (uint32_t s = 0; s < n_samples; ++s, ++dst, ++src) {
-					*dst += *src;
-				}
+			while (++it != connections->end ()) {
+				source = static_cast<const PulseAudioPort*> (it->get ());
+				assert (source->is_output ());
+				mix_buffers_no_gain (_buffer, source->const_buffer (), n_samples);
 			}
 		}
 	}
@@ -1249,11 +1246,11 @@ void* PulseMidiPort::get_buffer (pframes_t /*n_samples*/)
 {
 	if (is_input ()) {
 		_buffer.clear ();
-		const std::set<BackendPortPtr>& connections = get_connections ();
-		for (std::set<BackendPortPtr>::const_iterator i = connections.begin ();
-		     i != connections.end ();
+		boost::shared_ptr<const ConnectionList> connections = rt_connections ();
+		for (ConnectionList::const_iterator i = connections->begin ();
+		     i != connections->end ();
 		     ++i) {
-			const PulseMidiBuffer* src = boost::dynamic_pointer_cast<PulseMidiPort> (*i)->const_buffer ();
+			const PulseMidiBuffer* src = static_cast<const PulseMidiPort*> (i->get ())->const_buffer ();
 			for (PulseMidiBuffer::const_iterator it = src->begin (); it != src->end (); ++it) {
 				_buffer.push_back (*it);
 			}
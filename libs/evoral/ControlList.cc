@@ -35,6 +35,7 @@
 
 #define GUARD_POINT_DELTA(foo) (foo.time_domain () == Temporal::AudioTime ? Temporal::timecnt_t (64) : Temporal::timecnt_t (Beats (0, 1)))
 
+#include <algorithm>
 #include <cassert>
 #include <cmath>
 #include <iostream>
@@ -1224,6 +1225,7 @@ ControlList::thaw ()
 			_events.sort (event_time_less_than);
 			unlocked_remove_duplicates ();
 			unlocked_invalidate_insert_iterator ();
+			mark_dirty ();
 			_sort_pending = false;
 		}
 	}
@@ -1239,6 +1241,19 @@ ControlList::mark_dirty () const
 	_search_cache.left         = timepos_t::max (_time_domain);
 	_search_cache.first        = _events.end ();
 
+	{
+		PBD::SpinLock sl (_index_lock);
+		_index.valid = false;
+
+		size_t const n = _events.size ();
+		if (_index.when.capacity () < n) {
+			size_t const reserve = std::max<size_t> (64, 2 * n);
+			_index.when.reserve (reserve);
+			_index.value.reserve (reserve);
+			_index.iter.reserve (reserve);
+		}
+	}
+
 	if (_curve) {
 		_curve->mark_dirty ();
 	}
@@ -1441,24 +1456,56 @@ ControlList::truncate_start (timecnt_t const& overall)
 	maybe_signal_changed ();
 }
 
+bool
+ControlList::lock_index () const
+{
+	if (!_index_lock.try_lock ()) {
+		/* index is being rebuilt or invalidated by another thread */
+		return false;
+	}
+
+	if (_index.valid) {
+		return true;
+	}
+
+	size_t const n = _events.size ();
+
+	if (_index.when.capacity () < n) {
+		/* not reserved by mark_dirty(), do not allocate here */
+		_index_lock.unlock ();
+		return false;
+	}
+
+	_index.when.clear ();
+	_index.value.clear ();
+	_index.iter.clear ();
+
+	for (const_iterator i = _events.begin (); i != _events.end (); ++i) {
+		_index.when.push_back ((*i)->when);
+		_index.value.push_back ((*i)->value);
+		_index.iter.push_back (i);
+	}
+
+	_index.valid = true;
+	return true;
+}
+
+size_t
+ControlList::index_lower_bound (timepos_t const& x) const
+{
+	return std::lower_bound (_index.when.begin (), _index.when.end (), x) - _index.when.begin ();
+}
+
 double
 ControlList::unlocked_eval (timepos_t const& xtime) const
 {
-	int32_t   npoints;
 	timepos_t lpos, upos;
 	double    lval, uval;
 	double    fraction;
 	double    xx;
 	double    ll;
 
-	const_iterator length_check_iter = _events.begin ();
-	for (npoints = 0; npoints < 4; ++npoints, ++length_check_iter) {
-		if (length_check_iter == _events.end ()) {
-			break;
-		}
-	}
-
-	switch (npoints) {
+	switch (std::min<size_t> (_events.size (), 3)) {
 		case 0:
 			return _desc.normal;
 
@@ -1520,6 +1567,17 @@ ControlList::multipoint_eval (timepos_t const& xtime) const
 	/* "Stepped" lookup (no interpolation) */
 	/* FIXME: no cache.  significant? */
 	if (_interpolation == Discrete) {
+		if (lock_index ()) {
+			size_t const i = index_lower_bound (xtime);
+
+			// shouldn't have made it to multipoint_eval
+			assert (i < _index.when.size ());
+
+			double const val = (i == 0 || _index.when[i] == xtime) ? _index.value[i] : _index.value[i - 1];
+			unlock_index ();
+			return val;
+		}
+
 		const ControlEvent        cp (xtime, 0);
 		EventList::const_iterator i = lower_bound (_events.begin (), _events.end (), &cp, time_comparator);
 
@@ -1538,9 +1596,18 @@ ControlList::multipoint_eval (timepos_t const& xtime) const
 	    ((_lookup_cache.left > xtime) ||
 	     (_lookup_cache.range.first == _events.end ()) ||
 	     ((*_lookup_cache.range.second)->when < xtime))) {
-		const ControlEvent cp (xtime, 0);
+		if (lock_index ()) {
+			size_t const lo = index_lower_bound (xtime);
+			size_t const hi = std::upper_bound (_index.when.begin () + lo, _index.when.end (), xtime) - _index.when.begin ();
+
+			_lookup_cache.range.first  = lo < _index.iter.size () ? _index.iter[lo] : _events.end ();
+			_lookup_cache.range.second = hi < _index.iter.size () ? _index.iter[hi] : _events.end ();
+			unlock_index ();
+		} else {
+			const ControlEvent cp (xtime, 0);
 
-		_lookup_cache.range = equal_range (_events.begin (), _events.end (), &cp, time_comparator);
+			_lookup_cache.range = equal_range (_events.begin (), _events.end (), &cp, time_comparator);
+		}
 	}
 
 	pair<const_iterator, const_iterator> range = _lookup_cache.range;
@@ -1606,10 +1673,17 @@ ControlList::build_search_cache_if_necessary (timepos_t const& start_time) const
 	} else if ((_search_cache.left == timepos_t::max (_time_domain)) || (_search_cache.left > start)) {
 		/* Marked dirty (left == max), or we're too far forward, re-search. */
 
-		const ControlEvent start_point (start, 0);
+		if (lock_index ()) {
+			size_t const i = index_lower_bound (start);
 
-		_search_cache.first = lower_bound (_events.begin (), _events.end (), &start_point, time_comparator);
-		_search_cache.left  = start;
+			_search_cache.first = i < _index.iter.size () ? _index.iter[i] : _events.end ();
+			unlock_index ();
+		} else {
+			const ControlEvent start_point (start, 0);
+
+			_search_cache.first = lower_bound (_events.begin (), _events.end (), &start_point, time_comparator);
+		}
+		_search_cache.left = start;
 	}
 
 	/* We now have a search cache that is not too far right, but it may be too
@@ -25,6 +25,7 @@
 #include <climits>
 #include <cfloat>
 #include <cmath>
+#include <algorithm>
 #include <vector>
 
 #include <glibmm/threads.h>
@@ -39,6 +40,10 @@ using namespace sigc;
 
 namespace Evoral {
 
+Curve::linear_ramp_t Curve::_linear_ramp = &Curve::default_linear_ramp;
+Curve::exp2_ramp_t   Curve::_exp2_ramp   = &Curve::default_exp2_ramp;
+Curve::gain_ramp_t   Curve::_gain_ramp   = &Curve::default_gain_ramp;
+Curve::cubic_ramp_t  Curve::_cubic_ramp  = &Curve::default_cubic_ramp;
 
 Curve::Curve (const ControlList& cl)
 	: _dirty (true)
@@ -384,6 +389,215 @@ Curve::_get_vector (Temporal::timepos_t x0, Temporal::timepos_t x1, float *vec,
 	}
 }
 
+/** @return number of samples of a block, spaced \p dx from \p start, that are before \p x */
+static inline uint32_t
+samples_before (double x, double start, double dx, uint32_t nframes)
+{
+	return (uint32_t) std::min<double> (nframes, std::max (0.0, ceil ((x - start) / dx)));
+}
+
+bool
+Curve::rt_safe_get_block (Temporal::timepos_t const & start, Temporal::timepos_t const & end, float* vec, uint32_t nframes) const
+{
+	Glib::Threads::RWLock::ReaderLock lm(_list.lock(), Glib::Threads::TRY_LOCK);
+
+	if (!lm.locked()) {
+		return false;
+	} else {
+		_get_block (start, end, vec, nframes);
+		return true;
+	}
+}
+
+void
+Curve::get_block (Temporal::timepos_t const & start, Temporal::timepos_t const & end, float* vec, uint32_t nframes) const
+{
+	Glib::Threads::RWLock::ReaderLock lm(_list.lock());
+	_get_block (start, end, vec, nframes);
+}
+
+void
+Curve::_get_block (Temporal::timepos_t x0, Temporal::timepos_t x1, float* vec, uint32_t nframes) const
+{
+	if (nframes == 0) {
+		return;
+	}
+
+	x0.set_time_domain (_list.time_domain());
+	x1.set_time_domain (_list.time_domain());
+
+	const size_t npoints = _list.events().size();
+
+	if (npoints < 2) {
+		const float val = npoints == 0 ? _list.descriptor().normal : _list.events().front()->value;
+		for (uint32_t i = 0; i < nframes; ++i) {
+			vec[i] = val;
+		}
+		return;
+	}
+
+	const double start = x0.val();
+	const double dx    = (x1.val() - start) / nframes;
+
+	if (_list.interpolation() == ControlList::Curved && _dirty) {
+		solve ();
+	}
+
+	if (dx <= 0 || !_list.lock_index ()) {
+		/* reverse, or the index is not available: evaluate every sample */
+		for (uint32_t i = 0; i < nframes; ++i) {
+			const double rx = start + i * dx;
+			vec[i] = multipoint_eval (x0.is_beats() ? Temporal::timepos_t::from_ticks (rx) : Temporal::timepos_t::from_superclock (rx));
+		}
+		return;
+	}
+
+	const ControlList::EventIndex& index = _list._index;
+	const size_t n = index.when.size();
+
+	uint32_t i = 0;
+	size_t   k = _list.index_lower_bound (x0);
+
+	if (k == 0) {
+		/* before the first point */
+		const uint32_t cnt = samples_before (index.when[0].val(), start, dx, nframes);
+		for (; i < cnt; ++i) {
+			vec[i] = index.value[0];
+		}
+	}
+
+	while (i < nframes) {
+		const double rx = start + i * dx;
+
+		/* find the segment [k - 1, k) that contains rx */
+		while (k < n && index.when[k].val() <= rx) {
+			++k;
+		}
+
+		if (k == n) {
+			/* after the last point */
+			for (; i < nframes; ++i) {
+				vec[i] = index.value[n - 1];
+			}
+			break;
+		}
+
+		if (k == 0) {
+			/* rounding, still before the first point */
+			vec[i++] = index.value[0];
+			continue;
+		}
+
+		const uint32_t next = std::max (i + 1, samples_before (index.when[k].val(), start, dx, nframes));
+		const uint32_t cnt  = next - i;
+
+		const double lpos  = index.when[k - 1].val();
+		const double upos  = index.when[k].val();
+		const double lval  = index.value[k - 1];
+		const double uval  = index.value[k];
+		const double f0    = (rx - lpos) / (upos - lpos);
+		const double df    = dx / (upos - lpos);
+
+		switch (_list.interpolation()) {
+			case ControlList::Discrete:
+				for (uint32_t j = i; j < next; ++j) {
+					vec[j] = lval;
+				}
+				break;
+			case ControlList::Curved:
+				{
+					/* see multipoint_eval (): the spline coefficients are
+					 * stored with the upper point of the segment, in terms
+					 * of absolute x. Expand the cubic around rx, in terms
+					 * of t = (j - i) / cnt, which keeps the coefficients
+					 * in the range of the values.
+					 */
+					ControlEvent const* ev = *index.iter[k];
+					if (ev->coeff && uval != lval) {
+						const double* c  = ev->coeff;
+						const double  s  = cnt * dx;
+						const double  a0 = c[0] + rx * (c[1] + rx * (c[2] + rx * c[3]));
+						const double  a1 = (c[1] + rx * (2 * c[2] + 3 * rx * c[3])) * s;
+						const double  a2 = (c[2] + 3 * rx * c[3]) * s * s;
+						const double  a3 = c[3] * s * s * s;
+						_cubic_ramp (vec + i, cnt, a0, a1, a2, a3, 1.0 / cnt);
+						break;
+					}
+				}
+				/* no spline for this segment */
+				_linear_ramp (vec + i, cnt, lval + f0 * (uval - lval), df * (uval - lval));
+				break;
+			case ControlList::Logarithmic:
+				if (lval * uval > 0) {
+					/* interpolate_logarithmic (): lval * (uval / lval)^fraction */
+					const double l2 = log2 (uval / lval);
+					_exp2_ramp (vec + i, cnt, lval * exp2 (f0 * l2), df * l2);
+					break;
+				}
+				_linear_ramp (vec + i, cnt, lval + f0 * (uval - lval), df * (uval - lval));
+				break;
+			case ControlList::Exponential:
+				{
+					/* see interpolate_gain () */
+					const double upper = _list.descriptor().upper;
+					const double from  = lval + TINY_NUMBER;
+					const double to    = uval + TINY_NUMBER;
+					if (fabs (to - from) < TINY_NUMBER) {
+						for (uint32_t j = i; j < next; ++j) {
+							vec[j] = to;
+						}
+						break;
+					}
+					const double g0 = gain_to_position (from * 2. / upper);
+					const double g1 = gain_to_position (to * 2. / upper);
+					_gain_ramp (vec + i, cnt, g0 + f0 * (g1 - g0), df * (g1 - g0), upper / 2.);
+				}
+				break;
+			default: // Linear
+				_linear_ramp (vec + i, cnt, lval + f0 * (uval - lval), df * (uval - lval));
+				break;
+		}
+
+		i = next;
+	}
+
+	_list.unlock_index ();
+}
+
+void
+Curve::default_linear_ramp (float* dst, uint32_t nframes, float y0, float dy)
+{
+	for (uint32_t i = 0; i < nframes; ++i) {
+		dst[i] = y0 + i * dy;
+	}
+}
+
+void
+Curve::default_exp2_ramp (float* dst, uint32_t nframes, float y0, float de)
+{
+	for (uint32_t i = 0; i < nframes; ++i) {
+		dst[i] = y0 * exp2 (i * (double) de);
+	}
+}
+
+void
+Curve::default_gain_ramp (float* dst, uint32_t nframes, float p0, float dp, float scale)
+{
+	for (uint32_t i = 0; i < nframes; ++i) {
+		const double p = p0 + i * (double) dp;
+		dst[i] = p > 0 ? scale * position_to_gain (p) : 0;
+	}
+}
+
+void
+Curve::default_cubic_ramp (float* dst, uint32_t nframes, float a0, float a1, float a2, float a3, float dt)
+{
+	for (uint32_t i = 0; i < nframes; ++i) {
+		const float t = i * dt;
+		dst[i] = a0 + t * (a1 + t * (a2 + t * a3));
+	}
+}
+
 double
 Curve::multipoint_eval (Temporal::timepos_t const & x) const
 {
@@ -49,6 +49,7 @@ SMF::SMF()
 	: _smf (0)
 	, _smf_track (0)
 	, _empty (true)
+	, _track_revision (0)
 	, _n_note_on_events (0)
 	, _has_pgm_change (false)
 	, _num_channels (0)
@@ -86,6 +87,7 @@ int
 SMF::seek_to_track(int track)
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
+	++_track_revision;
 	_smf_track = smf_get_track_by_number(_smf, track);
 	if (_smf_track != NULL) {
 		_smf_track->next_event_number = (_smf_track->number_of_events == 0) ? 0 : 1;
@@ -131,6 +133,8 @@ SMF::open(const std::string& path, int track, bool scan)
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
+	++_track_revision;
+
 	_num_channels     = 0;
 	_n_note_on_events = 0;
 	_has_pgm_change   = false;
@@ -228,6 +232,8 @@ SMF::create(const std::string& path, int track, uint16_t ppqn)
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
+	++_track_revision;
+
 	assert(track >= 1);
 	if (_smf) {
 		smf_delete(_smf);
@@ -283,6 +289,8 @@ SMF::close()
 {
 	Glib::Threads::Mutex::Lock lm (_smf_lock);
 
+	++_track_revision;
+
 	if (_smf) {
 		smf_delete(_smf);
 		_smf = 0;
@@ -487,6 +495,7 @@ SMF::append_event_delta(uint32_t delta_t, uint32_t size, const uint8_t* buf, eve
 	assert(_smf_track);
 	smf_track_add_event_delta_pulses(_smf_track, event, delta_t);
 	_empty = false;
+	++_track_revision;
 }
 
 void
@@ -502,6 +511,95 @@ SMF::begin_write()
 
 	smf_add_track(_smf, _smf_track);
 	assert(_smf->number_of_tracks == 1);
+	++_track_revision;
+}
+
+static bool
+is_tempo_or_meter (smf_event_t const* ev)
+{
+	return ev->midi_buffer_length > 1 && ev->midi_buffer[0] == 0xff && (ev->midi_buffer[1] == 0x51 || ev->midi_buffer[1] == 0x58);
+}
+
+static bool
+event_time_less (smf_event_t const* ev, size_t pulses)
+{
+	return ev->time_pulses < pulses;
+}
+
+static bool
+time_event_less (size_t pulses, smf_event_t const* ev)
+{
+	return pulses < ev->time_pulses;
+}
+
+bool
+SMF::begin_replace (size_t start, size_t end, size_t& last)
+{
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+
+	assert (_smf_track);
+	assert (_replace_tail.empty ());
+
+	GPtrArray*    events = _smf_track->events_array;
+	smf_event_t** first  = (smf_event_t**) events->pdata;
+	smf_event_t** past   = first + events->len;
+
+	/* events are sorted by time */
+	smf_event_t** lo = std::lower_bound (first, past, start, event_time_less);
+	smf_event_t** hi = std::upper_bound (lo, past, end, time_event_less);
+
+	for (smf_event_t** e = lo; e != hi; ++e) {
+		if (is_tempo_or_meter (*e)) {
+			return false;
+		}
+	}
+
+	for (smf_event_t** e = lo; e != hi; ++e) {
+		free ((*e)->midi_buffer);
+		free (*e);
+	}
+
+	_replace_tail.assign (hi, past);
+
+	size_t const n_kept = lo - first;
+
+	/* only drop the pointers, the events were freed or moved to _replace_tail */
+	g_ptr_array_set_size (events, n_kept);
+
+	_smf_track->number_of_events  = n_kept;
+	_smf_track->next_event_number = n_kept > 0 ? 1 : 0;
+
+	last = n_kept > 0 ? first[n_kept - 1]->time_pulses : 0;
+
+	++_track_revision;
+	return true;
+}
+
+void
+SMF::end_replace ()
+{
+	Glib::Threads::Mutex::Lock lm (_smf_lock);
+
+	assert (_smf_track);
+
+	GPtrArray* events = _smf_track->events_array;
+	size_t     prev   = events->len > 0 ? ((smf_event_t*) g_ptr_array_index (events, events->len - 1))->time_pulses : 0;
+
+	for (std::vector<smf_event_t*>::const_iterator e = _replace_tail.begin (); e != _replace_tail.end (); ++e) {
+		/* only the first event's delta can change */
+		assert ((*e)->time_pulses >= prev);
+		(*e)->delta_time_pulses = (*e)->time_pulses - prev;
+		prev = (*e)->time_pulses;
+
+		g_ptr_array_add (events, *e);
+		(*e)->event_number = ++_smf_track->number_of_events;
+	}
+
+	_replace_tail.clear ();
+
+	_smf_track->next_event_number = _smf_track->number_of_events > 0 ? 1 : 0;
+	_empty = _smf_track->number_of_events == 0;
+	++_track_revision;
 }
 
 void
@@ -28,6 +28,8 @@
 #include <stdint.h>
 #include <cstdio>
 
+#include <boost/make_shared.hpp>
+
 #if __clang__
 #include "evoral/Note.h"
 #endif
@@ -475,6 +477,8 @@ Sequence<Time>::const_iterator::operator=(const const_iterator& other)
 template<typename Time>
 Sequence<Time>::Sequence(const TypeMap& type_map)
 	: _edited(false)
+	, _all_dirty(true)
+	, _dirty(false)
 	, _overlapping_pitches_accepted (true)
 	, _overlap_pitch_resolution (FirstOnFirstOff)
 	, _writing(false)
@@ -496,6 +500,8 @@ template<typename Time>
 Sequence<Time>::Sequence(const Sequence<Time>& other)
 	: ControlSet (other)
 	, _edited(false)
+	, _all_dirty(true)
+	, _dirty(false)
 	, _overlapping_pitches_accepted (other._overlapping_pitches_accepted)
 	, _overlap_pitch_resolution (other._overlap_pitch_resolution)
 	, _writing(false)
@@ -505,8 +511,9 @@ Sequence<Time>::Sequence(const Sequence<Time>& other)
 	, _highest_note(other._highest_note)
 {
 	for (typename Notes::const_iterator i = other._notes.begin(); i != other._notes.end(); ++i) {
-		NotePtr n (new Note<Time> (**i));
+		NotePtr n (boost::make_shared<Note<Time> > (**i));
 		_notes.insert (n);
+		_note_ids[n->id()] = n;
 	}
 
 	for (typename SysExes::const_iterator i = other._sysexes.begin(); i != other._sysexes.end(); ++i) {
@@ -624,10 +631,12 @@ Sequence<Time>::clear()
 {
 	WriteLock lock(write_lock());
 	_notes.clear();
+	_note_ids.clear ();
 	_sysexes.clear ();
 	_patch_changes.clear ();
 	for (Controls::iterator li = _controls.begin(); li != _controls.end(); ++li)
 		li->second->list()->clear();
+	_all_dirty = true;
 }
 
 /** Begin a write of events to the model.
@@ -643,6 +652,7 @@ Sequence<Time>::start_write()
 {
 	WriteLock lock(write_lock());
 	_writing = true;
+	_all_dirty = true;
 	for (int i = 0; i < 16; ++i) {
 		_write_notes[i].clear();
 	}
@@ -676,12 +686,14 @@ Sequence<Time>::end_write (StuckNoteOption option, Time when)
 				break;
 			case DeleteStuckNotes:
 				cerr << "WARNING: Stuck note lost (end was " << when << "): " << (**n) << endl;
+				unindex_note (*n);
 				_notes.erase(n);
 				break;
 			case ResolveStuckNotes:
 				if (when <= (*n)->time()) {
 					cerr << "WARNING: Stuck note resolution - end time @ "
 					     << when << " is before note on: " << (**n) << endl;
+					unindex_note (*n);
 					_notes.erase (n);
 				} else {
 					(*n)->set_length (when - (*n)->time());
@@ -727,7 +739,9 @@ Sequence<Time>::add_note_unlocked(const NotePtr note, void* arg)
 
 	_notes.insert (note);
 	_pitches[note->channel()].insert (note);
+	_note_ids[note->id()] = note;
 
+	mark_dirty (note->time(), note->end_time());
 	_edited = true;
 
 	return true;
@@ -756,6 +770,7 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 		if (*i == note) {
 
 			DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1\terasing note #%2 %3 @ %4\n", this, (*i)->id(), (int)(*i)->note(), (*i)->time()));
+			unindex_note (*i);
 			_notes.erase (i);
 
 			if (note->note() == _lowest_note || note->note() == _highest_note) {
@@ -796,6 +811,7 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 			if ((*i)->id() == note->id()) {
 
 				DEBUG_TRACE (DEBUG::Sequence, string_compose ("%1\tID-based pass, erasing note #%2 %3 @ %4\n", this, (*i)->id(), (int)(*i)->note(), (*i)->time()));
+				unindex_note (*i);
 				_notes.erase (i);
 
 				if (note->note() == _lowest_note || note->note() == _highest_note) {
@@ -862,6 +878,7 @@ Sequence<Time>::remove_note_unlocked(const constNotePtr note)
 			warning << string_compose ("erased note %1 not found in pitches for channel %2", *note, (int) note->channel()) << endmsg;
 		}
 
+		mark_dirty (note->time(), note->end_time());
 		_edited = true;
 
 	} else {
@@ -882,6 +899,7 @@ Sequence<Time>::remove_patch_change_unlocked (const constPatchChangePtr p)
 
 		if (**i == *p) {
 			_patch_changes.erase (i);
+			mark_dirty (p->time(), p->time());
 		}
 
 		i = tmp;
@@ -900,6 +918,7 @@ Sequence<Time>::remove_sysex_unlocked (const SysExPtr sysex)
 
 		if (*i == sysex) {
 			_sysexes.erase (i);
+			mark_dirty (sysex->time(), sysex->time());
 		}
 
 		i = tmp;
@@ -1006,7 +1025,7 @@ Sequence<Time>::append_note_on_unlocked (const Event<Time>& ev, event_id_t evid)
 	/* nascent (incoming notes without a note-off ...yet) have a duration
 	   that extends to Beats::max()
 	*/
-	NotePtr note(new Note<Time>(ev.channel(), ev.time(), std::numeric_limits<Temporal::Beats>::max() - ev.time(), ev.note(), ev.velocity()));
+	NotePtr note (boost::make_shared<Note<Time> > (ev.channel(), ev.time(), std::numeric_limits<Temporal::Beats>::max() - ev.time(), ev.note(), ev.velocity()));
 	assert (note->end_time() == std::numeric_limits<Temporal::Beats>::max());
 	note->set_id (evid);
 
@@ -1123,6 +1142,7 @@ Sequence<Time>::add_patch_change_unlocked (PatchChangePtr p)
 	}
 
 	_patch_changes.insert (p);
+	mark_dirty (p->time(), p->time());
 }
 
 template<typename Time>
@@ -1134,6 +1154,7 @@ Sequence<Time>::add_sysex_unlocked (SysExPtr s)
 	}
 
 	_sysexes.insert (s);
+	mark_dirty (s->time(), s->time());
 }
 
 template<typename Time>
@@ -1206,6 +1227,77 @@ void
 Sequence<Time>::set_notes (const typename Sequence<Time>::Notes& n)
 {
 	_notes = n;
+	_all_dirty = true;
+	rebuild_note_ids ();
+}
+
+template<typename Time>
+typename Sequence<Time>::NotePtr
+Sequence<Time>::note_by_id (event_id_t id) const
+{
+	typename NoteIDs::const_iterator i = _note_ids.find (id);
+
+	if (i == _note_ids.end ()) {
+		return NotePtr ();
+	}
+
+	return i->second.lock ();
+}
+
+template<typename Time>
+void
+Sequence<Time>::unindex_note (NotePtr const& note)
+{
+	typename NoteIDs::iterator i = _note_ids.find (note->id ());
+
+	/* IDs are not necessarily unique, e.g. after pasting a copy */
+	if (i != _note_ids.end () && i->second.lock () == note) {
+		_note_ids.erase (i);
+	}
+}
+
+template<typename Time>
+void
+Sequence<Time>::rebuild_note_ids ()
+{
+	_note_ids.clear ();
+
+	for (typename Notes::const_iterator l = _notes.begin(); l != _notes.end(); ++l) {
+		_note_ids[(*l)->id()] = *l;
+	}
+}
+
+template<typename Time>
+void
+Sequence<Time>::mark_dirty (Time start, Time end)
+{
+	if (!_dirty) {
+		_dirty_start = start;
+		_dirty_end   = end;
+		_dirty       = true;
+	} else {
+		_dirty_start = std::min (_dirty_start, start);
+		_dirty_end   = std::max (_dirty_end, end);
+	}
+}
+
+template<typename Time>
+bool
+Sequence<Time>::dirty_range (Time& start, Time& end) const
+{
+	if (_all_dirty) {
+		return false;
+	}
+
+	if (_dirty) {
+		start = _dirty_start;
+		end   = _dirty_end;
+	} else {
+		start = std::numeric_limits<Time>::max();
+		end   = Time();
+	}
+
+	return true;
 }
 
 // CONST iterator implementations (x3)
@@ -1413,6 +1505,7 @@ void
 Sequence<Time>::control_list_marked_dirty ()
 {
 	set_edited (true);
+	mark_all_dirty ();
 }
 
 template<typename Time>
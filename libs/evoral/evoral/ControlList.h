@@ -26,6 +26,7 @@
 #include <cassert>
 #include <list>
 #include <stdint.h>
+#include <vector>
 
 #include <boost/pool/pool.hpp>
 #include <boost/pool/pool_alloc.hpp>
@@ -33,6 +34,7 @@
 #include <glibmm/threads.h>
 
 #include "pbd/signals.h"
+#include "pbd/spinlock.h"
 
 #include "temporal/timeline.h"
 #include "temporal/types.h"
@@ -365,12 +367,37 @@ public:
 	void invalidate_insert_iterator ();
 
   protected:
+	friend class Curve;
 
 	/** Called by unlocked_eval() to handle cases of 3 or more control points. */
 	double multipoint_eval (Temporal::timepos_t const & x) const;
 
 	void build_search_cache_if_necessary (Temporal::timepos_t const & start) const;
 
+	/** Contiguous copy of the event times and values, used for lookups.
+	 *
+	 * _events remains the authoritative (and editable) storage, the index
+	 * is invalidated by mark_dirty() and lazily rebuilt on the next lookup.
+	 * Space is reserved by mark_dirty(), so that a rebuild in a realtime
+	 * context does not allocate.
+	 */
+	struct EventIndex {
+		EventIndex () : valid (false) {}
+		std::vector<Temporal::timepos_t> when;
+		std::vector<double>              value;
+		std::vector<const_iterator>      iter;
+		bool                             valid;
+	};
+
+	/** Lock and, if needed, rebuild the index. If this returns true,
+	 * the index can be used until unlock_index() is called.
+	 */
+	bool lock_index () const;
+	void unlock_index () const { _index_lock.unlock (); }
+
+	/** @return position of the first indexed event not before \a x */
+	size_t index_lower_bound (Temporal::timepos_t const & x) const;
+
 	boost::shared_ptr<ControlList> cut_copy_clear (Temporal::timepos_t const &, Temporal::timepos_t const &, int op);
 	bool erase_range_internal (Temporal::timepos_t const & start, Temporal::timepos_t const & end, EventList &);
 
@@ -386,6 +413,8 @@ public:
 
 	mutable LookupCache   _lookup_cache;
 	mutable SearchCache   _search_cache;
+	mutable EventIndex    _index;
+	mutable PBD::spinlock_t _index_lock;
 
 	mutable Glib::Threads::RWLock _lock;
 
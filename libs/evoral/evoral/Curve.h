@@ -38,6 +38,32 @@ public:
 	bool rt_safe_get_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const & x1, float *arg, int32_t veclen) const;
 	void get_vector (Temporal::timepos_t const & x0, Temporal::timepos_t const & x1, float *arg, int32_t veclen) const;
 
+	/** Evaluate the curve for a block of \p nframes samples.
+	 *
+	 * Unlike get_vector(), \p end is not included: vec[i] is the value at
+	 * start + i * (end - start) / nframes. Segments are looked up once per
+	 * call and interpolated with the ramp functions below.
+	 *
+	 * @return false if the list is locked (rt_safe_ variant only)
+	 */
+	bool rt_safe_get_block (Temporal::timepos_t const & start, Temporal::timepos_t const & end, float* vec, uint32_t nframes) const;
+	void get_block (Temporal::timepos_t const & start, Temporal::timepos_t const & end, float* vec, uint32_t nframes) const;
+
+	/* dst[i] = y0 + i * dy */
+	typedef void (*linear_ramp_t) (float* dst, uint32_t nframes, float y0, float dy);
+	/* dst[i] = y0 * 2^(i * de) */
+	typedef void (*exp2_ramp_t) (float* dst, uint32_t nframes, float y0, float de);
+	/* dst[i] = scale * position_to_gain (p0 + i * dp) */
+	typedef void (*gain_ramp_t) (float* dst, uint32_t nframes, float p0, float dp, float scale);
+	/* dst[i] = a0 + t * (a1 + t * (a2 + t * a3)), t = i * dt */
+	typedef void (*cubic_ramp_t) (float* dst, uint32_t nframes, float a0, float a1, float a2, float a3, float dt);
+
+	/* allow libardour to set optimized versions */
+	static void override_linear_ramp (linear_ramp_t func) { _linear_ramp = func; }
+	static void override_exp2_ramp (exp2_ramp_t func)     { _exp2_ramp = func; }
+	static void override_gain_ramp (gain_ramp_t func)     { _gain_ramp = func; }
+	static void override_cubic_ramp (cubic_ramp_t func)   { _cubic_ramp = func; }
+
 	void solve () const;
 
 	void mark_dirty() const { _dirty = true; }
@@ -46,6 +72,17 @@ private:
 	double multipoint_eval (Temporal::timepos_t const & x) const;
 
 	void _get_vector (Temporal::timepos_t x0, Temporal::timepos_t x1, float *arg, int32_t veclen) const;
+	void _get_block (Temporal::timepos_t start, Temporal::timepos_t end, float* vec, uint32_t nframes) const;
+
+	static void default_linear_ramp (float* dst, uint32_t nframes, float y0, float dy);
+	static void default_exp2_ramp (float* dst, uint32_t nframes, float y0, float de);
+	static void default_gain_ramp (float* dst, uint32_t nframes, float p0, float dp, float scale);
+	static void default_cubic_ramp (float* dst, uint32_t nframes, float a0, float a1, float a2, float a3, float dt);
+
+	static linear_ramp_t _linear_ramp;
+	static exp2_ramp_t   _exp2_ramp;
+	static gain_ramp_t   _gain_ramp;
+	static cubic_ramp_t  _cubic_ramp;
 
 	mutable bool       _dirty;
 	const ControlList& _list;
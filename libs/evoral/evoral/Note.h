@@ -109,7 +109,12 @@ public:
 	inline const Event<Time>& off_event() const { return _off_event; }
 
 private:
-	// Event buffers are self-contained
+	/* Event buffers are self-contained: the events reference these
+	 * (declared first, so they exist when the events are constructed)
+	 * rather than allocating buffers of their own.
+	 */
+	uint8_t     _on_data[3];
+	uint8_t     _off_data[3];
 	Event<Time> _on_event;
 	Event<Time> _off_event;
 };
@@ -24,6 +24,7 @@
 
 #include <glibmm/threads.h>
 #include <set>
+#include <vector>
 
 #include "evoral/visibility.h"
 #include "evoral/types.h"
@@ -31,9 +32,11 @@
 struct smf_struct;
 struct smf_track_struct;
 struct smf_tempo_struct;
+struct smf_event_struct;
 typedef smf_struct smf_t;
 typedef smf_track_struct smf_track_t;
 typedef smf_tempo_struct smf_tempo_t;
+typedef smf_event_struct smf_event_t;
 
 namespace Evoral {
 
@@ -82,6 +85,21 @@ public:
 	void append_event_delta(uint32_t delta_t, uint32_t size, const uint8_t* buf, event_id_t note_id);
 	void end_write(std::string const &);
 
+	/* Partial rewrites: begin_replace() removes all events in [start, end]
+	 * (in pulses) from the track, events added with append_event_delta()
+	 * until end_replace() take their place. The events before and after the
+	 * range are kept as they are, nothing is re-encoded.
+	 *
+	 * begin_replace() fails if the range contains tempo or meter changes.
+	 * \p last is set to the time of the last event before the range, which
+	 * the delta time of the first new event is relative to.
+	 */
+	bool begin_replace (size_t start, size_t end, size_t& last);
+	void end_replace ();
+
+	/** Incremented by every change of the track */
+	uint64_t track_revision () const { return _track_revision; }
+
 	void flush() {};
 
 	double round_to_file_precision (double val) const;
@@ -140,6 +158,9 @@ public:
 	smf_t*       _smf;
 	smf_track_t* _smf_track;
 	bool         _empty; ///< true iff file contains(non-empty) events
+	uint64_t     _track_revision;
+
+	std::vector<smf_event_t*> _replace_tail; ///< events after the range of begin_replace()
 
 	mutable Glib::Threads::Mutex _smf_lock;
 
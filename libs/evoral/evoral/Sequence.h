@@ -27,6 +27,7 @@
 #include <queue>
 #include <set>
 #include <list>
+#include <unordered_map>
 #include <utility>
 #include <boost/shared_ptr.hpp>
 #include <glibmm/threads.h>
@@ -187,6 +188,17 @@ public:
 
 	void set_notes (const typename Sequence<Time>::Notes& n);
 
+	/** Find the note with the given ID (see Note::id()), or return a null pointer.
+	 *
+	 * This uses an index of note IDs, which is maintained as notes are
+	 * added and removed, so both hits and misses are O(1). Notes must
+	 * therefore be added with add_note_unlocked() rather than by inserting
+	 * into notes() directly, and must not be re-numbered while they are
+	 * part of the sequence. The caller must hold a lock (or be the only
+	 * user of the sequence).
+	 */
+	NotePtr note_by_id (event_id_t id) const;
+
 	typedef boost::shared_ptr< Event<Time> > SysExPtr;
 	typedef boost::shared_ptr<const Event<Time> > constSysExPtr;
 
@@ -214,7 +226,7 @@ public:
 	inline const PatchChanges& patch_changes () const { return _patch_changes; }
 
 private:
-	typedef std::priority_queue<NotePtr, std::deque<NotePtr>, LaterNoteEndComparator> ActiveNotes;
+	typedef std::priority_queue<NotePtr, std::vector<NotePtr>, LaterNoteEndComparator> ActiveNotes;
 public:
 
 	/** Read iterator */
@@ -298,6 +310,22 @@ public:
 	bool edited() const      { return _edited; }
 	void set_edited(bool yn) { _edited = yn; }
 
+	/** Extend the range of changes (see dirty_range()) by [start, end] */
+	void mark_dirty (Time start, Time end);
+	/** Forget the range of changes, the whole sequence is considered changed */
+	void mark_all_dirty () { _all_dirty = true; }
+	/** Start tracking changes anew, e.g. after the sequence was written to disk */
+	void clear_dirty () { _all_dirty = false; _dirty = false; }
+
+	/** Get the time range of all changes since the last call to clear_dirty().
+	 *
+	 * @return false if that is not known, because the sequence was
+	 * (re)written, cleared or controller data changed. Otherwise
+	 * \p start and \p end are set to the range of changes, and \p start
+	 * is greater than \p end if there were none.
+	 */
+	bool dirty_range (Time& start, Time& end) const;
+
 	bool overlaps (const NotePtr& ev,
 	               const NotePtr& ignore_this_note) const;
 	bool contains (const NotePtr& ev) const;
@@ -317,6 +345,10 @@ public:
 
 protected:
 	bool                   _edited;
+	bool                   _all_dirty;
+	bool                   _dirty;
+	Time                   _dirty_start;
+	Time                   _dirty_end;
 	bool                   _overlapping_pitches_accepted;
 	OverlapPitchResolution _overlap_pitch_resolution;
 	mutable Glib::Threads::RWLock   _lock;
@@ -354,6 +386,12 @@ private:
 	SysExes      _sysexes;
 	PatchChanges _patch_changes;
 
+	typedef std::unordered_map<event_id_t, WeakNotePtr> NoteIDs;
+	NoteIDs      _note_ids;    // notes indexed by ID, see note_by_id()
+
+	void unindex_note (NotePtr const&);
+	void rebuild_note_ids ();
+
 	typedef std::multiset<NotePtr, EarlierNoteComparator> WriteNotes;
 	WriteNotes _write_notes[16];
 
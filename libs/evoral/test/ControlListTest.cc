@@ -0,0 +1,119 @@
+#include <stdlib.h>
+
+#include "ControlListTest.h"
+#include "evoral/ControlList.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (ControlListTest);
+
+using namespace Evoral;
+using namespace Temporal;
+
+/* value of the point at \p i, points are 64 samples apart */
+static double
+point_value (int64_t i)
+{
+	return (i * 7) % 1024;
+}
+
+/* reference linear interpolation, equidistant points */
+static double
+reference_eval (int64_t n_points, int64_t s)
+{
+	if (s <= 0) {
+		return point_value (0);
+	}
+	if (s >= (n_points - 1) * 64) {
+		return point_value (n_points - 1);
+	}
+	int64_t const i = s / 64;
+	double const  f = (s % 64) / 64.0;
+	return point_value (i) + f * (point_value (i + 1) - point_value (i));
+}
+
+static void
+fill (boost::shared_ptr<ControlList> cl, int64_t n_points)
+{
+	for (int64_t i = 0; i < n_points; ++i) {
+		cl->fast_simple_add (timepos_t (i * 64), point_value (i));
+	}
+}
+
+void
+ControlListTest::indexedEval ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+	int64_t const n_points = 1000;
+
+	fill (cl, n_points);
+
+	/* random access, defeating the lookup cache */
+	srand (0);
+	for (int i = 0; i < 10000; ++i) {
+		int64_t s = rand () % (n_points * 64 + 256) - 128;
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (reference_eval (n_points, s), cl->eval (timepos_t (s)), 1e-9);
+	}
+
+	/* sequential access */
+	for (int64_t s = 0; s < 4096; ++s) {
+		CPPUNIT_ASSERT_DOUBLES_EQUAL (reference_eval (n_points, s), cl->eval (timepos_t (s)), 1e-9);
+	}
+
+	cl->set_interpolation (ControlList::Discrete);
+	CPPUNIT_ASSERT_EQUAL (point_value (10), cl->eval (timepos_t (10 * 64)));
+	CPPUNIT_ASSERT_EQUAL (point_value (10), cl->eval (timepos_t (10 * 64 + 63)));
+	CPPUNIT_ASSERT_EQUAL (point_value (11), cl->eval (timepos_t (11 * 64)));
+}
+
+void
+ControlListTest::indexAfterEdit ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+
+	fill (cl, 100);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (reference_eval (100, 1000), cl->eval (timepos_t (1000)), 1e-9);
+
+	/* modify a point, the index must follow */
+	ControlList::iterator i = cl->begin ();
+	std::advance (i, 15);
+	cl->modify (i, (*i)->when, 1000);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (1000, cl->eval (timepos_t (15 * 64)), 1e-9);
+
+	/* erase points */
+	cl->erase_range (timepos_t (10 * 64), timepos_t (20 * 64));
+	CPPUNIT_ASSERT_EQUAL ((size_t) 89, cl->size ());
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (0.5 * (point_value (9) + point_value (21)), cl->eval (timepos_t (15 * 64)), 1e-9);
+
+	/* add points */
+	cl->add (timepos_t (15 * 64), 512, false, false);
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (512, cl->eval (timepos_t (15 * 64)), 1e-9);
+
+	/* out of order add while frozen, thaw sorts */
+	cl->freeze ();
+	cl->fast_simple_add (timepos_t (100 * 64), 1);
+	cl->fast_simple_add (timepos_t (99 * 64 + 32), 3);
+	cl->thaw ();
+	CPPUNIT_ASSERT_DOUBLES_EQUAL (2, cl->eval (timepos_t (99 * 64 + 48)), 1e-9);
+
+	cl->clear ();
+	CPPUNIT_ASSERT_EQUAL (cl->descriptor ().normal, (float) cl->eval (timepos_t (1000)));
+}
+
+void
+ControlListTest::earliestEvent ()
+{
+	boost::shared_ptr<ControlList> cl = TestCtrlList ();
+	fill (cl, 100);
+
+	timepos_t x;
+	double    y;
+
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (timepos_t (1000), x, y, true));
+	CPPUNIT_ASSERT_EQUAL (timepos_t (16 * 64), x);
+	CPPUNIT_ASSERT_EQUAL (point_value (16), y);
+
+	/* search backwards, forcing a new lookup */
+	CPPUNIT_ASSERT (cl->rt_safe_earliest_event_discrete_unlocked (timepos_t (65), x, y, false));
+	CPPUNIT_ASSERT_EQUAL (timepos_t (2 * 64), x);
+
+	CPPUNIT_ASSERT (!cl->rt_safe_earliest_event_discrete_unlocked (timepos_t (100 * 64), x, y, true));
+}
@@ -0,0 +1,26 @@
+#include <cppunit/TestFixture.h>
+#include <cppunit/extensions/HelperMacros.h>
+#include <boost/shared_ptr.hpp>
+#include "evoral/ControlList.h"
+
+class ControlListTest : public CppUnit::TestFixture
+{
+	CPPUNIT_TEST_SUITE (ControlListTest);
+	CPPUNIT_TEST (indexedEval);
+	CPPUNIT_TEST (indexAfterEdit);
+	CPPUNIT_TEST (earliestEvent);
+	CPPUNIT_TEST_SUITE_END ();
+
+public:
+	void indexedEval ();
+	void indexAfterEdit ();
+	void earliestEvent ();
+
+private:
+	boost::shared_ptr<Evoral::ControlList> TestCtrlList() {
+		Evoral::Parameter param (Evoral::Parameter(0));
+		Evoral::ParameterDescriptor desc;
+		desc.upper = 1024;
+		return boost::shared_ptr<Evoral::ControlList> (new Evoral::ControlList(param, desc, Temporal::AudioTime));
+	}
+};
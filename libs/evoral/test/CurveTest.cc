@@ -2,6 +2,7 @@
 #include "evoral/ControlList.h"
 #include "evoral/Curve.h"
 #include <stdlib.h>
+#include <algorithm>
 
 CPPUNIT_TEST_SUITE_REGISTRATION (CurveTest);
 
@@ -523,3 +524,109 @@ CurveTest::constrainedCubic ()
 		CPPUNIT_ASSERT_DOUBLES_EQUAL(v, g[x], 0.000008);
 	}
 }
+
+void
+CurveTest::compareBlock (boost::shared_ptr<Evoral::ControlList> cl, Temporal::samplepos_t start, uint32_t nframes)
+{
+	float vec[1024];
+	CPPUNIT_ASSERT (nframes <= 1024);
+
+	cl->curve().get_block (timepos_t (start), timepos_t (start + nframes), vec, nframes);
+
+	for (uint32_t i = 0; i < nframes; ++i) {
+		char msg[64];
+		snprintf (msg, 64, "at i=%d (start=%" PRId64 ")", i, start);
+		const double expected = cl->unlocked_eval (timepos_t (start + i));
+		CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE (msg, expected, vec[i], 1e-5 * std::max (1.0, fabs (expected)));
+	}
+}
+
+void
+CurveTest::blockEval ()
+{
+	boost::shared_ptr<Evoral::ControlList> cl = TestCtrlList();
+	cl->create_curve ();
+
+	cl->fast_simple_add (timepos_t (0), 2.0);
+	cl->fast_simple_add (timepos_t (100), 4.0);
+	cl->fast_simple_add (timepos_t (200), 0.0);
+	cl->fast_simple_add (timepos_t (300), 8.0);
+
+	/* before the first, across all segments, after the last point */
+	compareBlock (cl, -50, 1024);
+	/* start at a control point, end within a segment */
+	compareBlock (cl, 100, 150);
+	/* within a single segment */
+	compareBlock (cl, 210, 64);
+
+	cl->set_interpolation (ControlList::Discrete);
+	compareBlock (cl, -50, 1024);
+	compareBlock (cl, 100, 150);
+
+	/* gain */
+	Evoral::ParameterDescriptor gain_desc;
+	gain_desc.upper = 2;
+	cl.reset (new Evoral::ControlList (Evoral::Parameter (0), gain_desc, Temporal::AudioTime));
+	cl->create_curve ();
+	CPPUNIT_ASSERT (cl->set_interpolation (ControlList::Exponential));
+
+	cl->fast_simple_add (timepos_t (0), 0.0);
+	cl->fast_simple_add (timepos_t (100), 1.0);
+	cl->fast_simple_add (timepos_t (300), 2.0);
+	cl->fast_simple_add (timepos_t (500), 2.0);
+	cl->fast_simple_add (timepos_t (700), 0.5);
+	compareBlock (cl, -50, 1024);
+	compareBlock (cl, 30, 17);
+
+	/* logarithmic */
+	Evoral::ParameterDescriptor log_desc;
+	log_desc.lower = 20;
+	log_desc.upper = 20000;
+	cl.reset (new Evoral::ControlList (Evoral::Parameter (0), log_desc, Temporal::AudioTime));
+	cl->create_curve ();
+	CPPUNIT_ASSERT (cl->set_interpolation (ControlList::Logarithmic));
+
+	cl->fast_simple_add (timepos_t (0), 20.0);
+	cl->fast_simple_add (timepos_t (300), 2000.0);
+	cl->fast_simple_add (timepos_t (600), 20000.0);
+	cl->fast_simple_add (timepos_t (900), 100.0);
+	compareBlock (cl, -50, 1024);
+	compareBlock (cl, 299, 3);
+}
+
+void
+CurveTest::curvedBlockEval ()
+{
+	/* a constant power fade in, as made by AudioRegion::set_fade_in (),
+	 * starting well into the timeline
+	 */
+	const int                   num_steps = 32;
+	const Temporal::samplepos_t offset    = 10 * 48000;
+	const Temporal::samplepos_t len       = 2 * 48000;
+
+	boost::shared_ptr<Evoral::ControlList> cl (new Evoral::ControlList (Evoral::Parameter (0), Evoral::ParameterDescriptor (), Temporal::AudioTime));
+	cl->create_curve ();
+	cl->fast_simple_add (timepos_t (offset), 0.0);
+	for (int i = 1; i < num_steps; ++i) {
+		const float dist = i / (num_steps + 1.f);
+		cl->fast_simple_add (timepos_t (offset + (Temporal::samplepos_t) (len * dist)), sin (dist * M_PI / 2.0));
+	}
+	cl->fast_simple_add (timepos_t (offset + len), 1.0);
+	cl->set_interpolation (ControlList::Curved);
+
+	float vec[1024];
+	const Temporal::samplepos_t starts[] = { offset - 100, offset + 3000, offset + len / 2 + 17, offset + len - 500 };
+
+	for (size_t s = 0; s < sizeof (starts) / sizeof (starts[0]); ++s) {
+		cl->curve().get_block (timepos_t (starts[s]), timepos_t (starts[s] + 1024), vec, 1024);
+
+		for (uint32_t i = 0; i < 1024; ++i) {
+			float expected;
+			cl->curve().get_vector (timepos_t (starts[s] + i), timepos_t (starts[s] + i), &expected, 1);
+
+			char msg[64];
+			snprintf (msg, 64, "at i=%d (start=%" PRId64 ")", i, starts[s]);
+			CPPUNIT_ASSERT_DOUBLES_EQUAL_MESSAGE (msg, expected, vec[i], 1e-5);
+		}
+	}
+}
@@ -13,6 +13,8 @@ class CurveTest : public CppUnit::TestFixture
 	CPPUNIT_TEST (threePointDiscete);
 	CPPUNIT_TEST (constrainedCubic);
 	CPPUNIT_TEST (ctrlListEval);
+	CPPUNIT_TEST (blockEval);
+	CPPUNIT_TEST (curvedBlockEval);
 	CPPUNIT_TEST_SUITE_END ();
 
 public:
@@ -23,8 +25,12 @@ public:
 	void threePointDiscete ();
 	void constrainedCubic ();
 	void ctrlListEval ();
+	void blockEval ();
+	void curvedBlockEval ();
 
 private:
+	void compareBlock (boost::shared_ptr<Evoral::ControlList>, Temporal::samplepos_t start, uint32_t nframes);
+
 	boost::shared_ptr<Evoral::ControlList> TestCtrlList() {
 		Evoral::Parameter param (Evoral::Parameter(0));
 		const Evoral::ParameterDescriptor desc;
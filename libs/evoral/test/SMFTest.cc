@@ -116,3 +116,71 @@ SMFTest::writeTest ()
 
 	// TODO: Check files are actually equivalent
 }
+
+void
+SMFTest::replaceTest ()
+{
+	TestSMF smf;
+	const string output_dir_path = PBD::tmp_writable_directory (PACKAGE, "replaceTest");
+	const string new_file_path   = Glib::build_filename (output_dir_path, "Replace.mid");
+	CPPUNIT_ASSERT_EQUAL (0, smf.create(new_file_path, 1, 1920));
+	smf.begin_write();
+
+	/* one short note every 100 ticks */
+	uint8_t on[]  = { 0x90, 60, 100 };
+	uint8_t off[] = { 0x80, 60, 64 };
+	for (int i = 0; i < 100; ++i) {
+		smf.append_event_delta(i == 0 ? 0 : 90, 3, on, i);
+		smf.append_event_delta(10, 3, off, i);
+	}
+	smf.end_write(new_file_path);
+
+	uint64_t const revision = smf.track_revision();
+
+	/* replace the notes in [2000, 2999] by a single long note */
+	size_t last = 0;
+	CPPUNIT_ASSERT (smf.begin_replace(2000, 2999, last));
+	CPPUNIT_ASSERT_EQUAL (size_t(1910), last);
+
+	uint8_t on2[]  = { 0x90, 72, 100 };
+	uint8_t off2[] = { 0x80, 72, 64 };
+	smf.append_event_delta(2500 - 1910, 3, on2, 1000);
+	smf.append_event_delta(400, 3, off2, 1000);
+	smf.end_replace();
+	smf.end_write(new_file_path);
+
+	CPPUNIT_ASSERT (smf.track_revision() != revision);
+
+	/* read it back */
+	TestSMF in;
+	CPPUNIT_ASSERT_EQUAL (0, in.open(new_file_path));
+	CPPUNIT_ASSERT_EQUAL (0, in.seek_to_track(1));
+	in.seek_to_start();
+
+	uint64_t time    = 0;
+	uint32_t delta_t = 0;
+	uint32_t size    = 0;
+	uint8_t* buf     = NULL;
+	int      ret;
+	size_t   n_on    = 0;
+
+	while ((ret = in.read_event(&delta_t, &size, &buf)) >= 0) {
+		time += delta_t;
+		if (ret == 0 || (buf[0] & 0xf0) != 0x90) {
+			continue;
+		}
+		if (buf[1] == 72) {
+			CPPUNIT_ASSERT_EQUAL (uint64_t(2500), time);
+		} else {
+			CPPUNIT_ASSERT (time < 2000 || time > 2999);
+			CPPUNIT_ASSERT_EQUAL (uint64_t(0), time % 100);
+		}
+		++n_on;
+	}
+
+	/* 10 notes were replaced by 1 */
+	CPPUNIT_ASSERT_EQUAL (size_t(91), n_on);
+	CPPUNIT_ASSERT_EQUAL (uint64_t(9910), time);
+
+	free (buf);
+}
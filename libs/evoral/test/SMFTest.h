@@ -58,6 +58,7 @@ class SMFTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(createNewFileTest);
 	CPPUNIT_TEST(takeFiveTest);
 	CPPUNIT_TEST(writeTest);
+	CPPUNIT_TEST(replaceTest);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -79,6 +80,7 @@ public:
 	void createNewFileTest();
 	void takeFiveTest();
 	void writeTest();
+	void replaceTest();
 
 private:
 	DummyTypeMap*     type_map;
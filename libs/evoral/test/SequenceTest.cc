@@ -195,3 +195,73 @@ SequenceTest::controlInterpolationTest ()
 		last_value = i->second;
 	}
 }
+
+void
+SequenceTest::dirtyRangeTest ()
+{
+	Time start;
+	Time end;
+
+	/* a new sequence has no known relation to anything written before */
+	CPPUNIT_ASSERT (!seq->dirty_range (start, end));
+
+	seq->clear_dirty ();
+	CPPUNIT_ASSERT (seq->dirty_range (start, end));
+	CPPUNIT_ASSERT (start > end);
+
+	Sequence<Time>::NotePtr note (new Note<Time> (0, Time::from_double (100), Time::from_double (50), 60));
+	CPPUNIT_ASSERT (seq->add_note_unlocked (note));
+	CPPUNIT_ASSERT (seq->dirty_range (start, end));
+	CPPUNIT_ASSERT_EQUAL (Time::from_double (100), start);
+	CPPUNIT_ASSERT_EQUAL (Time::from_double (150), end);
+
+	Sequence<Time>::NotePtr other (new Note<Time> (0, Time::from_double (400), Time::from_double (10), 62));
+	CPPUNIT_ASSERT (seq->add_note_unlocked (other));
+	seq->remove_note_unlocked (note);
+	CPPUNIT_ASSERT (seq->dirty_range (start, end));
+	CPPUNIT_ASSERT_EQUAL (Time::from_double (100), start);
+	CPPUNIT_ASSERT_EQUAL (Time::from_double (410), end);
+
+	seq->clear_dirty ();
+	seq->remove_note_unlocked (other);
+	CPPUNIT_ASSERT (seq->dirty_range (start, end));
+	CPPUNIT_ASSERT_EQUAL (Time::from_double (400), start);
+	CPPUNIT_ASSERT_EQUAL (Time::from_double (410), end);
+
+	seq->clear ();
+	CPPUNIT_ASSERT (!seq->dirty_range (start, end));
+}
+
+void
+SequenceTest::noteByIdTest ()
+{
+	for (Notes::const_iterator i = test_notes.begin(); i != test_notes.end(); ++i) {
+		CPPUNIT_ASSERT (seq->add_note_unlocked (*i));
+	}
+
+	for (Notes::const_iterator i = test_notes.begin(); i != test_notes.end(); ++i) {
+		CPPUNIT_ASSERT (seq->note_by_id ((*i)->id ()) == *i);
+	}
+
+	/* removed notes are not found */
+	seq->remove_note_unlocked (test_notes[3]);
+	CPPUNIT_ASSERT (!seq->note_by_id (test_notes[3]->id ()));
+	CPPUNIT_ASSERT (seq->note_by_id (test_notes[4]->id ()) == test_notes[4]);
+
+	/* unknown IDs */
+	CPPUNIT_ASSERT (!seq->note_by_id (next_event_id ()));
+
+	/* re-added notes are found again */
+	CPPUNIT_ASSERT (seq->add_note_unlocked (test_notes[3]));
+	CPPUNIT_ASSERT (seq->note_by_id (test_notes[3]->id ()) == test_notes[3]);
+
+	/* copies have their own notes, with new IDs */
+	MySequence<Time> copy (*seq);
+	CPPUNIT_ASSERT_EQUAL (seq->notes ().size (), copy.notes ().size ());
+	CPPUNIT_ASSERT (!copy.note_by_id (test_notes[4]->id ()));
+	CPPUNIT_ASSERT ((*copy.notes ().begin ())->on_event ().buffer () != (*seq->notes ().begin ())->on_event ().buffer ());
+	CPPUNIT_ASSERT (copy.note_by_id ((*copy.notes ().begin ())->id ()) == *copy.notes ().begin ());
+
+	seq->clear ();
+	CPPUNIT_ASSERT (!seq->note_by_id (test_notes[4]->id ()));
+}
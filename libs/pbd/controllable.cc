@@ -20,7 +20,9 @@
  * 51 Franklin Street, Fifth Floor, Boston, MA 02110-1301 USA.
  */
 
+#include "pbd/compose.h"
 #include "pbd/controllable.h"
+#include "pbd/debug.h"
 #include "pbd/enumwriter.h"
 #include "pbd/xml++.h"
 #include "pbd/error.h"
@@ -39,6 +41,7 @@ PBD::Signal1<void, boost::weak_ptr<PBD::Controllable> > Controllable::ControlTou
 
 Glib::Threads::RWLock Controllable::registry_lock;
 Controllable::Controllables Controllable::registry;
+Controllable::ControllablesByID Controllable::registry_index;
 PBD::ScopedConnectionList Controllable::registry_connections;
 
 const std::string Controllable::xml_node_name = X_("Controllable");
@@ -118,6 +121,7 @@ Controllable::add (Controllable& ctl)
 {
 	Glib::Threads::RWLock::WriterLock lm (registry_lock);
 	registry.insert (&ctl);
+	registry_index[ctl.id()] = &ctl;
 	ctl.DropReferences.connect_same_thread (registry_connections, boost::bind (&Controllable::remove, &ctl));
 	ctl.Destroyed.connect_same_thread (registry_connections, boost::bind (&Controllable::remove, &ctl));
 }
@@ -126,22 +130,58 @@ void
 Controllable::remove (Controllable* ctl)
 {
 	Glib::Threads::RWLock::WriterLock lm (registry_lock);
-	Controllables::iterator i = std::find (registry.begin(), registry.end(), ctl);
+	Controllables::iterator i = registry.find (ctl);
 	if (i != registry.end()) {
 		registry.erase (i);
+		unindex (ctl, ctl->id());
 	}
 }
 
+/* registry_lock must be held for writing */
+void
+Controllable::unindex (Controllable* ctl, PBD::ID const& id)
+{
+	ControllablesByID::iterator i = registry_index.find (id);
+
+	if (i != registry_index.end() && i->second == ctl) {
+		registry_index.erase (i);
+	}
+}
+
+/* keep the index authoritative, so that ::by_id() does not need to search */
+void
+Controllable::id_changed (PBD::ID const& previous)
+{
+	Glib::Threads::RWLock::WriterLock lm (registry_lock);
+
+	if (registry.find (this) == registry.end()) {
+		return;
+	}
+
+	unindex (this, previous);
+	registry_index[id()] = this;
+}
+
 boost::shared_ptr<Controllable>
 Controllable::by_id (const ID& id)
 {
 	Glib::Threads::RWLock::ReaderLock lm (registry_lock);
 
-	for (Controllables::iterator i = registry.begin(); i != registry.end(); ++i) {
-		if ((*i)->id() == id) {
-			return (*i)->shared_from_this ();
+	ControllablesByID::const_iterator i = registry_index.find (id);
+
+	if (i != registry_index.end()) {
+		return i->second->shared_from_this ();
+	}
+
+	if (DEBUG_ENABLED (DEBUG::Stateful)) {
+		for (Controllables::iterator c = registry.begin(); c != registry.end(); ++c) {
+			if ((*c)->id() == id) {
+				DEBUG_TRACE (DEBUG::Stateful, string_compose ("Controllable %1 (%2) is missing from the ID index\n", (*c)->name(), id));
+				break;
+			}
 		}
 	}
+
 	return boost::shared_ptr<Controllable>();
 }
 
@@ -25,6 +25,7 @@
 
 #include <string>
 #include <set>
+#include <unordered_map>
 
 #include "pbd/libpbd_visibility.h"
 #include "pbd/signals.h"
@@ -182,6 +183,8 @@ protected:
 		TouchChanged (); /* EMIT SIGNAL */
 	}
 
+	void id_changed (PBD::ID const&);
+
 private:
 	std::string _name;
 	std::string _units;
@@ -189,13 +192,16 @@ private:
 	bool        _touching;
 
 	typedef std::set<PBD::Controllable*> Controllables;
+	typedef std::unordered_map<PBD::ID, PBD::Controllable*, PBD::ID::Hash> ControllablesByID;
 
 	static ScopedConnectionList registry_connections;
 	static Glib::Threads::RWLock registry_lock;
 	static Controllables registry;
+	static ControllablesByID registry_index; /* kept up to date by ::id_changed() */
 
 	static void add (Controllable&);
 	static void remove (Controllable*);
+	static void unindex (Controllable*, PBD::ID const&);
 };
 
 }
@@ -23,6 +23,7 @@
 #define __pbd_id_h__
 
 #include <stdint.h>
+#include <functional>
 #include <string>
 
 #include <glibmm/threads.h>
@@ -63,6 +64,13 @@ class LIBPBD_API ID {
 
 	std::string to_s () const;
 
+	/** hash function object, for use with std::unordered_map et al. */
+	struct Hash {
+		size_t operator() (ID const& id) const {
+			return std::hash<uint64_t> () (id._id);
+		}
+	};
+
 	static uint64_t counter() { return _counter; }
 	static void init_counter (uint64_t val) { _counter = val; }
 	static void init ();
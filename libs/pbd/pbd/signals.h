@@ -26,6 +26,7 @@
 
 #include <list>
 #include <map>
+#include <vector>
 
 #ifdef nil
 #undef nil
@@ -41,6 +42,7 @@
 #include <boost/function.hpp>
 #include <boost/enable_shared_from_this.hpp>
 #include <boost/optional.hpp>
+#include <boost/smart_ptr/detail/yield_k.hpp>
 
 #include "pbd/libpbd_visibility.h"
 #include "pbd/event_loop.h"
@@ -63,6 +65,8 @@ class LIBPBD_API SignalBase
 public:
 	SignalBase ()
 	: _in_dtor (false)
+	, _active_reads (0)
+	, _no_slots (true)
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	, _debug_connection (false)
 #endif
@@ -74,8 +78,21 @@ public:
 #endif
 
 protected:
+	/* Emission does not use _mutex. It takes a reference to an immutable
+	 * list of slots, which is dropped whenever a slot is connected or
+	 * disconnected, and rebuilt by the next emission. Taking the reference
+	 * is protected by _active_reads, in the same way as RCUManager::reader().
+	 */
+	void wait_for_readers () const {
+		for (unsigned int i = 0; _active_reads.load () != 0; ++i) {
+			boost::detail::yield (i);
+		}
+	}
+
 	mutable Glib::Threads::Mutex _mutex;
 	std::atomic<bool>            _in_dtor;
+	mutable std::atomic<int>     _active_reads;
+	std::atomic<bool>            _no_slots;
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 	bool _debug_connection;
 #endif
@@ -109,6 +126,12 @@ public:
 		}
 	}
 
+	/** @return false once the connection was disconnected, or its signal went away */
+	bool connected () const
+	{
+		return _signal.load (std::memory_order_acquire) != 0;
+	}
+
 	void disconnected ()
 	{
 		if (_invalidation_record) {
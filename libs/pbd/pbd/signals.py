@@ -104,10 +104,17 @@ def signal(f, n, v):
 \t/** The slots that this signal will call on emission */
 \ttypedef std::map<boost::shared_ptr<Connection>, slot_function_type> Slots;
 \tSlots _slots;
+
+\t/** An immutable copy of _slots, which is used for emission */
+\ttypedef std::vector<std::pair<boost::shared_ptr<Connection>, slot_function_type> > SlotList;
+\ttypedef boost::shared_ptr<SlotList const> SlotListPtr;
+\tstd::atomic<SlotListPtr*> _slot_list;
 """, file=f)
 
     print("public:", file=f)
     print("", file=f)
+    print("\tSignal%d () : _slot_list (0) {}" % n, file=f)
+    print("", file=f)
     print("\t~Signal%d () {" % n, file=f)
 
     print("\t\t_in_dtor.store (true, std::memory_order_release);", file=f)
@@ -117,6 +124,7 @@ def signal(f, n, v):
 
     print("\t\t\ti->first->signal_going_away ();", file=f)
     print("\t\t}", file=f)
+    print("\t\tdrop_slot_list ();", file=f)
     print("\t}", file=f)
     print("", file=f)
 
@@ -231,38 +239,39 @@ def signal(f, n, v):
     else:
         print("\ttypename C::result_type operator() (%s)" % comma_separated(Anan), file=f)
     print("\t{", file=f)
-    print("\t\t/* First, take a copy of our list of slots as it is now */", file=f)
-    print("", file=f)
-    print("\t\tSlots s;", file=f)
-    print("\t\t{", file=f)
-    print("\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);", file=f)
-    print("\t\t\ts = _slots;", file=f)
-    print("\t\t}", file=f)
-    print("", file=f)
-    if not v:
+    print("""\t\t/* Take a reference to the current list of slots. This neither locks
+\t\t * nor allocates, unless slots were connected or disconnected since
+\t\t * the last emission.
+\t\t */
+\t\tSlotListPtr s (slot_list ());
+""", file=f)
+    if v:
+        print("\t\tif (!s) {", file=f)
+        print("\t\t\treturn;", file=f)
+        print("\t\t}", file=f)
+        print("", file=f)
+        t = "\t\t"
+    else:
         print("\t\tstd::list<R> r;", file=f)
-    print("\t\tfor (%sSlots::const_iterator i = s.begin(); i != s.end(); ++i) {" % typename, file=f)
+        print("\t\tif (s) {", file=f)
+        t = "\t\t\t"
+    print("%sfor (%sSlotList::const_iterator i = s->begin(); i != s->end(); ++i) {" % (t, typename), file=f)
     print("""
-\t\t\t/* We may have just called a slot, and this may have resulted in
-\t\t\t * disconnection of other slots from us.  The list copy means that
-\t\t\t * this won't cause any problems with invalidated iterators, but we
-\t\t\t * must check to see if the slot we are about to call is still on the list.
-\t\t\t */
-\t\t\tbool still_there = false;
-\t\t\t{
-\t\t\t\tGlib::Threads::Mutex::Lock lm (_mutex);
-\t\t\t\tstill_there = _slots.find (i->first) != _slots.end ();
-\t\t\t}
-
-\t\t\tif (still_there) {""", file=f)
+%(t)s\t/* We may have just called a slot, and this may have resulted in
+%(t)s\t * disconnection of other slots from us. The list is immutable, so
+%(t)s\t * this won't invalidate any iterators, but we must check to see if
+%(t)s\t * the slot we are about to call is still connected.
+%(t)s\t */
+%(t)s\tif (i->first->connected ()) {""" % {'t': t}, file=f)
     if v:
-        print("\t\t\t\t(i->second)(%s);" % comma_separated(an), file=f)
+        print("%s\t\t(i->second)(%s);" % (t, comma_separated(an)), file=f)
     else:
-        print("\t\t\t\tr.push_back ((i->second)(%s));" % comma_separated(an), file=f)
-    print("\t\t\t}", file=f)
-    print("\t\t}", file=f)
-    print("", file=f)
+        print("%s\t\tr.push_back ((i->second)(%s));" % (t, comma_separated(an)), file=f)
+    print("%s\t}" % t, file=f)
+    print("%s}" % t, file=f)
     if not v:
+        print("\t\t}", file=f)
+        print("", file=f)
         print("\t\t/* Call our combiner to do whatever is required to the result values */", file=f)
         print("\t\tC c;", file=f)
         print("\t\treturn c (r.begin(), r.end());", file=f)
@@ -270,8 +279,7 @@ def signal(f, n, v):
 
     print("""
 \tbool empty () const {
-\t\tGlib::Threads::Mutex::Lock lm (_mutex);
-\t\treturn _slots.empty ();
+\t\treturn _no_slots.load (std::memory_order_acquire);
 \t}
 """, file=f)
     print("""
@@ -296,6 +304,7 @@ def signal(f, n, v):
 \t\tboost::shared_ptr<Connection> c (new Connection (this, ir));
 \t\tGlib::Threads::Mutex::Lock lm (_mutex);
 \t\t_slots[c] = f;
+\t\tdrop_slot_list ();
 #ifdef DEBUG_PBD_SIGNAL_CONNECTIONS
 \t\tif (_debug_connection) {
 \t\t\tstd::cerr << "+++++++ CONNECT " << this << " size now " << _slots.size() << std::endl;
@@ -319,6 +328,7 @@ def signal(f, n, v):
 \t\t\tlm.try_acquire ();
 \t\t}
 \t\t_slots.erase (c);
+\t\tdrop_slot_list ();
 \t\tlm.release ();
 
 \t\tc->disconnected ();
@@ -330,6 +340,46 @@ def signal(f, n, v):
 #endif
 \t}
 
+\t/** @return the immutable list of slots, or an empty pointer if there are none */
+\tSlotListPtr slot_list ()
+\t{
+\t\tSlotListPtr s;
+
+\t\t_active_reads.fetch_add (1);
+\t\tSlotListPtr* p = _slot_list.load ();
+\t\tif (p) {
+\t\t\ts = *p;
+\t\t}
+\t\t_active_reads.fetch_sub (1);
+
+\t\tif (s || _no_slots.load (std::memory_order_acquire)) {
+\t\t\treturn s;
+\t\t}
+
+\t\t/* slots were connected or disconnected since the last emission */
+\t\tGlib::Threads::Mutex::Lock lm (_mutex);
+\t\tif (!_slots.empty () && !_slot_list.load ()) {
+\t\t\t_slot_list.store (new SlotListPtr (new SlotList (_slots.begin (), _slots.end ())));
+\t\t}
+\t\tif ((p = _slot_list.load ())) {
+\t\t\ts = *p;
+\t\t}
+\t\treturn s;
+\t}
+
+\t/* Called with _mutex held, after _slots was modified. The list is
+\t * rebuilt by the next emission, so that connecting many slots in a
+\t * row does not copy the list each time.
+\t */
+\tvoid drop_slot_list ()
+\t{
+\t\t_no_slots.store (_slots.empty (), std::memory_order_release);
+\t\tSlotListPtr* p = _slot_list.exchange (0);
+\t\tif (p) {
+\t\t\twait_for_readers ();
+\t\t\tdelete p;
+\t\t}
+\t}
 };
 """, file=f)
 
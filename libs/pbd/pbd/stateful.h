@@ -54,6 +54,12 @@ class LIBPBD_API Stateful {
 	virtual XMLNode& get_state () const = 0;
 	virtual int set_state (const XMLNode&, int version) = 0;
 
+	/** Write the state, as returned by get_state(), to @a writer.
+	 *  Objects with large state can override this to write it
+	 *  incrementally, rather than building all of it first.
+	 */
+	virtual void write_state (XMLWriter& writer) const;
+
 	virtual bool apply_change (PropertyBase const &);
 	PropertyChange apply_changes (PropertyList const &);
 
@@ -135,6 +141,11 @@ class LIBPBD_API Stateful {
 	*/
 	virtual void mid_thaw (const PropertyChange&) { }
 
+	/** derived classes can implement this to follow changes of their ID,
+	    e.g. to keep an index of objects by ID up to date.
+	*/
+	virtual void id_changed (PBD::ID const& /*previous*/) { }
+
 	bool regenerate_xml_or_string_ids () const;
 
   private:
@@ -23,11 +23,13 @@
 
 #include <stdint.h>
 
+#include <algorithm>
 #include <cmath>
 #include <limits>
 #include <string>
 #include <vector>
 
+#include "pbd/g_atomic_compat.h"
 #include "pbd/microseconds.h"
 #include "pbd/libpbd_visibility.h"
 
@@ -224,6 +226,102 @@ private:
 	int      _queue_reset;
 };
 
+/** Histogram of time intervals, using power-of-two microsecond buckets:
+ * bucket 0 counts intervals < 1 usec, bucket n counts [2^(n-1), 2^n) usec
+ * and the last bucket everything longer.
+ *
+ * add() does not lock or allocate and may be called from a realtime
+ * thread, by one thread at a time. Other threads can read the
+ * counters concurrently; a reset is queued and performed by the next
+ * add(), like TimingStats::queue_reset().
+ */
+class LIBPBD_API TimingHistogram
+{
+public:
+	static const int n_buckets = 24;
+
+	TimingHistogram ()
+	{
+		reset ();
+	}
+
+	void add (microseconds_t t)
+	{
+		if (g_atomic_int_get (&_queue_reset)) {
+			reset ();
+		}
+		if (t < 0) {
+			return;
+		}
+		int b = 0;
+		while (b < n_buckets - 1 && t >= bucket_limit (b)) {
+			++b;
+		}
+		g_atomic_int_set (&_count[b], g_atomic_int_get (&_count[b]) + 1);
+		if (t > _max) {
+			_max = t;
+		}
+	}
+
+	void queue_reset () {
+		g_atomic_int_set (&_queue_reset, 1);
+	}
+
+	void reset ()
+	{
+		for (int b = 0; b < n_buckets; ++b) {
+			g_atomic_int_set (&_count[b], 0);
+		}
+		_max = 0;
+		g_atomic_int_set (&_queue_reset, 0);
+	}
+
+	/** upper limit [usec] of bucket \p b, exclusive */
+	static microseconds_t bucket_limit (int b) {
+		return b < n_buckets - 1 ? (microseconds_t) 1 << b : std::numeric_limits<microseconds_t>::max ();
+	}
+
+	uint32_t count (int b) const {
+		return b >= 0 && b < n_buckets ? g_atomic_int_get (&_count[b]) : 0;
+	}
+
+	uint64_t total () const
+	{
+		uint64_t n = 0;
+		for (int b = 0; b < n_buckets; ++b) {
+			n += count (b);
+		}
+		return n;
+	}
+
+	microseconds_t max () const { return _max; }
+
+	/** @return upper limit [usec] of the bucket containing the \p p-th percentile (0..100),
+	 * or 0 if the histogram is empty.
+	 */
+	microseconds_t percentile (double p) const
+	{
+		uint64_t const n = total ();
+		if (n == 0) {
+			return 0;
+		}
+		uint64_t const rank = ceil (n * std::min (100., std::max (0., p)) / 100.);
+		uint64_t       sum  = 0;
+		for (int b = 0; b < n_buckets - 1; ++b) {
+			sum += count (b);
+			if (sum >= rank && sum > 0) {
+				return std::min (bucket_limit (b), _max);
+			}
+		}
+		return _max;
+	}
+
+private:
+	GATOMIC_QUAL gint _count[n_buckets];
+	GATOMIC_QUAL gint _queue_reset;
+	microseconds_t    _max;
+};
+
 /** Provides an exception (and return path)-safe method to measure a timer
  * interval. The timer is started at scope entry, and updated at scope exit
  * (however that occurs)
@@ -48,6 +48,7 @@
 
 class XMLTree;
 class XMLNode;
+class XMLWriter;
 
 class LIBPBD_API XMLProperty {
 public:
@@ -197,6 +198,8 @@ public:
 	void dump (std::ostream &, std::string p = "") const;
 
 private:
+	friend class XMLWriter;
+
 	std::string         _name;
 	bool                _is_content;
 	std::string         _content;
@@ -207,6 +210,61 @@ private:
 	void clear_lists ();
 };
 
+/** Write XML to a file while it is produced, without building a complete
+ *  tree first. The output is identical to that of XMLTree::write().
+ *
+ *  Nodes can be written complete, using write(), or incrementally: open()
+ *  writes the start tag and properties of a node, flush() writes and
+ *  deletes the children that were added to the innermost open node so far,
+ *  and close() writes the remaining children and the end tag.
+ *
+ *  A node that is opened must already have all its properties, and must
+ *  not have content children. If it is a child of the enclosing open node,
+ *  close() removes and deletes it, otherwise it is owned by the caller.
+ */
+class LIBPBD_API XMLWriter {
+public:
+	XMLWriter ();
+	~XMLWriter ();
+
+	/** Create @a path and write the XML declaration */
+	bool start (const std::string& path);
+	/** Close all open nodes and the file.
+	 * @return false if anything could not be written
+	 */
+	bool finish ();
+
+	void write (const XMLNode&);
+
+	void open (XMLNode&);
+	void flush ();
+	void close ();
+
+	bool failed () const { return _failed; }
+
+private:
+	struct OpenNode {
+		OpenNode (XMLNode* n) : node (n), empty (true) {}
+		XMLNode* node;
+		bool     empty;
+	};
+
+	void write_child (const XMLNode&);
+	void write_node (const XMLNode&, int level, bool format);
+	void write_start_tag (const XMLNode&);
+	void write_child_prefix ();
+	void write_indent (int level);
+	void write_escaped (const std::string&, bool attribute);
+	void write_raw (const char*, size_t);
+	void write_raw (const std::string& s) { write_raw (s.data (), s.size ()); }
+	void write_buffer ();
+
+	FILE*                 _file;
+	std::string           _buffer;
+	bool                  _failed;
+	std::vector<OpenNode> _open;
+};
+
 class LIBPBD_API XMLException: public std::exception {
 public:
 	explicit XMLException(const std::string msg) : _message(msg) {}
@@ -61,6 +61,14 @@ Stateful::~Stateful ()
 	delete _instant_xml;
 }
 
+void
+Stateful::write_state (XMLWriter& writer) const
+{
+	XMLNode& node (get_state ());
+	writer.write (node);
+	delete &node;
+}
+
 void
 Stateful::add_extra_xml (XMLNode& node)
 {
@@ -390,7 +398,12 @@ Stateful::set_id (const XMLNode& node)
 		return true;
 	}
 
+	ID const previous (_id);
+
 	if (node.get_property ("id", _id)) {
+		if (_id != previous) {
+			id_changed (previous);
+		}
 		return true;
 	}
 
@@ -400,7 +413,9 @@ Stateful::set_id (const XMLNode& node)
 void
 Stateful::reset_id ()
 {
+	ID const previous (_id);
 	_id = ID ();
+	id_changed (previous);
 }
 
 void
@@ -411,7 +426,11 @@ Stateful::set_id (const string& str)
 	if (regen && *regen) {
 		reset_id ();
 	} else {
+		ID const previous (_id);
 		_id = str;
+		if (_id != previous) {
+			id_changed (previous);
+		}
 	}
 }
 
@@ -1,6 +1,10 @@
+#include <iostream>
+
 #include <glibmm/thread.h>
 
 #include "signals_test.h"
+#include "pbd/microseconds.h"
+#include "pbd/pthread_utils.h"
 #include "pbd/signals.h"
 
 using namespace std;
@@ -89,3 +93,118 @@ SignalsTest::testScopedConnectionList ()
 
 	CPPUNIT_ASSERT_EQUAL (1, N);
 }
+
+static int M = 0;
+
+static void
+int_receiver (int x)
+{
+	M += x;
+}
+
+/** Emit signals with a few slots connected, which is the common case,
+ *  and report the time per emission.
+ */
+void
+SignalsTest::testEmissionThroughput ()
+{
+	PBD::Signal0<void>      s0;
+	PBD::Signal1<void, int> s1;
+	PBD::ScopedConnectionList c;
+
+	const int n_slots     = 4;
+	const int n_emissions = 1000000;
+
+	for (int i = 0; i < n_slots; ++i) {
+		s0.connect_same_thread (c, boost::bind (&receiver));
+		s1.connect_same_thread (c, boost::bind (&int_receiver, _1));
+	}
+
+	N = 0;
+	PBD::microseconds_t t0 = PBD::get_microseconds ();
+	for (int i = 0; i < n_emissions; ++i) {
+		s0 ();
+	}
+	PBD::microseconds_t t1 = PBD::get_microseconds ();
+
+	M = 0;
+	for (int i = 0; i < n_emissions; ++i) {
+		s1 (1);
+	}
+	PBD::microseconds_t t2 = PBD::get_microseconds ();
+
+	PBD::Signal0<void> unconnected;
+	for (int i = 0; i < n_emissions; ++i) {
+		unconnected ();
+	}
+	PBD::microseconds_t t3 = PBD::get_microseconds ();
+
+	CPPUNIT_ASSERT_EQUAL (n_slots * n_emissions, N);
+	CPPUNIT_ASSERT_EQUAL (n_slots * n_emissions, M);
+
+	std::cout << std::endl
+	          << "Signal0, " << n_slots << " slots: " << (t1 - t0) * 1000.0 / n_emissions << " ns per emission" << std::endl
+	          << "Signal1, " << n_slots << " slots: " << (t2 - t1) * 1000.0 / n_emissions << " ns per emission" << std::endl
+	          << "Signal0, no slots: " << (t3 - t2) * 1000.0 / n_emissions << " ns per emission" << std::endl;
+}
+
+class CountingEmitter
+{
+public:
+	CountingEmitter () : count (0), emitted (0), done (false) {}
+
+	void run () {
+		while (!done.load ()) {
+			Fred ();
+			++emitted;
+		}
+	}
+
+	void receiver () {
+		++count;
+	}
+
+	PBD::Signal0<void> Fred;
+	std::atomic<int>   count;
+	std::atomic<int>   emitted;
+	std::atomic<bool>  done;
+};
+
+static void
+noop ()
+{
+}
+
+/** Emit a signal in one thread while slots are connected and disconnected
+ *  in another. A slot that stays connected must be called once per emission.
+ */
+void
+SignalsTest::testConcurrentEmission ()
+{
+	CountingEmitter e;
+	PBD::ScopedConnection permanent;
+	e.Fred.connect_same_thread (permanent, boost::bind (&CountingEmitter::receiver, &e));
+
+	PBD::Thread* t = PBD::Thread::create (boost::bind (&CountingEmitter::run, &e));
+
+	int n_emissions = 0;
+	for (int i = 0; i < 20000; ++i) {
+		PBD::ScopedConnectionList c;
+		e.Fred.connect_same_thread (c, boost::bind (&noop));
+		e.Fred.connect_same_thread (c, boost::bind (&noop));
+		e.Fred ();
+		++n_emissions;
+	}
+
+	e.done = true;
+	t->join ();
+	delete t;
+
+	CPPUNIT_ASSERT_EQUAL (n_emissions + e.emitted.load (), e.count.load ());
+
+	permanent.disconnect ();
+	int const before = e.count.load ();
+	e.Fred ();
+	CPPUNIT_ASSERT_EQUAL (before, e.count.load ());
+	CPPUNIT_ASSERT (e.Fred.empty ());
+}
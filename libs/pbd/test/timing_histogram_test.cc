@@ -0,0 +1,57 @@
+#include "timing_histogram_test.h"
+#include "pbd/timing.h"
+
+CPPUNIT_TEST_SUITE_REGISTRATION (TimingHistogramTest);
+
+using namespace PBD;
+
+void
+TimingHistogramTest::testBuckets ()
+{
+	TimingHistogram h;
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 0, h.total ());
+	CPPUNIT_ASSERT_EQUAL ((microseconds_t) 0, h.percentile (50));
+
+	h.add (0);
+	h.add (1);
+	h.add (3);
+	h.add (4);
+	h.add (7);
+	h.add (1000000000);
+
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 6, h.total ());
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 1, h.count (0)); // [0, 1)
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 1, h.count (1)); // [1, 2)
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 1, h.count (2)); // [2, 4)
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 2, h.count (3)); // [4, 8)
+	CPPUNIT_ASSERT_EQUAL ((uint32_t) 1, h.count (TimingHistogram::n_buckets - 1));
+	CPPUNIT_ASSERT_EQUAL ((microseconds_t) 1000000000, h.max ());
+}
+
+void
+TimingHistogramTest::testPercentile ()
+{
+	TimingHistogram h;
+	for (int i = 0; i < 99; ++i) {
+		h.add (100); // [64, 128)
+	}
+	h.add (5000); // [4096, 8192)
+
+	CPPUNIT_ASSERT_EQUAL ((microseconds_t) 128, h.percentile (50));
+	CPPUNIT_ASSERT_EQUAL ((microseconds_t) 128, h.percentile (99));
+	CPPUNIT_ASSERT_EQUAL ((microseconds_t) 5000, h.percentile (100));
+}
+
+void
+TimingHistogramTest::testQueueReset ()
+{
+	TimingHistogram h;
+	h.add (10);
+	h.add (20);
+	h.queue_reset ();
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 2, h.total ());
+
+	h.add (30);
+	CPPUNIT_ASSERT_EQUAL ((uint64_t) 1, h.total ());
+	CPPUNIT_ASSERT_EQUAL ((microseconds_t) 30, h.max ());
+}
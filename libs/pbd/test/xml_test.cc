@@ -224,7 +224,7 @@ test_xml_document (const std::string& test_name,
 
 	const std::string output_file_basename = Glib::build_filename (test_output_dir, test_name);
 
-	TimingData create_timing_data, write_timing_data, read_timing_data;
+	TimingData create_timing_data, write_timing_data, stream_timing_data, read_timing_data;
 
 	for (uint32_t iter = 0; iter < test_iterations; ++iter) {
 
@@ -247,6 +247,20 @@ test_xml_document (const std::string& test_name,
 
 		write_timing_data.add_elapsed ();
 
+		const std::string stream_file_path = output_file_basename + buf + "-stream.xml";
+
+		stream_timing_data.start_timing ();
+
+		XMLWriter writer;
+		CPPUNIT_ASSERT (writer.start (stream_file_path));
+		writer.write (*test_xml.root ());
+		CPPUNIT_ASSERT (writer.finish ());
+
+		stream_timing_data.add_elapsed ();
+
+		CPPUNIT_ASSERT (Glib::file_get_contents (stream_file_path) == Glib::file_get_contents (output_file_path));
+		CPPUNIT_ASSERT (g_remove (stream_file_path.c_str ()) == 0);
+
 		read_timing_data.start_timing ();
 
 		PBD::Timing read_timing;
@@ -265,6 +279,7 @@ test_xml_document (const std::string& test_name,
 	std::cerr << std::endl;
 	std::cerr << "   Create : " << create_timing_data.summary ();
 	std::cerr << "   Write : " << write_timing_data.summary ();
+	std::cerr << "   Stream : " << stream_timing_data.summary ();
 	std::cerr << "   Read : " << read_timing_data.summary ();
 }
 
@@ -304,3 +319,75 @@ XMLTest::testPerfLargeXMLDocument ()
 
 	test_xml_document ("testPerfLargeXMLDocument", node_options);
 }
+
+/** XMLWriter must produce the same output as XMLTree::write(), including
+ *  escaping and the formatting of elements with content, both when writing
+ *  complete nodes and when writing a tree while it is built.
+ */
+void
+XMLTest::testXMLWriter ()
+{
+	const string output_dir = test_output_directory ("testXMLWriter");
+	const string tree_path  = Glib::build_filename (output_dir, "tree.xml");
+	const string write_path = Glib::build_filename (output_dir, "writer.xml");
+	const string inc_path   = Glib::build_filename (output_dir, "incremental.xml");
+
+	XMLNode* root = new XMLNode (root_node_name);
+	root->set_property ("escaped", "<a & \"b\">\n\t\r 'c' \xc3\xa9");
+
+	XMLNode* child = root->add_child (child_node_name);
+	child->add_content ("<text> & \"more\"\n\t\r \xc3\xa9");
+
+	XMLNode* mixed = root->add_child ("Mixed");
+	mixed->add_child (grandchild_node_name)->set_property ("id", 1);
+	mixed->add_content ("between");
+	mixed->add_child (grandchild_node_name)->add_child (great_grandchild_node_name);
+
+	root->add_child ("Empty");
+
+	/* libxml2 limits indentation */
+	XMLNode* deep = root;
+	for (int i = 0; i < 40; ++i) {
+		deep = deep->add_child ("Deep");
+		deep->set_property ("level", i);
+	}
+
+	XMLTree tree;
+	tree.set_root (root);
+	CPPUNIT_ASSERT (tree.write (tree_path));
+
+	XMLWriter writer;
+	CPPUNIT_ASSERT (writer.start (write_path));
+	writer.write (*root);
+	CPPUNIT_ASSERT (writer.finish ());
+
+	CPPUNIT_ASSERT (Glib::file_get_contents (write_path) == Glib::file_get_contents (tree_path));
+
+	/* build the same tree while writing it */
+	XMLWriter inc;
+	CPPUNIT_ASSERT (inc.start (inc_path));
+
+	XMLNode inc_root (root_node_name);
+	inc_root.set_property ("escaped", root->property ("escaped")->value ());
+	inc.open (inc_root);
+
+	inc_root.add_child_copy (*child);
+	inc.flush ();
+	CPPUNIT_ASSERT (inc_root.children ().empty ());
+
+	inc_root.add_child_copy (*mixed);
+
+	XMLNode* empty = inc_root.add_child ("Empty");
+	inc.open (*empty);
+	inc.close ();
+
+	XMLNode* inc_deep = inc_root.add_child ("Deep");
+	inc_deep->set_property ("level", 0);
+	inc.open (*inc_deep);
+	inc_deep->add_child_copy (*root->child ("Deep")->child ("Deep"));
+	inc.close ();
+
+	CPPUNIT_ASSERT (inc.finish ());
+
+	CPPUNIT_ASSERT (Glib::file_get_contents (inc_path) == Glib::file_get_contents (tree_path));
+}
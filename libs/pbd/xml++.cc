@@ -6,8 +6,11 @@
  */
 
 #include <string.h>
+#include <algorithm>
 #include <iostream>
 
+#include <glib/gstdio.h>
+
 #include "pbd/xml++.h"
 
 #include <libxml/debugXML.h>
@@ -842,3 +845,295 @@ XMLNode::dump (ostream& s, string p) const
 		s << p << "</" << _name << ">\n";
 	}
 }
+
+/* XMLWriter mirrors the formatting of xmlSaveFormatFileEnc(): elements are
+ * indented by two spaces per level (up to 30 levels), and elements that have
+ * content children are written without any formatting inside.
+ */
+
+static const size_t xml_writer_buffer_size = 65536;
+static const int    xml_writer_max_indent  = 30;
+
+XMLWriter::XMLWriter ()
+	: _file (0)
+	, _failed (false)
+{
+	_buffer.reserve (xml_writer_buffer_size);
+}
+
+XMLWriter::~XMLWriter ()
+{
+	finish ();
+}
+
+bool
+XMLWriter::start (const string& path)
+{
+	assert (!_file);
+
+	if ((_file = g_fopen (path.c_str (), "wb")) == 0) {
+		_failed = true;
+		return false;
+	}
+
+	write_raw ("<?xml version=\"1.0\" encoding=\"UTF-8\"?>\n");
+	return true;
+}
+
+bool
+XMLWriter::finish ()
+{
+	while (!_open.empty ()) {
+		close ();
+	}
+
+	if (_file) {
+		write_buffer ();
+		if (fclose (_file) != 0) {
+			_failed = true;
+		}
+		_file = 0;
+	}
+
+	return !_failed;
+}
+
+void
+XMLWriter::write (const XMLNode& node)
+{
+	/* children that were added to the innermost open node come first */
+	flush ();
+	write_child (node);
+}
+
+void
+XMLWriter::write_child (const XMLNode& node)
+{
+	write_child_prefix ();
+	write_node (node, _open.size (), true);
+	write_raw ("\n", 1);
+}
+
+void
+XMLWriter::open (XMLNode& node)
+{
+#ifndef NDEBUG
+	for (XMLNodeConstIterator i = node._children.begin (); i != node._children.end (); ++i) {
+		assert (!(*i)->is_content ());
+	}
+#endif
+
+	if (!_open.empty ()) {
+		/* write preceding siblings, if any */
+		XMLNodeList& children (_open.back ().node->_children);
+		XMLNodeIterator i;
+		for (i = children.begin (); i != children.end () && *i != &node; ++i) {
+			write_child (**i);
+			delete *i;
+		}
+		children.erase (children.begin (), i);
+		_open.back ().node->_selected_children.clear ();
+	}
+
+	write_child_prefix ();
+	write_start_tag (node);
+	_open.push_back (OpenNode (&node));
+}
+
+void
+XMLWriter::flush ()
+{
+	if (_open.empty ()) {
+		return;
+	}
+
+	XMLNode* node = _open.back ().node;
+
+	for (XMLNodeIterator i = node->_children.begin (); i != node->_children.end (); ++i) {
+		assert (!(*i)->is_content ());
+		write_child (**i);
+		delete *i;
+	}
+
+	node->_children.clear ();
+	node->_selected_children.clear ();
+}
+
+void
+XMLWriter::close ()
+{
+	assert (!_open.empty ());
+
+	flush ();
+
+	OpenNode o (_open.back ());
+	_open.pop_back ();
+
+	if (o.empty) {
+		write_raw ("/>", 2);
+	} else {
+		write_indent (_open.size ());
+		write_raw ("</", 2);
+		write_raw (o.node->name ());
+		write_raw (">", 1);
+	}
+	write_raw ("\n", 1);
+
+	if (!_open.empty ()) {
+		XMLNode*        parent = _open.back ().node;
+		XMLNodeIterator i      = std::find (parent->_children.begin (), parent->_children.end (), o.node);
+		if (i != parent->_children.end ()) {
+			parent->_children.erase (i);
+			parent->_selected_children.clear ();
+			delete o.node;
+		}
+	}
+}
+
+void
+XMLWriter::write_child_prefix ()
+{
+	if (_open.empty ()) {
+		return;
+	}
+
+	OpenNode& o (_open.back ());
+	if (o.empty) {
+		write_raw (">\n", 2);
+		o.empty = false;
+	}
+
+	write_indent (_open.size ());
+}
+
+void
+XMLWriter::write_start_tag (const XMLNode& node)
+{
+	write_raw ("<", 1);
+	write_raw (node._name);
+
+	for (XMLPropertyConstIterator i = node._proplist.begin (); i != node._proplist.end (); ++i) {
+		write_raw (" ", 1);
+		write_raw ((*i)->name ());
+		write_raw ("=\"", 2);
+		write_escaped ((*i)->value (), true);
+		write_raw ("\"", 1);
+	}
+}
+
+void
+XMLWriter::write_node (const XMLNode& node, int level, bool format)
+{
+	if (node._is_content) {
+		write_escaped (node._content, false);
+		return;
+	}
+
+	write_start_tag (node);
+
+	if (node._children.empty ()) {
+		write_raw ("/>", 2);
+		return;
+	}
+
+	for (XMLNodeConstIterator i = node._children.begin (); i != node._children.end () && format; ++i) {
+		if ((*i)->_is_content) {
+			format = false;
+		}
+	}
+
+	write_raw (">", 1);
+	if (format) {
+		write_raw ("\n", 1);
+	}
+
+	for (XMLNodeConstIterator i = node._children.begin (); i != node._children.end (); ++i) {
+		if (format) {
+			write_indent (level + 1);
+		}
+		write_node (**i, level + 1, format);
+		if (format) {
+			write_raw ("\n", 1);
+		}
+	}
+
+	if (format) {
+		write_indent (level);
+	}
+
+	write_raw ("</", 2);
+	write_raw (node._name);
+	write_raw (">", 1);
+}
+
+void
+XMLWriter::write_indent (int level)
+{
+	static const char spaces[] = "                                                            ";
+	write_raw (spaces, 2 * std::min (level, xml_writer_max_indent));
+}
+
+void
+XMLWriter::write_escaped (const string& str, bool attribute)
+{
+	/* like libxml2, stop at the first NUL */
+	const char* p   = str.c_str ();
+	const char* run = p;
+
+	for (; *p; ++p) {
+		const char* esc;
+		switch (*p) {
+			case '<':
+				esc = "&lt;";
+				break;
+			case '>':
+				esc = "&gt;";
+				break;
+			case '&':
+				esc = "&amp;";
+				break;
+			case '\r':
+				esc = "&#13;";
+				break;
+			case '"':
+				esc = attribute ? "&quot;" : 0;
+				break;
+			case '\n':
+				esc = attribute ? "&#10;" : 0;
+				break;
+			case '\t':
+				esc = attribute ? "&#9;" : 0;
+				break;
+			default:
+				esc = 0;
+				break;
+		}
+		if (esc) {
+			write_raw (run, p - run);
+			write_raw (esc, strlen (esc));
+			run = p + 1;
+		}
+	}
+
+	write_raw (run, p - run);
+}
+
+void
+XMLWriter::write_raw (const char* s, size_t n)
+{
+	_buffer.append (s, n);
+	if (_buffer.size () >= xml_writer_buffer_size) {
+		write_buffer ();
+	}
+}
+
+void
+XMLWriter::write_buffer ()
+{
+	if (_file && !_failed && !_buffer.empty ()) {
+		if (fwrite (_buffer.data (), 1, _buffer.size (), _file) != _buffer.size ()) {
+			_failed = true;
+		}
+	}
+	_buffer.clear ();
+}
@@ -54,6 +54,7 @@
 #include "ardour/vca.h"
 #include "ardour/monitor_control.h"
 #include "ardour/dB.h"
+#include "ardour/dsp_profiler.h"
 #include "ardour/filesystem_paths.h"
 #include "ardour/panner.h"
 #include "ardour/panner_shell.h"
@@ -443,6 +444,9 @@ OSC::register_callbacks()
 		REGISTER_CALLBACK (serv, X_("/group/list"), "f", group_list);
 		REGISTER_CALLBACK (serv, X_("/surface/list"), "", surface_list);
 		REGISTER_CALLBACK (serv, X_("/surface/list"), "f", surface_list);
+		REGISTER_CALLBACK (serv, X_("/dsp/profile"), "", dsp_profile);
+		REGISTER_CALLBACK (serv, X_("/dsp/profile/reset"), "", dsp_profile_reset);
+		REGISTER_CALLBACK (serv, X_("/dsp/profile/enable"), "i", dsp_profile_enable);
 		REGISTER_CALLBACK (serv, X_("/add_marker"), "", add_marker);
 		REGISTER_CALLBACK (serv, X_("/add_marker"), "f", add_marker);
 		REGISTER_CALLBACK (serv, X_("/add_marker"), "s", add_marker_name);
@@ -3291,6 +3295,70 @@ OSC::send_group_list (lo_address addr)
 	return 0;
 }
 
+static void
+add_dsp_profile (lo_message reply, std::string const& route, std::string const& processor, PBD::TimingHistogram const& h)
+{
+	lo_message_add_string (reply, route.c_str ());
+	lo_message_add_string (reply, processor.c_str ());
+	lo_message_add_int32 (reply, (int32_t) std::min<uint64_t> (h.total (), INT32_MAX));
+	lo_message_add_int32 (reply, (int32_t) h.percentile (50));
+	lo_message_add_int32 (reply, (int32_t) h.percentile (99));
+	lo_message_add_int32 (reply, (int32_t) h.max ());
+}
+
+/* reply with one message per route and processor:
+ * route-name, processor-name ("" for the route itself), count, median, 99th percentile, max [usec]
+ */
+void
+OSC::dsp_profile (lo_message msg)
+{
+	if (!session) {
+		return;
+	}
+
+	lo_address addr = get_address (msg);
+
+	boost::shared_ptr<RouteList const> rl = session->get_routes ();
+	for (RouteList::const_iterator r = rl->begin (); r != rl->end (); ++r) {
+		lo_message reply = lo_message_new ();
+		add_dsp_profile (reply, (*r)->name (), "", (*r)->process_histogram ());
+		lo_send_message (addr, X_("/dsp/profile"), reply);
+		lo_message_free (reply);
+
+		boost::shared_ptr<Processor> p;
+		for (uint32_t n = 0; (p = (*r)->nth_processor (n)); ++n) {
+			PBD::TimingHistogram const h (p->process_histogram ());
+			if (h.total () == 0) {
+				continue;
+			}
+			reply = lo_message_new ();
+			add_dsp_profile (reply, (*r)->name (), p->display_name (), h);
+			lo_send_message (addr, X_("/dsp/profile"), reply);
+			lo_message_free (reply);
+		}
+	}
+
+	lo_message reply = lo_message_new ();
+	lo_send_message (addr, X_("/dsp/profile/end"), reply);
+	lo_message_free (reply);
+}
+
+void
+OSC::dsp_profile_reset (lo_message)
+{
+	if (session) {
+		session->dsp_profiler ().reset_stats ();
+	}
+}
+
+void
+OSC::dsp_profile_enable (int yn)
+{
+	if (session) {
+		session->dsp_profiler ().set_enabled (yn);
+	}
+}
+
 int
 OSC::click_level (float position)
 {
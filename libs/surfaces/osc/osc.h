@@ -352,6 +352,9 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	void routes_list (lo_message msg);
 	int group_list (lo_message msg);
 	void surface_list (lo_message msg);
+	void dsp_profile (lo_message msg);
+	void dsp_profile_reset (lo_message msg);
+	void dsp_profile_enable (int yn);
 	void transport_sample (lo_message msg);
 	void transport_speed (lo_message msg);
 	void record_enabled (lo_message msg);
@@ -406,6 +409,8 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	PATH_CALLBACK_MSG(route_get_receives);
 	PATH_CALLBACK_MSG(routes_list);
 	PATH_CALLBACK_MSG(group_list);
+	PATH_CALLBACK_MSG(dsp_profile);
+	PATH_CALLBACK_MSG(dsp_profile_reset);
 	PATH_CALLBACK_MSG(sel_previous);
 	PATH_CALLBACK_MSG(sel_next);
 	PATH_CALLBACK_MSG(surface_list);
@@ -498,6 +503,7 @@ class OSC : public ARDOUR::ControlProtocol, public AbstractUI<OSCUIRequest>
 	}
 
 	PATH_CALLBACK1(trigger_cue_row,i,);
+	PATH_CALLBACK1(dsp_profile_enable,i,);
 	PATH_CALLBACK1(trigger_stop_all,i,);  //0 = "stop at end of bar"  1 = "stop now"
 
 	PATH_CALLBACK1(store_mixer_scene,i,);
@@ -740,6 +740,8 @@ TempoMap::TempoMap (Tempo const & initial_tempo, Meter const & initial_meter)
 
 	_points.push_back (*tp);
 	_points.push_back (*mp);
+
+	rebuild_index ();
 }
 
 TempoMap::~TempoMap()
@@ -770,6 +772,8 @@ TempoMap::copy_points (TempoMap const & other)
 	TempoPoint const * tp;
 	MeterPoint const * mp;
 
+	invalidate_index ();
+
 	for (auto const & point : other._points) {
 		if ((mt = dynamic_cast<MusicTimePoint const *> (&point))) {
 			MusicTimePoint* mtp = new MusicTimePoint (*mt);
@@ -787,6 +791,8 @@ TempoMap::copy_points (TempoMap const & other)
 			_points.push_back (*tpp);
 		}
 	}
+
+	rebuild_index ();
 }
 
 MeterPoint*
@@ -887,6 +893,7 @@ TempoMap::core_add_point (Point* pp)
 
 	for (p = _points.begin(); p != _points.end() && p->beats() < beats_limit; ++p);
 	_points.insert (p, *pp);
+	invalidate_index ();
 }
 
 TempoPoint*
@@ -1128,6 +1135,7 @@ TempoMap::remove_point (Point const & point)
 		if (&(*p) == tpp) {
 			// XXX need to fix this leak delete tpp;
 			_points.erase (p);
+			invalidate_index ();
 			break;
 		}
 	}
@@ -1146,6 +1154,7 @@ TempoMap::reset_starting_at (superclock_t sc)
 	assert (!_tempos.empty());
 	assert (!_meters.empty());
 
+	invalidate_index ();
 
 	TempoPoint*     tp;
 	TempoPoint*     nxt_tempo = 0;
@@ -1293,6 +1302,8 @@ TempoMap::reset_starting_at (superclock_t sc)
 		}
 	}
 
+	rebuild_index ();
+
 	DEBUG_TRACE (DEBUG::MapReset, "RESET DONE\n");
 #ifndef NDEBUG
 	if (DEBUG_ENABLED(DEBUG::MapReset)) {
@@ -1384,6 +1395,7 @@ TempoMap::move_meter (MeterPoint const & mp, timepos_t const & when, bool earlie
 	const superclock_t old_sc = mp.sclock();
 
 	/* reset position of this meter */
+	invalidate_index ();
 	const_cast<MeterPoint*> (&mp)->set (sc, beats, bbt);
 
 	{
@@ -1508,6 +1520,7 @@ TempoMap::move_tempo (TempoPoint const & tp, timepos_t const & when, bool push)
 
 	const superclock_t old_sc = tp.sclock();
 	/* reset position of this tempo */
+	invalidate_index ();
 	const_cast<TempoPoint*> (&tp)->set (sc, beats, bbt);
 
 	/* move to correct position in tempo list */
@@ -1785,6 +1798,8 @@ TempoMap::sample_rate_changed (samplecnt_t new_sr)
 	for (MusicTimes::iterator p = _bartimes.begin(); p != _bartimes.end(); ++p) {
 		p->map_reset_set_sclock_for_sr_change (llrint (ratio * p->sclock()));
 	}
+
+	rebuild_index ();
 }
 
 void
@@ -1913,6 +1928,194 @@ TempoMap::_get_tempo_and_meter (typename const_traits_t::tempo_point_type & tp,
 	return last_used;
 }
 
+void
+TempoMap::rebuild_index ()
+{
+	_index.sclock.clear ();
+	_index.beats.clear ();
+	_index.bbt.clear ();
+	_index.point.clear ();
+	_index.tempo.clear ();
+	_index.meter.clear ();
+
+	_index.valid = false;
+	_index.bbt_sorted = false;
+
+	if (_tempos.empty() || _meters.empty() || _points.empty()) {
+		return;
+	}
+
+	const size_t n = _points.size();
+
+	_index.sclock.reserve (n);
+	_index.beats.reserve (n);
+	_index.bbt.reserve (n);
+	_index.point.reserve (n);
+	_index.tempo.reserve (n);
+	_index.meter.reserve (n);
+
+	TempoPoint const * tp = &_tempos.front();
+	MeterPoint const * mp = &_meters.front();
+	bool sorted = true;
+	bool bbt_sorted = true;
+
+	for (auto const & p : _points) {
+
+		TempoPoint const * tpp;
+		MeterPoint const * mpp;
+
+		if ((tpp = dynamic_cast<TempoPoint const *> (&p)) != 0) {
+			tp = tpp;
+		}
+
+		if ((mpp = dynamic_cast<MeterPoint const *> (&p)) != 0) {
+			mp = mpp;
+		}
+
+		if (!_index.point.empty()) {
+			if (p.sclock() < _index.sclock.back() || p.beats() < _index.beats.back()) {
+				sorted = false;
+			}
+			if (p.bbt() < _index.bbt.back()) {
+				bbt_sorted = false;
+			}
+		}
+
+		_index.sclock.push_back (p.sclock());
+		_index.beats.push_back (p.beats());
+		_index.bbt.push_back (p.bbt());
+		_index.point.push_back (&p);
+		_index.tempo.push_back (tp);
+		_index.meter.push_back (mp);
+	}
+
+	/* a binary search is only meaningful if the points are ordered in
+	 * the given time domain. If not, the lookup falls back to walking the
+	 * list.
+	 */
+
+	_index.valid = sorted;
+	_index.bbt_sorted = sorted && bbt_sorted;
+
+	DEBUG_TRACE (DEBUG::MapReset, string_compose ("rebuilt point index, %1 points, valid %2 bbt %3\n", n, _index.valid, _index.bbt_sorted));
+}
+
+/* Equivalent to ::_get_tempo_and_meter() but uses a binary search in the
+ * index instead of walking _points. Since every point is either a tempo or
+ * a meter (or both), the last point at (or before) @p arg is the one that
+ * the linear walk would have used last.
+ */
+
+template<typename T> TempoMap::Points::const_iterator
+TempoMap::_get_indexed_tempo_and_meter (TempoPoint const *& tp, MeterPoint const *& mp,
+                                        std::vector<T> const & keys, T const & arg,
+                                        bool can_match, bool ret_iterator_after_not_at) const
+{
+	assert (_index.valid);
+	assert (keys.size() == _index.point.size());
+
+	/* see comment in ::_get_tempo_and_meter() */
+	can_match = (can_match || arg == T ());
+
+	/* number of points at (if @p can_match is true) or before @p arg */
+	size_t n;
+
+	if (can_match) {
+		n = std::upper_bound (keys.begin(), keys.end(), arg) - keys.begin();
+	} else {
+		n = std::lower_bound (keys.begin(), keys.end(), arg) - keys.begin();
+	}
+
+	if (n == 0) {
+		tp = &_tempos.front();
+		mp = &_meters.front();
+		return _points.end();
+	}
+
+	tp = _index.tempo[n-1];
+	mp = _index.meter[n-1];
+
+	if (ret_iterator_after_not_at) {
+		if (n == _index.point.size()) {
+			return _points.end();
+		}
+		return _points.iterator_to (*_index.point[n]);
+	}
+
+	return _points.iterator_to (*_index.point[n-1]);
+}
+
+void
+TempoMap::convert (timepos_t* positions, size_t n, TimeDomain domain) const
+{
+	if (!_index.valid) {
+		for (size_t i = 0; i < n; ++i) {
+			if (positions[i].time_domain() == domain) {
+				continue;
+			}
+			if (domain == AudioTime) {
+				positions[i] = timepos_t::from_superclock (superclock_at (positions[i]));
+			} else {
+				positions[i] = timepos_t (quarters_at (positions[i]));
+			}
+		}
+		return;
+	}
+
+	/* Walk the index along with the positions. @p k is the number of
+	 * points at or before the current position, so the TempoMetric in
+	 * effect is given by point k-1 (the same as ::metric_at()).
+	 */
+
+	const size_t np = _index.point.size();
+	size_t k = 0;
+
+	for (size_t i = 0; i < n; ++i) {
+
+		timepos_t& pos (positions[i]);
+
+		if (pos.time_domain() == domain) {
+			continue;
+		}
+
+		if (pos.is_beats()) {
+
+			const Beats b (pos.beats());
+
+			if (k > 0 && b < _index.beats[k-1]) {
+				/* not sorted, search again */
+				k = std::upper_bound (_index.beats.begin(), _index.beats.end(), b) - _index.beats.begin();
+			} else {
+				while (k < np && !(b < _index.beats[k])) {
+					++k;
+				}
+			}
+
+			TempoPoint const * tp = (k > 0) ? _index.tempo[k-1] : &_tempos.front();
+			MeterPoint const * mp = (k > 0) ? _index.meter[k-1] : &_meters.front();
+
+			pos = timepos_t::from_superclock (TempoMetric (*tp, *mp).superclock_at (b));
+
+		} else {
+
+			const superclock_t sc (pos.superclocks());
+
+			if (k > 0 && sc < _index.sclock[k-1]) {
+				k = std::upper_bound (_index.sclock.begin(), _index.sclock.end(), sc) - _index.sclock.begin();
+			} else {
+				while (k < np && !(sc < _index.sclock[k])) {
+					++k;
+				}
+			}
+
+			TempoPoint const * tp = (k > 0) ? _index.tempo[k-1] : &_tempos.front();
+			MeterPoint const * mp = (k > 0) ? _index.meter[k-1] : &_meters.front();
+
+			pos = timepos_t (TempoMetric (*tp, *mp).quarters_at_superclock (sc));
+		}
+	}
+}
+
 void
 TempoMap::get_grid (TempoMapPoints& ret, superclock_t start, superclock_t end, uint32_t bar_mod, uint32_t beat_div) const
 {
@@ -2508,8 +2711,12 @@ TempoMap::get_state () const
 int
 TempoMap::set_state (XMLNode const & node, int version)
 {
+	invalidate_index ();
+
 	if (version <= 6000) {
-		return set_state_3x (node);
+		int ret = set_state_3x (node);
+		rebuild_index ();
+		return ret;
 	}
 
 	/* global map properties */
@@ -2554,6 +2761,8 @@ TempoMap::set_state (XMLNode const & node, int version)
 		}
 	}
 
+	rebuild_index ();
+
 	return 0;
 }
 
@@ -2817,6 +3026,8 @@ TempoMap::insert_time (timepos_t const & pos, timecnt_t const & duration)
 			return;
 		}
 
+		invalidate_index ();
+
 		/* advance fundamental iterators to correct position */
 
 		while (t != _tempos.end()   && t->sclock() < sc) ++t;
@@ -2889,6 +3100,8 @@ TempoMap::insert_time (timepos_t const & pos, timecnt_t const & duration)
 			}
 
 		}
+
+		rebuild_index ();
 		break;
 
 	case BeatTime:
@@ -3384,6 +3597,11 @@ TempoMap::write_copy()
 int
 TempoMap::update (TempoMap::WritableSharedPtr m)
 {
+	/* points may have been modified directly by the caller, make sure the
+	 * index matches the map before it is shared with other threads.
+	 */
+	m->rebuild_index ();
+
 	if (!_map_mgr.update (m)) {
 		return -1;
 	}
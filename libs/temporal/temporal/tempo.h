@@ -879,6 +879,13 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 
 	LIBTEMPORAL_API	Temporal::timecnt_t convert_duration (Temporal::timecnt_t const & duration, Temporal::timepos_t const &, Temporal::TimeDomain domain) const;
 
+	/* Convert @p n positions to @p domain. When the positions are sorted,
+	 * the map is walked only once for all of them, rather than looking up
+	 * the TempoMetric for each position individually. Unsorted input is
+	 * converted correctly, but less efficiently.
+	 */
+	LIBTEMPORAL_API	void convert (Temporal::timepos_t* positions, size_t n, Temporal::TimeDomain domain) const;
+
 	LIBTEMPORAL_API	BBT_Time bbt_walk (BBT_Time const &, BBT_Offset const &) const;
 
 	LIBTEMPORAL_API	void get_grid (TempoMapPoints & points, superclock_t start, superclock_t end, uint32_t bar_mod = 0, uint32_t beat_div = 1) const;
@@ -914,6 +921,33 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 	MusicTimes   _bartimes;
 	Points       _points;
 
+	/* Sorted arrays of the position of every point in _points, in each time
+	 * domain, along with the tempo and meter in effect at each point. This
+	 * allows get_tempo_and_meter() to use a binary search rather than
+	 * walking the list.
+	 *
+	 * The index is rebuilt once the map has been reset after a change (and
+	 * in ::update()). Until then, lookups fall back to walking _points.
+	 */
+	struct PointIndex {
+		PointIndex () : valid (false), bbt_sorted (false) {}
+
+		std::vector<superclock_t>       sclock;
+		std::vector<Beats>              beats;
+		std::vector<BBT_Time>           bbt;
+		std::vector<Point const *>      point;
+		std::vector<TempoPoint const *> tempo;
+		std::vector<MeterPoint const *> meter;
+
+		bool valid;
+		bool bbt_sorted; /* BBT time may not be monotonic due to MusicTimePoints */
+	};
+
+	PointIndex _index;
+
+	void rebuild_index ();
+	void invalidate_index () { _index.valid = false; }
+
 	int set_tempos_from_state (XMLNode const &);
 	int set_meters_from_state (XMLNode const &);
 	int set_music_times_from_state (XMLNode const &);
@@ -998,6 +1032,13 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 		                      bool can_match,
 		                      bool ret_iterator_after_not_at) const;
 
+	/* The same as above, but using the index, and only for const lookups */
+
+	template<typename T> Points::const_iterator
+		_get_indexed_tempo_and_meter (TempoPoint const *&, MeterPoint const *&,
+		                              std::vector<T> const & keys, T const & arg,
+		                              bool can_match, bool ret_iterator_after_not_at) const;
+
 	/* fetch non-const tempo/meter pairs and iterator (used in
 	 * ::reset_starting_at() in which we will modify points.
 	 */
@@ -1034,12 +1075,21 @@ class /*LIBTEMPORAL_API*/ TempoMap : public PBD::StatefulDestructible
 
 		   will all be the const versions of these methods.
 		*/
+		if (_index.valid && _index.bbt_sorted) {
+			return _get_indexed_tempo_and_meter (t, m, _index.bbt, bbt, can_match, ret_iterator_after_not_at);
+		}
 		return _get_tempo_and_meter<const_traits<BBT_Time const  &, BBT_Time> > (t, m, &Point::bbt, bbt, _points.begin(), _points.end(), &_tempos.front(), &_meters.front(), can_match, ret_iterator_after_not_at);
 	}
 	Points::const_iterator  get_tempo_and_meter (TempoPoint const *& t, MeterPoint const *& m, superclock_t sc, bool can_match, bool ret_iterator_after_not_at) const {
+		if (_index.valid) {
+			return _get_indexed_tempo_and_meter (t, m, _index.sclock, sc, can_match, ret_iterator_after_not_at);
+		}
 		return _get_tempo_and_meter<const_traits<superclock_t, superclock_t> > (t, m, &Point::sclock, sc, _points.begin(), _points.end(), &_tempos.front(), &_meters.front(), can_match, ret_iterator_after_not_at);
 	}
 	Points::const_iterator  get_tempo_and_meter (TempoPoint const *& t, MeterPoint const *& m, Beats const & b, bool can_match, bool ret_iterator_after_not_at) const {
+		if (_index.valid) {
+			return _get_indexed_tempo_and_meter (t, m, _index.beats, b, can_match, ret_iterator_after_not_at);
+		}
 		return _get_tempo_and_meter<const_traits<Beats const &, Beats> > (t, m, &Point::beats, b, _points.begin(), _points.end(), &_tempos.front(), &_meters.front(), can_match, ret_iterator_after_not_at);
 	}
 
@@ -1,4 +1,4 @@
-#include <stdlib.h>
+#include <vector>
 
 #include "temporal/tempo.h"
 
@@ -8,6 +8,51 @@ CPPUNIT_TEST_SUITE_REGISTRATION(TempoMapTest);
 
 using namespace Temporal;
 
+/* Reference lookups, walking the list of points from the start of the map
+ * (rather than using the TempoMap's index) to find the tempo and meter in
+ * effect at a given time.
+ */
+
+template<typename T, typename PointTime>
+static TempoMetric
+reference_metric (TempoMap const & tmap, PointTime time, T const & when)
+{
+	TempoMap::Metrics metrics;
+	tmap.get_metrics (metrics);
+
+	TempoPoint const * tp = &tmap.tempos().front();
+	MeterPoint const * mp = &tmap.meters().front();
+
+	for (TempoMap::Metrics::const_iterator p = metrics.begin(); p != metrics.end() && !(when < ((*p)->*time)()); ++p) {
+		if (TempoPoint const * t = dynamic_cast<TempoPoint const *> (*p)) {
+			tp = t;
+		}
+		if (MeterPoint const * m = dynamic_cast<MeterPoint const *> (*p)) {
+			mp = m;
+		}
+	}
+
+	return TempoMetric (*tp, *mp);
+}
+
+static Beats
+reference_quarters_at (TempoMap const & tmap, superclock_t sc)
+{
+	return reference_metric (tmap, &Point::sclock, sc).quarters_at_superclock (sc);
+}
+
+static superclock_t
+reference_superclock_at (TempoMap const & tmap, Beats const & b)
+{
+	return reference_metric (tmap, &Point::beats, b).superclock_at (b);
+}
+
+static superclock_t
+reference_superclock_at (TempoMap const & tmap, BBT_Time const & bbt)
+{
+	return reference_metric (tmap, &Point::bbt, bbt).superclock_at (bbt);
+}
+
 void
 TempoMapTest::createTest()
 {
@@ -55,3 +100,93 @@ TempoMapTest::convertTest()
 {
 }
 
+
+/* add a tempo change at every bar, ramping every fifth one towards the
+ * next, and a meter change every 8 bars
+ */
+void
+TempoMapTest::add_tempos (TempoMap::WritableSharedPtr tmap, int n_bars)
+{
+	std::vector<TempoPoint*> ramped;
+
+	for (int bar = 2; bar <= n_bars; ++bar) {
+		TempoPoint& tp (tmap->set_tempo (Tempo (90 + (bar % 64), 4), BBT_Time (bar, 1, 0)));
+		if ((bar % 5) == 0 && bar < n_bars) {
+			ramped.push_back (&tp);
+		}
+		if ((bar % 8) == 0) {
+			tmap->set_meter (Meter ((bar % 16) ? 3 : 4, 4), BBT_Time (bar, 1, 0));
+		}
+	}
+
+	for (std::vector<TempoPoint*>::const_iterator t = ramped.begin(); t != ramped.end(); ++t) {
+		CPPUNIT_ASSERT (tmap->set_ramped (**t, true));
+	}
+}
+
+void
+TempoMapTest::batchConvertTest()
+{
+	TempoMap::WritableSharedPtr tmap (TempoMap::write_copy());
+	add_tempos (tmap, 200);
+
+	/* a BBT marker in the middle of a bar, renumbering bars from there */
+	tmap->set_bartime (BBT_Time (130, 1, 0), timepos_t::from_superclock (tmap->superclock_at (BBT_Time (120, 3, 0))));
+
+	CPPUNIT_ASSERT_EQUAL (size_t (1), tmap->bartimes().size());
+
+	superclock_t const end = tmap->superclock_at (BBT_Time (220, 1, 0));
+
+	std::vector<timepos_t> audio;
+	std::vector<timepos_t> music;
+
+	for (superclock_t sc = 0; sc < end; sc += end / 5000) {
+		audio.push_back (timepos_t::from_superclock (sc));
+		music.push_back (timepos_t (reference_quarters_at (*tmap, sc)));
+	}
+
+	/* sorted */
+	std::vector<timepos_t> b (audio);
+	tmap->convert (&b[0], b.size(), BeatTime);
+	for (size_t i = 0; i < b.size(); ++i) {
+		CPPUNIT_ASSERT (b[i].is_beats ());
+		CPPUNIT_ASSERT_EQUAL (music[i].beats(), b[i].beats());
+	}
+
+	b = music;
+	tmap->convert (&b[0], b.size(), AudioTime);
+	for (size_t i = 0; i < b.size(); ++i) {
+		CPPUNIT_ASSERT (!b[i].is_beats ());
+		CPPUNIT_ASSERT_EQUAL (reference_superclock_at (*tmap, music[i].beats()), b[i].superclocks());
+	}
+
+	/* unsorted, and positions already in the target domain */
+	std::vector<timepos_t> u;
+	for (size_t i = 0; i < audio.size(); i += 7) {
+		u.push_back (audio[audio.size() - 1 - i]);
+		u.push_back (music[i]);
+	}
+	b = u;
+	tmap->convert (&b[0], b.size(), BeatTime);
+	for (size_t i = 0; i < b.size(); ++i) {
+		CPPUNIT_ASSERT (b[i].is_beats ());
+		if (u[i].is_beats ()) {
+			CPPUNIT_ASSERT_EQUAL (u[i].beats(), b[i].beats());
+		} else {
+			CPPUNIT_ASSERT_EQUAL (reference_quarters_at (*tmap, u[i].superclocks()), b[i].beats());
+		}
+	}
+
+	/* single lookups, including BBT times on either side of the marker */
+	for (size_t i = 0; i < audio.size(); i += 13) {
+		CPPUNIT_ASSERT_EQUAL (music[i].beats(), tmap->quarters_at_superclock (audio[i].superclocks()));
+	}
+	for (int bar = 1; bar < 220; ++bar) {
+		for (int beat = 1; beat <= 3; ++beat) {
+			BBT_Time const bbt (bar, beat, 0);
+			CPPUNIT_ASSERT_EQUAL (reference_superclock_at (*tmap, bbt), tmap->superclock_at (bbt));
+		}
+	}
+
+	tmap->abort_update ();
+}
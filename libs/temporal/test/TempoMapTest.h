@@ -1,6 +1,8 @@
 #include <cppunit/TestFixture.h>
 #include <cppunit/extensions/HelperMacros.h>
 
+#include "temporal/tempo.h"
+
 class TempoMapTest : public CppUnit::TestFixture
 {
 	CPPUNIT_TEST_SUITE(TempoMapTest);
@@ -10,6 +12,7 @@ class TempoMapTest : public CppUnit::TestFixture
 	CPPUNIT_TEST(multiplyTest);
 	CPPUNIT_TEST(convertTest);
 	CPPUNIT_TEST(roundTest);
+	CPPUNIT_TEST(batchConvertTest);
 	CPPUNIT_TEST_SUITE_END();
 
 public:
@@ -19,4 +22,8 @@ public:
 	void multiplyTest();
 	void convertTest();
 	void roundTest();
+	void batchConvertTest();
+
+private:
+	void add_tempos (Temporal::TempoMap::WritableSharedPtr, int n_bars);
 };
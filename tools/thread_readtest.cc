@@ -1,4 +1,8 @@
-/* g++ -o thread_readtest thread_readtest.cc `pkg-config --cflags --libs glibmm-2.4` -lm */
+/* g++ -o thread_readtest thread_readtest.cc `pkg-config --cflags --libs glibmm-2.4` -lm
+ *
+ * with io_uring support:
+ * g++ -DHAVE_LIBURING -o thread_readtest thread_readtest.cc `pkg-config --cflags --libs glibmm-2.4 liburing` -lm
+ */
 
 #ifndef _WIN32
 #  define HAVE_MMAP
@@ -22,12 +26,16 @@
 
 #include <glibmm.h>
 
+#ifdef HAVE_LIBURING
+#  include <liburing.h>
+#endif
+
 char* data = 0;
 
 void
 usage ()
 {
-	fprintf (stderr, "thread_readtest [ -b BLOCKSIZE ] [ -l FILELIMIT] [ -n NTHREADS ] [ -D ] [ -R ] [ -M ] filename-template\n");
+	fprintf (stderr, "thread_readtest [ -b BLOCKSIZE ] [ -l FILELIMIT] [ -n NTHREADS ] [ -D ] [ -R ] [ -M ] [ -U ] [ -d QUEUEDEPTH ] filename-template\n");
 }
 
 Glib::Threads::Cond pool_run;
@@ -155,14 +163,81 @@ run_thread_pool (int* files, int nfiles)
 	return 0;
 }
 
+#ifdef HAVE_LIBURING
+struct io_uring ring;
+std::vector<char*> ring_buffers;
+
+int
+build_io_uring (int depth, size_t block_size)
+{
+	if (io_uring_queue_init (depth, &ring, 0) < 0) {
+		return -1;
+	}
+	for (int n = 0; n < depth; ++n) {
+		ring_buffers.push_back ((char*) malloc (sizeof (char) * block_size));
+	}
+	return 0;
+}
+
+/* read one block of each file at the given offset, keeping up to
+ * queue-depth reads in flight, similar to ARDOUR::AsyncFileReader
+ */
+int
+run_io_uring (int* files, int nfiles, size_t block_size, off_t offset)
+{
+	std::vector<char*> free_buffers (ring_buffers);
+	int next = 0;
+	int in_flight = 0;
+	int errors = 0;
+
+	while (next < nfiles || in_flight > 0) {
+		while (next < nfiles && !free_buffers.empty ()) {
+			struct io_uring_sqe* sqe = io_uring_get_sqe (&ring);
+			if (!sqe) {
+				break;
+			}
+			char* buf = free_buffers.back ();
+			free_buffers.pop_back ();
+			io_uring_prep_read (sqe, files[next++], buf, block_size, offset);
+			io_uring_sqe_set_data (sqe, buf);
+			++in_flight;
+		}
+
+		if (io_uring_submit (&ring) < 0) {
+			return -1;
+		}
+
+		struct io_uring_cqe* cqe;
+		if (io_uring_wait_cqe (&ring, &cqe) < 0) {
+			return -1;
+		}
+		do {
+			if (cqe->res != (int) block_size) {
+				if (cqe->res < 0) {
+					fprintf (stderr, "io_uring read error = %s\n", strerror (-cqe->res));
+				}
+				++errors;
+			}
+			free_buffers.push_back ((char*) io_uring_cqe_get_data (cqe));
+			io_uring_cqe_seen (&ring, cqe);
+			--in_flight;
+		} while (in_flight > 0 && io_uring_peek_cqe (&ring, &cqe) == 0);
+	}
+
+	return errors ? -1 : 0;
+}
+#endif
+
 int
 main (int argc, char* argv[])
 {
 	int* files;
-	char optstring[] = "b:DRMl:q";
+	char optstring[] = "b:DRMl:qn:Ud:";
 	uint32_t block_size = 64 * 1024 * 4;
 	int max_files = -1;
 	int nthreads = 16;
+	int use_io_uring = 0;
+	int queue_depth = 64;
 #ifdef __APPLE__
 	int direct = 0;
 	int noreadahead = 0;
@@ -178,7 +253,9 @@ main (int argc, char* argv[])
 		{ "mmap", 0, 0, 'M' },
 		{ "noreadahead", 0, 0, 'R' },
 		{ "limit", 1, 0, 'l' },
-		{ "nthreads", 16, 0, 'n' },
+		{ "nthreads", 1, 0, 'n' },
+		{ "io-uring", 0, 0, 'U' },
+		{ "queue-depth", 1, 0, 'd' },
 		{ 0, 0, 0, 0 }
 	};
 
@@ -223,6 +300,16 @@ main (int argc, char* argv[])
 		case 'n':
 			nthreads = atoi (optarg);
 			break;
+		case 'U':
+#ifdef HAVE_LIBURING
+			use_io_uring = 1;
+#else
+			fprintf (stderr, "io_uring support was not compiled in, using threads.\n");
+#endif
+			break;
+		case 'd':
+			queue_depth = atoi (optarg);
+			break;
 		default:
 			usage ();
 			return 0;
@@ -334,12 +421,31 @@ main (int argc, char* argv[])
 	double var_s = 0;
 	uint64_t cnt = 0;
 
+#ifdef HAVE_LIBURING
+	if (use_io_uring) {
+		if (build_io_uring (queue_depth, block_size)) {
+			fprintf (stderr, "Could not initialize io_uring\n");
+			return 1;
+		}
+		if (!quiet) {
+			printf ("# Using io_uring, queue depth %d.\n", queue_depth);
+		}
+	} else
+#endif
 	build_thread_pool (nthreads, block_size);
 
 	while (1) {
 		gint64 before;
 		before = g_get_monotonic_time();
 
+#ifdef HAVE_LIBURING
+		if (use_io_uring) {
+			if (run_io_uring (files, nfiles, block_size, _read)) {
+				fprintf (stderr, "io_uring error\n");
+				goto out;
+			}
+		} else
+#endif
 		if (run_thread_pool (files, nfiles)) {
 			fprintf (stderr, "thread pool error\n");
 			goto out;